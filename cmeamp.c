@@ -9,26 +9,42 @@
 
    Doesn't implement independent gain and mute controls for L and R in the stereo version (no sense in implementing an entire mixer!).
 
-   This file has poor memory protection. Failures during malloc() will
-   not recover nicely. */
+   Silent input (every sample +0 or -0, which is most channels of a big session most of the time) isn't multiplied: run() just zero-fills the output, or leaves it alone when processing in place, and run_adding() adds nothing.  The "Silent" output is 1 whenever the plugin's output block is all zeros, so a host can skip whatever comes after it.
+
+   The descriptors are const static data, so loading the library allocates nothing.  Instances are taken from a pool of cache-line-aligned slots (see cmepool.h), so instances run on different threads never share a cache line.
+
+   For surround and wide buses there are also 4, 6, 8, 16, 32 and 64 channel versions (IDs 53 to 58), so that a 5.1 or 64-channel bus takes one instance rather than a stack of stereo ones: the dB control is converted once per change for the whole bus, and run() is a single sweep across the channels, each going through the Scale kernel (or being zero-filled, if it is silent) in turn.  If the host puts one channel's output on another's input, that sweep would overwrite input not yet read, so then run() goes 32 samples at a time instead, copying that much of every input first.  "Silent" is 1 only when every channel's output is all zeros.
+
+   Gain and mute changes are smoothed (see cmesmooth.h): the gain ramps linearly to a new setting over the time set by the "Smoothing" control (10 ms by default, up to 40), rather than jumping at the start of the next block, and mute is a fade out (and back in) over the same time.  The ramp is applied by the ScaleRamp kernels; once it has finished, run() uses the routine the smoother picked for the setting when it last moved: at 0 dB that is a copy (nothing at all in place), and at any other gain the plain Scale again, for every variant including the wide ones.  "Smoothing" is the last port, so the others keep their numbers.
+
+   gain_mono_mod and gain_stereo_mod (IDs 66 and 67) take the gain as an audio-rate input, in dB, so automation and modulation are sample-accurate without the host splitting blocks.  The dB values are turned into gains CME_GAIN_CHUNK samples at a time by the DBToGain kernel (the vector version of cmeDBToGain(), bit for bit), and applied with Multiply or DualMultiply, so a constant gain signal gives exactly what gain_mono and gain_stereo give for the same control value.  Mute stays a control port, and fades as above. */
 
 /*****************************************************************************/
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 
 /*****************************************************************************/
 
 #include "ladspa.h"
+#include "cmekernels.h"
+#include "cmemath.h"
+#include "cmesmooth.h"
+#include "cmepool.h"
+#include "cmeplugins.h"
 
 /*****************************************************************************/
 
 #define CMEAMP_MONO_LADSPA_ID	48
 #define CMEAMP_STEREO_LADSPA_ID 49
+#define CMEAMP_WIDE_LADSPA_ID	53	// ...to 58; see g_asWideAmplifierDescriptors
+#define CMEAMP_MONO_MOD_LADSPA_ID	66
+#define CMEAMP_STEREO_MOD_LADSPA_ID	67
 
-#define CMEAMP_MONO_PORT_COUNT 4
-#define CMEAMP_STEREO_PORT_COUNT 6
+#define CMEAMP_MONO_PORT_COUNT 6
+#define CMEAMP_STEREO_PORT_COUNT 8
 
 /* The internal ID numbers for the plugin's ports: */
 
@@ -40,27 +56,67 @@
 #define AMP_INPUT2  4
 #define AMP_OUTPUT2 5
 
+// The "Silent" output and "Smoothing" control come last, so their numbers depend on the variant:
+#define AMP_MONO_SILENT   4
+#define AMP_MONO_SMOOTHING 5
+#define AMP_STEREO_SILENT 6
+#define AMP_STEREO_SMOOTHING 7
+
+// The wide-bus versions have all the inputs from AMP_WIDE_INPUTS, then all the outputs, then "Silent" and "Smoothing":
+#define AMP_WIDE_INPUTS	2
+#define AMP_WIDE_PORT_COUNT(Channels)	(AMP_WIDE_INPUTS + 2 * (Channels) + 2)
+#define AMP_WIDE_MAX_CHANNELS	64
+
+// Samples per step when a wide bus is cross-wired (so the chunk buffer is 8 KiB of stack at most):
+#define AMP_WIDE_CHUNK	32
+
 /*****************************************************************************/
 
 /* The structure used to hold port connection information and state
-   (actually gain controls require no further state). */
+   (the last gain setting and its linear factor, so we only convert dB when the control moves, the gain the host has asked run_adding() to apply, and the ramp between factors). */
 
 
 typedef struct {
-	LADSPA_Data * m_pfControlValue;
+	LADSPA_Data * m_pfControlValue;	// (An audio buffer, in the audio-rate gain versions)
 	LADSPA_Data * m_pfMuteValue;	// CME
 	LADSPA_Data * m_pfInputBuffer1;
 	LADSPA_Data * m_pfOutputBuffer1;
 	LADSPA_Data * m_pfInputBuffer2;  /* (Not used for mono) */
 	LADSPA_Data * m_pfOutputBuffer2; /* (Not used for mono) */
+	LADSPA_Data * m_pfSilentValue;	// (NULL if the host hasn't connected it)
+	LADSPA_Data * m_pfSmoothingValue;
+	unsigned long m_lSilentPort;	// AMP_MONO_SILENT or AMP_STEREO_SILENT ("Smoothing" is the next one)
+	LADSPA_Data m_fLastGain;		// dB value m_fGainFactor was computed from
+	LADSPA_Data m_fGainFactor;
+	LADSPA_Data m_fRunAddingGain;
+	CMESmoother m_sSmoother;		// Both channels use Current[0] etc.
+	unsigned long m_lChannels;		/* (Wide-bus versions only, as are the next two) */
+	LADSPA_Data ** m_ppfInputBuffers;	// [m_lChannels]
+	LADSPA_Data ** m_ppfOutputBuffers;
+	int m_iCrossWired;			// 1 if an output is on another channel's input, -1 if not yet checked since connect_port()
 } Amplifier;
 
+/* Every variant's instances come from here (see cmepool.h): */
+static CMEInstancePool g_sAmplifierPool = CME_INSTANCE_POOL(Amplifier);
+
 
 /* Construct a new plugin instance. */
 LADSPA_Handle 
 instantiateAmplifier(const LADSPA_Descriptor * Descriptor,
 		     unsigned long             SampleRate) {
-	return malloc(sizeof(Amplifier));
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)cmePoolAllocate(&g_sAmplifierPool);
+	if (psAmplifier) {
+		psAmplifier->m_pfSilentValue = NULL;
+		psAmplifier->m_lSilentPort = Descriptor->PortCount - 2;
+		psAmplifier->m_fLastGain = NAN;	// (never equal to anything, so the first run() computes the factor)
+		psAmplifier->m_fGainFactor = 1.0;
+		psAmplifier->m_fRunAddingGain = 1.0;
+		cmeSmootherInit(&psAmplifier->m_sSmoother, SampleRate);
+	}
+	return psAmplifier;
 }
 
 
@@ -73,6 +129,14 @@ connectPortToAmplifier(LADSPA_Handle Instance,
 	Amplifier * psAmplifier;
 
 	psAmplifier = (Amplifier *)Instance;
+	if (Port == psAmplifier->m_lSilentPort) {
+		psAmplifier->m_pfSilentValue = DataLocation;
+		return;
+	}
+	if (Port == psAmplifier->m_lSilentPort + 1) {
+		psAmplifier->m_pfSmoothingValue = DataLocation;
+		return;
+	}
 	switch (Port) {
 		case AMP_GAIN:
 			psAmplifier->m_pfControlValue = DataLocation;
@@ -99,33 +163,69 @@ connectPortToAmplifier(LADSPA_Handle Instance,
 
 
 
+/* Return the linear gain factor for the gain control, recomputing it only if the control has changed since last time. */
+static LADSPA_Data
+getGainFactor(Amplifier * psAmplifier) {
+
+	LADSPA_Data fGain;
+
+	fGain = *(psAmplifier->m_pfControlValue);
+	if (fGain != psAmplifier->m_fLastGain) {
+		psAmplifier->m_fLastGain = fGain;
+		psAmplifier->m_fGainFactor = cmeDBToGain(fGain);
+	}
+	return psAmplifier->m_fGainFactor;
+}
+
+
+/* Report whether this block of output was all zeros, if the host wants to know. */
+static inline void
+setSilent(Amplifier * psAmplifier,
+	  int Silent) {
+	if (psAmplifier->m_pfSilentValue)
+		*(psAmplifier->m_pfSilentValue) = Silent ? 1 : 0;
+}
+
+
+/* Set the factor to ramp to: GainFactor, or 0 when muted (so mute is a fade). */
+static inline void
+setGainTarget(Amplifier * psAmplifier,
+	      LADSPA_Data GainFactor) {
+	if (*(psAmplifier->m_pfMuteValue) == 1)
+		GainFactor = 0;
+	cmeSmootherSetTarget(&psAmplifier->m_sSmoother, GainFactor, GainFactor, *(psAmplifier->m_pfSmoothingValue));
+}
+
+
+
 void 
 runMonoAmplifier(LADSPA_Handle Instance,
 		 unsigned long SampleCount) {
   
 	LADSPA_Data * pfInput;
 	LADSPA_Data * pfOutput;
-	LADSPA_Data fGain;	// CME: now in dB
-	LADSPA_Data fMute;	// CME: added mute control.
-	LADSPA_Data GainFactor;	// Store it to reduce CPU load.
 	Amplifier * psAmplifier;
-	unsigned long lSampleIndex;
 
 	psAmplifier = (Amplifier *)Instance;
 
 	pfInput = psAmplifier->m_pfInputBuffer1;
 	pfOutput = psAmplifier->m_pfOutputBuffer1;
-	fGain = *(psAmplifier->m_pfControlValue);
-	GainFactor = pow(10, fGain / 20.0);
-	fMute = *(psAmplifier->m_pfMuteValue);
-
-	if (fMute == 1)	// If mute switch enabled, output silence
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
-			*(pfOutput++) = 0.0;
-	else	// otherwise scale the input according to the gain control
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
-			*(pfOutput++) = *(pfInput++) * GainFactor;
-	// I nested the for loops within the conditional rather than the other way round to avoid having to check the state of fMute every iteration.
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));	// CME: gain control now in dB, and mute fades.
+
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {	// If muted (and faded out), output silence
+		g_sCMEKernels.Zero(pfOutput, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else if (g_sCMEKernels.IsSilent(pfInput, SampleCount)) {	// Silence in, silence out (already there if in place)
+		if (pfOutput != pfInput)
+			g_sCMEKernels.Zero(pfOutput, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else {	// otherwise scale the input according to the gain control
+		cmeSmoothedScale(&psAmplifier->m_sSmoother, pfInput, pfOutput, 1.0f, SampleCount, 0);
+		setSilent(psAmplifier, 0);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
 }
 
 
@@ -134,216 +234,753 @@ void
 runStereoAmplifier(LADSPA_Handle Instance,
 		   unsigned long SampleCount) {
   
-	LADSPA_Data * pfInput;
-	LADSPA_Data * pfOutput;
-	LADSPA_Data fGain;	// CME
-	LADSPA_Data fMute;	// CME
-	LADSPA_Data GainFactor;	// CME
 	Amplifier * psAmplifier;
-	unsigned long lSampleIndex;
 
 	psAmplifier = (Amplifier *)Instance;
 
-	fGain = *(psAmplifier->m_pfControlValue);
-	GainFactor = pow(10.0, fGain / 20.0);
-	fMute = *(psAmplifier->m_pfMuteValue);
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));	// CME
 
-	// Process L buffer:
-	pfInput = psAmplifier->m_pfInputBuffer1;
-	pfOutput = psAmplifier->m_pfOutputBuffer1;
-	if (fMute == 1)
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
-			*(pfOutput++) = 0.0;
-	else
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) 
-			*(pfOutput++) = *(pfInput++) * GainFactor;
-
-	// Process R buffer:
-	pfInput = psAmplifier->m_pfInputBuffer2;
-	pfOutput = psAmplifier->m_pfOutputBuffer2;
-	if (fMute == 1)
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) 
-			*(pfOutput++) = 0.0;
-	else
-		for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) 
-			*(pfOutput++) = *(pfInput++) * GainFactor;
+	// Process L and R buffers together:
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {
+		g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer2, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else if (g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount)
+		 && g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer2, SampleCount)) {
+		if (psAmplifier->m_pfOutputBuffer1 != psAmplifier->m_pfInputBuffer1)
+			g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		if (psAmplifier->m_pfOutputBuffer2 != psAmplifier->m_pfInputBuffer2)
+			g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer2, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else {
+		cmeSmoothedDualScale(&psAmplifier->m_sSmoother, psAmplifier->m_pfInputBuffer1, psAmplifier->m_pfInputBuffer2,
+				     psAmplifier->m_pfOutputBuffer1, psAmplifier->m_pfOutputBuffer2, 1.0f, SampleCount, 0);
+		setSilent(psAmplifier, 0);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
 }
 
 
-/* Throw away a simple delay line. */
+/* run_adding() versions: these accumulate into the output buffers instead of overwriting them, with the host's run-adding gain folded into the gain factor (and ramp), so a host can mix straight onto a bus.  Mute (once faded out) and silent input simply add nothing, and "Silent" then says so (it's about what we added, not what's in the bus). */
+
 void 
-cleanupAmplifier(LADSPA_Handle Instance) {
-	free(Instance);
+setAmplifierRunAddingGain(LADSPA_Handle Instance,
+			  LADSPA_Data Gain) {
+	((Amplifier *)Instance)->m_fRunAddingGain = Gain;
 }
 
 
+void 
+runAddingMonoAmplifier(LADSPA_Handle Instance,
+		       unsigned long SampleCount) {
 
-LADSPA_Descriptor * g_psMonoDescriptor = NULL;
-LADSPA_Descriptor * g_psStereoDescriptor = NULL;
+	Amplifier * psAmplifier;
 
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)
+	    || g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount))
+		setSilent(psAmplifier, 1);
+	else {
+		setSilent(psAmplifier, 0);
+		cmeSmoothedScale(&psAmplifier->m_sSmoother, psAmplifier->m_pfInputBuffer1, psAmplifier->m_pfOutputBuffer1,
+				 psAmplifier->m_fRunAddingGain, SampleCount, 1);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
 
 
-/* _init() is called automatically when the plugin library is first
-   loaded. */
 void 
-_init() {
+runAddingStereoAmplifier(LADSPA_Handle Instance,
+			 unsigned long SampleCount) {
 
-	char ** pcPortNames;
-	LADSPA_PortDescriptor * piPortDescriptors;
-	LADSPA_PortRangeHint * psPortRangeHints;
+	Amplifier * psAmplifier;
 
-	g_psMonoDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
-	g_psStereoDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+	psAmplifier = (Amplifier *)Instance;
 
-	if (g_psMonoDescriptor) {
-  
-		g_psMonoDescriptor->UniqueID = CMEAMP_MONO_LADSPA_ID;
-		g_psMonoDescriptor->Label = strdup("gain_mono");
-		g_psMonoDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-		g_psMonoDescriptor->Name = strdup("Gain (dB), Mono, with mute (CME)");
-		g_psMonoDescriptor->Maker = strdup("Chris Edwards");
-		g_psMonoDescriptor->Copyright = strdup("None");
-
-		g_psMonoDescriptor->PortCount = CMEAMP_MONO_PORT_COUNT;
-		piPortDescriptors = (LADSPA_PortDescriptor *)calloc(CMEAMP_MONO_PORT_COUNT, sizeof(LADSPA_PortDescriptor));
-		g_psMonoDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)piPortDescriptors;
-		piPortDescriptors[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		pcPortNames = (char **)calloc(CMEAMP_MONO_PORT_COUNT, sizeof(char *));
-		g_psMonoDescriptor->PortNames = (const char **)pcPortNames;
-		pcPortNames[AMP_GAIN] = strdup("Gain");
-		pcPortNames[AMP_MUTE] = strdup("Mute");
-		pcPortNames[AMP_INPUT1]= strdup("Input");
-		pcPortNames[AMP_OUTPUT1]= strdup("Output");
-		psPortRangeHints = ((LADSPA_PortRangeHint *) calloc(CMEAMP_MONO_PORT_COUNT, sizeof(LADSPA_PortRangeHint)));
-		g_psMonoDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)psPortRangeHints;
-
-		psPortRangeHints[AMP_GAIN].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[AMP_GAIN].LowerBound = -120;
-		psPortRangeHints[AMP_GAIN].UpperBound = 120;
-
-		psPortRangeHints[AMP_MUTE].HintDescriptor = (LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0);
-
-		psPortRangeHints[AMP_INPUT1].HintDescriptor = 0;
-		psPortRangeHints[AMP_OUTPUT1].HintDescriptor = 0;
-
-		g_psMonoDescriptor->instantiate = instantiateAmplifier;
-		g_psMonoDescriptor->connect_port = connectPortToAmplifier;
-		g_psMonoDescriptor->activate = NULL;
-		g_psMonoDescriptor->run = runMonoAmplifier;
-		g_psMonoDescriptor->run_adding = NULL;
-		g_psMonoDescriptor->set_run_adding_gain = NULL;
-		g_psMonoDescriptor->deactivate = NULL;
-		g_psMonoDescriptor->cleanup = cleanupAmplifier;
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)
+	    || (g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount)
+		&& g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer2, SampleCount)))
+		setSilent(psAmplifier, 1);
+	else {
+		setSilent(psAmplifier, 0);
+		cmeSmoothedDualScale(&psAmplifier->m_sSmoother, psAmplifier->m_pfInputBuffer1, psAmplifier->m_pfInputBuffer2,
+				     psAmplifier->m_pfOutputBuffer1, psAmplifier->m_pfOutputBuffer2, psAmplifier->m_fRunAddingGain, SampleCount, 1);
 	}
-  
-	if (g_psStereoDescriptor) {
-		g_psStereoDescriptor->UniqueID = CMEAMP_STEREO_LADSPA_ID;
-		g_psStereoDescriptor->Label = strdup("gain_stereo");
-		g_psStereoDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-		g_psStereoDescriptor->Name = strdup("Gain (dB), Stereo, with mute (CME)");
-		g_psStereoDescriptor->Maker = strdup("Chris Edwards");
-		g_psStereoDescriptor->Copyright = strdup("None");
-
-		g_psStereoDescriptor->PortCount = CMEAMP_STEREO_PORT_COUNT;
-		piPortDescriptors = (LADSPA_PortDescriptor *)calloc(CMEAMP_STEREO_PORT_COUNT, sizeof(LADSPA_PortDescriptor));
-		g_psStereoDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)piPortDescriptors;
-		piPortDescriptors[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[AMP_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[AMP_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		pcPortNames = (char **)calloc(CMEAMP_STEREO_PORT_COUNT, sizeof(char *));
-		g_psStereoDescriptor->PortNames = (const char **)pcPortNames;
-		
-		pcPortNames[AMP_GAIN]= strdup("Gain");
-		pcPortNames[AMP_MUTE] = strdup("Mute");
-		pcPortNames[AMP_INPUT1] = strdup("Input (Left)");
-		pcPortNames[AMP_OUTPUT1] = strdup("Output (Left)");
-		pcPortNames[AMP_INPUT2] = strdup("Input (Right)");
-		pcPortNames[AMP_OUTPUT2] = strdup("Output (Right)");
-
-		psPortRangeHints = ((LADSPA_PortRangeHint *) calloc(CMEAMP_STEREO_PORT_COUNT, sizeof(LADSPA_PortRangeHint)));
-		g_psStereoDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)psPortRangeHints;
-
-		psPortRangeHints[AMP_GAIN].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-			);
-		psPortRangeHints[AMP_GAIN].LowerBound = -120;
-		psPortRangeHints[AMP_GAIN].UpperBound = 120;
-
-		psPortRangeHints[AMP_MUTE].HintDescriptor = (LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0);
-
-		psPortRangeHints[AMP_INPUT1].HintDescriptor = 0;
-		psPortRangeHints[AMP_OUTPUT1].HintDescriptor = 0;
-		psPortRangeHints[AMP_INPUT2].HintDescriptor = 0;
-		psPortRangeHints[AMP_OUTPUT2].HintDescriptor = 0;
-
-		g_psStereoDescriptor->instantiate = instantiateAmplifier;
-		g_psStereoDescriptor->connect_port = connectPortToAmplifier;
-		g_psStereoDescriptor->activate = NULL;
-		g_psStereoDescriptor->run = runStereoAmplifier;
-		g_psStereoDescriptor->run_adding = NULL;
-		g_psStereoDescriptor->set_run_adding_gain = NULL;
-		g_psStereoDescriptor->deactivate = NULL;
-		g_psStereoDescriptor->cleanup = cleanupAmplifier;
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
+/*****************************************************************************/
+
+/* Audio-rate gain versions.  The ports are as for mono and stereo (so connectPortToAmplifier() does), but AMP_GAIN is an audio input. */
+
+/* Apply the gain signal, times Gain and the mute fade, to one or both channels, a chunk at a time; each chunk's gains are worked out before any of its output is written, so this is safe in place, whichever buffers are shared. */
+static void
+modulateAmplifier(Amplifier * psAmplifier,
+		  int Stereo,
+		  LADSPA_Data Gain,
+		  unsigned long SampleCount,
+		  int Adding) {
+
+	const CMESmoother * psSmoother = &psAmplifier->m_sSmoother;
+	LADSPA_Data afGains[CME_GAIN_CHUNK];
+	unsigned long lRamp = cmeSmootherRampLength(psSmoother, SampleCount);
+	unsigned long lDone, lLength, lRamped;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = SampleCount - lDone < CME_GAIN_CHUNK ? SampleCount - lDone : CME_GAIN_CHUNK;
+		g_sCMEKernels.DBToGain(psAmplifier->m_pfControlValue + lDone, afGains, Gain, lLength);
+		// Mid-fade, the mute factor (0 .. 1) goes into the gains too:
+		lRamped = 0;
+		if (lDone < lRamp) {
+			lRamped = lRamp - lDone < lLength ? lRamp - lDone : lLength;
+			g_sCMEKernels.ScaleRamp(afGains, afGains, cmeSmootherStart(psSmoother, 0) + (LADSPA_Data)lDone * psSmoother->Step[0], psSmoother->Step[0], lRamped);
+		}
+		if (lRamped < lLength && psSmoother->Target[0] != 1)
+			g_sCMEKernels.Scale(afGains + lRamped, afGains + lRamped, psSmoother->Target[0], lLength - lRamped);
+		if (!Stereo) {
+			if (Adding)
+				g_sCMEKernels.MultiplyAdd(psAmplifier->m_pfInputBuffer1 + lDone, afGains, psAmplifier->m_pfOutputBuffer1 + lDone, lLength);
+			else
+				g_sCMEKernels.Multiply(psAmplifier->m_pfInputBuffer1 + lDone, afGains, psAmplifier->m_pfOutputBuffer1 + lDone, lLength);
+		}
+		else if (Adding)
+			g_sCMEKernels.DualMultiplyAdd(psAmplifier->m_pfInputBuffer1 + lDone, psAmplifier->m_pfInputBuffer2 + lDone, afGains, afGains,
+						      psAmplifier->m_pfOutputBuffer1 + lDone, psAmplifier->m_pfOutputBuffer2 + lDone, lLength);
+		else
+			g_sCMEKernels.DualMultiply(psAmplifier->m_pfInputBuffer1 + lDone, psAmplifier->m_pfInputBuffer2 + lDone, afGains, afGains,
+						   psAmplifier->m_pfOutputBuffer1 + lDone, psAmplifier->m_pfOutputBuffer2 + lDone, lLength);
+	}
+}
+
+
+void 
+runModulatedMonoAmplifier(LADSPA_Handle Instance,
+			  unsigned long SampleCount) {
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, 1);
+
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {
+		g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else if (g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount)) {
+		if (psAmplifier->m_pfOutputBuffer1 != psAmplifier->m_pfInputBuffer1)
+			g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else {
+		modulateAmplifier(psAmplifier, 0, 1.0f, SampleCount, 0);
+		setSilent(psAmplifier, 0);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
+void 
+runModulatedStereoAmplifier(LADSPA_Handle Instance,
+			    unsigned long SampleCount) {
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, 1);
+
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {
+		g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer2, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else if (g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount)
+		 && g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer2, SampleCount)) {
+		if (psAmplifier->m_pfOutputBuffer1 != psAmplifier->m_pfInputBuffer1)
+			g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer1, SampleCount);
+		if (psAmplifier->m_pfOutputBuffer2 != psAmplifier->m_pfInputBuffer2)
+			g_sCMEKernels.Zero(psAmplifier->m_pfOutputBuffer2, SampleCount);
+		setSilent(psAmplifier, 1);
+	}
+	else {
+		modulateAmplifier(psAmplifier, 1, 1.0f, SampleCount, 0);
+		setSilent(psAmplifier, 0);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
+void 
+runAddingModulatedMonoAmplifier(LADSPA_Handle Instance,
+				unsigned long SampleCount) {
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, 1);
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)
+	    || g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount))
+		setSilent(psAmplifier, 1);
+	else {
+		setSilent(psAmplifier, 0);
+		modulateAmplifier(psAmplifier, 0, psAmplifier->m_fRunAddingGain, SampleCount, 1);
 	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
 }
 
+
+void 
+runAddingModulatedStereoAmplifier(LADSPA_Handle Instance,
+				  unsigned long SampleCount) {
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, 1);
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)
+	    || (g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer1, SampleCount)
+		&& g_sCMEKernels.IsSilent(psAmplifier->m_pfInputBuffer2, SampleCount)))
+		setSilent(psAmplifier, 1);
+	else {
+		setSilent(psAmplifier, 0);
+		modulateAmplifier(psAmplifier, 1, psAmplifier->m_fRunAddingGain, SampleCount, 1);
+	}
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
 /*****************************************************************************/
 
-void
-deleteDescriptor(LADSPA_Descriptor * psDescriptor) {
-  unsigned long lIndex;
-	if (psDescriptor) {
-		free((char *)psDescriptor->Label);
-		free((char *)psDescriptor->Name);
-		free((char *)psDescriptor->Maker);
-		free((char *)psDescriptor->Copyright);
-		free((LADSPA_PortDescriptor *)psDescriptor->PortDescriptors);
-		for (lIndex = 0; lIndex < psDescriptor->PortCount; lIndex++)
-			free((char *)(psDescriptor->PortNames[lIndex]));
-		free((char **)psDescriptor->PortNames);
-		free((LADSPA_PortRangeHint *)psDescriptor->PortRangeHints);
-		free(psDescriptor);
+/* Wide-bus versions.  Ports: gain, mute, Channels inputs, Channels outputs, "Silent", "Smoothing". */
+
+LADSPA_Handle 
+instantiateWideAmplifier(const LADSPA_Descriptor * Descriptor,
+			 unsigned long             SampleRate) {
+
+	Amplifier * psAmplifier;
+	unsigned long lChannels = (unsigned long)(uintptr_t)Descriptor->ImplementationData;
+
+	psAmplifier = (Amplifier *)instantiateAmplifier(Descriptor, SampleRate);
+	if (!psAmplifier)
+		return NULL;
+
+	psAmplifier->m_lChannels = lChannels;
+	psAmplifier->m_iCrossWired = -1;
+	psAmplifier->m_ppfInputBuffers = (LADSPA_Data **)calloc(lChannels, sizeof(LADSPA_Data *));
+	psAmplifier->m_ppfOutputBuffers = (LADSPA_Data **)calloc(lChannels, sizeof(LADSPA_Data *));
+	if (!psAmplifier->m_ppfInputBuffers || !psAmplifier->m_ppfOutputBuffers) {
+		free(psAmplifier->m_ppfInputBuffers);
+		free(psAmplifier->m_ppfOutputBuffers);
+		cmePoolRelease(&g_sAmplifierPool, psAmplifier);
+		return NULL;
+	}
+	return psAmplifier;
+}
+
+
+void 
+connectPortToWideAmplifier(LADSPA_Handle Instance,
+			   unsigned long Port,
+			   LADSPA_Data * DataLocation) {
+
+	Amplifier * psAmplifier;
+	unsigned long lChannels;
+
+	psAmplifier = (Amplifier *)Instance;
+	lChannels = psAmplifier->m_lChannels;
+	if (Port == AMP_GAIN)
+		psAmplifier->m_pfControlValue = DataLocation;
+	else if (Port == AMP_MUTE)
+		psAmplifier->m_pfMuteValue = DataLocation;
+	else if (Port < AMP_WIDE_INPUTS + lChannels) {
+		psAmplifier->m_ppfInputBuffers[Port - AMP_WIDE_INPUTS] = DataLocation;
+		psAmplifier->m_iCrossWired = -1;
 	}
+	else if (Port < AMP_WIDE_INPUTS + 2 * lChannels) {
+		psAmplifier->m_ppfOutputBuffers[Port - AMP_WIDE_INPUTS - lChannels] = DataLocation;
+		psAmplifier->m_iCrossWired = -1;
+	}
+	else if (Port == psAmplifier->m_lSilentPort)
+		psAmplifier->m_pfSilentValue = DataLocation;
+	else if (Port == psAmplifier->m_lSilentPort + 1)
+		psAmplifier->m_pfSmoothingValue = DataLocation;
 }
 
+
+/* Whether any channel's output is on another channel's input, so that a channel-by-channel sweep would overwrite input it has yet to read. */
+static int
+isCrossWired(const Amplifier * psAmplifier) {
+
+	unsigned long lOutput, lInput;
+
+	for (lOutput = 0; lOutput < psAmplifier->m_lChannels; lOutput++)
+		for (lInput = 0; lInput < psAmplifier->m_lChannels; lInput++)
+			if (lInput != lOutput && psAmplifier->m_ppfOutputBuffers[lOutput] == psAmplifier->m_ppfInputBuffers[lInput])
+				return 1;
+	return 0;
+}
+
+
+/* Scale (or scale and add) samples Offset .. Offset + Length - 1 of one channel (Input and Output point at sample Offset) by Gain times the smoothed factor.  The ramp, if any, goes AMP_WIDE_CHUNK samples at a time, each piece starting from its own sample number, so it comes out the same whether or not the bus is cross-wired. */
+static void
+scaleWideChannel(const Amplifier * psAmplifier,
+		 const LADSPA_Data * Input,
+		 LADSPA_Data * Output,
+		 unsigned long Offset,
+		 unsigned long Length,
+		 unsigned long RampLength,
+		 LADSPA_Data Gain,
+		 int Adding) {
+
+	const CMESmoother * psSmoother = &psAmplifier->m_sSmoother;
+	LADSPA_Data fStart, fStep = psSmoother->Step[0] * Gain;
+	unsigned long lLength;
+
+	while (Length && Offset < RampLength) {
+		lLength = (Offset / AMP_WIDE_CHUNK + 1) * AMP_WIDE_CHUNK - Offset;
+		if (lLength > Length)
+			lLength = Length;
+		if (lLength > RampLength - Offset)
+			lLength = RampLength - Offset;
+		fStart = cmeSmootherStart(psSmoother, 0) * Gain + (LADSPA_Data)Offset * fStep;
+		if (Adding)
+			g_sCMEKernels.ScaleRampAdd(Input, Output, fStart, fStep, lLength);
+		else
+			g_sCMEKernels.ScaleRamp(Input, Output, fStart, fStep, lLength);
+		Input += lLength;
+		Output += lLength;
+		Offset += lLength;
+		Length -= lLength;
+	}
+	if (!Length)
+		return;
+	if (Adding)
+		g_sCMEKernels.ScaleAdd(Input, Output, psSmoother->Target[0] * Gain, Length);
+	else if (Gain == 1)
+		psSmoother->Settled(psSmoother, Input, NULL, Output, NULL, Length);
+	else
+		g_sCMEKernels.Scale(Input, Output, psSmoother->Target[0] * Gain, Length);
+}
+
+
+/* Scale (or scale and add) every channel, Silent[channel] or not.  If the bus is cross-wired, this goes AMP_WIDE_CHUNK samples at a time, copying that much of every input before writing any output. */
+static void
+sweepWideAmplifier(Amplifier * psAmplifier,
+		   const char * Silent,
+		   LADSPA_Data Gain,
+		   unsigned long SampleCount,
+		   int Adding) {
+
+	LADSPA_Data ** ppfInputs = psAmplifier->m_ppfInputBuffers;
+	LADSPA_Data ** ppfOutputs = psAmplifier->m_ppfOutputBuffers;
+	LADSPA_Data afChunk[AMP_WIDE_MAX_CHANNELS][AMP_WIDE_CHUNK];
+	unsigned long lRamp = cmeSmootherRampLength(&psAmplifier->m_sSmoother, SampleCount);
+	unsigned long lChannel, lDone, lLength;
+
+	if (psAmplifier->m_iCrossWired < 0)
+		psAmplifier->m_iCrossWired = isCrossWired(psAmplifier);
+
+	if (!psAmplifier->m_iCrossWired) {
+		// One sweep across the bus, with the same factor for every channel, and silent channels just zero-filled (or left alone in place):
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++) {
+			if (Silent[lChannel]) {
+				if (!Adding && ppfOutputs[lChannel] != ppfInputs[lChannel])
+					g_sCMEKernels.Zero(ppfOutputs[lChannel], SampleCount);
+			}
+			else
+				scaleWideChannel(psAmplifier, ppfInputs[lChannel], ppfOutputs[lChannel], 0, SampleCount, lRamp, Gain, Adding);
+		}
+		return;
+	}
+
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = SampleCount - lDone < AMP_WIDE_CHUNK ? SampleCount - lDone : AMP_WIDE_CHUNK;
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++)
+			if (!Silent[lChannel])
+				memcpy(afChunk[lChannel], ppfInputs[lChannel] + lDone, lLength * sizeof(LADSPA_Data));
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++) {
+			if (Silent[lChannel]) {
+				if (!Adding && ppfOutputs[lChannel] != ppfInputs[lChannel])
+					g_sCMEKernels.Zero(ppfOutputs[lChannel] + lDone, lLength);
+			}
+			else
+				scaleWideChannel(psAmplifier, afChunk[lChannel], ppfOutputs[lChannel] + lDone, lDone, lLength, lRamp, Gain, Adding);
+		}
+	}
+}
+
+
+void 
+runWideAmplifier(LADSPA_Handle Instance,
+		 unsigned long SampleCount) {
+
+	char acSilent[AMP_WIDE_MAX_CHANNELS] = { 0 };	// (all set before use, but GCC can't see that)
+	unsigned long lChannel;
+	int iSilent = 1;
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));
+
+	if (cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++)
+			g_sCMEKernels.Zero(psAmplifier->m_ppfOutputBuffers[lChannel], SampleCount);
+	}
+	else {
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++) {
+			acSilent[lChannel] = g_sCMEKernels.IsSilent(psAmplifier->m_ppfInputBuffers[lChannel], SampleCount);
+			iSilent &= acSilent[lChannel];
+		}
+		sweepWideAmplifier(psAmplifier, acSilent, 1.0f, SampleCount, 0);
+	}
+	setSilent(psAmplifier, iSilent);
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
+void 
+runAddingWideAmplifier(LADSPA_Handle Instance,
+		       unsigned long SampleCount) {
+
+	char acSilent[AMP_WIDE_MAX_CHANNELS];
+	unsigned long lChannel;
+	int iSilent = 1;
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+
+	setGainTarget(psAmplifier, getGainFactor(psAmplifier));
+	if (!cmeSmootherIsOff(&psAmplifier->m_sSmoother)) {
+		for (lChannel = 0; lChannel < psAmplifier->m_lChannels; lChannel++) {
+			acSilent[lChannel] = g_sCMEKernels.IsSilent(psAmplifier->m_ppfInputBuffers[lChannel], SampleCount);
+			iSilent &= acSilent[lChannel];
+		}
+		if (!iSilent)
+			sweepWideAmplifier(psAmplifier, acSilent, psAmplifier->m_fRunAddingGain, SampleCount, 1);
+	}
+	setSilent(psAmplifier, iSilent);
+	cmeSmootherAdvance(&psAmplifier->m_sSmoother, SampleCount);
+}
+
+
+void 
+cleanupWideAmplifier(LADSPA_Handle Instance) {
+
+	Amplifier * psAmplifier;
+
+	psAmplifier = (Amplifier *)Instance;
+	free(psAmplifier->m_ppfInputBuffers);
+	free(psAmplifier->m_ppfOutputBuffers);
+	cmePoolRelease(&g_sAmplifierPool, psAmplifier);
+}
+
+/*****************************************************************************/
+
+
+/* Throw away a simple delay line. */
+void 
+cleanupAmplifier(LADSPA_Handle Instance) {
+	cmePoolRelease(&g_sAmplifierPool, Instance);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiMonoAmplifierPortDescriptors[CMEAMP_MONO_PORT_COUNT] = {
+	[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_MONO_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[AMP_MONO_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const LADSPA_PortDescriptor g_aiStereoAmplifierPortDescriptors[CMEAMP_STEREO_PORT_COUNT] = {
+	[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_STEREO_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[AMP_STEREO_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcMonoAmplifierPortNames[CMEAMP_MONO_PORT_COUNT] = {
+	[AMP_GAIN] = "Gain",
+	[AMP_MUTE] = "Mute",
+	[AMP_INPUT1] = "Input",
+	[AMP_OUTPUT1] = "Output",
+	[AMP_MONO_SILENT] = "Silent",
+	[AMP_MONO_SMOOTHING] = "Smoothing (ms)"
+};
+
+static const char * const g_apcStereoAmplifierPortNames[CMEAMP_STEREO_PORT_COUNT] = {
+	[AMP_GAIN] = "Gain",
+	[AMP_MUTE] = "Mute",
+	[AMP_INPUT1] = "Input (Left)",
+	[AMP_OUTPUT1] = "Output (Left)",
+	[AMP_INPUT2] = "Input (Right)",
+	[AMP_OUTPUT2] = "Output (Right)",
+	[AMP_STEREO_SILENT] = "Silent",
+	[AMP_STEREO_SMOOTHING] = "Smoothing (ms)"
+};
+
+#define AMP_GAIN_HINT { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 120 }
+#define AMP_GAIN_SIGNAL_HINT { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE, -120, 120 }	// (the same range, for an audio-rate gain)
+#define AMP_TOGGLE_HINT { LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 }
+
+static const LADSPA_PortRangeHint g_asMonoAmplifierPortRangeHints[CMEAMP_MONO_PORT_COUNT] = {
+	[AMP_GAIN] = AMP_GAIN_HINT,
+	[AMP_MUTE] = AMP_TOGGLE_HINT,
+	[AMP_MONO_SILENT] = AMP_TOGGLE_HINT,
+	[AMP_MONO_SMOOTHING] = CME_SMOOTH_HINT
+};
+
+static const LADSPA_PortRangeHint g_asStereoAmplifierPortRangeHints[CMEAMP_STEREO_PORT_COUNT] = {
+	[AMP_GAIN] = AMP_GAIN_HINT,
+	[AMP_MUTE] = AMP_TOGGLE_HINT,
+	[AMP_STEREO_SILENT] = AMP_TOGGLE_HINT,
+	[AMP_STEREO_SMOOTHING] = CME_SMOOTH_HINT
+};
+
+
+const LADSPA_Descriptor g_sMonoAmplifierDescriptor = {
+	.UniqueID = CMEAMP_MONO_LADSPA_ID,
+	.Label = "gain_mono",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Gain (dB), Mono, with mute (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEAMP_MONO_PORT_COUNT,
+	.PortDescriptors = g_aiMonoAmplifierPortDescriptors,
+	.PortNames = g_apcMonoAmplifierPortNames,
+	.PortRangeHints = g_asMonoAmplifierPortRangeHints,
+	.instantiate = instantiateAmplifier,
+	.connect_port = connectPortToAmplifier,
+	.run = runMonoAmplifier,
+	.run_adding = runAddingMonoAmplifier,
+	.set_run_adding_gain = setAmplifierRunAddingGain,
+	.cleanup = cleanupAmplifier
+};
+
+const LADSPA_Descriptor g_sStereoAmplifierDescriptor = {
+	.UniqueID = CMEAMP_STEREO_LADSPA_ID,
+	.Label = "gain_stereo",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Gain (dB), Stereo, with mute (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEAMP_STEREO_PORT_COUNT,
+	.PortDescriptors = g_aiStereoAmplifierPortDescriptors,
+	.PortNames = g_apcStereoAmplifierPortNames,
+	.PortRangeHints = g_asStereoAmplifierPortRangeHints,
+	.instantiate = instantiateAmplifier,
+	.connect_port = connectPortToAmplifier,
+	.run = runStereoAmplifier,
+	.run_adding = runAddingStereoAmplifier,
+	.set_run_adding_gain = setAmplifierRunAddingGain,
+	.cleanup = cleanupAmplifier
+};
+
+
+/* Audio-rate gain versions: the same ports, but with the gain as an audio input. */
+
+static const LADSPA_PortDescriptor g_aiModulatedMonoAmplifierPortDescriptors[CMEAMP_MONO_PORT_COUNT] = {
+	[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_MONO_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[AMP_MONO_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const LADSPA_PortDescriptor g_aiModulatedStereoAmplifierPortDescriptors[CMEAMP_STEREO_PORT_COUNT] = {
+	[AMP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[AMP_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[AMP_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[AMP_STEREO_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[AMP_STEREO_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const LADSPA_PortRangeHint g_asModulatedMonoAmplifierPortRangeHints[CMEAMP_MONO_PORT_COUNT] = {
+	[AMP_GAIN] = AMP_GAIN_SIGNAL_HINT,
+	[AMP_MUTE] = AMP_TOGGLE_HINT,
+	[AMP_MONO_SILENT] = AMP_TOGGLE_HINT,
+	[AMP_MONO_SMOOTHING] = CME_SMOOTH_HINT
+};
+
+static const LADSPA_PortRangeHint g_asModulatedStereoAmplifierPortRangeHints[CMEAMP_STEREO_PORT_COUNT] = {
+	[AMP_GAIN] = AMP_GAIN_SIGNAL_HINT,
+	[AMP_MUTE] = AMP_TOGGLE_HINT,
+	[AMP_STEREO_SILENT] = AMP_TOGGLE_HINT,
+	[AMP_STEREO_SMOOTHING] = CME_SMOOTH_HINT
+};
+
+
+const LADSPA_Descriptor g_sModulatedMonoAmplifierDescriptor = {
+	.UniqueID = CMEAMP_MONO_MOD_LADSPA_ID,
+	.Label = "gain_mono_mod",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Gain (dB, audio-rate), Mono, with mute (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEAMP_MONO_PORT_COUNT,
+	.PortDescriptors = g_aiModulatedMonoAmplifierPortDescriptors,
+	.PortNames = g_apcMonoAmplifierPortNames,
+	.PortRangeHints = g_asModulatedMonoAmplifierPortRangeHints,
+	.instantiate = instantiateAmplifier,
+	.connect_port = connectPortToAmplifier,
+	.run = runModulatedMonoAmplifier,
+	.run_adding = runAddingModulatedMonoAmplifier,
+	.set_run_adding_gain = setAmplifierRunAddingGain,
+	.cleanup = cleanupAmplifier
+};
+
+const LADSPA_Descriptor g_sModulatedStereoAmplifierDescriptor = {
+	.UniqueID = CMEAMP_STEREO_MOD_LADSPA_ID,
+	.Label = "gain_stereo_mod",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Gain (dB, audio-rate), Stereo, with mute (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEAMP_STEREO_PORT_COUNT,
+	.PortDescriptors = g_aiModulatedStereoAmplifierPortDescriptors,
+	.PortNames = g_apcStereoAmplifierPortNames,
+	.PortRangeHints = g_asModulatedStereoAmplifierPortRangeHints,
+	.instantiate = instantiateAmplifier,
+	.connect_port = connectPortToAmplifier,
+	.run = runModulatedStereoAmplifier,
+	.run_adding = runAddingModulatedStereoAmplifier,
+	.set_run_adding_gain = setAmplifierRunAddingGain,
+	.cleanup = cleanupAmplifier
+};
+
+
+/* The wide-bus port tables are spelt out by the preprocessor, with CME_CHANNELS_n() (see cmeplugins.h): */
+#define AMP_WIDE_AUDIO_PORT(n)	LADSPA_PORT_AUDIO,
+#define AMP_WIDE_INPUT_NAME(n)	"Input " #n,
+#define AMP_WIDE_OUTPUT_NAME(n)	"Output " #n,
+#define AMP_WIDE_AUDIO_HINT(n)	{ 0, 0, 0 },
+
+#define AMP_WIDE_PORT_TABLES(C) \
+	static const LADSPA_PortDescriptor g_aiWideAmplifier##C##PortDescriptors[] = { \
+		LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL, \
+		LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL, \
+		CME_CHANNELS_##C(LADSPA_PORT_INPUT | AMP_WIDE_AUDIO_PORT) \
+		CME_CHANNELS_##C(LADSPA_PORT_OUTPUT | AMP_WIDE_AUDIO_PORT) \
+		LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL, \
+		LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL \
+	}; \
+	static const char * const g_apcWideAmplifier##C##PortNames[] = { \
+		"Gain", \
+		"Mute", \
+		CME_CHANNELS_##C(AMP_WIDE_INPUT_NAME) \
+		CME_CHANNELS_##C(AMP_WIDE_OUTPUT_NAME) \
+		"Silent", \
+		"Smoothing (ms)" \
+	}; \
+	static const LADSPA_PortRangeHint g_asWideAmplifier##C##PortRangeHints[] = { \
+		AMP_GAIN_HINT, \
+		AMP_TOGGLE_HINT, \
+		CME_CHANNELS_##C(AMP_WIDE_AUDIO_HINT) \
+		CME_CHANNELS_##C(AMP_WIDE_AUDIO_HINT) \
+		AMP_TOGGLE_HINT, \
+		CME_SMOOTH_HINT \
+	};
+
+AMP_WIDE_PORT_TABLES(4)
+AMP_WIDE_PORT_TABLES(6)
+AMP_WIDE_PORT_TABLES(8)
+AMP_WIDE_PORT_TABLES(16)
+AMP_WIDE_PORT_TABLES(32)
+AMP_WIDE_PORT_TABLES(64)
+
+#define AMP_WIDE_DESCRIPTOR(Variant, C) { \
+	.UniqueID = CMEAMP_WIDE_LADSPA_ID + Variant, \
+	.Label = "gain_" #C, \
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE, \
+	.Name = "Gain (dB), " #C " channels, with mute (CME)", \
+	.Maker = "Chris Edwards", \
+	.Copyright = "None", \
+	.PortCount = AMP_WIDE_PORT_COUNT(C), \
+	.PortDescriptors = g_aiWideAmplifier##C##PortDescriptors, \
+	.PortNames = g_apcWideAmplifier##C##PortNames, \
+	.PortRangeHints = g_asWideAmplifier##C##PortRangeHints, \
+	.ImplementationData = (void *)(uintptr_t)C, \
+	.instantiate = instantiateWideAmplifier, \
+	.connect_port = connectPortToWideAmplifier, \
+	.run = runWideAmplifier, \
+	.run_adding = runAddingWideAmplifier, \
+	.set_run_adding_gain = setAmplifierRunAddingGain, \
+	.cleanup = cleanupWideAmplifier \
+}
+
+const LADSPA_Descriptor g_asWideAmplifierDescriptors[CME_WIDE_AMPLIFIER_VARIANTS] = {
+	AMP_WIDE_DESCRIPTOR(0, 4),
+	AMP_WIDE_DESCRIPTOR(1, 6),
+	AMP_WIDE_DESCRIPTOR(2, 8),
+	AMP_WIDE_DESCRIPTOR(3, 16),
+	AMP_WIDE_DESCRIPTOR(4, 32),
+	AMP_WIDE_DESCRIPTOR(5, 64)
+};
+_Static_assert(AMP_WIDE_MAX_CHANNELS == 64, "the widest bus");
+
+/* Every port table must match its descriptor's PortCount: */
+_Static_assert(sizeof(g_aiWideAmplifier64PortDescriptors) / sizeof(g_aiWideAmplifier64PortDescriptors[0]) == AMP_WIDE_PORT_COUNT(64), "wide gain port table");
+_Static_assert(sizeof(g_apcWideAmplifier64PortNames) / sizeof(g_apcWideAmplifier64PortNames[0]) == AMP_WIDE_PORT_COUNT(64), "wide gain port names");
+_Static_assert(sizeof(g_asWideAmplifier64PortRangeHints) / sizeof(g_asWideAmplifier64PortRangeHints[0]) == AMP_WIDE_PORT_COUNT(64), "wide gain range hints");
+_Static_assert(sizeof(g_aiWideAmplifier6PortDescriptors) / sizeof(g_aiWideAmplifier6PortDescriptors[0]) == AMP_WIDE_PORT_COUNT(6), "wide gain port table");
+
+
+
+#ifndef CME_BUNDLE
+
 /*****************************************************************************/
 
-/* _fini() is called automatically when the library is unloaded. */
-void
-_fini() {
-	deleteDescriptor(g_psMonoDescriptor);
-	deleteDescriptor(g_psStereoDescriptor);
+/* _init() is called automatically when the plugin library is first
+   loaded. */
+void 
+_init() {
+	cmeKernelsInit();
 }
 
 /*****************************************************************************/
 
-/* Return a descriptor of the requested plugin type. There are two
-   plugin types available in this library (mono and stereo). */
+/* Return a descriptor of the requested plugin type: mono, stereo, the wide-bus versions (narrowest first), then the audio-rate gain versions. */
 const LADSPA_Descriptor * 
 ladspa_descriptor(unsigned long Index) {
 	/* Return the requested descriptor or null if the index is out of range. */
 	switch (Index) {
 	case 0:
-		return g_psMonoDescriptor;
+		return &g_sMonoAmplifierDescriptor;
 	case 1:
-		return g_psStereoDescriptor;
+		return &g_sStereoAmplifierDescriptor;
 	default:
+		if (Index - 2 < CME_WIDE_AMPLIFIER_VARIANTS)
+			return &g_asWideAmplifierDescriptors[Index - 2];
+		if (Index == 2 + CME_WIDE_AMPLIFIER_VARIANTS)
+			return &g_sModulatedMonoAmplifierDescriptor;
+		if (Index == 3 + CME_WIDE_AMPLIFIER_VARIANTS)
+			return &g_sModulatedStereoAmplifierDescriptor;
 		return NULL;
 	}
 }
 
+#endif /* CME_BUNDLE */
+
 /*****************************************************************************/
 
 /* EOF */
@@ -1,21 +1,35 @@
 /*
 LADSPA plugin implementing a simple balance control (stereo input, stereo output).
 CME 2007-10-05
+
+Balance changes are smoothed (see cmesmooth.h): both gains ramp linearly to a new setting over the time set by the "Smoothing" control (10 ms by default), so moving the balance between blocks doesn't click.  Once the ramp has finished, run() uses the routine the smoother picked for the setting (see cmesmooth.h): at centre under the default law both gains are 1, so that is a copy, or nothing at all in place; elsewhere, the plain DualScale again.
+
+When both inputs are silent they aren't multiplied: the outputs are zero-filled (apart from any that are input buffers, which already hold the zeros), and the "Silent" output goes to 1.
+CME 2026-10
+
+The "Law" control selects the balance law, from the same tables as the pan plugin (see cmepanlaw.h); 0 is the original one.  cme_balance_mod (ID 69) takes the balance as an audio-rate input, like cme_pan_mod: the PanLawGains kernel works out both gains for CME_GAIN_CHUNK samples at a time and DualMultiply applies them, so a constant balance signal gives exactly what the control-rate balance (ID 52) gives for the same control value.
+CME 2026-10
 */
 
 
 #include <stdlib.h>
-#define _GNU_SOURCE
 #include <string.h>
 #include <math.h>
 
 #include "ladspa.h"
+#include "cmekernels.h"
+#include "cmesmooth.h"
+#include "cmepanlaw.h"
+#include "cmepool.h"
+#include "cmeplugins.h"
 
 
 
 #define CMEBALANCE_LADSPA_ID	52
+#define CMEBALANCE_MOD_LADSPA_ID	69
 
-#define CMEBALANCE_PORT_COUNT 5
+#define CMEBALANCE_PORT_COUNT 8
+#define CMEBALANCE_MOD_PORT_COUNT 7	// (no BALANCE_SMOOTHING, so the law is port 6)
 
 /* The internal ID numbers for the plugin's ports: */
 
@@ -25,29 +39,59 @@ CME 2007-10-05
 #define BALANCE_INPUT_R	2
 #define BALANCE_OUTPUT_L	3
 #define BALANCE_OUTPUT_R	4
+#define BALANCE_SILENT	5
+#define BALANCE_SMOOTHING	6
+#define BALANCE_LAW	7
+
+#define BALANCE_MOD_LAW	6
 
 
 
 
 
 /* The structure used to hold port connection information and state
-   (actually gain controls require no further state). */
+   (the gain factors for the last setting, and the ramp to them). */
 
 
 typedef struct {
-	LADSPA_Data * ControlValue;
+	LADSPA_Data * ControlValue;	// (An audio buffer, for cme_balance_mod)
 	LADSPA_Data * LInputBuffer;
 	LADSPA_Data * RInputBuffer;
 	LADSPA_Data * LOutputBuffer;
 	LADSPA_Data * ROutputBuffer;
+	LADSPA_Data * SilentValue;	// (NULL if the host hasn't connected it)
+	LADSPA_Data * SmoothingValue;
+	LADSPA_Data * LawValue;
+	LADSPA_Data LastControlValue;	// Setting and law the gain factors below were computed for
+	int LastLaw;
+	LADSPA_Data LGainFactor;
+	LADSPA_Data RGainFactor;
+	LADSPA_Data RunAddingGain;
+	CMESmoother Smoother;
 } Balance;
 
+/* Both versions' instances come from here (see cmepool.h): */
+static CMEInstancePool g_sBalancePool = CME_INSTANCE_POOL(Balance);
+
 
 /* Construct a new plugin instance. */
 LADSPA_Handle 
 instantiateBalance(const LADSPA_Descriptor * Descriptor,
 		     unsigned long             SampleRate) {
-	return malloc(sizeof(Balance));
+
+	Balance * psBalance;
+
+	psBalance = (Balance *)cmePoolAllocate(&g_sBalancePool);
+	if (psBalance) {
+		psBalance->SilentValue = NULL;
+		psBalance->LastControlValue = NAN;	// (never equal to anything, so the first run() computes the factors)
+		psBalance->LastLaw = 0;
+		psBalance->LGainFactor = 1.0;
+		psBalance->RGainFactor = 1.0;
+		psBalance->RunAddingGain = 1.0;
+		cmeSmootherInit(&psBalance->Smoother, SampleRate);
+	}
+	return psBalance;
 }
 
 
@@ -69,16 +113,78 @@ connectPortToBalance(LADSPA_Handle Instance,
 			break;
 		case BALANCE_INPUT_R:
 			psBalance->RInputBuffer = DataLocation;
+			break;
 		case BALANCE_OUTPUT_L:
 			psBalance->LOutputBuffer = DataLocation;
 			break;
 		case BALANCE_OUTPUT_R:
 			psBalance->ROutputBuffer = DataLocation;
 			break;
+		case BALANCE_SILENT:
+			psBalance->SilentValue = DataLocation;
+			break;
+		case BALANCE_SMOOTHING:
+			psBalance->SmoothingValue = DataLocation;
+			break;
+		case BALANCE_LAW:
+			psBalance->LawValue = DataLocation;
+			break;
 	}
 }
 
 
+/* The same for cme_balance_mod, whose law is port BALANCE_MOD_LAW. */
+void 
+connectPortToModulatedBalance(LADSPA_Handle Instance,
+			      unsigned long Port,
+			      LADSPA_Data * DataLocation) {
+	if (Port == BALANCE_MOD_LAW)
+		((Balance *)Instance)->LawValue = DataLocation;
+	else
+		connectPortToBalance(Instance, Port, DataLocation);
+}
+
+
+
+/* Update the cached L and R gain factors if the control or the law has changed since the last run(), and ramp to them. */
+static void
+updateBalanceGains(Balance * psBalance) {
+
+	LADSPA_Data BalanceValue;
+	int iLaw;
+
+	BalanceValue = *(psBalance->ControlValue);
+	iLaw = cmePanLawSelect(*(psBalance->LawValue));
+	if (BalanceValue != psBalance->LastControlValue || iLaw != psBalance->LastLaw) {
+		psBalance->LastControlValue = BalanceValue;
+		psBalance->LastLaw = iLaw;
+
+		// Logarithmic gain functions, intersecting at (0, -3 dB):
+		//LGainFactor = pow(10.0, 3 * (log2(1 - BalanceValue) - 1) / 20.0);
+		//RGainFactor = pow(10.0, 3 * (log2(1 + BalanceValue) - 1) / 20.0);
+		// On second thought, let's leave the y-intercept at 0 dB, so you don't get a reduction in volume when you engage the effect.  This means +3 dB boost at extreme settings, however, with risk of clipping.
+		// (That is law 0, CME_PAN_LAW_CME; the -3 dB one above is CME_PAN_LAW_3DB, near enough.  See cmepanlaw.h.)
+		cmePanLawGains(iLaw, BalanceValue, 1.0f, &psBalance->LGainFactor, &psBalance->RGainFactor);
+	}
+	cmeSmootherSetTarget(&psBalance->Smoother, psBalance->LGainFactor, psBalance->RGainFactor, *(psBalance->SmoothingValue));
+}
+
+
+/* 1 if both inputs are silent this block, and say so on the "Silent" output if the host wants to know. */
+static int
+checkBalanceSilent(Balance * psBalance,
+		   unsigned long SampleCount) {
+
+	int iSilent;
+
+	iSilent = g_sCMEKernels.IsSilent(psBalance->LInputBuffer, SampleCount)
+		&& g_sCMEKernels.IsSilent(psBalance->RInputBuffer, SampleCount);
+	if (psBalance->SilentValue)
+		*(psBalance->SilentValue) = iSilent ? 1 : 0;
+	return iSilent;
+}
+
+
 
 void 
 runBalance(LADSPA_Handle Instance,
@@ -88,12 +194,8 @@ runBalance(LADSPA_Handle Instance,
 	LADSPA_Data * RInput;
 	LADSPA_Data * LOutput;
 	LADSPA_Data * ROutput;
-	LADSPA_Data BalanceValue;
-	LADSPA_Data LGainFactor;
-	LADSPA_Data RGainFactor;
 
 	Balance * psBalance;
-	unsigned long SampleIndex;
 
 	psBalance = (Balance *)Instance;
 
@@ -101,21 +203,19 @@ runBalance(LADSPA_Handle Instance,
 	RInput = psBalance->RInputBuffer;
 	LOutput = psBalance->LOutputBuffer;
 	ROutput = psBalance->ROutputBuffer;
-	BalanceValue = *(psBalance->ControlValue);
 
-	// Logarithmic gain functions, intersecting at (0, -3 dB):
-	//LGainFactor = pow(10.0, 3 * (log2(1 - BalanceValue) - 1) / 20.0);
-	//RGainFactor = pow(10.0, 3 * (log2(1 + BalanceValue) - 1) / 20.0);
-	// On second thought, let's leave the y-intercept at 0 dB, so you don't get a reduction in volume when you engage the effect.  This means +3 dB boost at extreme settings, however, with risk of clipping.
-	LGainFactor = pow(10.0, 3 * log2(1 - BalanceValue) / 20.0);
-	RGainFactor = pow(10.0, 3 * log2(1 + BalanceValue) / 20.0);
-
-	// Process the sample buffer:
-	for (SampleIndex = 0; SampleIndex < SampleCount; SampleIndex++)
-	{
-			*(LOutput++) = *(LInput++) * LGainFactor;
-			*(ROutput++) = *(RInput++) * RGainFactor;
+	updateBalanceGains(psBalance);
+
+	// Silence in, silence out:
+	if (checkBalanceSilent(psBalance, SampleCount)) {
+		if (LOutput != LInput && LOutput != RInput)
+			g_sCMEKernels.Zero(LOutput, SampleCount);
+		if (ROutput != LInput && ROutput != RInput)
+			g_sCMEKernels.Zero(ROutput, SampleCount);
 	}
+	else	// Process the sample buffer:
+		cmeSmoothedDualScale(&psBalance->Smoother, LInput, RInput, LOutput, ROutput, 1.0f, SampleCount, 0);
+	cmeSmootherAdvance(&psBalance->Smoother, SampleCount);
 }
 
 
@@ -123,117 +223,239 @@ runBalance(LADSPA_Handle Instance,
 
 
 
-/* Throw away a simple delay line. */
+/* run_adding() version: accumulates into the outputs, with the host's run-adding gain folded into both gain factors (and ramps).  Silent input adds nothing. */
+
 void 
-cleanupBalance(LADSPA_Handle Instance) {
-	free(Instance);
+setBalanceRunAddingGain(LADSPA_Handle Instance,
+			LADSPA_Data Gain) {
+	((Balance *)Instance)->RunAddingGain = Gain;
 }
 
 
+void 
+runAddingBalance(LADSPA_Handle Instance,
+		 unsigned long SampleCount) {
 
-LADSPA_Descriptor * g_psBalanceDescriptor = NULL;
+	Balance * psBalance;
 
+	psBalance = (Balance *)Instance;
 
+	updateBalanceGains(psBalance);
+	if (!checkBalanceSilent(psBalance, SampleCount))
+		cmeSmoothedDualScale(&psBalance->Smoother, psBalance->LInputBuffer, psBalance->RInputBuffer,
+				     psBalance->LOutputBuffer, psBalance->ROutputBuffer,
+				     psBalance->RunAddingGain, SampleCount, 1);
+	cmeSmootherAdvance(&psBalance->Smoother, SampleCount);
+}
 
 
-void 
-_init() {
 
-	char ** pcPortNames;
-	LADSPA_PortDescriptor * piPortDescriptors;
-	LADSPA_PortRangeHint * psPortRangeHints;
 
-	g_psBalanceDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
 
-  
-		g_psBalanceDescriptor->UniqueID = CMEBALANCE_LADSPA_ID;
-		g_psBalanceDescriptor->Label = strdup("cme_pan");
-		g_psBalanceDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-		g_psBalanceDescriptor->Name = strdup("Balance (CME)");
-		g_psBalanceDescriptor->Maker = strdup("Chris Edwards");
-		g_psBalanceDescriptor->Copyright = strdup("None");
-
-		g_psBalanceDescriptor->PortCount = CMEBALANCE_PORT_COUNT;
-		piPortDescriptors = (LADSPA_PortDescriptor *)calloc(CMEBALANCE_PORT_COUNT, sizeof(LADSPA_PortDescriptor));
-		g_psBalanceDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)piPortDescriptors;
-		piPortDescriptors[BALANCE_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[BALANCE_INPUT_L] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[BALANCE_INPUT_R] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[BALANCE_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[BALANCE_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		
-		pcPortNames = (char **)calloc(CMEBALANCE_PORT_COUNT, sizeof(char *));
-		g_psBalanceDescriptor->PortNames = (const char **)pcPortNames;
-		pcPortNames[BALANCE_CONTROL] = strdup("Balance");
-		pcPortNames[BALANCE_INPUT_L] = strdup("Input (L)");
-		pcPortNames[BALANCE_INPUT_L] = strdup("Input (R)");
-		pcPortNames[BALANCE_OUTPUT_L] = strdup("Output (L)");
-		pcPortNames[BALANCE_OUTPUT_R] = strdup("Output (R)");
-		psPortRangeHints = ((LADSPA_PortRangeHint *) calloc(CMEBALANCE_PORT_COUNT, sizeof(LADSPA_PortRangeHint)));
-		g_psBalanceDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)psPortRangeHints;
-
-		psPortRangeHints[BALANCE_CONTROL].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[BALANCE_CONTROL].LowerBound = -1;
-		psPortRangeHints[BALANCE_CONTROL].UpperBound = 1;
-
-		psPortRangeHints[BALANCE_INPUT_L].HintDescriptor = 0;
-		psPortRangeHints[BALANCE_INPUT_R].HintDescriptor = 0;
-
-		psPortRangeHints[BALANCE_OUTPUT_L].HintDescriptor = 0;
-		psPortRangeHints[BALANCE_OUTPUT_R].HintDescriptor = 0;
-
-		g_psBalanceDescriptor->instantiate = instantiateBalance;
-		g_psBalanceDescriptor->connect_port = connectPortToBalance;
-		g_psBalanceDescriptor->activate = NULL;
-		g_psBalanceDescriptor->run = runBalance;
-		g_psBalanceDescriptor->run_adding = NULL;
-		g_psBalanceDescriptor->set_run_adding_gain = NULL;
-		g_psBalanceDescriptor->deactivate = NULL;
-		g_psBalanceDescriptor->cleanup = cleanupBalance;
 
+/* Audio-rate version: the same ports, but BALANCE_CONTROL is an audio input (and there's no BALANCE_SMOOTHING). */
+
+/* Balance a chunk at a time, each chunk's gains worked out before any of its output is written (so it's safe in place, even on the balance signal's buffer). */
+static void
+modulateBalance(Balance * psBalance,
+		LADSPA_Data Gain,
+		unsigned long SampleCount,
+		int Adding) {
 
+	LADSPA_Data afLGains[CME_GAIN_CHUNK];
+	LADSPA_Data afRGains[CME_GAIN_CHUNK];
+	const CMEPanLawTable * psLaw = &g_asCMEPanLaws[cmePanLawSelect(*(psBalance->LawValue))];
+	unsigned long lDone, lLength;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = SampleCount - lDone < CME_GAIN_CHUNK ? SampleCount - lDone : CME_GAIN_CHUNK;
+		g_sCMEKernels.PanLawGains(psBalance->ControlValue + lDone, psLaw->Segments, afLGains, afRGains, Gain, lLength);
+		if (Adding)
+			g_sCMEKernels.DualMultiplyAdd(psBalance->LInputBuffer + lDone, psBalance->RInputBuffer + lDone, afLGains, afRGains,
+						      psBalance->LOutputBuffer + lDone, psBalance->ROutputBuffer + lDone, lLength);
+		else
+			g_sCMEKernels.DualMultiply(psBalance->LInputBuffer + lDone, psBalance->RInputBuffer + lDone, afLGains, afRGains,
+						   psBalance->LOutputBuffer + lDone, psBalance->ROutputBuffer + lDone, lLength);
+	}
 }
 
 
-void
-deleteDescriptor(LADSPA_Descriptor * psDescriptor) {
-  unsigned long lIndex;
-	if (psDescriptor) {
-		free((char *)psDescriptor->Label);
-		free((char *)psDescriptor->Name);
-		free((char *)psDescriptor->Maker);
-		free((char *)psDescriptor->Copyright);
-		free((LADSPA_PortDescriptor *)psDescriptor->PortDescriptors);
-		for (lIndex = 0; lIndex < psDescriptor->PortCount; lIndex++)
-			free((char *)(psDescriptor->PortNames[lIndex]));
-		free((char **)psDescriptor->PortNames);
-		free((LADSPA_PortRangeHint *)psDescriptor->PortRangeHints);
-		free(psDescriptor);
+void 
+runModulatedBalance(LADSPA_Handle Instance,
+		    unsigned long SampleCount) {
+
+	Balance * psBalance;
+
+	psBalance = (Balance *)Instance;
+
+	if (checkBalanceSilent(psBalance, SampleCount)) {
+		if (psBalance->LOutputBuffer != psBalance->LInputBuffer && psBalance->LOutputBuffer != psBalance->RInputBuffer)
+			g_sCMEKernels.Zero(psBalance->LOutputBuffer, SampleCount);
+		if (psBalance->ROutputBuffer != psBalance->LInputBuffer && psBalance->ROutputBuffer != psBalance->RInputBuffer)
+			g_sCMEKernels.Zero(psBalance->ROutputBuffer, SampleCount);
+		return;
 	}
+	modulateBalance(psBalance, 1.0f, SampleCount, 0);
 }
 
 
-void
-_fini() {
-	deleteDescriptor(g_psBalanceDescriptor);
+void 
+runAddingModulatedBalance(LADSPA_Handle Instance,
+			  unsigned long SampleCount) {
+
+	Balance * psBalance;
+
+	psBalance = (Balance *)Instance;
+
+	if (!checkBalanceSilent(psBalance, SampleCount))
+		modulateBalance(psBalance, psBalance->RunAddingGain, SampleCount, 1);
+}
+
+
+
+
+
+
+/* Throw away a simple delay line. */
+void 
+cleanupBalance(LADSPA_Handle Instance) {
+	cmePoolRelease(&g_sBalancePool, Instance);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiBalancePortDescriptors[CMEBALANCE_PORT_COUNT] = {
+	[BALANCE_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[BALANCE_INPUT_L] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_INPUT_R] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[BALANCE_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[BALANCE_LAW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcBalancePortNames[CMEBALANCE_PORT_COUNT] = {
+	[BALANCE_CONTROL] = "Balance",
+	[BALANCE_INPUT_L] = "Input (L)",
+	[BALANCE_INPUT_R] = "Input (R)",
+	[BALANCE_OUTPUT_L] = "Output (L)",
+	[BALANCE_OUTPUT_R] = "Output (R)",
+	[BALANCE_SILENT] = "Silent",
+	[BALANCE_SMOOTHING] = "Smoothing (ms)",
+	[BALANCE_LAW] = "Law"
+};
+
+static const LADSPA_PortRangeHint g_asBalancePortRangeHints[CMEBALANCE_PORT_COUNT] = {
+	[BALANCE_CONTROL] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_0,
+		-1, 1
+	},
+	[BALANCE_SILENT] = { LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 },
+	[BALANCE_SMOOTHING] = CME_SMOOTH_HINT,
+	[BALANCE_LAW] = CME_PAN_LAW_HINT
+};
+
+
+const LADSPA_Descriptor g_sBalanceDescriptor = {
+	.UniqueID = CMEBALANCE_LADSPA_ID,
+#ifdef CME_BUNDLE
+	.Label = "cme_balance",		// (libcme.so also has the pan, so it needs a label of its own there)
+#else
+	.Label = "cme_pan",		// (as it always has been, alone in cmebal.so)
+#endif
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Balance (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEBALANCE_PORT_COUNT,
+	.PortDescriptors = g_aiBalancePortDescriptors,
+	.PortNames = g_apcBalancePortNames,
+	.PortRangeHints = g_asBalancePortRangeHints,
+	.instantiate = instantiateBalance,
+	.connect_port = connectPortToBalance,
+	.run = runBalance,
+	.run_adding = runAddingBalance,
+	.set_run_adding_gain = setBalanceRunAddingGain,
+	.cleanup = cleanupBalance
+};
+
+
+static const LADSPA_PortDescriptor g_aiModulatedBalancePortDescriptors[CMEBALANCE_MOD_PORT_COUNT] = {
+	[BALANCE_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_INPUT_L] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_INPUT_R] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[BALANCE_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[BALANCE_MOD_LAW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcModulatedBalancePortNames[CMEBALANCE_MOD_PORT_COUNT] = {
+	[BALANCE_CONTROL] = "Balance",
+	[BALANCE_INPUT_L] = "Input (L)",
+	[BALANCE_INPUT_R] = "Input (R)",
+	[BALANCE_OUTPUT_L] = "Output (L)",
+	[BALANCE_OUTPUT_R] = "Output (R)",
+	[BALANCE_SILENT] = "Silent",
+	[BALANCE_MOD_LAW] = "Law"
+};
+
+static const LADSPA_PortRangeHint g_asModulatedBalancePortRangeHints[CMEBALANCE_MOD_PORT_COUNT] = {
+	[BALANCE_CONTROL] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE,
+		-1, 1
+	},
+	[BALANCE_SILENT] = { LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 },
+	[BALANCE_MOD_LAW] = CME_PAN_LAW_HINT
+};
+
+
+const LADSPA_Descriptor g_sModulatedBalanceDescriptor = {
+	.UniqueID = CMEBALANCE_MOD_LADSPA_ID,
+	.Label = "cme_balance_mod",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Balance, audio-rate (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEBALANCE_MOD_PORT_COUNT,
+	.PortDescriptors = g_aiModulatedBalancePortDescriptors,
+	.PortNames = g_apcModulatedBalancePortNames,
+	.PortRangeHints = g_asModulatedBalancePortRangeHints,
+	.instantiate = instantiateBalance,
+	.connect_port = connectPortToModulatedBalance,
+	.run = runModulatedBalance,
+	.run_adding = runAddingModulatedBalance,
+	.set_run_adding_gain = setBalanceRunAddingGain,
+	.cleanup = cleanupBalance
+};
+
+
+
+#ifndef CME_BUNDLE
+
+void 
+_init() {
+	cmeKernelsInit();
+	cmePanLawsInit();
 }
 
 
-/* Return a descriptor of the requested plugin type. There are two
-   plugin types available in this library (pan and balance). */
+/* Return a descriptor of the requested plugin type: control-rate or audio-rate balance. */
 const LADSPA_Descriptor * 
 ladspa_descriptor(unsigned long Index) {
 	/* Return the requested descriptor or null if the index is out of range. */
 	switch (Index) {
 	case 0:
-		return g_psBalanceDescriptor;
+		return &g_sBalanceDescriptor;
+	case 1:
+		return &g_sModulatedBalanceDescriptor;
 	default:
 		return NULL;
 	}
 }
 
-
+#endif /* CME_BUNDLE */
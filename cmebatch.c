@@ -0,0 +1,956 @@
+/*
+Offline batch host for the CME LADSPA plugins: runs a chain of plugins over many audio files, on all cores, and reports each file's levels, so an archive of recordings can be normalised and metered without a DAW.
+
+Usage: cmebatch [-j jobs] [-b block] [-o directory] [-F] [-r rate] [-c channels] [-t s16|s24|s32|f32] [-p library.so:plugin[,port=value...]] ... file ...
+
+Each -p adds a plugin to the chain, in order.  The plugin is given by label or unique ID (the balance is "cme_balance" in libcme.so, but "cme_pan" in cmebal.so, where it is alone), and its control inputs by port number or by the start of their name (case ignored), e.g.
+
+	cmebatch -o normalised -p ./cmeamp.so:gain_stereo,gain=-3.5 -p ./libcme.so:cme_balance,balance=0.1 *.wav
+
+Controls not given take their default from the port hints, at the file's sample rate.  The chain adapts to each file's channel count: a stage with I audio inputs runs C / I copies of the plugin side by side (so a mono plugin on a stereo file runs twice, once per channel), and its outputs, O per copy, become the C / I * O channels the next stage sees; a plugin with no audio outputs (the meters) just listens, and the channels go on past it unchanged.  It is an error if I doesn't divide C.  With no -p at all the files are only metered.
+
+Inputs are WAV files (16, 24 or 32-bit integer, or 32-bit float, PCM) or, for anything not starting with a RIFF/WAVE header, headerless interleaved little-endian samples described by -t (default f32), -c (default 1) and -r (default 48000).  Each input is memory-mapped, and processed in blocks of -b frames (default BATCH_BLOCK), small enough that every buffer of the chain stays in the L2 cache between one stage and the next: each block of each channel is converted straight from the mapping into the first stage's input buffer, every stage whose outputs can go on top of its inputs runs in place (none of the plugins declares LADSPA_PROPERTY_INPLACE_BROKEN; see cmeplugins.h), and the last buffers are converted straight into the output file, mapped too.  A mono 32-bit float input isn't converted at all: its mapping is connected to the first stage's input as it is.  So apart from the format conversions, the only copies of the audio are those the plugins make themselves.
+
+Every plugin is run in offline mode: cmebatch sets CME_OFFLINE_ENV (see cmeplugins.h) before loading anything, so plugins that would otherwise drop work that isn't ready in time (the convolution reverb's tail) wait for it instead, and the same files and chain give the same output, byte for byte, every time ("make check" tries it).  A plugin from elsewhere that doesn't know about CME_OFFLINE_ENV gets no such promise.
+
+With -o, each output is written to the directory under the input's name, in the input's format (integer outputs are rounded and clipped, without dither), or as 32-bit float with -F; without -o nothing is written.  Outputs are the same length as the inputs: a reverb's tail past the end of its input is cut off.
+
+The files are shared out among -j threads (by default one per online CPU), each working through one file at a time with its own instances of the chain, instantiated at the file's sample rate.  The report goes to stdout as CSV, each file's lines together as it finishes (so files come out in the order they finish, not the order given), with a header line:
+  file, channel, reading, value
+For each channel of the chain's output (from 1) there is a peak_db, rms_db, trough_db and crest_db reading over the whole file, computed as the meters do (with the Stats kernel; trough is the smallest |sample|, and levels bottom out at -120 dB, see cmestatswindow.h).  Then there is a line for each control output of each stage, as it stood at the end of the file, with the copy for a channel and the reading "<stage>:<label>:<port name>", e.g. "2:cme_meter:Integrated loudness (LUFS)".  Files that can't be processed are reported on stderr, and the exit status is then 1.
+
+CME 2026-10
+*/
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+#include "cmestatswindow.h"
+#include "cmeplugins.h"
+
+
+
+#define BATCH_BLOCK		4096	// Frames: 16 kB per channel buffer
+#define BATCH_MAX_BLOCK		65536
+#define BATCH_MAX_STAGES	32
+#define BATCH_MAX_PORTS		64	// Audio inputs (or outputs) a plugin can have
+#define BATCH_MAX_CHANNELS	256
+#define BATCH_MAX_THREADS	256
+#define BUFFER_ALIGNMENT	64
+
+#define BATCH_DEFAULT_RATE	48000
+
+/* Sample formats (in files): */
+#define FORMAT_S16	0
+#define FORMAT_S24	1
+#define FORMAT_S32	2
+#define FORMAT_F32	3
+
+static const char * g_apcFormatNames[] = { "s16", "s24", "s32", "f32" };
+static const unsigned int g_auiFormatBytes[] = { 2, 3, 4, 4 };
+
+#define WAV_FORMAT_PCM		1
+#define WAV_FORMAT_FLOAT	3
+#define WAV_FORMAT_EXTENSIBLE	0xFFFE
+
+
+
+/* One plugin in the chain, as given by -p. */
+typedef struct {
+	const LADSPA_Descriptor * Descriptor;
+	unsigned long Inputs[BATCH_MAX_PORTS];		// Audio input ports, in order
+	unsigned long InputCount;
+	unsigned long Outputs[BATCH_MAX_PORTS];		// Audio output ports
+	unsigned long OutputCount;
+	LADSPA_Data * Values;		// [port]: control inputs given on the command line...
+	char * Given;			// [port]: ...where this is set
+} BatchStage;
+
+
+/* Batch options. */
+typedef struct {
+	BatchStage Stages[BATCH_MAX_STAGES];
+	unsigned long StageCount;
+	unsigned long BlockSize;
+	unsigned long Threads;
+	const char * OutputDirectory;
+	int FloatOutput;
+	int RawFormat;
+	unsigned long RawChannels;
+	unsigned long RawSampleRate;
+} BatchOptions;
+
+
+/* The work shared by the threads. */
+typedef struct {
+	const BatchOptions * Options;
+	char ** Files;
+	unsigned long FileCount;
+	unsigned long NextFile;		// Taken atomically
+	int Status;			// Set (under ReportLock) if any file fails
+	pthread_mutex_t ReportLock;
+} BatchJobs;
+
+
+/* A mapped audio file, in or out. */
+typedef struct {
+	unsigned char * Mapping;
+	size_t MappingSize;
+	unsigned char * Data;		// First frame
+	int Wav;
+	int Format;
+	unsigned long Channels;
+	unsigned long SampleRate;
+	unsigned long Frames;
+} AudioFile;
+
+
+/* One stage's instances for one file. */
+typedef struct {
+	unsigned long Copies;
+	LADSPA_Handle * Instances;	// [Copies]
+	LADSPA_Data * Controls;		// [Copies][PortCount]
+	LADSPA_Data ** Buffers;		// [Copies][OutputCount]: where each output goes when it can't go on top of its input
+} StageRun;
+
+
+
+static LADSPA_Data *
+allocateBuffer(unsigned long SampleCount) {
+
+	LADSPA_Data * pfBuffer;
+	size_t lBytes;
+
+	lBytes = SampleCount * sizeof(LADSPA_Data);
+	lBytes = (lBytes + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+	pfBuffer = (LADSPA_Data *)aligned_alloc(BUFFER_ALIGNMENT, lBytes);
+	if (!pfBuffer) {
+		fprintf(stderr, "cmebatch: out of memory\n");
+		exit(1);
+	}
+	memset(pfBuffer, 0, lBytes);
+	return pfBuffer;
+}
+
+
+static unsigned int
+readLE16(const unsigned char * Bytes) {
+	return Bytes[0] | (Bytes[1] << 8);
+}
+
+static uint32_t
+readLE32(const unsigned char * Bytes) {
+	return Bytes[0] | (Bytes[1] << 8) | (Bytes[2] << 16) | ((uint32_t)Bytes[3] << 24);
+}
+
+static void
+writeLE16(unsigned char * Bytes,
+	  unsigned int Value) {
+	Bytes[0] = Value;
+	Bytes[1] = Value >> 8;
+}
+
+static void
+writeLE32(unsigned char * Bytes,
+	  uint32_t Value) {
+	Bytes[0] = Value;
+	Bytes[1] = Value >> 8;
+	Bytes[2] = Value >> 16;
+	Bytes[3] = Value >> 24;
+}
+
+
+
+/* A control input's default, following the LADSPA hints (as cmebench's "unity" setting does, bar the toggles, which keep their defaults). */
+static LADSPA_Data
+defaultValue(const LADSPA_PortRangeHint * psHint,
+	     unsigned long SampleRate) {
+
+	LADSPA_PortRangeHintDescriptor iHint = psHint->HintDescriptor;
+	LADSPA_Data fLower = psHint->LowerBound;
+	LADSPA_Data fUpper = psHint->UpperBound;
+	LADSPA_Data fProportion;
+
+	if (LADSPA_IS_HINT_SAMPLE_RATE(iHint)) {
+		fLower *= SampleRate;
+		fUpper *= SampleRate;
+	}
+
+	switch (iHint & LADSPA_HINT_DEFAULT_MASK) {
+		case LADSPA_HINT_DEFAULT_MINIMUM:	return fLower;
+		case LADSPA_HINT_DEFAULT_MAXIMUM:	return fUpper;
+		case LADSPA_HINT_DEFAULT_0:		return 0.0;
+		case LADSPA_HINT_DEFAULT_1:		return 1.0;
+		case LADSPA_HINT_DEFAULT_100:		return 100.0;
+		case LADSPA_HINT_DEFAULT_440:		return 440.0;
+		case LADSPA_HINT_DEFAULT_LOW:		fProportion = 0.25; break;
+		case LADSPA_HINT_DEFAULT_MIDDLE:	fProportion = 0.5; break;
+		case LADSPA_HINT_DEFAULT_HIGH:		fProportion = 0.75; break;
+		default:
+			// No default: use the lower bound if there is one, else 0.
+			return LADSPA_IS_HINT_BOUNDED_BELOW(iHint) ? fLower : 0.0;
+	}
+
+	if (LADSPA_IS_HINT_LOGARITHMIC(iHint) && fLower > 0 && fUpper > 0)
+		return exp(log(fLower) * (1 - fProportion) + log(fUpper) * fProportion);
+	else
+		return fLower * (1 - fProportion) + fUpper * fProportion;
+}
+
+
+
+/* The control input port a "port=value" setting refers to: its number, or the one port whose name starts with it (or is it exactly).  Returns PortCount if there isn't one. */
+static unsigned long
+findControl(const LADSPA_Descriptor * psDescriptor,
+	    const char * Name) {
+
+	unsigned long lPort, lFound = psDescriptor->PortCount;
+	unsigned long lMatches = 0;
+	char * pcEnd;
+
+	lPort = strtoul(Name, &pcEnd, 10);
+	if (pcEnd != Name && *pcEnd == '\0')
+		lFound = lPort < psDescriptor->PortCount ? lPort : psDescriptor->PortCount;
+	else
+		for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+			if (strcasecmp(psDescriptor->PortNames[lPort], Name) == 0)
+				return LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort])
+					&& LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]) ? lPort : psDescriptor->PortCount;
+			if (strncasecmp(psDescriptor->PortNames[lPort], Name, strlen(Name)) == 0
+			    && LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort])
+			    && LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort])) {
+				lFound = lPort;
+				lMatches++;
+			}
+		}
+	if (lMatches > 1)
+		return psDescriptor->PortCount;
+
+	if (lFound < psDescriptor->PortCount
+	    && !(LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lFound]) && LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lFound])))
+		lFound = psDescriptor->PortCount;
+	return lFound;
+}
+
+
+/* Load the plugin a -p argument names ("library.so:plugin[,port=value...]") into a chain stage.  Exits on any error, as it's the command line that's wrong. */
+static void
+loadStage(BatchStage * psStage,
+	  const char * Spec) {
+
+	char * pcSpec = strdup(Spec);
+	char * pcSettings, * pcPlugin, * pcToken, * pcValue, * pcEnd;
+	void * pvLibrary;
+	LADSPA_Descriptor_Function pfDescriptorFunction;
+	const LADSPA_Descriptor * psDescriptor;
+	unsigned long lIndex, lPort, lID;
+
+	pcSettings = strchr(pcSpec, ',');
+	if (pcSettings)
+		*pcSettings++ = '\0';
+	pcPlugin = strrchr(pcSpec, ':');
+	if (!pcPlugin || pcPlugin == pcSpec || pcPlugin[1] == '\0') {
+		fprintf(stderr, "cmebatch: -p %s: expected library.so:plugin\n", Spec);
+		exit(2);
+	}
+	*pcPlugin++ = '\0';
+
+	pvLibrary = dlopen(pcSpec, RTLD_NOW | RTLD_LOCAL);
+	if (!pvLibrary) {
+		fprintf(stderr, "cmebatch: %s\n", dlerror());
+		exit(2);
+	}
+	pfDescriptorFunction = (LADSPA_Descriptor_Function)dlsym(pvLibrary, "ladspa_descriptor");
+	if (!pfDescriptorFunction) {
+		fprintf(stderr, "cmebatch: %s: no ladspa_descriptor()\n", pcSpec);
+		exit(2);
+	}
+
+	// By unique ID if it's a number, else by label:
+	lID = strtoul(pcPlugin, &pcEnd, 10);
+	for (lIndex = 0; (psDescriptor = pfDescriptorFunction(lIndex)) != NULL; lIndex++)
+		if (*pcEnd == '\0' ? psDescriptor->UniqueID == lID : strcmp(psDescriptor->Label, pcPlugin) == 0)
+			break;
+	if (!psDescriptor) {
+		fprintf(stderr, "cmebatch: %s: no plugin %s\n", pcSpec, pcPlugin);
+		exit(2);
+	}
+
+	memset(psStage, 0, sizeof(BatchStage));
+	psStage->Descriptor = psDescriptor;
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (!LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort]))
+			continue;
+		if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]) ? psStage->InputCount == BATCH_MAX_PORTS : psStage->OutputCount == BATCH_MAX_PORTS) {
+			fprintf(stderr, "cmebatch: %s: more than %d audio ports each way\n", psDescriptor->Label, BATCH_MAX_PORTS);
+			exit(2);
+		}
+		if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+			psStage->Inputs[psStage->InputCount++] = lPort;
+		else
+			psStage->Outputs[psStage->OutputCount++] = lPort;
+	}
+	if (psStage->InputCount == 0) {
+		fprintf(stderr, "cmebatch: %s: no audio inputs\n", psDescriptor->Label);
+		exit(2);
+	}
+
+	psStage->Values = (LADSPA_Data *)calloc(psDescriptor->PortCount, sizeof(LADSPA_Data));
+	psStage->Given = (char *)calloc(psDescriptor->PortCount, 1);
+	for (pcToken = pcSettings ? strtok(pcSettings, ",") : NULL; pcToken; pcToken = strtok(NULL, ",")) {
+		pcValue = strchr(pcToken, '=');
+		if (!pcValue) {
+			fprintf(stderr, "cmebatch: %s: expected port=value, not %s\n", psDescriptor->Label, pcToken);
+			exit(2);
+		}
+		*pcValue++ = '\0';
+		lPort = findControl(psDescriptor, pcToken);
+		if (lPort == psDescriptor->PortCount) {
+			fprintf(stderr, "cmebatch: %s: no single control input %s\n", psDescriptor->Label, pcToken);
+			exit(2);
+		}
+		psStage->Values[lPort] = strtof(pcValue, &pcEnd);
+		if (pcEnd == pcValue || *pcEnd != '\0') {
+			fprintf(stderr, "cmebatch: %s: %s: bad value %s\n", psDescriptor->Label, psDescriptor->PortNames[lPort], pcValue);
+			exit(2);
+		}
+		psStage->Given[lPort] = 1;
+	}
+
+	// (The library stays loaded until exit.)
+	free(pcSpec);
+}
+
+
+
+/* Map an input file and work out its format.  Returns 0 with a reason in Error if it can't be used. */
+static int
+openInput(AudioFile * psFile,
+	  const char * Filename,
+	  const BatchOptions * psOptions,
+	  char * Error,
+	  size_t ErrorSize) {
+
+	struct stat sStat;
+	unsigned char * pcChunk, * pcEnd, * pcFormat = NULL;
+	unsigned long lDataBytes = 0;
+	unsigned int uiTag, uiBits, uiBlockAlign;
+	int iFile;
+
+	memset(psFile, 0, sizeof(AudioFile));
+	iFile = open(Filename, O_RDONLY);
+	if (iFile < 0 || fstat(iFile, &sStat) != 0) {
+		snprintf(Error, ErrorSize, "%s", strerror(errno));
+		if (iFile >= 0)
+			close(iFile);
+		return 0;
+	}
+	if (sStat.st_size == 0) {
+		close(iFile);
+		snprintf(Error, ErrorSize, "empty file");
+		return 0;
+	}
+	psFile->MappingSize = sStat.st_size;
+	psFile->Mapping = (unsigned char *)mmap(NULL, psFile->MappingSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+	close(iFile);
+	if (psFile->Mapping == MAP_FAILED) {
+		psFile->Mapping = NULL;
+		snprintf(Error, ErrorSize, "%s", strerror(errno));
+		return 0;
+	}
+	madvise(psFile->Mapping, psFile->MappingSize, MADV_SEQUENTIAL);
+
+	if (psFile->MappingSize < 12 || memcmp(psFile->Mapping, "RIFF", 4) != 0 || memcmp(psFile->Mapping + 8, "WAVE", 4) != 0) {
+		psFile->Format = psOptions->RawFormat;
+		psFile->Channels = psOptions->RawChannels;
+		psFile->SampleRate = psOptions->RawSampleRate;
+		psFile->Data = psFile->Mapping;
+		psFile->Frames = psFile->MappingSize / (g_auiFormatBytes[psFile->Format] * psFile->Channels);
+		return 1;
+	}
+
+	// WAV: find the fmt and data chunks (padded to even lengths).
+	psFile->Wav = 1;
+	pcEnd = psFile->Mapping + psFile->MappingSize;
+	for (pcChunk = psFile->Mapping + 12; pcEnd - pcChunk >= 8; pcChunk += 8 + ((readLE32(pcChunk + 4) + 1) & ~1UL)) {
+		if (memcmp(pcChunk, "fmt ", 4) == 0 && readLE32(pcChunk + 4) >= 16 && pcEnd - pcChunk >= 24)
+			pcFormat = pcChunk + 8;
+		else if (memcmp(pcChunk, "data", 4) == 0) {
+			psFile->Data = pcChunk + 8;
+			lDataBytes = readLE32(pcChunk + 4);
+			if (lDataBytes > (unsigned long)(pcEnd - psFile->Data))	// (truncated, or still being written)
+				lDataBytes = pcEnd - psFile->Data;
+			break;
+		}
+		if ((unsigned long)(pcEnd - pcChunk) < 8 + ((readLE32(pcChunk + 4) + 1) & ~1UL))
+			break;
+	}
+	if (!pcFormat || !psFile->Data) {
+		snprintf(Error, ErrorSize, "no %s chunk", pcFormat ? "data" : "fmt");
+		return 0;
+	}
+
+	uiTag = readLE16(pcFormat);
+	psFile->Channels = readLE16(pcFormat + 2);
+	psFile->SampleRate = readLE32(pcFormat + 4);
+	uiBlockAlign = readLE16(pcFormat + 12);
+	uiBits = readLE16(pcFormat + 14);
+	if (uiTag == WAV_FORMAT_EXTENSIBLE && readLE32(pcFormat - 4) >= 26 && pcEnd - pcFormat >= 26)
+		uiTag = readLE16(pcFormat + 24);	// (the first two bytes of the sub-format GUID)
+	if (uiTag == WAV_FORMAT_PCM && uiBits == 16)
+		psFile->Format = FORMAT_S16;
+	else if (uiTag == WAV_FORMAT_PCM && uiBits == 24)
+		psFile->Format = FORMAT_S24;
+	else if (uiTag == WAV_FORMAT_PCM && uiBits == 32)
+		psFile->Format = FORMAT_S32;
+	else if (uiTag == WAV_FORMAT_FLOAT && uiBits == 32)
+		psFile->Format = FORMAT_F32;
+	else {
+		snprintf(Error, ErrorSize, "unsupported WAV format %u, %u bits", uiTag, uiBits);
+		return 0;
+	}
+	if (psFile->Channels == 0 || psFile->SampleRate == 0 || uiBlockAlign != psFile->Channels * g_auiFormatBytes[psFile->Format]) {
+		snprintf(Error, ErrorSize, "bad WAV header");
+		return 0;
+	}
+	psFile->Frames = lDataBytes / uiBlockAlign;
+	return 1;
+}
+
+
+/* Create and map an output file of Frames frames (with its WAV header if Wav is set).  The space is allocated up front, so a full disk is an error here rather than a SIGBUS later. */
+static int
+createOutput(AudioFile * psFile,
+	     const char * Filename,
+	     char * Error,
+	     size_t ErrorSize) {
+
+	size_t lHeader = !psFile->Wav ? 0 : psFile->Format == FORMAT_F32 ? 58 : 44;
+	size_t lDataBytes = (size_t)psFile->Frames * psFile->Channels * g_auiFormatBytes[psFile->Format];
+	unsigned char * pcHeader;
+	int iFile, iError;
+
+	if (psFile->Wav && lDataBytes > 0xFFFFFFFFUL - lHeader) {
+		snprintf(Error, ErrorSize, "too long for a WAV file");
+		return 0;
+	}
+	psFile->MappingSize = lHeader + lDataBytes;
+	iFile = open(Filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (iFile < 0) {
+		snprintf(Error, ErrorSize, "%s: %s", Filename, strerror(errno));
+		return 0;
+	}
+	if (psFile->MappingSize == 0) {
+		close(iFile);
+		return 1;
+	}
+	if ((iError = posix_fallocate(iFile, 0, psFile->MappingSize)) != 0
+	    || (psFile->Mapping = (unsigned char *)mmap(NULL, psFile->MappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0)) == MAP_FAILED) {
+		snprintf(Error, ErrorSize, "%s: %s", Filename, strerror(iError ? iError : errno));
+		psFile->Mapping = NULL;
+		close(iFile);
+		unlink(Filename);
+		return 0;
+	}
+	close(iFile);
+	madvise(psFile->Mapping, psFile->MappingSize, MADV_SEQUENTIAL);
+	psFile->Data = psFile->Mapping + lHeader;
+
+	if (psFile->Wav) {
+		pcHeader = psFile->Mapping;
+		memcpy(pcHeader, "RIFF", 4);
+		writeLE32(pcHeader + 4, psFile->MappingSize - 8);
+		memcpy(pcHeader + 8, "WAVEfmt ", 8);
+		writeLE32(pcHeader + 16, psFile->Format == FORMAT_F32 ? 18 : 16);
+		writeLE16(pcHeader + 20, psFile->Format == FORMAT_F32 ? WAV_FORMAT_FLOAT : WAV_FORMAT_PCM);
+		writeLE16(pcHeader + 22, psFile->Channels);
+		writeLE32(pcHeader + 24, psFile->SampleRate);
+		writeLE32(pcHeader + 28, psFile->SampleRate * psFile->Channels * g_auiFormatBytes[psFile->Format]);
+		writeLE16(pcHeader + 32, psFile->Channels * g_auiFormatBytes[psFile->Format]);
+		writeLE16(pcHeader + 34, 8 * g_auiFormatBytes[psFile->Format]);
+		pcHeader += 36;
+		if (psFile->Format == FORMAT_F32) {
+			// (Non-PCM formats have a cbSize and a fact chunk.)
+			writeLE16(pcHeader, 0);
+			memcpy(pcHeader + 2, "fact", 4);
+			writeLE32(pcHeader + 6, 4);
+			writeLE32(pcHeader + 10, psFile->Frames);
+			pcHeader += 14;
+		}
+		memcpy(pcHeader, "data", 4);
+		writeLE32(pcHeader + 4, lDataBytes);
+	}
+	return 1;
+}
+
+
+static void
+closeFile(AudioFile * psFile) {
+	if (psFile->Mapping)
+		munmap(psFile->Mapping, psFile->MappingSize);
+	psFile->Mapping = NULL;
+}
+
+
+
+/* Convert Count frames of one channel, starting at Frame, from the file into Buffer. */
+static void
+readChannel(const AudioFile * psFile,
+	    unsigned long Channel,
+	    unsigned long Frame,
+	    unsigned long Count,
+	    LADSPA_Data * Buffer) {
+
+	unsigned long lStride = psFile->Channels * g_auiFormatBytes[psFile->Format];
+	const unsigned char * pcSample = psFile->Data + Frame * lStride + Channel * g_auiFormatBytes[psFile->Format];
+	unsigned long lIndex;
+	uint32_t uiBits;
+
+	switch (psFile->Format) {
+	case FORMAT_S16:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride)
+			Buffer[lIndex] = (int16_t)readLE16(pcSample) * (1.0f / 32768);
+		break;
+	case FORMAT_S24:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride)
+			Buffer[lIndex] = ((int32_t)((pcSample[0] << 8) | (pcSample[1] << 16) | ((uint32_t)pcSample[2] << 24)) >> 8) * (1.0f / 8388608);
+		break;
+	case FORMAT_S32:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride)
+			Buffer[lIndex] = (int32_t)readLE32(pcSample) * (1.0f / 2147483648.0f);
+		break;
+	default:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride) {
+			uiBits = readLE32(pcSample);
+			memcpy(&Buffer[lIndex], &uiBits, sizeof(float));
+		}
+	}
+}
+
+
+/* Convert Count samples from Buffer into one channel of the file, starting at Frame. */
+static void
+writeChannel(AudioFile * psFile,
+	     unsigned long Channel,
+	     unsigned long Frame,
+	     unsigned long Count,
+	     const LADSPA_Data * Buffer) {
+
+	unsigned long lStride = psFile->Channels * g_auiFormatBytes[psFile->Format];
+	unsigned char * pcSample = psFile->Data + Frame * lStride + Channel * g_auiFormatBytes[psFile->Format];
+	unsigned long lIndex;
+	double dValue;
+	uint32_t uiBits;
+
+	switch (psFile->Format) {
+	case FORMAT_S16:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride) {
+			dValue = nearbyint(Buffer[lIndex] * 32768.0);
+			writeLE16(pcSample, (int16_t)(dValue > 32767 ? 32767 : dValue < -32768 ? -32768 : dValue));
+		}
+		break;
+	case FORMAT_S24:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride) {
+			dValue = nearbyint(Buffer[lIndex] * 8388608.0);
+			uiBits = (uint32_t)(int32_t)(dValue > 8388607 ? 8388607 : dValue < -8388608 ? -8388608 : dValue);
+			pcSample[0] = uiBits;
+			pcSample[1] = uiBits >> 8;
+			pcSample[2] = uiBits >> 16;
+		}
+		break;
+	case FORMAT_S32:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride) {
+			dValue = nearbyint(Buffer[lIndex] * 2147483648.0);
+			writeLE32(pcSample, (uint32_t)(int32_t)(dValue > 2147483647.0 ? 2147483647.0 : dValue < -2147483648.0 ? -2147483648.0 : dValue));
+		}
+		break;
+	default:
+		for (lIndex = 0; lIndex < Count; lIndex++, pcSample += lStride) {
+			memcpy(&uiBits, &Buffer[lIndex], sizeof(float));
+			writeLE32(pcSample, uiBits);
+		}
+	}
+}
+
+
+
+/* Run the chain over one file, writing its report lines to Report.  Returns 0 with a reason in Error if it couldn't. */
+static int
+processFile(const BatchOptions * psOptions,
+	    const char * Filename,
+	    FILE * Report,
+	    char * Error,
+	    size_t ErrorSize) {
+
+	AudioFile sInput, sOutput;
+	StageRun asRuns[BATCH_MAX_STAGES];
+	const BatchStage * psStage;
+	StageRun * psRun;
+	const LADSPA_Descriptor * psDescriptor;
+	LADSPA_Data * apfChannels[BATCH_MAX_CHANNELS], * apfNext[BATCH_MAX_CHANNELS];
+	char abWritable[BATCH_MAX_CHANNELS];	// apfChannels[c] is ours to overwrite (not the input mapping)
+	LADSPA_Data * apfInputBuffers[BATCH_MAX_CHANNELS];
+	CMEStats * psStats;
+	double * pdSumOfSquares;
+	CMEStats sBlock;
+	char * pcOutputPath = NULL, * pcCopy;
+	struct stat sInputStat, sOutputStat;
+	unsigned long lBlockSize = psOptions->BlockSize;
+	unsigned long lChannels, lInputChannels, lStage, lCopy, lPort, lIndex, lFrame, lCount, lChannel;
+	LADSPA_Data * pfBuffer;
+	LADSPA_Data fPeak, fRMS;
+	int iDirect, iOK = 0;
+
+	memset(asRuns, 0, sizeof(asRuns));
+	memset(&sOutput, 0, sizeof(sOutput));
+	if (!openInput(&sInput, Filename, psOptions, Error, ErrorSize)) {
+		closeFile(&sInput);
+		return 0;
+	}
+	lInputChannels = lChannels = sInput.Channels;
+	if (lChannels > BATCH_MAX_CHANNELS) {
+		snprintf(Error, ErrorSize, "more than %d channels", BATCH_MAX_CHANNELS);
+		closeFile(&sInput);
+		return 0;
+	}
+
+	// Work out how many copies of each stage the file's channels need, and instantiate them.
+	for (lStage = 0; lStage < psOptions->StageCount; lStage++) {
+		psStage = &psOptions->Stages[lStage];
+		psDescriptor = psStage->Descriptor;
+		psRun = &asRuns[lStage];
+		if (lChannels % psStage->InputCount != 0) {
+			snprintf(Error, ErrorSize, "stage %lu (%s) takes %lu channels, and there are %lu", lStage + 1, psDescriptor->Label, psStage->InputCount, lChannels);
+			goto done;
+		}
+		psRun->Copies = lChannels / psStage->InputCount;
+		if (psStage->OutputCount)
+			lChannels = psRun->Copies * psStage->OutputCount;
+		if (lChannels > BATCH_MAX_CHANNELS) {
+			snprintf(Error, ErrorSize, "more than %d channels after stage %lu (%s)", BATCH_MAX_CHANNELS, lStage + 1, psDescriptor->Label);
+			goto done;
+		}
+
+		psRun->Instances = (LADSPA_Handle *)calloc(psRun->Copies, sizeof(LADSPA_Handle));
+		psRun->Controls = allocateBuffer(psRun->Copies * psDescriptor->PortCount);
+		psRun->Buffers = (LADSPA_Data **)calloc(psRun->Copies * psStage->OutputCount + 1, sizeof(LADSPA_Data *));
+		for (lIndex = 0; lIndex < psRun->Copies * psStage->OutputCount; lIndex++)
+			psRun->Buffers[lIndex] = allocateBuffer(lBlockSize);
+		for (lCopy = 0; lCopy < psRun->Copies; lCopy++) {
+			psRun->Instances[lCopy] = psDescriptor->instantiate(psDescriptor, sInput.SampleRate);
+			if (!psRun->Instances[lCopy]) {
+				snprintf(Error, ErrorSize, "stage %lu (%s): instantiate failed", lStage + 1, psDescriptor->Label);
+				goto done;
+			}
+			for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+				if (!LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort]))
+					continue;
+				pfBuffer = &psRun->Controls[lCopy * psDescriptor->PortCount + lPort];
+				if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+					*pfBuffer = psStage->Given[lPort] ? psStage->Values[lPort] : defaultValue(&psDescriptor->PortRangeHints[lPort], sInput.SampleRate);
+				psDescriptor->connect_port(psRun->Instances[lCopy], lPort, pfBuffer);
+			}
+			if (psDescriptor->activate)
+				psDescriptor->activate(psRun->Instances[lCopy]);
+		}
+	}
+
+	if (psOptions->OutputDirectory) {
+		pcCopy = strdup(Filename);
+		if (asprintf(&pcOutputPath, "%s/%s", psOptions->OutputDirectory, basename(pcCopy)) < 0)
+			pcOutputPath = NULL;
+		free(pcCopy);
+		if (!pcOutputPath) {
+			snprintf(Error, ErrorSize, "out of memory");
+			goto done;
+		}
+		// (Never write over the input, which is still mapped.)
+		if (stat(Filename, &sInputStat) == 0 && stat(pcOutputPath, &sOutputStat) == 0
+		    && sInputStat.st_dev == sOutputStat.st_dev && sInputStat.st_ino == sOutputStat.st_ino) {
+			snprintf(Error, ErrorSize, "%s is the input", pcOutputPath);
+			goto done;
+		}
+		sOutput.Wav = sInput.Wav;
+		sOutput.Format = psOptions->FloatOutput ? FORMAT_F32 : sInput.Format;
+		sOutput.Channels = lChannels;
+		sOutput.SampleRate = sInput.SampleRate;
+		sOutput.Frames = sInput.Frames;
+		if (!createOutput(&sOutput, pcOutputPath, Error, ErrorSize))
+			goto done;
+	}
+
+	// A mono float input can go to the first stage as it is; anything else is converted a block at a time.
+	iDirect = sInput.Channels == 1 && sInput.Format == FORMAT_F32 && ((uintptr_t)sInput.Data & (sizeof(float) - 1)) == 0
+		&& __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+	for (lChannel = 0; lChannel < lInputChannels; lChannel++)
+		apfInputBuffers[lChannel] = iDirect ? NULL : allocateBuffer(lBlockSize);
+	psStats = (CMEStats *)calloc(lChannels, sizeof(CMEStats));
+	pdSumOfSquares = (double *)calloc(lChannels, sizeof(double));
+	for (lChannel = 0; lChannel < lChannels; lChannel++)
+		psStats[lChannel].Min = HUGE_VALF;
+
+	for (lFrame = 0; lFrame < sInput.Frames; lFrame += lCount) {
+		lCount = sInput.Frames - lFrame < lBlockSize ? sInput.Frames - lFrame : lBlockSize;
+
+		for (lChannel = 0; lChannel < lInputChannels; lChannel++) {
+			if (iDirect)
+				apfChannels[lChannel] = (LADSPA_Data *)sInput.Data + lFrame;
+			else {
+				apfChannels[lChannel] = apfInputBuffers[lChannel];
+				readChannel(&sInput, lChannel, lFrame, lCount, apfChannels[lChannel]);
+			}
+			abWritable[lChannel] = !iDirect;
+		}
+		lChannels = lInputChannels;
+
+		// Each copy's nth output goes on top of its nth input where that's ours to overwrite (connect_port() is allowed between any two runs):
+		for (lStage = 0; lStage < psOptions->StageCount; lStage++) {
+			psStage = &psOptions->Stages[lStage];
+			psDescriptor = psStage->Descriptor;
+			psRun = &asRuns[lStage];
+			for (lCopy = 0; lCopy < psRun->Copies; lCopy++) {
+				for (lIndex = 0; lIndex < psStage->InputCount; lIndex++)
+					psDescriptor->connect_port(psRun->Instances[lCopy], psStage->Inputs[lIndex], apfChannels[lCopy * psStage->InputCount + lIndex]);
+				for (lIndex = 0; lIndex < psStage->OutputCount; lIndex++) {
+					lChannel = lCopy * psStage->InputCount + lIndex;
+					if (lIndex < psStage->InputCount && abWritable[lChannel] && !LADSPA_IS_INPLACE_BROKEN(psDescriptor->Properties))
+						pfBuffer = apfChannels[lChannel];
+					else
+						pfBuffer = psRun->Buffers[lCopy * psStage->OutputCount + lIndex];
+					psDescriptor->connect_port(psRun->Instances[lCopy], psStage->Outputs[lIndex], pfBuffer);
+					apfNext[lCopy * psStage->OutputCount + lIndex] = pfBuffer;
+				}
+				psDescriptor->run(psRun->Instances[lCopy], lCount);
+			}
+			if (psStage->OutputCount) {
+				lChannels = psRun->Copies * psStage->OutputCount;
+				memcpy(apfChannels, apfNext, lChannels * sizeof(LADSPA_Data *));
+				memset(abWritable, 1, lChannels);
+			}
+		}
+
+		for (lChannel = 0; lChannel < lChannels; lChannel++) {
+			sBlock.Min = HUGE_VALF;
+			sBlock.Max = 0;
+			sBlock.SumOfSquares = 0;
+			g_sCMEKernels.Stats(apfChannels[lChannel], lCount, &sBlock);
+			if (sBlock.Max > psStats[lChannel].Max)	psStats[lChannel].Max = sBlock.Max;
+			if (sBlock.Min < psStats[lChannel].Min)	psStats[lChannel].Min = sBlock.Min;
+			pdSumOfSquares[lChannel] += sBlock.SumOfSquares;
+			if (sOutput.Mapping)
+				writeChannel(&sOutput, lChannel, lFrame, lCount, apfChannels[lChannel]);
+		}
+	}
+
+	for (lChannel = 0; lChannel < lChannels; lChannel++) {
+		fPeak = cmeLevelToDB(psStats[lChannel].Max);
+		fRMS = cmeLevelToDB(sInput.Frames ? sqrt(pdSumOfSquares[lChannel] / sInput.Frames) : 0);
+		fprintf(Report, "%s,%lu,peak_db,%.3f\n", Filename, lChannel + 1, fPeak);
+		fprintf(Report, "%s,%lu,rms_db,%.3f\n", Filename, lChannel + 1, fRMS);
+		fprintf(Report, "%s,%lu,trough_db,%.3f\n", Filename, lChannel + 1, cmeLevelToDB(sInput.Frames ? psStats[lChannel].Min : 0));
+		fprintf(Report, "%s,%lu,crest_db,%.3f\n", Filename, lChannel + 1, fPeak - fRMS);
+	}
+	for (lStage = 0; lStage < psOptions->StageCount; lStage++) {
+		psDescriptor = psOptions->Stages[lStage].Descriptor;
+		for (lCopy = 0; lCopy < asRuns[lStage].Copies; lCopy++)
+			for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+				if (LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort]) && LADSPA_IS_PORT_OUTPUT(psDescriptor->PortDescriptors[lPort]))
+					fprintf(Report, "%s,%lu,%lu:%s:%s,%g\n", Filename, lCopy + 1, lStage + 1, psDescriptor->Label, psDescriptor->PortNames[lPort],
+						asRuns[lStage].Controls[lCopy * psDescriptor->PortCount + lPort]);
+	}
+
+	for (lChannel = 0; lChannel < lInputChannels; lChannel++)
+		free(apfInputBuffers[lChannel]);
+	free(psStats);
+	free(pdSumOfSquares);
+	iOK = 1;
+
+done:
+	for (lStage = 0; lStage < psOptions->StageCount; lStage++) {
+		psDescriptor = psOptions->Stages[lStage].Descriptor;
+		psRun = &asRuns[lStage];
+		for (lCopy = 0; lCopy < psRun->Copies && psRun->Instances; lCopy++) {
+			if (!psRun->Instances[lCopy])
+				continue;
+			if (psDescriptor->deactivate)
+				psDescriptor->deactivate(psRun->Instances[lCopy]);
+			psDescriptor->cleanup(psRun->Instances[lCopy]);
+		}
+		for (lIndex = 0; psRun->Buffers && psRun->Buffers[lIndex]; lIndex++)
+			free(psRun->Buffers[lIndex]);
+		free(psRun->Instances);
+		free(psRun->Controls);
+		free(psRun->Buffers);
+	}
+	closeFile(&sOutput);
+	if (!iOK && sOutput.Data && pcOutputPath)
+		unlink(pcOutputPath);
+	free(pcOutputPath);
+	closeFile(&sInput);
+	return iOK;
+}
+
+
+
+/* Worker thread: take files off the list until there are none left. */
+static void *
+batchWorker(void * pvJobs) {
+
+	BatchJobs * psJobs = (BatchJobs *)pvJobs;
+	unsigned long lFile;
+	char * pcReport;
+	size_t lReportSize;
+	FILE * psReport;
+	char acError[512];
+	int iOK;
+
+	while ((lFile = __atomic_fetch_add(&psJobs->NextFile, 1, __ATOMIC_RELAXED)) < psJobs->FileCount) {
+		pcReport = NULL;
+		psReport = open_memstream(&pcReport, &lReportSize);
+		if (!psReport) {
+			fprintf(stderr, "cmebatch: out of memory\n");
+			exit(1);
+		}
+		iOK = processFile(psJobs->Options, psJobs->Files[lFile], psReport, acError, sizeof(acError));
+		fclose(psReport);
+
+		pthread_mutex_lock(&psJobs->ReportLock);
+		if (iOK)
+			fwrite(pcReport, 1, lReportSize, stdout);
+		else {
+			fprintf(stderr, "cmebatch: %s: %s\n", psJobs->Files[lFile], acError);
+			psJobs->Status = 1;
+		}
+		fflush(stdout);
+		pthread_mutex_unlock(&psJobs->ReportLock);
+		free(pcReport);
+	}
+	return NULL;
+}
+
+
+
+static void
+usage(void) {
+	fprintf(stderr, "usage: cmebatch [-j jobs] [-b block] [-o directory] [-F] [-r rate] [-c channels] [-t s16|s24|s32|f32]\n"
+			"                [-p library.so:plugin[,port=value...]] ... file ...\n");
+	exit(2);
+}
+
+
+int
+main(int argc, char ** argv) {
+
+	BatchOptions sOptions;
+	BatchJobs sJobs;
+	pthread_t asThreads[BATCH_MAX_THREADS];
+	unsigned long lThread;
+	long lCPUs;
+	int iOption, iFormat;
+
+	memset(&sOptions, 0, sizeof(sOptions));
+	sOptions.BlockSize = BATCH_BLOCK;
+	sOptions.RawFormat = FORMAT_F32;
+	sOptions.RawChannels = 1;
+	sOptions.RawSampleRate = BATCH_DEFAULT_RATE;
+	lCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+	sOptions.Threads = lCPUs > 0 ? lCPUs : 1;
+
+	cmeKernelsInit();
+	setenv(CME_OFFLINE_ENV, "1", 1);
+
+	while ((iOption = getopt(argc, argv, "j:b:o:Fr:c:t:p:")) != -1) {
+		switch (iOption) {
+			case 'j':
+				sOptions.Threads = strtoul(optarg, NULL, 10);
+				if (sOptions.Threads < 1)
+					sOptions.Threads = 1;
+				break;
+			case 'b':
+				sOptions.BlockSize = strtoul(optarg, NULL, 10);
+				if (sOptions.BlockSize < 1 || sOptions.BlockSize > BATCH_MAX_BLOCK) {
+					fprintf(stderr, "cmebatch: the block size must be 1..%d\n", BATCH_MAX_BLOCK);
+					exit(2);
+				}
+				break;
+			case 'o':
+				sOptions.OutputDirectory = optarg;
+				break;
+			case 'F':
+				sOptions.FloatOutput = 1;
+				break;
+			case 'r':
+				sOptions.RawSampleRate = strtoul(optarg, NULL, 10);
+				if (sOptions.RawSampleRate < 1)
+					usage();
+				break;
+			case 'c':
+				sOptions.RawChannels = strtoul(optarg, NULL, 10);
+				if (sOptions.RawChannels < 1 || sOptions.RawChannels > BATCH_MAX_CHANNELS) {
+					fprintf(stderr, "cmebatch: the channel count must be 1..%d\n", BATCH_MAX_CHANNELS);
+					exit(2);
+				}
+				break;
+			case 't':
+				for (iFormat = FORMAT_F32; iFormat >= 0 && strcmp(optarg, g_apcFormatNames[iFormat]) != 0; iFormat--)
+					;
+				if (iFormat < 0)
+					usage();
+				sOptions.RawFormat = iFormat;
+				break;
+			case 'p':
+				if (sOptions.StageCount == BATCH_MAX_STAGES) {
+					fprintf(stderr, "cmebatch: no more than %d plugins in the chain\n", BATCH_MAX_STAGES);
+					exit(2);
+				}
+				loadStage(&sOptions.Stages[sOptions.StageCount++], optarg);
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind >= argc)
+		usage();
+
+	memset(&sJobs, 0, sizeof(sJobs));
+	sJobs.Options = &sOptions;
+	sJobs.Files = argv + optind;
+	sJobs.FileCount = argc - optind;
+	pthread_mutex_init(&sJobs.ReportLock, NULL);
+	if (sOptions.Threads > sJobs.FileCount)
+		sOptions.Threads = sJobs.FileCount;
+	if (sOptions.Threads > BATCH_MAX_THREADS)
+		sOptions.Threads = BATCH_MAX_THREADS;
+
+	printf("file,channel,reading,value\n");
+	fflush(stdout);
+	for (lThread = 0; lThread < sOptions.Threads; lThread++)
+		if (pthread_create(&asThreads[lThread], NULL, batchWorker, &sJobs) != 0) {
+			fprintf(stderr, "cmebatch: can't start thread %lu\n", lThread + 1);
+			exit(1);
+		}
+	for (lThread = 0; lThread < sOptions.Threads; lThread++)
+		pthread_join(asThreads[lThread], NULL);
+
+	pthread_mutex_destroy(&sJobs.ReportLock);
+	return sJobs.Status;
+}
+
+
+/* EOF */
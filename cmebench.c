@@ -0,0 +1,912 @@
+/*
+Standalone benchmark host for the CME LADSPA plugins.
+
+Usage: cmebench [-b block,sizes,...] [-s samples] [-r trials] [-d seconds] [-l label] plugin.so ...
+       cmebench -i [-b block,sizes,...] [-l label] plugin.so ...
+       cmebench -t threads [-n instances] [-b block] [-s samples] [-r trials] [-l label] plugin.so ...
+
+Loads each library, walks ladspa_descriptor() and, for every plugin, times run() at each block size (1, 2, 4 ... 8192 by default) with each of three control settings:
+
+  muted		toggled controls (e.g. Mute) on, everything else at its default
+  unity		toggled controls off, everything else at its default (0 dB, centre)
+  arbitrary	toggled controls off, everything else 37% of the way through its range
+
+and then once more, at a block size of BENCH_DECAY_BLOCK, with:
+
+  decay		the arbitrary controls, and BENCH_BURST_SECONDS of the noise followed by silence, for -d seconds of audio in all (default 12; 0 skips it)
+
+The decay case reports the slowest one-second stretch of the silent part, so a plugin whose state decays into subnormal numbers (which can make x86 floating point a hundred times slower) shows up as much slower than its arbitrary line.  The arbitrary controls give the reverbs a decay time of about 0.7 s, by which they reach the subnormals about 9 s into the silence.
+
+Buffers are 64-byte aligned, and the input is pseudo-random noise at about -6 dBFS.  Each case runs for about -s samples per trial (default 2^20), or as many as fit in half a second for slow plugins, and the best of -r trials (default 5) is reported, so the figures are repeatable enough to compare between releases.
+
+Output is CSV on stdout, one line per case, with a header line.  Columns:
+  library, id, label, setting, block, runs, ns_per_sample, cycles_per_sample, msamples_per_sec, kernels
+cycles_per_sample counts TSC (reference) cycles on x86, and is 0 elsewhere; kernels is the CME_KERNELS setting the plugins were loaded with.
+
+With -i, nothing is timed: instead each plugin is checked for in-place processing, i.e. with its audio outputs connected to the same buffers as its inputs, as a host may do to save cache.  For each control setting, each block size (by default 1, 3, 64 and 1000, odd enough to hit every kernel's tail handling) and both run() and run_adding(), two instances are fed the same BENCH_CHECK_SAMPLES of noise (or two blocks, if that is more), one with every port on its own buffer and one aliased, and every output, audio and control, is compared bit for bit after every block.  The aliasing is tried two ways: the nth output on the nth input, and crossed, the nth output on the nth input from the end (e.g. balance's left output on its right input).  Plugins that set LADSPA_PROPERTY_INPLACE_BROKEN are skipped, and plugins with no audio outputs have nothing to check.  The convolution reverb's tail is rendered by a worker thread, and in a live host dropped whenever that falls behind, which running flat out it will, so the check sets CME_OFFLINE_ENV (see cmeplugins.h), and run() waits for it instead; BENCH_CHECK_SAMPLES is long enough for the first two blocks of the tail to be compared too.  The output is CSV again:
+  library, id, label, result, kernels
+where result is "ok", "skipped" (with the reason), or "differs" with the first case that did; the exit status is 1 if anything differed.  (In the instrumented build, the load outputs are timings, so they aren't compared; see cmeinstrument.h.)
+
+With -t, each plugin is timed as a big session runs it: 1, 2, 4 ... threads (up to -t, which is also always tried), each running -n instances (default BENCH_SCALING_INSTANCES) one after another, with the unity controls, at one block size (the first -b, default BENCH_SCALING_BLOCK).  The instances are all created by the main thread before any of them run, taking turns between the threads, as a host instantiating a session would, so each instance's neighbours in memory belong to other threads: if instances shared cache lines, each run() would fight the other cores for them, and the time per sample would go up with the thread count.  Each thread has its own buffers, and runs -s samples per trial (spread over its instances); the threads start each trial together, and the best of -r trials is reported.  Columns:
+  library, id, label, threads, instances, block, ns_per_sample, msamples_per_sec, scaling, kernels
+where ns_per_sample is wall-clock time per sample each thread ran, msamples_per_sec is the total over all the threads, and scaling is that total over (threads x the one-thread total): 1.0 is linear scaling.  Only as many threads as there are free cores can scale, of course.
+
+CME 2026-10
+*/
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define readCycles() __rdtsc()
+#else
+#define readCycles() 0ULL
+#endif
+
+#include "ladspa.h"
+#include "cmeinstrument.h"
+#include "cmeplugins.h"
+
+
+
+#define MAX_BLOCK_SIZE	8192
+#define MAX_BLOCK_SIZES	32
+#define BUFFER_ALIGNMENT	64
+
+#define SETTING_MUTED		0
+#define SETTING_UNITY		1
+#define SETTING_ARBITRARY	2
+#define SETTING_COUNT		3
+
+static const char * g_apcSettingNames[SETTING_COUNT + 1] = { "muted", "unity", "arbitrary", "decay" };
+
+#define BENCH_SAMPLE_RATE	48000
+
+#define SETTING_DECAY		SETTING_COUNT
+#define BENCH_DECAY_BLOCK	256
+#define BENCH_BURST_SECONDS	1
+
+#define BENCH_CHECK_SAMPLES	5120	// Per -i case: the convolution reverb's head (3072) and two tail blocks (1024); the big mesh manages only 7000 samples a second
+#define BENCH_CHECK_PORTS	64	// Audio inputs (or outputs) a plugin can have for -i
+
+/* Longest a trial may take: slow plugins (the reverbs) get fewer runs, so "make bench" still finishes. */
+#define BENCH_MAX_TRIAL_SECONDS	0.5
+
+#define BENCH_SCALING_BLOCK	256
+#define BENCH_SCALING_INSTANCES	64
+#define BENCH_MAX_THREADS	256
+
+
+
+/* Benchmark options. */
+typedef struct {
+	unsigned long BlockSizes[MAX_BLOCK_SIZES];
+	unsigned long BlockSizeCount;
+	unsigned long SamplesPerTrial;
+	unsigned long Trials;
+	unsigned long DecaySeconds;
+	const char * LabelFilter;
+	int CheckInPlace;
+	unsigned long MaxThreads;	// Scaling benchmark (-t) if non-zero
+	unsigned long Instances;
+} BenchOptions;
+
+
+/* One timed measurement. */
+typedef struct {
+	unsigned long Runs;
+	double Seconds;
+	unsigned long long Cycles;
+} BenchResult;
+
+
+
+static double
+now(void) {
+	struct timespec sTime;
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+	return sTime.tv_sec + sTime.tv_nsec * 1e-9;
+}
+
+
+static LADSPA_Data *
+allocateBuffer(unsigned long SampleCount) {
+
+	LADSPA_Data * pfBuffer;
+	size_t lBytes;
+
+	lBytes = SampleCount * sizeof(LADSPA_Data);
+	lBytes = (lBytes + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+	pfBuffer = (LADSPA_Data *)aligned_alloc(BUFFER_ALIGNMENT, lBytes);
+	if (!pfBuffer) {
+		fprintf(stderr, "cmebench: out of memory\n");
+		exit(1);
+	}
+	memset(pfBuffer, 0, lBytes);
+	return pfBuffer;
+}
+
+
+/* Fill a buffer with reproducible noise, uniform in about +/-0.5. */
+static void
+fillNoise(LADSPA_Data * Buffer,
+	  unsigned long SampleCount,
+	  unsigned int Seed) {
+
+	unsigned long lIndex;
+
+	for (lIndex = 0; lIndex < SampleCount; lIndex++) {
+		Seed = Seed * 1664525u + 1013904223u;
+		Buffer[lIndex] = ((LADSPA_Data)(Seed >> 8) / (LADSPA_Data)(1 << 24)) - 0.5;
+	}
+}
+
+
+
+/* Work out a control port's value for one of the benchmark settings, following the LADSPA default hints. */
+static LADSPA_Data
+controlValue(const LADSPA_PortRangeHint * psHint,
+	     int Setting) {
+
+	LADSPA_PortRangeHintDescriptor iHint = psHint->HintDescriptor;
+	LADSPA_Data fLower = psHint->LowerBound;
+	LADSPA_Data fUpper = psHint->UpperBound;
+	LADSPA_Data fProportion;
+	int bLog;
+
+	if (LADSPA_IS_HINT_SAMPLE_RATE(iHint)) {
+		fLower *= BENCH_SAMPLE_RATE;
+		fUpper *= BENCH_SAMPLE_RATE;
+	}
+	bLog = LADSPA_IS_HINT_LOGARITHMIC(iHint) && fLower > 0 && fUpper > 0;
+
+	if (LADSPA_IS_HINT_TOGGLED(iHint))
+		return Setting == SETTING_MUTED ? 1.0 : 0.0;
+
+	if (Setting == SETTING_ARBITRARY
+	    && LADSPA_IS_HINT_BOUNDED_BELOW(iHint) && LADSPA_IS_HINT_BOUNDED_ABOVE(iHint)) {
+		fProportion = 0.37;
+	}
+	else {
+		switch (iHint & LADSPA_HINT_DEFAULT_MASK) {
+			case LADSPA_HINT_DEFAULT_MINIMUM:	return fLower;
+			case LADSPA_HINT_DEFAULT_MAXIMUM:	return fUpper;
+			case LADSPA_HINT_DEFAULT_0:		return 0.0;
+			case LADSPA_HINT_DEFAULT_1:		return 1.0;
+			case LADSPA_HINT_DEFAULT_100:		return 100.0;
+			case LADSPA_HINT_DEFAULT_440:		return 440.0;
+			case LADSPA_HINT_DEFAULT_LOW:		fProportion = 0.25; break;
+			case LADSPA_HINT_DEFAULT_MIDDLE:	fProportion = 0.5; break;
+			case LADSPA_HINT_DEFAULT_HIGH:		fProportion = 0.75; break;
+			default:
+				// No default: use the lower bound if there is one, else 0.
+				return LADSPA_IS_HINT_BOUNDED_BELOW(iHint) ? fLower : 0.0;
+		}
+	}
+
+	if (bLog)
+		return exp(log(fLower) * (1 - fProportion) + log(fUpper) * fProportion);
+	else
+		return fLower * (1 - fProportion) + fUpper * fProportion;
+}
+
+
+
+/* Time one plugin at one block size and control setting. */
+static BenchResult
+benchmarkCase(const LADSPA_Descriptor * psDescriptor,
+	      LADSPA_Data ** Buffers,
+	      LADSPA_Data * Controls,
+	      int Setting,
+	      unsigned long BlockSize,
+	      const BenchOptions * psOptions) {
+
+	LADSPA_Handle hInstance;
+	BenchResult sBest = { 0, 0.0, 0 };
+	unsigned long lPort, lRun, lTrial;
+	unsigned long lRuns;
+	unsigned long long ullCycles;
+	double dStart, dSeconds;
+
+	hInstance = psDescriptor->instantiate(psDescriptor, BENCH_SAMPLE_RATE);
+	if (!hInstance)
+		return sBest;
+
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort])) {
+			if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+				Controls[lPort] = controlValue(&psDescriptor->PortRangeHints[lPort], Setting);
+			psDescriptor->connect_port(hInstance, lPort, &Controls[lPort]);
+		}
+		else
+			psDescriptor->connect_port(hInstance, lPort, Buffers[lPort]);
+	}
+
+	if (psDescriptor->activate)
+		psDescriptor->activate(hInstance);
+
+	lRuns = psOptions->SamplesPerTrial / BlockSize;
+	if (lRuns < 16)
+		lRuns = 16;
+
+	// One untimed trial to warm the caches and branch predictors (and to cut lRuns down if that takes too long), then keep the best of the rest.
+	dStart = now();
+	for (lRun = 0; lRun < lRuns; lRun++) {
+		psDescriptor->run(hInstance, BlockSize);
+		if (lRun + 1 >= 16 && now() - dStart > BENCH_MAX_TRIAL_SECONDS) {
+			lRuns = lRun + 1;
+			break;
+		}
+	}
+
+	for (lTrial = 1; lTrial <= psOptions->Trials; lTrial++) {
+		dStart = now();
+		ullCycles = readCycles();
+		for (lRun = 0; lRun < lRuns; lRun++)
+			psDescriptor->run(hInstance, BlockSize);
+		ullCycles = readCycles() - ullCycles;
+		dSeconds = now() - dStart;
+
+		if (sBest.Runs == 0 || dSeconds < sBest.Seconds) {
+			sBest.Runs = lRuns;
+			sBest.Seconds = dSeconds;
+			sBest.Cycles = ullCycles;
+		}
+	}
+
+	if (psDescriptor->deactivate)
+		psDescriptor->deactivate(hInstance);
+	psDescriptor->cleanup(hInstance);
+
+	return sBest;
+}
+
+
+
+/* Run one plugin through a burst of noise and then silence (see the note at the top), timing each second, and return the slowest second of the silence. */
+static BenchResult
+benchmarkDecay(const LADSPA_Descriptor * psDescriptor,
+	       LADSPA_Data ** Buffers,
+	       LADSPA_Data * Controls,
+	       const BenchOptions * psOptions) {
+
+	LADSPA_Handle hInstance;
+	BenchResult sWorst = { 0, 0.0, 0 };
+	BenchResult sSecond = { 0, 0.0, 0 };
+	LADSPA_Data * pfSilence;
+	unsigned long lPort, lSample;
+	unsigned long lBurstSamples = BENCH_BURST_SECONDS * BENCH_SAMPLE_RATE;
+	unsigned long lTotalSamples = psOptions->DecaySeconds * BENCH_SAMPLE_RATE;
+	unsigned long long ullCycles;
+	double dStart;
+
+	hInstance = psDescriptor->instantiate(psDescriptor, BENCH_SAMPLE_RATE);
+	if (!hInstance)
+		return sWorst;
+
+	pfSilence = allocateBuffer(BENCH_DECAY_BLOCK);
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort])) {
+			if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+				Controls[lPort] = controlValue(&psDescriptor->PortRangeHints[lPort], SETTING_ARBITRARY);
+			psDescriptor->connect_port(hInstance, lPort, &Controls[lPort]);
+		}
+		else
+			psDescriptor->connect_port(hInstance, lPort, Buffers[lPort]);
+	}
+
+	if (psDescriptor->activate)
+		psDescriptor->activate(hInstance);
+
+	for (lSample = 0; lSample < lTotalSamples; lSample += BENCH_DECAY_BLOCK) {
+		if (lSample == lBurstSamples / BENCH_DECAY_BLOCK * BENCH_DECAY_BLOCK)
+			for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+				if (LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort])
+				    && LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+					psDescriptor->connect_port(hInstance, lPort, pfSilence);
+
+		dStart = now();
+		ullCycles = readCycles();
+		psDescriptor->run(hInstance, BENCH_DECAY_BLOCK);
+		sSecond.Cycles += readCycles() - ullCycles;
+		sSecond.Seconds += now() - dStart;
+		sSecond.Runs++;
+
+		// At the end of each second of audio, keep it if it's the slowest of the silence so far:
+		if ((lSample + BENCH_DECAY_BLOCK) / BENCH_SAMPLE_RATE != lSample / BENCH_SAMPLE_RATE) {
+			if (lSample >= lBurstSamples && sSecond.Seconds / sSecond.Runs > (sWorst.Runs ? sWorst.Seconds / sWorst.Runs : 0.0))
+				sWorst = sSecond;
+			sSecond.Runs = 0;
+			sSecond.Seconds = 0.0;
+			sSecond.Cycles = 0;
+		}
+	}
+
+	if (psDescriptor->deactivate)
+		psDescriptor->deactivate(hInstance);
+	psDescriptor->cleanup(hInstance);
+	free(pfSilence);
+
+	return sWorst;
+}
+
+
+
+/* One side of an in-place check: an instance and its own set of buffers. */
+typedef struct {
+	LADSPA_Handle Instance;
+	LADSPA_Data ** Buffers;		// [port]: where each audio port is connected (aliased outputs share their input's)
+	LADSPA_Data * Controls;		// [port]
+} CheckSide;
+
+
+static int
+openCheckSide(CheckSide * psSide,
+	      const LADSPA_Descriptor * psDescriptor,
+	      int Setting,
+	      unsigned long BlockSize,
+	      const unsigned long * Inputs,
+	      const unsigned long * Outputs,
+	      unsigned long Pairs,
+	      int Crossed) {
+
+	unsigned long lPort, lPair;
+
+	psSide->Instance = psDescriptor->instantiate(psDescriptor, BENCH_SAMPLE_RATE);
+	psSide->Buffers = (LADSPA_Data **)calloc(psDescriptor->PortCount, sizeof(LADSPA_Data *));
+	psSide->Controls = allocateBuffer(psDescriptor->PortCount);
+	if (!psSide->Instance)
+		return 0;
+
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+		if (LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort]))
+			psSide->Buffers[lPort] = allocateBuffer(BlockSize);
+	for (lPair = 0; lPair < Pairs; lPair++) {
+		lPort = Crossed ? Outputs[Pairs - 1 - lPair] : Outputs[lPair];
+		free(psSide->Buffers[lPort]);
+		psSide->Buffers[lPort] = psSide->Buffers[Inputs[lPair]];
+	}
+
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (LADSPA_IS_PORT_CONTROL(psDescriptor->PortDescriptors[lPort])) {
+			if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+				psSide->Controls[lPort] = controlValue(&psDescriptor->PortRangeHints[lPort], Setting);
+			psDescriptor->connect_port(psSide->Instance, lPort, &psSide->Controls[lPort]);
+		}
+		else
+			psDescriptor->connect_port(psSide->Instance, lPort, psSide->Buffers[lPort]);
+	}
+	if (psDescriptor->activate)
+		psDescriptor->activate(psSide->Instance);
+	return 1;
+}
+
+
+static void
+closeCheckSide(CheckSide * psSide,
+	       const LADSPA_Descriptor * psDescriptor,
+	       const unsigned long * Outputs,
+	       unsigned long Pairs,
+	       int Crossed) {
+
+	unsigned long lPort, lPair;
+
+	if (psSide->Instance) {
+		if (psDescriptor->deactivate)
+			psDescriptor->deactivate(psSide->Instance);
+		psDescriptor->cleanup(psSide->Instance);
+	}
+	for (lPair = 0; lPair < Pairs; lPair++)
+		psSide->Buffers[Crossed ? Outputs[Pairs - 1 - lPair] : Outputs[lPair]] = NULL;
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+		free(psSide->Buffers[lPort]);
+	free(psSide->Buffers);
+	free(psSide->Controls);
+}
+
+
+/* Run one in-place check case (see the note at the top).  Returns 0 and describes the first difference in Result if the aliased instance's outputs ever differ from the reference's. */
+static int
+checkInPlaceCase(const LADSPA_Descriptor * psDescriptor,
+		 int Setting,
+		 unsigned long BlockSize,
+		 int Adding,
+		 int Crossed,
+		 const unsigned long * Inputs,
+		 unsigned long InputCount,
+		 const unsigned long * Outputs,
+		 unsigned long OutputCount,
+		 char * Result,
+		 size_t ResultSize) {
+
+	CheckSide sReference, sAliased;
+	unsigned long lPairs = InputCount < OutputCount ? InputCount : OutputCount;
+	unsigned long lPort, lIndex, lSample;
+	unsigned long lSamples = BENCH_CHECK_SAMPLES > 2 * BlockSize ? BENCH_CHECK_SAMPLES : 2 * BlockSize;
+	unsigned int uSeed;
+	int iOK = 1;
+
+	if (!openCheckSide(&sReference, psDescriptor, Setting, BlockSize, Inputs, Outputs, 0, 0)
+	    || !openCheckSide(&sAliased, psDescriptor, Setting, BlockSize, Inputs, Outputs, lPairs, Crossed)) {
+		snprintf(Result, ResultSize, "instantiate failed");
+		iOK = 0;
+		lSamples = 0;
+	}
+
+	for (lSample = 0; lSample < lSamples && iOK; lSample += BlockSize) {
+
+		// The same fresh noise into both, and the outputs of the reference filled just as the aliased ones will be:
+		for (lIndex = 0; lIndex < OutputCount; lIndex++) {
+			fillNoise(sReference.Buffers[Outputs[lIndex]], BlockSize, (unsigned int)(lSample * 7 + lIndex + 999));
+			if (lIndex >= lPairs)	// Not aliased either way
+				memcpy(sAliased.Buffers[Outputs[lIndex]], sReference.Buffers[Outputs[lIndex]], BlockSize * sizeof(LADSPA_Data));
+		}
+		for (lIndex = 0; lIndex < InputCount; lIndex++) {
+			uSeed = (unsigned int)(lSample * 7 + lIndex + 1);
+			fillNoise(sReference.Buffers[Inputs[lIndex]], BlockSize, uSeed);
+			fillNoise(sAliased.Buffers[Inputs[lIndex]], BlockSize, uSeed);
+		}
+		for (lIndex = 0; lIndex < lPairs; lIndex++)
+			memcpy(sReference.Buffers[Crossed ? Outputs[lPairs - 1 - lIndex] : Outputs[lIndex]],
+			       sReference.Buffers[Inputs[lIndex]], BlockSize * sizeof(LADSPA_Data));
+
+		if (Adding) {
+			psDescriptor->run_adding(sReference.Instance, BlockSize);
+			psDescriptor->run_adding(sAliased.Instance, BlockSize);
+		}
+		else {
+			psDescriptor->run(sReference.Instance, BlockSize);
+			psDescriptor->run(sAliased.Instance, BlockSize);
+		}
+
+		for (lPort = 0; lPort < psDescriptor->PortCount && iOK; lPort++) {
+			if (!LADSPA_IS_PORT_OUTPUT(psDescriptor->PortDescriptors[lPort])
+			    || strncmp(psDescriptor->PortNames[lPort], CME_INSTRUMENT_PORT_PREFIX, strlen(CME_INSTRUMENT_PORT_PREFIX)) == 0)
+				continue;
+			if (LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort]))
+				iOK = memcmp(sReference.Buffers[lPort], sAliased.Buffers[lPort], BlockSize * sizeof(LADSPA_Data)) == 0;
+			else
+				iOK = memcmp(&sReference.Controls[lPort], &sAliased.Controls[lPort], sizeof(LADSPA_Data)) == 0;
+			if (!iOK)
+				snprintf(Result, ResultSize, "differs: %s, block %lu, %s, %s, port %lu (%s), samples %lu-%lu",
+					 g_apcSettingNames[Setting], BlockSize, Adding ? "run_adding" : "run", Crossed ? "crossed" : "straight",
+					 lPort, psDescriptor->PortNames[lPort], lSample, lSample + BlockSize - 1);
+		}
+	}
+
+	closeCheckSide(&sReference, psDescriptor, Outputs, 0, 0);
+	closeCheckSide(&sAliased, psDescriptor, Outputs, lPairs, Crossed);
+	return iOK;
+}
+
+
+/* Check one plugin for in-place processing, in every case, and describe the outcome in Result.  Returns 0 if it failed. */
+static int
+checkInPlace(const LADSPA_Descriptor * psDescriptor,
+	     const BenchOptions * psOptions,
+	     char * Result,
+	     size_t ResultSize) {
+
+	unsigned long alInputs[BENCH_CHECK_PORTS], alOutputs[BENCH_CHECK_PORTS];
+	unsigned long lInputs = 0, lOutputs = 0;
+	unsigned long lPort, lBlock;
+	int iSetting, iAdding, iCrossed;
+
+	if (LADSPA_IS_INPLACE_BROKEN(psDescriptor->Properties)) {
+		snprintf(Result, ResultSize, "skipped (declares in-place broken)");
+		return 1;
+	}
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (!LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort]))
+			continue;
+		if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]) && lInputs < BENCH_CHECK_PORTS)
+			alInputs[lInputs++] = lPort;
+		else if (LADSPA_IS_PORT_OUTPUT(psDescriptor->PortDescriptors[lPort]) && lOutputs < BENCH_CHECK_PORTS)
+			alOutputs[lOutputs++] = lPort;
+	}
+	if (lInputs == 0 || lOutputs == 0) {
+		snprintf(Result, ResultSize, "skipped (no audio %s)", lOutputs == 0 ? "outputs" : "inputs");
+		return 1;
+	}
+
+	for (iSetting = 0; iSetting < SETTING_COUNT; iSetting++)
+		for (lBlock = 0; lBlock < psOptions->BlockSizeCount; lBlock++)
+			for (iAdding = 0; iAdding <= (psDescriptor->run_adding != NULL); iAdding++)
+				for (iCrossed = 0; iCrossed <= (lInputs > 1 || lOutputs > 1); iCrossed++)
+					if (!checkInPlaceCase(psDescriptor, iSetting, psOptions->BlockSizes[lBlock], iAdding, iCrossed,
+							      alInputs, lInputs, alOutputs, lOutputs, Result, ResultSize))
+						return 0;
+
+	snprintf(Result, ResultSize, "ok");
+	return 1;
+}
+
+
+
+/* One thread of the scaling benchmark (see the note at the top). */
+typedef struct {
+	const LADSPA_Descriptor * Descriptor;
+	LADSPA_Handle * Instances;	// This thread's: every Threads'th one created
+	unsigned long InstanceCount;
+	unsigned long BlockSize;
+	unsigned long Rounds;		// Passes over the instances per trial
+	unsigned long Trials;
+	pthread_barrier_t * Barrier;
+	double * Starts;		// [trial]
+	double * Ends;
+} ScalingThread;
+
+
+static void *
+runScalingThread(void * pvThread) {
+
+	ScalingThread * psThread = (ScalingThread *)pvThread;
+	const LADSPA_Descriptor * psDescriptor = psThread->Descriptor;
+	LADSPA_Data ** ppfBuffers;
+	LADSPA_Data * pfControls;
+	unsigned long lPort, lInstance, lRound, lTrial;
+
+	// The buffers are allocated (and so first touched) by the thread that uses them, and shared by its instances, like a bus's:
+	ppfBuffers = (LADSPA_Data **)calloc(psDescriptor->PortCount, sizeof(LADSPA_Data *));
+	pfControls = allocateBuffer(psDescriptor->PortCount);
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++) {
+		if (LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort])) {
+			ppfBuffers[lPort] = allocateBuffer(psThread->BlockSize);
+			if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+				fillNoise(ppfBuffers[lPort], psThread->BlockSize, 12345 + lPort);
+		}
+		else if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+			pfControls[lPort] = controlValue(&psDescriptor->PortRangeHints[lPort], SETTING_UNITY);
+	}
+	for (lInstance = 0; lInstance < psThread->InstanceCount; lInstance++) {
+		for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+			psDescriptor->connect_port(psThread->Instances[lInstance], lPort,
+						   LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort]) ? ppfBuffers[lPort] : &pfControls[lPort]);
+		if (psDescriptor->activate)
+			psDescriptor->activate(psThread->Instances[lInstance]);
+		psDescriptor->run(psThread->Instances[lInstance], psThread->BlockSize);
+	}
+
+	for (lTrial = 0; lTrial < psThread->Trials; lTrial++) {
+		pthread_barrier_wait(psThread->Barrier);
+		psThread->Starts[lTrial] = now();
+		for (lRound = 0; lRound < psThread->Rounds; lRound++)
+			for (lInstance = 0; lInstance < psThread->InstanceCount; lInstance++)
+				psDescriptor->run(psThread->Instances[lInstance], psThread->BlockSize);
+		psThread->Ends[lTrial] = now();
+	}
+
+	for (lInstance = 0; lInstance < psThread->InstanceCount && psDescriptor->deactivate; lInstance++)
+		psDescriptor->deactivate(psThread->Instances[lInstance]);
+	for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+		free(ppfBuffers[lPort]);
+	free(ppfBuffers);
+	free(pfControls);
+	return NULL;
+}
+
+
+/* Time one plugin with 1, 2, 4 ... MaxThreads threads (see the note at the top), printing a line for each.  Returns 0 if it couldn't. */
+static int
+benchmarkScaling(const char * Filename,
+		 const LADSPA_Descriptor * psDescriptor,
+		 const BenchOptions * psOptions,
+		 const char * Kernels) {
+
+	ScalingThread asThreads[BENCH_MAX_THREADS];
+	pthread_t aiThreads[BENCH_MAX_THREADS];
+	pthread_barrier_t sBarrier;
+	unsigned long lThreads, lThread, lInstance, lTrial;
+	unsigned long lBlockSize = psOptions->BlockSizes[0];
+	unsigned long lInstances = psOptions->Instances;
+	double dStart, dEnd, dBest, dSamples, dRate;
+	double dSingleRate = 0;
+	int iOK = 1;
+
+	for (lThreads = 1; iOK; lThreads = lThreads * 2 < psOptions->MaxThreads || lThreads == psOptions->MaxThreads ? lThreads * 2 : psOptions->MaxThreads) {
+		if (lThreads > psOptions->MaxThreads)
+			break;
+
+		memset(asThreads, 0, sizeof(asThreads));
+		for (lThread = 0; lThread < lThreads; lThread++) {
+			asThreads[lThread].Descriptor = psDescriptor;
+			asThreads[lThread].Instances = (LADSPA_Handle *)calloc(lInstances, sizeof(LADSPA_Handle));
+			asThreads[lThread].InstanceCount = lInstances;
+			asThreads[lThread].BlockSize = lBlockSize;
+			asThreads[lThread].Rounds = psOptions->SamplesPerTrial / (lBlockSize * lInstances);
+			if (asThreads[lThread].Rounds < 1)
+				asThreads[lThread].Rounds = 1;
+			asThreads[lThread].Trials = psOptions->Trials;
+			asThreads[lThread].Barrier = &sBarrier;
+			asThreads[lThread].Starts = (double *)calloc(psOptions->Trials, sizeof(double));
+			asThreads[lThread].Ends = (double *)calloc(psOptions->Trials, sizeof(double));
+		}
+
+		// Taking turns, so that consecutive instances belong to different threads:
+		for (lInstance = 0; lInstance < lInstances * lThreads && iOK; lInstance++) {
+			asThreads[lInstance % lThreads].Instances[lInstance / lThreads] = psDescriptor->instantiate(psDescriptor, BENCH_SAMPLE_RATE);
+			iOK = asThreads[lInstance % lThreads].Instances[lInstance / lThreads] != NULL;
+		}
+
+		if (iOK) {
+			pthread_barrier_init(&sBarrier, NULL, lThreads);
+			for (lThread = 0; lThread < lThreads; lThread++)
+				if (pthread_create(&aiThreads[lThread], NULL, runScalingThread, &asThreads[lThread]) != 0) {
+					fprintf(stderr, "cmebench: can't start thread %lu\n", lThread + 1);
+					exit(1);
+				}
+			for (lThread = 0; lThread < lThreads; lThread++)
+				pthread_join(aiThreads[lThread], NULL);
+			pthread_barrier_destroy(&sBarrier);
+
+			// A trial lasts from the first thread's start to the last one's end:
+			dBest = 0;
+			for (lTrial = 0; lTrial < psOptions->Trials; lTrial++) {
+				dStart = asThreads[0].Starts[lTrial];
+				dEnd = asThreads[0].Ends[lTrial];
+				for (lThread = 1; lThread < lThreads; lThread++) {
+					if (asThreads[lThread].Starts[lTrial] < dStart)	dStart = asThreads[lThread].Starts[lTrial];
+					if (asThreads[lThread].Ends[lTrial] > dEnd)	dEnd = asThreads[lThread].Ends[lTrial];
+				}
+				if (lTrial == 0 || dEnd - dStart < dBest)
+					dBest = dEnd - dStart;
+			}
+
+			dSamples = (double)asThreads[0].Rounds * lInstances * lBlockSize;
+			dRate = lThreads * dSamples / dBest;
+			if (lThreads == 1)
+				dSingleRate = dRate;
+			printf("%s,%lu,%s,%lu,%lu,%lu,%.4f,%.3f,%.3f,%s\n",
+			       Filename, psDescriptor->UniqueID, psDescriptor->Label,
+			       lThreads, lInstances, lBlockSize,
+			       dBest * 1e9 / dSamples,
+			       dRate * 1e-6,
+			       dRate / (lThreads * dSingleRate),
+			       Kernels);
+			fflush(stdout);
+		}
+		else
+			fprintf(stderr, "cmebench: %s: %s: instantiate failed\n", Filename, psDescriptor->Label);
+
+		for (lThread = 0; lThread < lThreads; lThread++) {
+			for (lInstance = 0; lInstance < lInstances; lInstance++)
+				if (asThreads[lThread].Instances[lInstance])
+					psDescriptor->cleanup(asThreads[lThread].Instances[lInstance]);
+			free(asThreads[lThread].Instances);
+			free(asThreads[lThread].Starts);
+			free(asThreads[lThread].Ends);
+		}
+		if (lThreads == psOptions->MaxThreads)
+			break;
+	}
+	return iOK;
+}
+
+
+static void
+printResult(const char * Filename,
+	    const LADSPA_Descriptor * psDescriptor,
+	    int Setting,
+	    unsigned long BlockSize,
+	    BenchResult sResult,
+	    const char * Kernels) {
+
+	double dSamples = (double)sResult.Runs * BlockSize;
+
+	printf("%s,%lu,%s,%s,%lu,%lu,%.4f,%.4f,%.3f,%s\n",
+	       Filename, psDescriptor->UniqueID, psDescriptor->Label,
+	       g_apcSettingNames[Setting], BlockSize, sResult.Runs,
+	       sResult.Seconds * 1e9 / dSamples,
+	       sResult.Cycles / dSamples,
+	       dSamples / sResult.Seconds * 1e-6,
+	       Kernels);
+	fflush(stdout);
+}
+
+
+
+static int
+benchmarkLibrary(const char * Filename,
+		 const BenchOptions * psOptions) {
+
+	void * pvLibrary;
+	LADSPA_Descriptor_Function pfDescriptorFunction;
+	const LADSPA_Descriptor * psDescriptor;
+	LADSPA_Data ** ppfBuffers;
+	LADSPA_Data * pfControls;
+	BenchResult sResult;
+	unsigned long lIndex, lPort, lBlock;
+	int iSetting;
+	int iStatus = 0;
+	const char * pcKernels;
+	char acResult[256];
+
+	pvLibrary = dlopen(Filename, RTLD_NOW | RTLD_LOCAL);
+	if (!pvLibrary) {
+		fprintf(stderr, "cmebench: %s\n", dlerror());
+		return 1;
+	}
+	pfDescriptorFunction = (LADSPA_Descriptor_Function)dlsym(pvLibrary, "ladspa_descriptor");
+	if (!pfDescriptorFunction) {
+		fprintf(stderr, "cmebench: %s: no ladspa_descriptor()\n", Filename);
+		dlclose(pvLibrary);
+		return 1;
+	}
+
+	pcKernels = getenv("CME_KERNELS");
+	if (!pcKernels)
+		pcKernels = "auto";
+
+	for (lIndex = 0; (psDescriptor = pfDescriptorFunction(lIndex)) != NULL; lIndex++) {
+
+		if (psOptions->LabelFilter && strcmp(psOptions->LabelFilter, psDescriptor->Label) != 0)
+			continue;
+
+		if (psOptions->CheckInPlace) {
+			if (!checkInPlace(psDescriptor, psOptions, acResult, sizeof(acResult)))
+				iStatus = 1;
+			printf("%s,%lu,%s,%s,%s\n", Filename, psDescriptor->UniqueID, psDescriptor->Label, acResult, pcKernels);
+			fflush(stdout);
+			continue;
+		}
+
+		if (psOptions->MaxThreads) {
+			if (!benchmarkScaling(Filename, psDescriptor, psOptions, pcKernels))
+				iStatus = 1;
+			continue;
+		}
+
+		ppfBuffers = (LADSPA_Data **)calloc(psDescriptor->PortCount, sizeof(LADSPA_Data *));
+		pfControls = allocateBuffer(psDescriptor->PortCount);
+		for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+			if (LADSPA_IS_PORT_AUDIO(psDescriptor->PortDescriptors[lPort])) {
+				ppfBuffers[lPort] = allocateBuffer(MAX_BLOCK_SIZE);
+				if (LADSPA_IS_PORT_INPUT(psDescriptor->PortDescriptors[lPort]))
+					fillNoise(ppfBuffers[lPort], MAX_BLOCK_SIZE, 12345 + lPort);
+			}
+
+		for (iSetting = 0; iSetting < SETTING_COUNT; iSetting++)
+			for (lBlock = 0; lBlock < psOptions->BlockSizeCount; lBlock++) {
+				sResult = benchmarkCase(psDescriptor, ppfBuffers, pfControls, iSetting,
+							psOptions->BlockSizes[lBlock], psOptions);
+				if (sResult.Runs == 0) {
+					fprintf(stderr, "cmebench: %s: %s: instantiate failed\n", Filename, psDescriptor->Label);
+					continue;
+				}
+				printResult(Filename, psDescriptor, iSetting, psOptions->BlockSizes[lBlock], sResult, pcKernels);
+			}
+
+		if (psOptions->DecaySeconds > BENCH_BURST_SECONDS) {
+			sResult = benchmarkDecay(psDescriptor, ppfBuffers, pfControls, psOptions);
+			if (sResult.Runs == 0)
+				fprintf(stderr, "cmebench: %s: %s: instantiate failed\n", Filename, psDescriptor->Label);
+			else
+				printResult(Filename, psDescriptor, SETTING_DECAY, BENCH_DECAY_BLOCK, sResult, pcKernels);
+		}
+
+		for (lPort = 0; lPort < psDescriptor->PortCount; lPort++)
+			free(ppfBuffers[lPort]);
+		free(ppfBuffers);
+		free(pfControls);
+	}
+
+	dlclose(pvLibrary);
+	return iStatus;
+}
+
+
+
+static void
+usage(void) {
+	fprintf(stderr, "usage: cmebench [-b block,sizes,...] [-s samples-per-trial] [-r trials] [-d decay-seconds] [-l label] plugin.so ...\n"
+			"       cmebench -i [-b block,sizes,...] [-l label] plugin.so ...\n"
+			"       cmebench -t threads [-n instances] [-b block] [-s samples-per-trial] [-r trials] [-l label] plugin.so ...\n");
+	exit(2);
+}
+
+
+int
+main(int argc, char ** argv) {
+
+	BenchOptions sOptions;
+	unsigned long lSize;
+	char * pcList;
+	char * pcToken;
+	int iOption;
+	int iStatus = 0;
+	int iBlockSizesGiven = 0;
+	static const unsigned long s_alCheckBlockSizes[] = { 1, 3, 64, 1000 };
+
+	memset(&sOptions, 0, sizeof(sOptions));
+	for (lSize = 1; lSize <= MAX_BLOCK_SIZE; lSize *= 2)
+		sOptions.BlockSizes[sOptions.BlockSizeCount++] = lSize;
+	sOptions.SamplesPerTrial = 1 << 20;
+	sOptions.Trials = 5;
+	sOptions.DecaySeconds = 12;
+	sOptions.Instances = BENCH_SCALING_INSTANCES;
+
+	while ((iOption = getopt(argc, argv, "b:s:r:d:l:it:n:")) != -1) {
+		switch (iOption) {
+			case 'b':
+				iBlockSizesGiven = 1;
+				sOptions.BlockSizeCount = 0;
+				pcList = strdup(optarg);
+				for (pcToken = strtok(pcList, ","); pcToken && sOptions.BlockSizeCount < MAX_BLOCK_SIZES; pcToken = strtok(NULL, ",")) {
+					lSize = strtoul(pcToken, NULL, 10);
+					if (lSize < 1 || lSize > MAX_BLOCK_SIZE) {
+						fprintf(stderr, "cmebench: block sizes must be 1..%d\n", MAX_BLOCK_SIZE);
+						exit(2);
+					}
+					sOptions.BlockSizes[sOptions.BlockSizeCount++] = lSize;
+				}
+				free(pcList);
+				break;
+			case 's':
+				sOptions.SamplesPerTrial = strtoul(optarg, NULL, 10);
+				break;
+			case 'r':
+				sOptions.Trials = strtoul(optarg, NULL, 10);
+				if (sOptions.Trials < 1)
+					sOptions.Trials = 1;
+				break;
+			case 'd':
+				sOptions.DecaySeconds = strtoul(optarg, NULL, 10);
+				break;
+			case 'l':
+				sOptions.LabelFilter = optarg;
+				break;
+			case 'i':
+				sOptions.CheckInPlace = 1;
+				break;
+			case 't':
+				sOptions.MaxThreads = strtoul(optarg, NULL, 10);
+				if (sOptions.MaxThreads < 1 || sOptions.MaxThreads > BENCH_MAX_THREADS) {
+					fprintf(stderr, "cmebench: threads must be 1..%d\n", BENCH_MAX_THREADS);
+					exit(2);
+				}
+				break;
+			case 'n':
+				sOptions.Instances = strtoul(optarg, NULL, 10);
+				if (sOptions.Instances < 1)
+					sOptions.Instances = 1;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind >= argc || sOptions.BlockSizeCount == 0)
+		usage();
+
+	if (sOptions.CheckInPlace) {
+		if (!iBlockSizesGiven) {
+			sOptions.BlockSizeCount = sizeof(s_alCheckBlockSizes) / sizeof(s_alCheckBlockSizes[0]);
+			memcpy(sOptions.BlockSizes, s_alCheckBlockSizes, sizeof(s_alCheckBlockSizes));
+		}
+		// (before anything is instantiated, which is when the convolution reverb looks)
+		setenv(CME_OFFLINE_ENV, "1", 1);
+		printf("library,id,label,result,kernels\n");
+	}
+	else if (sOptions.MaxThreads) {
+		if (!iBlockSizesGiven)
+			sOptions.BlockSizes[0] = BENCH_SCALING_BLOCK;
+		printf("library,id,label,threads,instances,block,ns_per_sample,msamples_per_sec,scaling,kernels\n");
+	}
+	else
+		printf("library,id,label,setting,block,runs,ns_per_sample,cycles_per_sample,msamples_per_sec,kernels\n");
+	for (; optind < argc; optind++)
+		iStatus |= benchmarkLibrary(argv[optind], &sOptions);
+
+	return iStatus;
+}
+
+
+/* EOF */
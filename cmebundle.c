@@ -0,0 +1,68 @@
+/*
+The combined library, libcme.so: every CME plugin in one file, so a host scanning LADSPA_PATH opens and maps one library rather than eight, and the kernels, FFT and telemetry code are loaded once.  The per-plugin libraries are still built, with the same IDs, so install one or the other, not both.
+
+The plugin sources are compiled for this with -DCME_BUNDLE, which leaves out their own ladspa_descriptor() and _init(); see cmeplugins.h.
+
+Every label here is unique.  The balance, which is labelled "cme_pan" in cmebal.so (as it always has been), is "cme_balance" here, so that it doesn't clash with the pan.
+
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+#include "cmepanlaw.h"
+#include "cmeplugins.h"
+
+
+static const LADSPA_Descriptor * const g_apsBundleDescriptors[] = {
+	&g_sMonoAmplifierDescriptor,
+	&g_sStereoAmplifierDescriptor,
+	&g_asWideAmplifierDescriptors[0],
+	&g_asWideAmplifierDescriptors[1],
+	&g_asWideAmplifierDescriptors[2],
+	&g_asWideAmplifierDescriptors[3],
+	&g_asWideAmplifierDescriptors[4],
+	&g_asWideAmplifierDescriptors[5],
+	&g_sModulatedMonoAmplifierDescriptor,
+	&g_sModulatedStereoAmplifierDescriptor,
+	&g_sPanDescriptor,
+	&g_sModulatedPanDescriptor,
+	&g_sBalanceDescriptor,
+	&g_sModulatedBalanceDescriptor,
+	&g_sMeterDescriptor,
+	&g_asMultiMeterDescriptors[0],
+	&g_asMultiMeterDescriptors[1],
+	&g_asMultiMeterDescriptors[2],
+	&g_asMultiMeterDescriptors[3],
+	&g_asMultiMeterDescriptors[4],
+	&g_sStripDescriptor,
+	&g_sFDNDescriptor,
+	&g_sConvDescriptor,
+	&g_asMeshDescriptors[0],
+	&g_asMeshDescriptors[1],
+	&g_asMeshDescriptors[2]
+};
+#define BUNDLE_DESCRIPTORS	(sizeof(g_apsBundleDescriptors) / sizeof(g_apsBundleDescriptors[0]))
+
+
+void
+_init() {
+	cmeKernelsInit();
+	cmePanLawsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type, in the order above. */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+	/* Return the requested descriptor or null if the index is out of range. */
+	if (Index < BUNDLE_DESCRIPTORS)
+		return g_apsBundleDescriptors[Index];
+	return NULL;
+}
+
+
+/* EOF */
@@ -0,0 +1,408 @@
+/*
+Kernel consistency check for the CME LADSPA plugins: "make check" builds and runs this.
+
+Usage: cmecheck
+
+cmekernels.h promises that every ISA version of every kernel gives exactly what the scalar reference gives, in place or not.  This holds each kernel set this machine supports (see cmeKernelsAvailable()) to that, bit for bit: every kernel is run by the scalar set and by the set under test on identical copies of the same buffers, and afterwards the copies (all of them, including the unused padding either side of every buffer, so stray stores show up too) and any statistics must be the same.  The one allowance is the one cmekernels.h makes: where the reference gives a NaN, the version under test must give a NaN, but not necessarily with the same sign and payload.
+
+The cases are every length from 0 to CHECK_MAX_SHORT and a few longer ones either side of the vector widths, each at CHECK_OFFSETS different alignments (each buffer is offset from a 64-byte boundary by a different number of samples), with the buffers wired up every way the plugins wire them: each on its own, outputs on their own inputs, crossed (each output on the other channel's input), one input for both channels (pan), outputs on the gain buffers, and one gain buffer for both channels.  The samples are noise with about one in eight of them NaN, +-0, +-infinity, subnormal or huge, and the scalar arguments include 0, 1, -1, NaN and subnormals.  Each case is run with the FPU in its default mode and again with flush-to-zero and denormals-are-zero on, as the plugins that use cmedenormal.h run them.
+
+Prints one line per kernel set, and the first few differences; the exit status is 1 if anything differed.
+
+CME 2026-10
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+#include "cmepanlaw.h"
+#include "cmedenormal.h"
+
+
+
+/* Every length up to this... */
+#define CHECK_MAX_SHORT	100
+
+/* ...and these: */
+static const unsigned long g_alLongLengths[] = { 127, 128, 129, 255, 256, 257, 1000, 1023, 1024, 1025, 4097 };
+#define CHECK_LONG_LENGTHS	(sizeof(g_alLongLengths) / sizeof(g_alLongLengths[0]))
+
+#define CHECK_MAX_LENGTH	4097
+
+/* Alignments tried (samples past a 64-byte boundary, for the first buffer; the others are staggered): */
+#define CHECK_OFFSETS	16
+
+/* Samples before each buffer (TruePeak reads CME_TRUE_PEAK_TAPS - 1 of them) and after it: */
+#define CHECK_LEAD	32
+#define CHECK_TRAIL	32
+
+#define CHECK_MAX_REPORTS	20
+
+
+/* The buffers of one case.  Each kernel argument is a role, and a wiring says which buffer each role uses. */
+enum { LINPUT, RINPUT, LOUTPUT, ROUTPUT, LGAINS, RGAINS, CHECK_ROLES };
+
+#define CHECK_STRIDE	(CHECK_LEAD + CHECK_OFFSETS + CHECK_MAX_LENGTH + CHECK_TRAIL + 16)
+
+/* The part of each buffer a case of Length samples can touch (only this much is filled, copied and compared): */
+#define CHECK_SPAN(Length)	(CHECK_LEAD + CHECK_OFFSETS + (Length) + CHECK_TRAIL)
+
+typedef struct {
+	LADSPA_Data Buffers[CHECK_ROLES][CHECK_STRIDE] __attribute__((aligned(64)));
+	CMEStats LStats;
+	CMEStats RStats;
+	int Silent;
+} CheckArena;
+
+
+typedef struct {
+	const char * Name;
+	int Roles[CHECK_ROLES];	// Buffer for each role
+} CheckWiring;
+
+static const CheckWiring g_asWirings[] = {
+	{ "separate",		{ LINPUT, RINPUT, LOUTPUT, ROUTPUT, LGAINS, RGAINS } },
+	{ "in place",		{ LINPUT, RINPUT, LINPUT, RINPUT, LGAINS, RGAINS } },
+	{ "crossed",		{ LINPUT, RINPUT, RINPUT, LINPUT, LGAINS, RGAINS } },
+	{ "L output on R input",	{ LINPUT, RINPUT, RINPUT, ROUTPUT, LGAINS, RGAINS } },
+	{ "shared input",	{ LINPUT, LINPUT, LOUTPUT, ROUTPUT, LGAINS, RGAINS } },
+	{ "shared input, L in place",	{ LINPUT, LINPUT, LINPUT, ROUTPUT, LGAINS, RGAINS } },
+	{ "outputs on gains",	{ LINPUT, RINPUT, LGAINS, RGAINS, LGAINS, RGAINS } },
+	{ "shared gains",	{ LINPUT, RINPUT, LOUTPUT, ROUTPUT, LGAINS, LGAINS } }
+};
+#define CHECK_WIRINGS	(sizeof(g_asWirings) / sizeof(g_asWirings[0]))
+
+
+/* Scalar arguments (gains, ramp starts and steps): */
+static const float g_afGains[] = { 0.0f, 1.0f, -1.0f, 0.7071f, -3.5f, 1e-3f, NAN, 1e-40f, 0.0f };
+#define CHECK_GAINS	(sizeof(g_afGains) / sizeof(g_afGains[0]))
+
+
+enum {
+	K_SCALE, K_DUALSCALE, K_SCALEADD, K_DUALSCALEADD, K_ZERO, K_STATS, K_TRUEPEAK, K_ISSILENT, K_DUALSCALESTATS,
+	K_DBTOGAIN, K_PANLAWGAINS, K_MULTIPLY, K_MULTIPLYADD, K_DUALMULTIPLY, K_DUALMULTIPLYADD,
+	K_SCALERAMP, K_SCALERAMPADD, K_DUALSCALERAMP, K_DUALSCALERAMPADD, CHECK_KERNELS
+};
+
+static const char * g_apcKernelNames[CHECK_KERNELS] = {
+	"Scale", "DualScale", "ScaleAdd", "DualScaleAdd", "Zero", "Stats", "TruePeak", "IsSilent", "DualScaleStats",
+	"DBToGain", "PanLawGains", "Multiply", "MultiplyAdd", "DualMultiply", "DualMultiplyAdd",
+	"ScaleRamp", "ScaleRampAdd", "DualScaleRamp", "DualScaleRampAdd"
+};
+
+
+static CheckArena g_sSource;
+static CheckArena g_sReference;
+static CheckArena g_sTested;
+static unsigned long g_lFailures;
+
+
+
+static uint32_t
+nextRandom(uint32_t * Seed) {
+	*Seed = *Seed * 1664525 + 1013904223;
+	return *Seed;
+}
+
+
+/* Noise from -Range to Range, with about one sample in eight special. */
+static LADSPA_Data
+randomSample(uint32_t * Seed,
+	     LADSPA_Data Range) {
+
+	static const float afSpecial[] = { NAN, -NAN, 0.0f, -0.0f, INFINITY, -INFINITY, 1e-40f, -1e-42f, 1.17e-38f, 3e30f, -3e30f, 1.0f };
+	uint32_t uRandom = nextRandom(Seed);
+
+	if ((uRandom >> 8) % 8 == 0)
+		return afSpecial[(uRandom >> 12) % (sizeof(afSpecial) / sizeof(afSpecial[0]))];
+	return ((LADSPA_Data)(uRandom >> 8) / (LADSPA_Data)(1 << 23) - 1.0f) * Range;
+}
+
+
+/* Fill the source arena for one kernel: its inputs get values that make sense for it, and everything else gets noise. */
+static void
+fillSource(int Kernel,
+	   unsigned long Length,
+	   uint32_t Seed) {
+
+	unsigned long lRole, lIndex;
+	LADSPA_Data fRange;
+
+	for (lRole = 0; lRole < CHECK_ROLES; lRole++) {
+		fRange = 2.0f;
+		if (Kernel == K_DBTOGAIN && lRole == LINPUT)
+			fRange = 150.0f;
+		else if (Kernel == K_PANLAWGAINS && lRole == LINPUT)
+			fRange = 1.2f;
+		for (lIndex = 0; lIndex < CHECK_SPAN(Length); lIndex++)
+			g_sSource.Buffers[lRole][lIndex] = randomSample(&Seed, fRange);
+	}
+
+	// IsSilent wants mostly silence, with the odd sample of something somewhere (or nothing):
+	if (Kernel == K_ISSILENT)
+		for (lRole = 0; lRole < CHECK_ROLES; lRole++) {
+			for (lIndex = 0; lIndex < CHECK_SPAN(Length); lIndex++)
+				g_sSource.Buffers[lRole][lIndex] = (nextRandom(&Seed) >> 9) & 1 ? -0.0f : 0.0f;
+			if (Length && (nextRandom(&Seed) >> 8) % 4)
+				g_sSource.Buffers[lRole][CHECK_LEAD + (nextRandom(&Seed) >> 8) % (CHECK_OFFSETS + Length)] = randomSample(&Seed, 1e-30f);
+		}
+
+	g_sSource.LStats.Min = (nextRandom(&Seed) >> 8) % 2 ? 3.0f : INFINITY;
+	g_sSource.LStats.Max = 0.25f;
+	g_sSource.LStats.SumOfSquares = 1.5f;
+	g_sSource.RStats = g_sSource.LStats;
+	g_sSource.Silent = -1;
+}
+
+
+/* Copy the source arena, as far as a case of Length samples goes. */
+static void
+copySource(CheckArena * Arena,
+	   unsigned long Length) {
+
+	int iRole;
+
+	for (iRole = 0; iRole < CHECK_ROLES; iRole++)
+		memcpy(Arena->Buffers[iRole], g_sSource.Buffers[iRole], CHECK_SPAN(Length) * sizeof(LADSPA_Data));
+	Arena->LStats = g_sSource.LStats;
+	Arena->RStats = g_sSource.RStats;
+	Arena->Silent = g_sSource.Silent;
+}
+
+
+/* Run one kernel from Table over Arena, with the buffers wired and offset as given. */
+static void
+runKernel(const CMEKernelTable * Table,
+	  CheckArena * Arena,
+	  int Kernel,
+	  const CheckWiring * Wiring,
+	  unsigned long Offset,
+	  unsigned long Length,
+	  LADSPA_Data Gain,
+	  LADSPA_Data Step,
+	  const float * PanLaw) {
+
+	LADSPA_Data * apfRole[CHECK_ROLES];
+	int iRole, iBuffer;
+
+	// (Each buffer gets its own alignment, and a role always points at its buffer's, so aliased roles are the very same pointer.)
+	for (iRole = 0; iRole < CHECK_ROLES; iRole++) {
+		iBuffer = Wiring->Roles[iRole];
+		apfRole[iRole] = Arena->Buffers[iBuffer] + CHECK_LEAD + (Offset + 5 * iBuffer) % CHECK_OFFSETS;
+	}
+
+	switch (Kernel) {
+	case K_SCALE:
+		Table->Scale(apfRole[LINPUT], apfRole[LOUTPUT], Gain, Length);
+		break;
+	case K_DUALSCALE:
+		Table->DualScale(apfRole[LINPUT], apfRole[RINPUT], apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Step, Length);
+		break;
+	case K_SCALEADD:
+		Table->ScaleAdd(apfRole[LINPUT], apfRole[LOUTPUT], Gain, Length);
+		break;
+	case K_DUALSCALEADD:
+		Table->DualScaleAdd(apfRole[LINPUT], apfRole[RINPUT], apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Step, Length);
+		break;
+	case K_ZERO:
+		Table->Zero(apfRole[LOUTPUT], Length);
+		break;
+	case K_STATS:
+		Table->Stats(apfRole[LINPUT], Length, &Arena->LStats);
+		break;
+	case K_TRUEPEAK:
+		Table->TruePeak(apfRole[LINPUT], apfRole[LOUTPUT], Length);
+		break;
+	case K_ISSILENT:
+		Arena->Silent = Table->IsSilent(apfRole[LINPUT], Length);
+		break;
+	case K_DUALSCALESTATS:
+		Table->DualScaleStats(apfRole[LINPUT], apfRole[RINPUT], apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Step, Length, &Arena->LStats, &Arena->RStats);
+		break;
+	case K_DBTOGAIN:
+		Table->DBToGain(apfRole[LINPUT], apfRole[LOUTPUT], Gain, Length);
+		break;
+	case K_PANLAWGAINS:
+		Table->PanLawGains(apfRole[LINPUT], PanLaw, apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Length);
+		break;
+	case K_MULTIPLY:
+		Table->Multiply(apfRole[LINPUT], apfRole[LGAINS], apfRole[LOUTPUT], Length);
+		break;
+	case K_MULTIPLYADD:
+		Table->MultiplyAdd(apfRole[LINPUT], apfRole[LGAINS], apfRole[LOUTPUT], Length);
+		break;
+	case K_DUALMULTIPLY:
+		Table->DualMultiply(apfRole[LINPUT], apfRole[RINPUT], apfRole[LGAINS], apfRole[RGAINS], apfRole[LOUTPUT], apfRole[ROUTPUT], Length);
+		break;
+	case K_DUALMULTIPLYADD:
+		Table->DualMultiplyAdd(apfRole[LINPUT], apfRole[RINPUT], apfRole[LGAINS], apfRole[RGAINS], apfRole[LOUTPUT], apfRole[ROUTPUT], Length);
+		break;
+	case K_SCALERAMP:
+		Table->ScaleRamp(apfRole[LINPUT], apfRole[LOUTPUT], Gain, Step, Length);
+		break;
+	case K_SCALERAMPADD:
+		Table->ScaleRampAdd(apfRole[LINPUT], apfRole[LOUTPUT], Gain, Step, Length);
+		break;
+	case K_DUALSCALERAMP:
+		Table->DualScaleRamp(apfRole[LINPUT], apfRole[RINPUT], apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Step, -Step, Gain, Length);
+		break;
+	case K_DUALSCALERAMPADD:
+		Table->DualScaleRampAdd(apfRole[LINPUT], apfRole[RINPUT], apfRole[LOUTPUT], apfRole[ROUTPUT], Gain, Step, -Step, Gain, Length);
+		break;
+	}
+}
+
+
+/* Which wirings make sense for a kernel: the ones that give its arguments different aliasing (the rest would only repeat a case). */
+static int
+usesWiring(int Kernel,
+	   unsigned long Wiring) {
+
+	switch (Kernel) {
+	case K_ZERO:
+	case K_STATS:
+	case K_ISSILENT:
+	case K_TRUEPEAK:	// (never in place: it reads the samples before each one)
+		return Wiring == 0;
+	case K_SCALE:
+	case K_SCALEADD:
+	case K_DBTOGAIN:
+	case K_SCALERAMP:
+	case K_SCALERAMPADD:
+		return Wiring <= 1;
+	case K_MULTIPLY:
+	case K_MULTIPLYADD:
+		return Wiring <= 1 || Wiring == 6;
+	case K_PANLAWGAINS:
+		return Wiring <= 3 || Wiring == 6;
+	default:
+		return 1;
+	}
+}
+
+
+/* Whether two results are the same bits, or both NaN (see cmekernels.h). */
+static int
+sameSample(LADSPA_Data Reference,
+	   LADSPA_Data Tested) {
+	return memcmp(&Reference, &Tested, sizeof(LADSPA_Data)) == 0 || (isnan(Reference) && isnan(Tested));
+}
+
+static int
+sameStats(const CMEStats * Reference,
+	  const CMEStats * Tested) {
+	return sameSample(Reference->Min, Tested->Min) && sameSample(Reference->Max, Tested->Max) && sameSample(Reference->SumOfSquares, Tested->SumOfSquares);
+}
+
+
+/* Report a difference between the reference and tested arenas, if there is one. */
+static void
+compareArenas(const CMEKernelTable * Table,
+	      int Kernel,
+	      unsigned long Wiring,
+	      unsigned long Offset,
+	      unsigned long Length,
+	      unsigned long Gain,
+	      int FTZ) {
+
+	unsigned long lRole, lIndex;
+	const char * pcWhat = NULL;
+	long lWhere = -1;
+
+	for (lRole = 0; lRole < CHECK_ROLES && !pcWhat; lRole++)
+		for (lIndex = 0; lIndex < CHECK_SPAN(Length); lIndex++)
+			if (!sameSample(g_sReference.Buffers[lRole][lIndex], g_sTested.Buffers[lRole][lIndex])) {
+				pcWhat = "buffer";
+				lWhere = (long)lRole * CHECK_STRIDE + (long)lIndex;
+				break;
+			}
+	if (!pcWhat && !sameStats(&g_sReference.LStats, &g_sTested.LStats))
+		pcWhat = "L statistics";
+	if (!pcWhat && !sameStats(&g_sReference.RStats, &g_sTested.RStats))
+		pcWhat = "R statistics";
+	if (!pcWhat && g_sReference.Silent != g_sTested.Silent)
+		pcWhat = "result";
+	if (!pcWhat)
+		return;
+
+	if (++g_lFailures <= CHECK_MAX_REPORTS) {
+		printf("%s %s differs: %s", Table->Name, g_apcKernelNames[Kernel], pcWhat);
+		if (lWhere >= 0) {
+			lRole = lWhere / CHECK_STRIDE;
+			lIndex = lWhere % CHECK_STRIDE;
+			printf(" %lu, sample %ld (%a, scalar %a)", lRole, (long)lIndex - CHECK_LEAD,
+			       g_sTested.Buffers[lRole][lIndex], g_sReference.Buffers[lRole][lIndex]);
+		}
+		printf("; %s, length %lu, offset %lu, gain %g, %s\n", g_asWirings[Wiring].Name, Length, Offset,
+		       g_afGains[Gain], FTZ ? "FTZ/DAZ" : "default FP mode");
+	}
+}
+
+
+/* Every case of every kernel for one kernel set.  Returns the number of cases run. */
+static unsigned long
+checkTable(const CMEKernelTable * Table) {
+
+	unsigned long lLengthIndex, lLength, lOffset, lWiring, lGain, lCases = 0;
+	unsigned long lDefaultMode = cmeReadFPMode();
+	int iKernel, iFTZ;
+	uint32_t uSeed = 1;
+
+	for (iFTZ = 0; iFTZ <= CME_HAVE_FTZ; iFTZ++)
+		for (lLengthIndex = 0; lLengthIndex <= CHECK_MAX_SHORT + CHECK_LONG_LENGTHS; lLengthIndex++) {
+			lLength = lLengthIndex <= CHECK_MAX_SHORT ? lLengthIndex : g_alLongLengths[lLengthIndex - CHECK_MAX_SHORT - 1];
+			for (iKernel = 0; iKernel < CHECK_KERNELS; iKernel++)
+				for (lOffset = 0; lOffset < CHECK_OFFSETS; lOffset++) {
+					fillSource(iKernel, lLength, nextRandom(&uSeed));
+					for (lWiring = 0; lWiring < CHECK_WIRINGS; lWiring++) {
+						if (!usesWiring(iKernel, lWiring))
+							continue;
+						// (One gain per case, in turn, so each length meets them all without multiplying the cases:)
+						lGain = (lLength + lOffset + lWiring) % CHECK_GAINS;
+						copySource(&g_sReference, lLength);
+						copySource(&g_sTested, lLength);
+						if (iFTZ)
+							cmeWriteFPMode(lDefaultMode | CME_FTZ_BITS | CME_DAZ_BITS);
+						runKernel(&g_sCMEKernelsScalar, &g_sReference, iKernel, &g_asWirings[lWiring], lOffset, lLength,
+							  g_afGains[lGain], g_afGains[(lGain + 3) % CHECK_GAINS] * 0.001f, g_asCMEPanLaws[lOffset % CME_PAN_LAWS].Segments);
+						runKernel(Table, &g_sTested, iKernel, &g_asWirings[lWiring], lOffset, lLength,
+							  g_afGains[lGain], g_afGains[(lGain + 3) % CHECK_GAINS] * 0.001f, g_asCMEPanLaws[lOffset % CME_PAN_LAWS].Segments);
+						cmeWriteFPMode(lDefaultMode);
+						compareArenas(Table, iKernel, lWiring, lOffset, lLength, lGain, iFTZ);
+						lCases++;
+					}
+				}
+		}
+	return lCases;
+}
+
+
+
+int
+main(int argc,
+     char ** argv) {
+
+	const CMEKernelTable * psTable;
+	unsigned long lIndex, lCases, lFailures;
+
+	cmePanLawsInit();
+
+	// (The scalar set is checked against itself too, which catches a kernel that depends on more than its arguments.)
+	for (lIndex = 0; (psTable = cmeKernelsAvailable(lIndex)) != NULL; lIndex++) {
+		lFailures = g_lFailures;
+		lCases = checkTable(psTable);
+		printf("%-8s %lu cases, %s\n", psTable->Name, lCases, g_lFailures == lFailures ? "ok" : "DIFFERS");
+	}
+	if (g_lFailures > CHECK_MAX_REPORTS)
+		printf("(%lu differences in all)\n", g_lFailures);
+	return g_lFailures ? 1 : 0;
+}
+
+
+/* EOF */
@@ -0,0 +1,809 @@
+/*
+LADSPA plugin implementing a convolution reverb: stereo in, stereo out, with no latency.
+
+The impulse response comes from the file named by the environment variable CME_CONV_IR (LADSPA control ports can only carry numbers, so the name can't come from a control), which must hold raw native-endian 32-bit floats at the host's sample rate, one channel, used for both sides; at most CONV_MAX_IR_SECONDS are used.  If it isn't set, or can't be read, each side gets its own few seconds of exponentially decaying noise, which makes a passable (and decorrelated) plate.
+
+The impulse response is split into three parts, so that run()'s worst case stays the same however long it is:
+
+  direct	the first CONV_BLOCK taps, convolved sample by sample in run() (along time, so it vectorises), which is what makes the plugin latency-free.
+  head		the rest of the first CONV_HEAD_LENGTH taps, as uniform partitions of CONV_BLOCK, convolved in run() every CONV_BLOCK samples with a 2 * CONV_BLOCK point real FFT (overlap-save, with a frequency-domain delay line of input spectra).
+  tail		everything after that, as partitions of CONV_TAIL_BLOCK, convolved the same way on a worker thread started in activate().
+
+The tail starts CONV_TAIL_DELAY tail blocks into the impulse response, so each tail block of output can be rendered from input that is complete CONV_TAIL_DELAY - 1 blocks (about 43 ms at 48 kHz) before it is due.  Nothing is locked: run() copies its input into a ring that the worker reads, bumps a counter and posts a semaphore; the worker writes each finished block into one of CONV_TAIL_SLOTS output slots and then stamps the slot with the block's number.  At the start of each tail block run() uses the slot only if the stamp matches, and otherwise leaves the tail out of that block.  If the worker falls so far behind that run() may have overwritten the input it needs, it empties its delay line and starts again from the newest block, so a stalled worker costs a gap in the tail but never disturbs run().
+
+That makes the output depend on timing, which is right for a live host but not for an offline one, which calls run() as fast as it can: there most of the tail would go missing, and differently every time.  So if CME_OFFLINE_ENV is set when the plugin is instantiated (see cmeplugins.h), run() instead waits at the start of each tail block until the worker has stamped its slot (on a second semaphore, which the worker posts after each block), and the worker never skips ahead; as run() then can't get round the input ring to a block the worker still needs, every tail block is rendered and used, and the output is the same from run to run.  (If the worker can't be started, offline run() renders the tail blocks itself.)
+
+Silence: once the input has been silent for as long as the impulse response, plus the tail's delay and the worker's input ring (QuietLimit samples), every delay line, every spectrum in the histories and every block of output still to come is exactly zero.  From then on, runs of silent input (checked with the IsSilent kernel) produce silence without touching the lines: run() only keeps count of its position, so the blocks fall where they would have, and at each tail block it records that the blocks so far need no rendering instead of waking the worker.  When the input comes back the worker skips straight to the first block it needs, and run() (offline) only waits for blocks that are rendered, so the output is the same as if everything had been run, and silence costs a read of the input.
+
+Everything is allocated in instantiate(): about 8 bytes per tap per side for the spectra, so roughly 4 MB for a 5 s impulse response at 48 kHz.
+
+CME 2026-10
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "ladspa.h"
+#include "cmefft.h"
+#include "cmedenormal.h"
+#include "cmekernels.h"
+#include "cmeplugins.h"
+
+
+
+#define CMECONV_LADSPA_ID	71
+
+#define CMECONV_PORT_COUNT	5
+
+/* The internal ID numbers for the plugin's ports: */
+#define CONV_MIX	0
+#define CONV_INPUT1	1
+#define CONV_OUTPUT1	2
+#define CONV_INPUT2	3
+#define CONV_OUTPUT2	4
+
+#define CONV_CHANNELS	2
+
+/* Partition sizes (see the note at the top); both must be powers of two. */
+#define CONV_BLOCK	64
+#define CONV_TAIL_BLOCK	1024
+#define CONV_BLOCKS_PER_TAIL_BLOCK	(CONV_TAIL_BLOCK / CONV_BLOCK)
+
+/* Tail blocks between the start of the impulse response and the start of the tail, and so the length of the part done in run(). */
+#define CONV_TAIL_DELAY	3
+#define CONV_HEAD_LENGTH	(CONV_TAIL_DELAY * CONV_TAIL_BLOCK)
+#define CONV_HEAD_PARTITIONS	(CONV_HEAD_LENGTH / CONV_BLOCK - 1)
+
+/* Tail blocks held by the worker's input ring and output slots (powers of two, > CONV_TAIL_DELAY). */
+#define CONV_TAIL_RING_BLOCKS	4
+#define CONV_TAIL_SLOTS	4
+
+#define CONV_IR_ENV	"CME_CONV_IR"
+#define CONV_MAX_IR_SECONDS	30
+
+/* The built-in impulse response: noise decaying by 60 dB over this long. */
+#define CONV_DEFAULT_IR_SECONDS	2.5
+
+#define CONV_NO_SLOT	(~0UL)
+
+
+/* The tail's contribution while its block isn't ready. */
+static const LADSPA_Data g_afConvSilence[CONV_BLOCK];
+
+
+
+/* State for one side. */
+
+typedef struct {
+	// run()'s:
+	LADSPA_Data Window[2 * CONV_BLOCK];	// The previous block of input, then the current one
+	LADSPA_Data HeadOutput[CONV_BLOCK];	// The head partitions' output for the current block
+	LADSPA_Data Direct[CONV_BLOCK];		// The first CONV_BLOCK taps
+	LADSPA_Data * HeadSpectra;		// HeadPartitions impulse response spectra (including the FFT's scaling)
+	LADSPA_Data * HeadHistory;		// HeadPartitions input spectra, one per block, as a ring
+
+	// Shared with the worker:
+	LADSPA_Data * TailInput;		// CONV_TAIL_RING_BLOCKS tail blocks of input, as a ring
+	LADSPA_Data * TailOutput;		// CONV_TAIL_SLOTS tail blocks of output
+
+	// The worker's:
+	LADSPA_Data * TailSpectra;		// TailPartitions impulse response spectra
+	LADSPA_Data * TailHistory;		// TailPartitions input spectra, as a ring
+} ConvChannel;
+
+
+/* The structure used to hold port connection information and state. */
+
+typedef struct {
+	LADSPA_Data * Mix;
+	LADSPA_Data * InputBuffer[CONV_CHANNELS];
+	LADSPA_Data * OutputBuffer[CONV_CHANNELS];
+
+	LADSPA_Data RunAddingGain;
+
+	ConvChannel Channel[CONV_CHANNELS];
+	CMEFFT * HeadFFT;
+	CMEFFT * TailFFT;
+	unsigned long HeadPartitions;		// (up to CONV_HEAD_PARTITIONS)
+	unsigned long TailPartitions;		// 0 if the impulse response is no longer than CONV_HEAD_LENGTH
+
+	// run()'s position:
+	unsigned long Fill;			// Samples of the current block received so far
+	unsigned long Blocks;			// Blocks completed since activate()
+	unsigned long HeadSlot;			// Where the next input spectrum goes in HeadHistory
+	unsigned long TailSlot;			// Output slot for the current tail block, or CONV_NO_SLOT
+	int Offline;				// Wait for the tail rather than leave it out (CME_OFFLINE_ENV)
+	unsigned long QuietSamples;		// Samples of silent input in a row (up to QuietLimit)
+	unsigned long QuietLimit;		// ...after which everything is zero (see "Silence" above)
+
+	// Handoff to and from the worker (only touched with __atomic builtins):
+	unsigned long TailBlocksIn;		// Tail blocks of input completed
+	unsigned long SlotBlock[CONV_TAIL_SLOTS];	// The tail block each output slot holds
+	unsigned long TailQuietBlocks;		// Tail blocks before this one were silent, and aren't rendered
+	int WorkerQuit;
+
+	pthread_t Worker;
+	sem_t WorkerWake;
+	sem_t TailDone;				// Posted after each tail block, when Offline
+	int WorkerRunning;
+
+	// Worker scratch:
+	LADSPA_Data * TailWindow;		// 2 * CONV_TAIL_BLOCK
+	LADSPA_Data * TailSum;			// Sum of the partitions' products
+	unsigned long TailHistorySlot;
+} Conv;
+
+
+void
+cleanupConv(LADSPA_Handle Instance);
+
+static void
+stopWorker(Conv * psConv);
+
+static void *
+convWorker(void * Arg);
+
+
+
+/* Read the impulse response named by CONV_IR_ENV into a new buffer; returns its length, or 0 (and NULL) if there isn't one. */
+static unsigned long
+readImpulseResponse(unsigned long SampleRate,
+		    LADSPA_Data ** Buffer) {
+
+	const char * pcPath = getenv(CONV_IR_ENV);
+	FILE * psFile;
+	long lBytes;
+	unsigned long lLength = 0;
+
+	*Buffer = NULL;
+	if (!pcPath || !*pcPath)
+		return 0;
+	psFile = fopen(pcPath, "rb");
+	if (!psFile)
+		return 0;
+	if (fseek(psFile, 0, SEEK_END) == 0 && (lBytes = ftell(psFile)) > 0 && fseek(psFile, 0, SEEK_SET) == 0) {
+		lLength = lBytes / sizeof(LADSPA_Data);
+		if (lLength > CONV_MAX_IR_SECONDS * SampleRate)
+			lLength = CONV_MAX_IR_SECONDS * SampleRate;
+		*Buffer = (LADSPA_Data *)malloc(lLength * sizeof(LADSPA_Data));
+		if (!*Buffer || fread(*Buffer, sizeof(LADSPA_Data), lLength, psFile) != lLength) {
+			free(*Buffer);
+			*Buffer = NULL;
+			lLength = 0;
+		}
+	}
+	fclose(psFile);
+	return lLength;
+}
+
+
+/* Fill Buffer with Length samples of noise decaying by 60 dB, with unit energy (so the reverb is about as loud as the input). */
+static void
+makeImpulseResponse(LADSPA_Data * Buffer,
+		    unsigned long Length,
+		    unsigned long Seed) {
+
+	unsigned long lIndex;
+	double dDecay = pow(0.001, 1.0 / Length);
+	double dGain = 1;
+	double dEnergy = 0;
+	double dScale;
+
+	for (lIndex = 0; lIndex < Length; lIndex++) {
+		Seed = (Seed * 1664525 + 1013904223) & 0xFFFFFFFF;
+		Buffer[lIndex] = dGain * ((double)Seed / 2147483648.0 - 1.0);
+		dEnergy += Buffer[lIndex] * Buffer[lIndex];
+		dGain *= dDecay;
+	}
+	dScale = 1 / sqrt(dEnergy);
+	for (lIndex = 0; lIndex < Length; lIndex++)
+		Buffer[lIndex] *= dScale;
+}
+
+
+/* Spectra of Count partitions of Size taps, starting at IR[Start] (zero beyond IR[Length - 1]), into Spectra, scaled to undo the FFT's gain. */
+static void
+partitionSpectra(const CMEFFT * psFFT,
+		 const LADSPA_Data * IR,
+		 unsigned long Length,
+		 unsigned long Start,
+		 unsigned long Size,
+		 unsigned long Count,
+		 LADSPA_Data * Spectra,
+		 LADSPA_Data * Scratch) {
+
+	unsigned long lPartition, lIndex, lTaps;
+
+	for (lPartition = 0; lPartition < Count; lPartition++) {
+		memset(Scratch, 0, 2 * Size * sizeof(LADSPA_Data));
+		lTaps = Length - Start - lPartition * Size;
+		if (lTaps > Size)
+			lTaps = Size;
+		for (lIndex = 0; lIndex < lTaps; lIndex++)
+			Scratch[lIndex] = IR[Start + lPartition * Size + lIndex] / Size;
+		cmeFFTForward(psFFT, Scratch, Spectra + lPartition * CME_FFT_SPECTRUM_SIZE(2 * Size));
+	}
+}
+
+
+/* Construct a new plugin instance: load the impulse response and transform it. */
+LADSPA_Handle
+instantiateConv(const LADSPA_Descriptor * Descriptor,
+		unsigned long             SampleRate) {
+
+	Conv * psConv;
+	ConvChannel * psChannel;
+	LADSPA_Data * apfIR[CONV_CHANNELS];
+	LADSPA_Data * pfScratch;
+	unsigned long lLength, lChannel, lIndex;
+	unsigned long lHeadSpectrum = CME_FFT_SPECTRUM_SIZE(2 * CONV_BLOCK);
+	unsigned long lTailSpectrum = CME_FFT_SPECTRUM_SIZE(2 * CONV_TAIL_BLOCK);
+	int iFailed = 0;
+
+	psConv = (Conv *)calloc(1, sizeof(Conv));
+	if (!psConv)
+		return NULL;
+	psConv->RunAddingGain = 1;
+	psConv->Offline = getenv(CME_OFFLINE_ENV) != NULL;
+
+	lLength = readImpulseResponse(SampleRate, &apfIR[0]);
+	if (lLength) {
+		apfIR[1] = apfIR[0];
+	}
+	else {
+		lLength = (unsigned long)(CONV_DEFAULT_IR_SECONDS * SampleRate);
+		apfIR[0] = (LADSPA_Data *)malloc(CONV_CHANNELS * lLength * sizeof(LADSPA_Data));
+		if (!apfIR[0]) {
+			free(psConv);
+			return NULL;
+		}
+		for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+			apfIR[lChannel] = apfIR[0] + lChannel * lLength;
+			makeImpulseResponse(apfIR[lChannel], lLength, 12345 + lChannel);
+		}
+	}
+
+	psConv->HeadPartitions = lLength > CONV_BLOCK ? (lLength - CONV_BLOCK + CONV_BLOCK - 1) / CONV_BLOCK : 0;
+	if (psConv->HeadPartitions > CONV_HEAD_PARTITIONS)
+		psConv->HeadPartitions = CONV_HEAD_PARTITIONS;
+	psConv->TailPartitions = lLength > CONV_HEAD_LENGTH ? (lLength - CONV_HEAD_LENGTH + CONV_TAIL_BLOCK - 1) / CONV_TAIL_BLOCK : 0;
+	psConv->QuietLimit = CONV_HEAD_LENGTH + (psConv->TailPartitions + 1 + CONV_TAIL_DELAY + CONV_TAIL_RING_BLOCKS) * CONV_TAIL_BLOCK;
+
+	psConv->HeadFFT = cmeFFTCreate(2 * CONV_BLOCK);
+	psConv->TailFFT = cmeFFTCreate(2 * CONV_TAIL_BLOCK);
+	psConv->TailWindow = (LADSPA_Data *)malloc(2 * CONV_TAIL_BLOCK * sizeof(LADSPA_Data));
+	psConv->TailSum = (LADSPA_Data *)malloc(lTailSpectrum * sizeof(LADSPA_Data));
+	pfScratch = psConv->TailWindow;
+	iFailed = !psConv->HeadFFT || !psConv->TailFFT || !psConv->TailWindow || !psConv->TailSum;
+
+	for (lChannel = 0; lChannel < CONV_CHANNELS && !iFailed; lChannel++) {
+		psChannel = &psConv->Channel[lChannel];
+		psChannel->HeadSpectra = (LADSPA_Data *)malloc((psConv->HeadPartitions + 1) * lHeadSpectrum * sizeof(LADSPA_Data));
+		psChannel->HeadHistory = (LADSPA_Data *)calloc((psConv->HeadPartitions + 1) * lHeadSpectrum, sizeof(LADSPA_Data));
+		psChannel->TailInput = (LADSPA_Data *)calloc(CONV_TAIL_RING_BLOCKS * CONV_TAIL_BLOCK, sizeof(LADSPA_Data));
+		psChannel->TailOutput = (LADSPA_Data *)calloc(CONV_TAIL_SLOTS * CONV_TAIL_BLOCK, sizeof(LADSPA_Data));
+		psChannel->TailSpectra = (LADSPA_Data *)malloc((psConv->TailPartitions + 1) * lTailSpectrum * sizeof(LADSPA_Data));
+		psChannel->TailHistory = (LADSPA_Data *)calloc((psConv->TailPartitions + 1) * lTailSpectrum, sizeof(LADSPA_Data));
+		if (!psChannel->HeadSpectra || !psChannel->HeadHistory || !psChannel->TailInput || !psChannel->TailOutput || !psChannel->TailSpectra || !psChannel->TailHistory) {
+			iFailed = 1;
+			break;
+		}
+
+		for (lIndex = 0; lIndex < CONV_BLOCK; lIndex++)
+			psChannel->Direct[lIndex] = lIndex < lLength ? apfIR[lChannel][lIndex] : 0;
+		partitionSpectra(psConv->HeadFFT, apfIR[lChannel], lLength, CONV_BLOCK, CONV_BLOCK, psConv->HeadPartitions, psChannel->HeadSpectra, pfScratch);
+		partitionSpectra(psConv->TailFFT, apfIR[lChannel], lLength, CONV_HEAD_LENGTH, CONV_TAIL_BLOCK, psConv->TailPartitions, psChannel->TailSpectra, pfScratch);
+	}
+
+	free(apfIR[0]);
+	if (iFailed) {
+		cleanupConv(psConv);
+		return NULL;
+	}
+	return psConv;
+}
+
+
+/* Empty the delay lines and start the worker (if there is a tail). */
+void
+activateConv(LADSPA_Handle Instance) {
+
+	Conv * psConv;
+	ConvChannel * psChannel;
+	unsigned long lChannel, lSlot;
+
+	psConv = (Conv *)Instance;
+	stopWorker(psConv);
+
+	for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+		psChannel = &psConv->Channel[lChannel];
+		memset(psChannel->Window, 0, sizeof(psChannel->Window));
+		memset(psChannel->HeadOutput, 0, sizeof(psChannel->HeadOutput));
+		memset(psChannel->HeadHistory, 0, psConv->HeadPartitions * CME_FFT_SPECTRUM_SIZE(2 * CONV_BLOCK) * sizeof(LADSPA_Data));
+		memset(psChannel->TailInput, 0, CONV_TAIL_RING_BLOCKS * CONV_TAIL_BLOCK * sizeof(LADSPA_Data));
+		memset(psChannel->TailHistory, 0, psConv->TailPartitions * CME_FFT_SPECTRUM_SIZE(2 * CONV_TAIL_BLOCK) * sizeof(LADSPA_Data));
+	}
+	psConv->Fill = 0;
+	psConv->Blocks = 0;
+	psConv->HeadSlot = 0;
+	psConv->TailSlot = CONV_NO_SLOT;
+	psConv->TailHistorySlot = 0;
+	psConv->TailBlocksIn = 0;
+	psConv->TailQuietBlocks = 0;
+	psConv->QuietSamples = psConv->QuietLimit;	// (the lines are empty)
+	for (lSlot = 0; lSlot < CONV_TAIL_SLOTS; lSlot++)
+		psConv->SlotBlock[lSlot] = CONV_NO_SLOT;
+
+	if (psConv->TailPartitions) {
+		psConv->WorkerQuit = 0;
+		if (sem_init(&psConv->WorkerWake, 0, 0) == 0) {
+			if (sem_init(&psConv->TailDone, 0, 0) != 0)
+				sem_destroy(&psConv->WorkerWake);
+			else if (pthread_create(&psConv->Worker, NULL, convWorker, psConv) == 0)
+				psConv->WorkerRunning = 1;
+			else {
+				sem_destroy(&psConv->TailDone);
+				sem_destroy(&psConv->WorkerWake);
+			}
+		}
+		// (if the worker couldn't be started, the tail is simply left out, or offline rendered by run())
+	}
+}
+
+
+/* Stop the worker, if it's running. */
+static void
+stopWorker(Conv * psConv) {
+
+	if (!psConv->WorkerRunning)
+		return;
+	__atomic_store_n(&psConv->WorkerQuit, 1, __ATOMIC_RELEASE);
+	sem_post(&psConv->WorkerWake);
+	pthread_join(psConv->Worker, NULL);
+	sem_destroy(&psConv->TailDone);
+	sem_destroy(&psConv->WorkerWake);
+	psConv->WorkerRunning = 0;
+}
+
+
+void
+deactivateConv(LADSPA_Handle Instance) {
+	stopWorker((Conv *)Instance);
+}
+
+
+/* Connect a port to a data location. */
+void
+connectPortToConv(LADSPA_Handle Instance,
+		  unsigned long Port,
+		  LADSPA_Data * DataLocation) {
+
+	Conv * psConv;
+
+	psConv = (Conv *)Instance;
+	switch (Port) {
+		case CONV_MIX:
+			psConv->Mix = DataLocation;
+			break;
+		case CONV_INPUT1:
+			psConv->InputBuffer[0] = DataLocation;
+			break;
+		case CONV_OUTPUT1:
+			psConv->OutputBuffer[0] = DataLocation;
+			break;
+		case CONV_INPUT2:
+			psConv->InputBuffer[1] = DataLocation;
+			break;
+		case CONV_OUTPUT2:
+			psConv->OutputBuffer[1] = DataLocation;
+			break;
+	}
+}
+
+
+
+/* Sum += X * H, for split spectra of Bins bins.  Straight loops over bins, which the compiler vectorises. */
+static inline void
+multiplyAccumulate(LADSPA_Data * Sum,
+		   const LADSPA_Data * X,
+		   const LADSPA_Data * H,
+		   unsigned long Bins) {
+
+	LADSPA_Data * pfSumIm = Sum + Bins;
+	const LADSPA_Data * pfXIm = X + Bins;
+	const LADSPA_Data * pfHIm = H + Bins;
+	unsigned long lBin;
+
+	for (lBin = 0; lBin < Bins; lBin++) {
+		Sum[lBin] += X[lBin] * H[lBin] - pfXIm[lBin] * pfHIm[lBin];
+		pfSumIm[lBin] += X[lBin] * pfHIm[lBin] + pfXIm[lBin] * H[lBin];
+	}
+}
+
+
+/* Convolve a window of 2 * Size input samples (whose spectrum goes into History[Slot]) with Partitions partitions, newest input first, leaving the last Size samples of the result in Output. */
+static void
+convolvePartitions(const CMEFFT * psFFT,
+		   const LADSPA_Data * Window,
+		   LADSPA_Data * History,
+		   const LADSPA_Data * Spectra,
+		   unsigned long Partitions,
+		   unsigned long Slot,
+		   unsigned long Size,
+		   LADSPA_Data * Sum,
+		   LADSPA_Data * Output) {
+
+	unsigned long lSpectrum = CME_FFT_SPECTRUM_SIZE(2 * Size);
+	unsigned long lPartition;
+
+	cmeFFTForward(psFFT, Window, History + Slot * lSpectrum);
+
+	memset(Sum, 0, lSpectrum * sizeof(LADSPA_Data));
+	for (lPartition = 0; lPartition < Partitions; lPartition++) {
+		multiplyAccumulate(Sum, History + Slot * lSpectrum, Spectra + lPartition * lSpectrum, Size + 1);
+		Slot = Slot ? Slot - 1 : Partitions - 1;
+	}
+
+	cmeFFTInverse(psFFT, Sum, Output);
+}
+
+
+/* Render tail block Block of every channel into its output slot, and stamp the slot. */
+static void
+renderTailBlock(Conv * psConv,
+		unsigned long Block) {
+
+	ConvChannel * psChannel;
+	LADSPA_Data * pfResult = psConv->TailWindow;	// (reused once the window has been transformed)
+	unsigned long lSlot = (Block + CONV_TAIL_DELAY) & (CONV_TAIL_SLOTS - 1);
+	unsigned long lChannel;
+
+	for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+		psChannel = &psConv->Channel[lChannel];
+		memcpy(psConv->TailWindow, psChannel->TailInput + ((Block - 1) & (CONV_TAIL_RING_BLOCKS - 1)) * CONV_TAIL_BLOCK, CONV_TAIL_BLOCK * sizeof(LADSPA_Data));
+		memcpy(psConv->TailWindow + CONV_TAIL_BLOCK, psChannel->TailInput + (Block & (CONV_TAIL_RING_BLOCKS - 1)) * CONV_TAIL_BLOCK, CONV_TAIL_BLOCK * sizeof(LADSPA_Data));
+		convolvePartitions(psConv->TailFFT, psConv->TailWindow, psChannel->TailHistory, psChannel->TailSpectra, psConv->TailPartitions, psConv->TailHistorySlot, CONV_TAIL_BLOCK, psConv->TailSum, pfResult);
+		memcpy(psChannel->TailOutput + lSlot * CONV_TAIL_BLOCK, pfResult + CONV_TAIL_BLOCK, CONV_TAIL_BLOCK * sizeof(LADSPA_Data));
+	}
+	psConv->TailHistorySlot = psConv->TailHistorySlot + 1 < psConv->TailPartitions ? psConv->TailHistorySlot + 1 : 0;
+
+	__atomic_store_n(&psConv->SlotBlock[lSlot], Block + CONV_TAIL_DELAY, __ATOMIC_RELEASE);
+}
+
+
+/* The worker: render each tail block as run() completes its input (see the note at the top). */
+static void *
+convWorker(void * Arg) {
+
+	Conv * psConv = (Conv *)Arg;
+	unsigned long lNext = 0;
+	unsigned long lAvailable;
+	unsigned long lQuiet;
+	unsigned long lChannel;
+
+	cmeDenormalsOff();
+	for (;;) {
+		while (sem_wait(&psConv->WorkerWake) != 0 && errno == EINTR)
+			;
+		if (__atomic_load_n(&psConv->WorkerQuit, __ATOMIC_ACQUIRE))
+			break;
+
+		while (lNext < (lAvailable = __atomic_load_n(&psConv->TailBlocksIn, __ATOMIC_ACQUIRE))) {
+			// Blocks run() skipped as silent would render as zeros, into a delay line that is all zeros already:
+			lQuiet = __atomic_load_n(&psConv->TailQuietBlocks, __ATOMIC_ACQUIRE);
+			if (lNext < lQuiet) {
+				lNext = lQuiet;
+				continue;
+			}
+			// run() is writing block lAvailable into the input ring; once that reaches the blocks we read, start again from there with an empty delay line (offline, run() waits for us instead):
+			if (!psConv->Offline && lAvailable - lNext >= CONV_TAIL_RING_BLOCKS - 1) {
+				for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++)
+					memset(psConv->Channel[lChannel].TailHistory, 0, psConv->TailPartitions * CME_FFT_SPECTRUM_SIZE(2 * CONV_TAIL_BLOCK) * sizeof(LADSPA_Data));
+				lNext = lAvailable - 1;
+			}
+			renderTailBlock(psConv, lNext);
+			lNext++;
+			if (psConv->Offline)
+				sem_post(&psConv->TailDone);
+		}
+	}
+	return NULL;
+}
+
+
+/* Offline: wait until the worker has stamped the slot for tail block Block. */
+static void
+waitForTail(Conv * psConv,
+	    unsigned long Block) {
+	while (__atomic_load_n(&psConv->SlotBlock[Block & (CONV_TAIL_SLOTS - 1)], __ATOMIC_ACQUIRE) != Block)
+		while (sem_wait(&psConv->TailDone) != 0 && errno == EINTR)
+			;
+}
+
+
+/* The current block of input is complete: run the head partitions for the next block, pass the input to the worker, and pick up the tail for the next block. */
+static void
+endBlock(Conv * psConv) {
+
+	LADSPA_Data afSum[CME_FFT_SPECTRUM_SIZE(2 * CONV_BLOCK)];
+	LADSPA_Data afResult[2 * CONV_BLOCK];
+	ConvChannel * psChannel;
+	unsigned long lChannel;
+	unsigned long lTailBlock;
+	unsigned long lBlockInTail = psConv->Blocks & (CONV_BLOCKS_PER_TAIL_BLOCK - 1);
+	int iTail = psConv->WorkerRunning || (psConv->Offline && psConv->TailPartitions);
+
+	for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+		psChannel = &psConv->Channel[lChannel];
+
+		if (psConv->HeadPartitions) {
+			convolvePartitions(psConv->HeadFFT, psChannel->Window, psChannel->HeadHistory, psChannel->HeadSpectra, psConv->HeadPartitions, psConv->HeadSlot, CONV_BLOCK, afSum, afResult);
+			memcpy(psChannel->HeadOutput, afResult + CONV_BLOCK, CONV_BLOCK * sizeof(LADSPA_Data));
+		}
+
+		if (iTail)
+			memcpy(psChannel->TailInput + ((psConv->Blocks * CONV_BLOCK) & (CONV_TAIL_RING_BLOCKS * CONV_TAIL_BLOCK - 1)), psChannel->Window + CONV_BLOCK, CONV_BLOCK * sizeof(LADSPA_Data));
+
+		memcpy(psChannel->Window, psChannel->Window + CONV_BLOCK, CONV_BLOCK * sizeof(LADSPA_Data));
+	}
+	psConv->HeadSlot = psConv->HeadSlot + 1 < psConv->HeadPartitions ? psConv->HeadSlot + 1 : 0;
+	psConv->Blocks++;
+
+	if (iTail && lBlockInTail == CONV_BLOCKS_PER_TAIL_BLOCK - 1) {
+		lTailBlock = psConv->Blocks / CONV_BLOCKS_PER_TAIL_BLOCK;
+		if (!psConv->WorkerRunning)
+			renderTailBlock(psConv, lTailBlock - 1);	// (offline, without a worker)
+		else {
+			__atomic_store_n(&psConv->TailBlocksIn, lTailBlock, __ATOMIC_RELEASE);
+			sem_post(&psConv->WorkerWake);
+			// (the first tail block due is CONV_TAIL_DELAY, or that many after a silence)
+			if (psConv->Offline && lTailBlock >= __atomic_load_n(&psConv->TailQuietBlocks, __ATOMIC_RELAXED) + CONV_TAIL_DELAY)
+				waitForTail(psConv, lTailBlock);
+		}
+
+		if (__atomic_load_n(&psConv->SlotBlock[lTailBlock & (CONV_TAIL_SLOTS - 1)], __ATOMIC_ACQUIRE) == lTailBlock)
+			psConv->TailSlot = lTailBlock & (CONV_TAIL_SLOTS - 1);
+		else
+			psConv->TailSlot = CONV_NO_SLOT;
+	}
+}
+
+
+/* The current block of input was silent, and everything is zero (see the note at the top): keep count, and note the tail blocks that needn't be rendered. */
+static void
+skipBlock(Conv * psConv) {
+
+	unsigned long lTailBlock;
+
+	psConv->HeadSlot = psConv->HeadSlot + 1 < psConv->HeadPartitions ? psConv->HeadSlot + 1 : 0;
+	psConv->Blocks++;
+	if ((psConv->Blocks & (CONV_BLOCKS_PER_TAIL_BLOCK - 1)) || !(psConv->WorkerRunning || (psConv->Offline && psConv->TailPartitions)))
+		return;
+
+	lTailBlock = psConv->Blocks / CONV_BLOCKS_PER_TAIL_BLOCK;
+	// Offline, the worker may still be rendering the blocks it was last given, from parts of the input ring run() can now get round to before it next waits:
+	if (psConv->Offline && psConv->WorkerRunning && lTailBlock >= __atomic_load_n(&psConv->TailQuietBlocks, __ATOMIC_RELAXED) + 2)
+		waitForTail(psConv, lTailBlock - 2 + CONV_TAIL_DELAY);
+	__atomic_store_n(&psConv->TailQuietBlocks, lTailBlock, __ATOMIC_RELEASE);
+	psConv->TailSlot = CONV_NO_SLOT;
+}
+
+
+/* Shared by run() and run_adding(): the output is the input and the reverb mixed according to the Mix control, times Gain, and either replaces or (if Adding) is added to the output buffers. */
+static inline void
+processConv(Conv * psConv,
+	    unsigned long SampleCount,
+	    LADSPA_Data Gain,
+	    int Adding) {
+
+	LADSPA_Data afWet[CONV_BLOCK];
+	LADSPA_Data fMix = *(psConv->Mix);
+	LADSPA_Data fDryGain, fWetGain, fTap, fOutput;
+	ConvChannel * psChannel;
+	const LADSPA_Data * pfInput;
+	const LADSPA_Data * pfDelayed;
+	const LADSPA_Data * pfTail;
+	LADSPA_Data * pfOutput;
+	unsigned long lDone, lCount, lChannel, lTap, lSampleIndex;
+	int iSilent;
+	CMEDenormalGuard sGuard;
+
+	cmeDenormalGuardEnter(&sGuard);
+	if (!(fMix >= 0))
+		fMix = 0;
+	if (fMix > 1)
+		fMix = 1;
+	fDryGain = (1 - fMix) * Gain;
+	fWetGain = fMix * Gain;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lCount) {
+		lCount = SampleCount - lDone < CONV_BLOCK - psConv->Fill ? SampleCount - lDone : CONV_BLOCK - psConv->Fill;
+		iSilent = g_sCMEKernels.IsSilent(psConv->InputBuffer[0] + lDone, lCount) && g_sCMEKernels.IsSilent(psConv->InputBuffer[1] + lDone, lCount);
+
+		// Silence into empty lines is silence out (the dry part included), and leaves them empty:
+		if (iSilent && psConv->QuietSamples >= psConv->QuietLimit) {
+			if (!Adding)
+				for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++)
+					g_sCMEKernels.Zero(psConv->OutputBuffer[lChannel] + lDone, lCount);
+			psConv->Fill += lCount;
+			if (psConv->Fill == CONV_BLOCK) {
+				skipBlock(psConv);
+				psConv->Fill = 0;
+			}
+			continue;
+		}
+		if (!iSilent)
+			psConv->QuietSamples = 0;
+		else if ((psConv->QuietSamples += lCount) > psConv->QuietLimit)
+			psConv->QuietSamples = psConv->QuietLimit;
+
+		// Taking a copy of both inputs first also means the host can connect an output to the same buffer as either input:
+		for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++)
+			memcpy(psConv->Channel[lChannel].Window + CONV_BLOCK + psConv->Fill, psConv->InputBuffer[lChannel] + lDone, lCount * sizeof(LADSPA_Data));
+
+		for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+			psChannel = &psConv->Channel[lChannel];
+			pfInput = psChannel->Window + CONV_BLOCK + psConv->Fill;
+			pfOutput = psConv->OutputBuffer[lChannel] + lDone;
+			if (psConv->TailSlot == CONV_NO_SLOT)
+				pfTail = g_afConvSilence;
+			else
+				pfTail = psChannel->TailOutput + psConv->TailSlot * CONV_TAIL_BLOCK + (psConv->Blocks & (CONV_BLOCKS_PER_TAIL_BLOCK - 1)) * CONV_BLOCK + psConv->Fill;
+
+			for (lSampleIndex = 0; lSampleIndex < lCount; lSampleIndex++)
+				afWet[lSampleIndex] = psChannel->HeadOutput[psConv->Fill + lSampleIndex] + pfTail[lSampleIndex];
+			// The direct taps, one at a time across the whole run of samples:
+			for (lTap = 0; lTap < CONV_BLOCK; lTap++) {
+				fTap = psChannel->Direct[lTap];
+				pfDelayed = pfInput - lTap;
+				for (lSampleIndex = 0; lSampleIndex < lCount; lSampleIndex++)
+					afWet[lSampleIndex] += fTap * pfDelayed[lSampleIndex];
+			}
+
+			for (lSampleIndex = 0; lSampleIndex < lCount; lSampleIndex++) {
+				fOutput = fDryGain * pfInput[lSampleIndex] + fWetGain * afWet[lSampleIndex];
+				if (Adding)
+					pfOutput[lSampleIndex] += fOutput;
+				else
+					pfOutput[lSampleIndex] = fOutput;
+			}
+		}
+
+		psConv->Fill += lCount;
+		if (psConv->Fill == CONV_BLOCK) {
+			endBlock(psConv);
+			psConv->Fill = 0;
+		}
+	}
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+void
+runConv(LADSPA_Handle Instance,
+	unsigned long SampleCount) {
+	processConv((Conv *)Instance, SampleCount, 1, 0);
+}
+
+
+void
+setConvRunAddingGain(LADSPA_Handle Instance,
+		     LADSPA_Data Gain) {
+	((Conv *)Instance)->RunAddingGain = Gain;
+}
+
+
+void
+runAddingConv(LADSPA_Handle Instance,
+	      unsigned long SampleCount) {
+	processConv((Conv *)Instance, SampleCount, ((Conv *)Instance)->RunAddingGain, 1);
+}
+
+
+/* Stop the worker and throw everything away. */
+void
+cleanupConv(LADSPA_Handle Instance) {
+
+	Conv * psConv;
+	ConvChannel * psChannel;
+	unsigned long lChannel;
+
+	psConv = (Conv *)Instance;
+	stopWorker(psConv);
+	for (lChannel = 0; lChannel < CONV_CHANNELS; lChannel++) {
+		psChannel = &psConv->Channel[lChannel];
+		free(psChannel->HeadSpectra);
+		free(psChannel->HeadHistory);
+		free(psChannel->TailInput);
+		free(psChannel->TailOutput);
+		free(psChannel->TailSpectra);
+		free(psChannel->TailHistory);
+	}
+	free(psConv->TailWindow);
+	free(psConv->TailSum);
+	cmeFFTDestroy(psConv->HeadFFT);
+	cmeFFTDestroy(psConv->TailFFT);
+	free(psConv);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiConvPortDescriptors[CMECONV_PORT_COUNT] = {
+	[CONV_MIX] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[CONV_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[CONV_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[CONV_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[CONV_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO
+};
+
+static const char * const g_apcConvPortNames[CMECONV_PORT_COUNT] = {
+	[CONV_MIX] = "Mix (dry/wet)",
+	[CONV_INPUT1] = "Input (Left)",
+	[CONV_OUTPUT1] = "Output (Left)",
+	[CONV_INPUT2] = "Input (Right)",
+	[CONV_OUTPUT2] = "Output (Right)"
+};
+
+static const LADSPA_PortRangeHint g_asConvPortRangeHints[CMECONV_PORT_COUNT] = {
+	[CONV_MIX] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_LOW,
+		0, 1
+	}
+};
+
+
+const LADSPA_Descriptor g_sConvDescriptor = {
+	.UniqueID = CMECONV_LADSPA_ID,
+	.Label = "cme_conv",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Convolution Reverb (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMECONV_PORT_COUNT,
+	.PortDescriptors = g_aiConvPortDescriptors,
+	.PortNames = g_apcConvPortNames,
+	.PortRangeHints = g_asConvPortRangeHints,
+	.instantiate = instantiateConv,
+	.connect_port = connectPortToConv,
+	.activate = activateConv,
+	.run = runConv,
+	.run_adding = runAddingConv,
+	.set_run_adding_gain = setConvRunAddingGain,
+	.deactivate = deactivateConv,
+	.cleanup = cleanupConv
+};
+
+
+#ifndef CME_BUNDLE
+
+void
+_init() {
+	cmeKernelsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type (there's only one). */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+	/* Return the requested descriptor or null if the index is out of range. */
+	switch (Index) {
+	case 0:
+		return &g_sConvDescriptor;
+	default:
+		return NULL;
+	}
+}
+
+#endif /* CME_BUNDLE */
+
+
+/* EOF */
@@ -0,0 +1,120 @@
+/*
+Denormal (subnormal number) protection for the CME plugins.
+
+Anything with feedback (reverb lines, filters, the mesh) decays exponentially once its input stops, and after a few seconds its state reaches the subnormal range below about 1e-38.  Most x86 CPUs handle subnormal operands in microcode, so that is when run() suddenly gets tens of times slower (about 50 times for the FDN reverb; see the decay case of "make bench"), over silence, just when nobody expects any load.
+
+So the run() of every plugin with state sets the FPU to flush subnormal results to zero (FTZ) and treat subnormal inputs as zero (DAZ) for its duration, and puts back the host's setting on the way out:
+
+	CMEDenormalGuard sGuard;
+	cmeDenormalGuardEnter(&sGuard);
+	...
+	cmeDenormalGuardLeave(&sGuard);
+
+On x86 this is the MXCSR register (which covers SSE floats and doubles), and on AArch64 the FZ bit of FPCR.  The register is only written if the mode actually needs changing, but hosts normally leave FTZ off, so in practice that is two writes per run(), about 7 ns altogether here.  That is lost in the noise for the reverbs and meters, but would double the cost of the stateless gain, pan and balance plugins at a block size of 1, and they have no feedback to protect (their output can only be subnormal if their input is), so they don't use it.  Our own worker threads call cmeDenormalsOff() once when they start.  Flushing only changes results that are below -750 dBFS anyway.
+
+Where the mode can't be set (CME_HAVE_FTZ is 0, e.g. x87-only builds), the guard does nothing, and the plugins with feedback instead add a constant CME_DENORMAL_BIAS (-400 dB, far below anything audible) to what they feed into it, using cmeDenormalBias(), so their state settles there rather than decaying into the subnormals.  Where FTZ is available cmeDenormalBias() compiles to nothing.
+
+CME 2026-10
+*/
+
+#ifndef CMEDENORMAL_H
+#define CMEDENORMAL_H
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define CME_HAVE_FTZ	1
+#define CME_FTZ_BITS	0x8000		// MXCSR flush-to-zero
+#ifdef __SSE2__
+#define CME_DAZ_BITS	0x0040		// MXCSR denormals-are-zero (not on the very first SSE CPUs)
+#else
+#define CME_DAZ_BITS	0
+#endif
+#elif defined(__aarch64__)
+#define CME_HAVE_FTZ	1
+#define CME_FTZ_BITS	(1u << 24)	// FPCR.FZ, which flushes inputs and results
+#define CME_DAZ_BITS	0
+#else
+#define CME_HAVE_FTZ	0
+#endif
+
+
+/* 1e-20, i.e. -400 dB. */
+#define CME_DENORMAL_BIAS	1e-20f
+
+
+typedef struct {
+	unsigned long Saved;		// The mode on entry
+} CMEDenormalGuard;
+
+
+/* The floating-point control register, or 0 if we can't change it. */
+static inline unsigned long
+cmeReadFPMode(void) {
+#if defined(__SSE__) || defined(__x86_64__)
+	return _mm_getcsr();
+#elif defined(__aarch64__)
+	unsigned long lMode;
+	__asm__ __volatile__ ("mrs %0, fpcr" : "=r" (lMode));
+	return lMode;
+#else
+	return 0;
+#endif
+}
+
+
+static inline void
+cmeWriteFPMode(unsigned long Mode) {
+#if defined(__SSE__) || defined(__x86_64__)
+	_mm_setcsr((unsigned int)Mode);
+#elif defined(__aarch64__)
+	__asm__ __volatile__ ("msr fpcr, %0" : : "r" (Mode));
+#else
+	(void)Mode;
+#endif
+}
+
+
+/* Turn on FTZ (and DAZ) for the rest of this thread's life: for worker threads, which never run host code. */
+static inline void
+cmeDenormalsOff(void) {
+#if CME_HAVE_FTZ
+	cmeWriteFPMode(cmeReadFPMode() | CME_FTZ_BITS | CME_DAZ_BITS);
+#endif
+}
+
+
+/* Turn on FTZ (and DAZ) until the matching cmeDenormalGuardLeave(). */
+static inline void
+cmeDenormalGuardEnter(CMEDenormalGuard * psGuard) {
+#if CME_HAVE_FTZ
+	psGuard->Saved = cmeReadFPMode();
+	if ((psGuard->Saved & (CME_FTZ_BITS | CME_DAZ_BITS)) != (CME_FTZ_BITS | CME_DAZ_BITS))
+		cmeWriteFPMode(psGuard->Saved | CME_FTZ_BITS | CME_DAZ_BITS);
+#else
+	psGuard->Saved = 0;
+#endif
+}
+
+
+/* Put back the mode saved by cmeDenormalGuardEnter(). */
+static inline void
+cmeDenormalGuardLeave(const CMEDenormalGuard * psGuard) {
+#if CME_HAVE_FTZ
+	if ((psGuard->Saved & (CME_FTZ_BITS | CME_DAZ_BITS)) != (CME_FTZ_BITS | CME_DAZ_BITS))
+		cmeWriteFPMode(psGuard->Saved);
+#endif
+}
+
+
+/* x, plus CME_DENORMAL_BIAS where the FPU can't flush subnormals itself.  For the inputs to feedback paths. */
+static inline float
+cmeDenormalBias(float x) {
+#if CME_HAVE_FTZ
+	return x;
+#else
+	return x + CME_DENORMAL_BIAS;
+#endif
+}
+
+
+#endif /* CMEDENORMAL_H */
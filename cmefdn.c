@@ -0,0 +1,542 @@
+/*
+LADSPA plugin implementing a feedback delay network (FDN) reverb: stereo in, stereo out.
+
+Eight delay lines of mutually unrelated lengths (31-74 ms at the default size) are fed back into each other through an 8x8 Hadamard matrix, which is orthogonal (lossless) and mixes every line into every other.  Each line has a one-pole damping filter in its feedback path, set (after Jot) so that the line loses 60 dB over the Decay time at low frequencies, and over Decay time * High-frequency decay at high frequencies.  The left input feeds the even lines and the right input the odd ones, and the outputs are taken from the line outputs with two different (orthogonal) sign patterns, so the reverb is decorrelated between L and R.
+
+Processing is done in blocks of FDN_BLOCK samples.  The shortest delay line is always at least that long, so the line outputs for a whole block are already in the delay lines before the block starts: each line is read and written as a contiguous run of samples, and the matrix is applied to whole blocks at a time (three butterfly stages, each an add and a subtract of two rows), which the compiler vectorises along time.  Only the damping filters, which are recursive, run sample by sample, and then with the eight lines interleaved so they don't wait on each other.
+
+The delay lines are power-of-two ring buffers, allocated in instantiate() for the largest room size: 8 x 8192 floats (256 kB) at 48 kHz.  Changing the room size changes the delay lengths immediately, which clicks, so it's best treated as a set-up control.
+
+Once the input has been silent long enough for the tail to die away completely (the denormal guard flushes it to exact zeros; several times the decay time, as that is -60 dB and the floor is about -760 dB), a whole trip round the rings has been written with zeros, and the network is known to be empty.  From then on, blocks of silent input (checked with the IsSilent kernel) produce silence without touching the lines, until the input comes back.
+
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+#include "cmemath.h"
+#include "cmedenormal.h"
+#include "cmeplugins.h"
+
+
+
+#define CMEFDN_LADSPA_ID	70
+
+#define CMEFDN_PORT_COUNT	8
+
+/* The internal ID numbers for the plugin's ports: */
+#define FDN_DECAY	0
+#define FDN_DAMPING	1
+#define FDN_SIZE	2
+#define FDN_MIX	3
+#define FDN_INPUT1	4
+#define FDN_OUTPUT1	5
+#define FDN_INPUT2	6
+#define FDN_OUTPUT2	7
+
+#define FDN_LINES	8
+#define FDN_BLOCK	64
+
+/* Range of the room size control (scales all the delay lengths): */
+#define FDN_MIN_SIZE	0.5
+#define FDN_MAX_SIZE	2.0
+
+
+/* Delay line lengths at room size 1 (ms). */
+static const LADSPA_Data g_afFDNDelays[FDN_LINES] = {
+	31.1, 37.3, 41.9, 45.7, 53.3, 59.9, 67.1, 73.7
+};
+
+/* Sign patterns (rows of the Hadamard matrix) for the inputs and outputs; the inputs alternate between L (even lines) and R (odd lines). */
+static const LADSPA_Data g_afFDNInputSigns[FDN_LINES] = { 1, 1, -1, -1, 1, 1, -1, -1 };
+static const LADSPA_Data g_afFDNLeftSigns[FDN_LINES] = { 1, -1, 1, -1, 1, -1, 1, -1 };
+static const LADSPA_Data g_afFDNRightSigns[FDN_LINES] = { 1, 1, -1, -1, -1, -1, 1, 1 };
+
+
+
+/* The structure used to hold port connection information and state
+   (the delay lines, the damping filters, and the coefficients, which are only recomputed when the controls move). */
+
+typedef struct {
+	LADSPA_Data * DecayTime;
+	LADSPA_Data * HFDecayRatio;
+	LADSPA_Data * RoomSize;
+	LADSPA_Data * Mix;
+	LADSPA_Data * InputBuffer1;
+	LADSPA_Data * OutputBuffer1;
+	LADSPA_Data * InputBuffer2;
+	LADSPA_Data * OutputBuffer2;
+
+	LADSPA_Data SampleRate;
+	LADSPA_Data RunAddingGain;
+
+	// Control values the coefficients were computed from:
+	LADSPA_Data LastDecayTime;
+	LADSPA_Data LastHFDecayRatio;
+	LADSPA_Data LastRoomSize;
+
+	unsigned long Delay[FDN_LINES];		// Samples
+	LADSPA_Data FeedbackGain[FDN_LINES];	// Damping filter numerator (including the matrix's 1/sqrt(8))
+	LADSPA_Data Pole[FDN_LINES];		// Damping filter pole
+	LADSPA_Data FilterState[FDN_LINES];
+
+	unsigned long RingMask;
+	unsigned long Position;			// Where the next sample is written, in every line
+	LADSPA_Data * Lines;			// FDN_LINES rings of RingMask + 1 samples, one after another
+	unsigned long QuietSamples;		// Zeros written to every line since anything else (capped at RingMask + 1, when the network is empty)
+} FDN;
+
+
+void
+cleanupFDN(LADSPA_Handle Instance);
+
+void
+activateFDN(LADSPA_Handle Instance);
+
+
+/* Construct a new plugin instance. */
+LADSPA_Handle
+instantiateFDN(const LADSPA_Descriptor * Descriptor,
+	       unsigned long             SampleRate) {
+
+	FDN * psFDN;
+	unsigned long lRingSize;
+
+	psFDN = (FDN *)calloc(1, sizeof(FDN));
+	if (!psFDN)
+		return NULL;
+
+	for (lRingSize = 1; lRingSize < (unsigned long)(g_afFDNDelays[FDN_LINES - 1] * FDN_MAX_SIZE * 0.001 * SampleRate) + 2; lRingSize *= 2)
+		;
+	psFDN->SampleRate = SampleRate;
+	psFDN->RunAddingGain = 1;
+	psFDN->RingMask = lRingSize - 1;
+	psFDN->Lines = (LADSPA_Data *)calloc(FDN_LINES * lRingSize, sizeof(LADSPA_Data));
+	if (!psFDN->Lines) {
+		cleanupFDN(psFDN);
+		return NULL;
+	}
+
+	activateFDN(psFDN);
+	return psFDN;
+}
+
+
+/* Empty the delay lines. */
+void
+activateFDN(LADSPA_Handle Instance) {
+
+	FDN * psFDN;
+
+	psFDN = (FDN *)Instance;
+	memset(psFDN->Lines, 0, FDN_LINES * (psFDN->RingMask + 1) * sizeof(LADSPA_Data));
+	memset(psFDN->FilterState, 0, sizeof(psFDN->FilterState));
+	psFDN->Position = 0;
+	psFDN->QuietSamples = 0;
+	psFDN->LastDecayTime = NAN;	// (forces the coefficients to be computed on the next run())
+}
+
+
+/* Connect a port to a data location. */
+void
+connectPortToFDN(LADSPA_Handle Instance,
+		 unsigned long Port,
+		 LADSPA_Data * DataLocation) {
+
+	FDN * psFDN;
+
+	psFDN = (FDN *)Instance;
+	switch (Port) {
+		case FDN_DECAY:
+			psFDN->DecayTime = DataLocation;
+			break;
+		case FDN_DAMPING:
+			psFDN->HFDecayRatio = DataLocation;
+			break;
+		case FDN_SIZE:
+			psFDN->RoomSize = DataLocation;
+			break;
+		case FDN_MIX:
+			psFDN->Mix = DataLocation;
+			break;
+		case FDN_INPUT1:
+			psFDN->InputBuffer1 = DataLocation;
+			break;
+		case FDN_OUTPUT1:
+			psFDN->OutputBuffer1 = DataLocation;
+			break;
+		case FDN_INPUT2:
+			psFDN->InputBuffer2 = DataLocation;
+			break;
+		case FDN_OUTPUT2:
+			psFDN->OutputBuffer2 = DataLocation;
+			break;
+	}
+}
+
+
+
+/* Recompute the delay lengths and damping filters if any of their controls have changed. */
+static void
+updateCoefficients(FDN * psFDN) {
+
+	LADSPA_Data fDecayTime = *(psFDN->DecayTime);
+	LADSPA_Data fRatio = *(psFDN->HFDecayRatio);
+	LADSPA_Data fSize = *(psFDN->RoomSize);
+	LADSPA_Data fAttenuation;	// dB lost per trip round the line
+	LADSPA_Data fPole;
+	unsigned long lLine;
+	unsigned long lDelay;
+
+	if (fDecayTime == psFDN->LastDecayTime && fRatio == psFDN->LastHFDecayRatio && fSize == psFDN->LastRoomSize)
+		return;
+	psFDN->LastDecayTime = fDecayTime;
+	psFDN->LastHFDecayRatio = fRatio;
+	psFDN->LastRoomSize = fSize;
+
+	if (!(fDecayTime >= 0.1f))
+		fDecayTime = 0.1f;
+	if (!(fRatio >= 0.1f))
+		fRatio = 0.1f;
+	if (fRatio > 1)
+		fRatio = 1;
+	if (!(fSize >= FDN_MIN_SIZE))
+		fSize = FDN_MIN_SIZE;
+	if (fSize > FDN_MAX_SIZE)
+		fSize = FDN_MAX_SIZE;
+
+	for (lLine = 0; lLine < FDN_LINES; lLine++) {
+		lDelay = (unsigned long)(g_afFDNDelays[lLine] * fSize * 0.001f * psFDN->SampleRate + 0.5f);
+		if (lDelay < FDN_BLOCK)		// (see the note at the top)
+			lDelay = FDN_BLOCK;
+		if (lDelay > psFDN->RingMask)
+			lDelay = psFDN->RingMask;
+		psFDN->Delay[lLine] = lDelay;
+
+		// Jot's absorption filter: g (1 - p) / (1 - p z^-1), with g giving the low-frequency decay and p chosen so the high-frequency decay time is Ratio times shorter.
+		fAttenuation = -60.0f * lDelay / (fDecayTime * psFDN->SampleRate);
+		fPole = (logf(10.0f) / 4.0f) * (fAttenuation / 20.0f) * (1.0f - 1.0f / (fRatio * fRatio));
+		if (fPole > 0.95f)
+			fPole = 0.95f;
+		psFDN->Pole[lLine] = fPole;
+		psFDN->FeedbackGain[lLine] = cmeDBToGain(fAttenuation) * (1.0f - fPole) * 0.35355339f;	// (1/sqrt(8) normalises the Hadamard matrix)
+	}
+}
+
+
+/* Read FDN_LINES runs of Count samples, each starting Delay[line] samples back, into Rows (FDN_BLOCK apart). */
+static void
+readLines(const FDN * psFDN,
+	  LADSPA_Data * Rows,
+	  unsigned long Count) {
+
+	unsigned long lRingSize = psFDN->RingMask + 1;
+	unsigned long lLine, lStart, lFirst;
+
+	for (lLine = 0; lLine < FDN_LINES; lLine++) {
+		lStart = (psFDN->Position - psFDN->Delay[lLine]) & psFDN->RingMask;
+		lFirst = lRingSize - lStart < Count ? lRingSize - lStart : Count;
+		memcpy(Rows + lLine * FDN_BLOCK, psFDN->Lines + lLine * lRingSize + lStart, lFirst * sizeof(LADSPA_Data));
+		memcpy(Rows + lLine * FDN_BLOCK + lFirst, psFDN->Lines + lLine * lRingSize, (Count - lFirst) * sizeof(LADSPA_Data));
+	}
+}
+
+
+/* Write Count samples of each row into the lines at the current position. */
+static void
+writeLines(FDN * psFDN,
+	   const LADSPA_Data * Rows,
+	   unsigned long Count) {
+
+	unsigned long lRingSize = psFDN->RingMask + 1;
+	unsigned long lStart = psFDN->Position & psFDN->RingMask;
+	unsigned long lFirst = lRingSize - lStart < Count ? lRingSize - lStart : Count;
+	unsigned long lLine;
+
+	for (lLine = 0; lLine < FDN_LINES; lLine++) {
+		memcpy(psFDN->Lines + lLine * lRingSize + lStart, Rows + lLine * FDN_BLOCK, lFirst * sizeof(LADSPA_Data));
+		memcpy(psFDN->Lines + lLine * lRingSize, Rows + lLine * FDN_BLOCK + lFirst, (Count - lFirst) * sizeof(LADSPA_Data));
+	}
+}
+
+
+/* Process one block (Count <= FDN_BLOCK) into WetL and WetR. */
+static void
+processBlock(FDN * psFDN,
+	     const LADSPA_Data * InputL,
+	     const LADSPA_Data * InputR,
+	     LADSPA_Data * WetL,
+	     LADSPA_Data * WetR,
+	     unsigned long Count) {
+
+	LADSPA_Data afRowsA[FDN_LINES * FDN_BLOCK];
+	LADSPA_Data afRowsB[FDN_LINES * FDN_BLOCK];
+	LADSPA_Data * pfFrom = afRowsA;
+	LADSPA_Data * pfTo = afRowsB;
+	LADSPA_Data * pfSwap;
+	LADSPA_Data afState[FDN_LINES];
+	const LADSPA_Data * pfInput;
+	unsigned long lLine, lPair, lStage, lSampleIndex;
+	LADSPA_Data fSign;
+
+	readLines(psFDN, afRowsA, Count);
+
+	// The outputs are taken straight from the delay lines:
+	for (lSampleIndex = 0; lSampleIndex < Count; lSampleIndex++)
+		WetL[lSampleIndex] = WetR[lSampleIndex] = 0;
+	for (lLine = 0; lLine < FDN_LINES; lLine++) {
+		for (lSampleIndex = 0; lSampleIndex < Count; lSampleIndex++) {
+			WetL[lSampleIndex] += g_afFDNLeftSigns[lLine] * afRowsA[lLine * FDN_BLOCK + lSampleIndex];
+			WetR[lSampleIndex] += g_afFDNRightSigns[lLine] * afRowsA[lLine * FDN_BLOCK + lSampleIndex];
+		}
+	}
+
+	// Damping filters, all eight lines at each step:
+	memcpy(afState, psFDN->FilterState, sizeof(afState));
+	for (lSampleIndex = 0; lSampleIndex < Count; lSampleIndex++)
+		for (lLine = 0; lLine < FDN_LINES; lLine++)
+			afRowsA[lLine * FDN_BLOCK + lSampleIndex] = afState[lLine]
+				= psFDN->FeedbackGain[lLine] * afRowsA[lLine * FDN_BLOCK + lSampleIndex] + psFDN->Pole[lLine] * afState[lLine];
+	memcpy(psFDN->FilterState, afState, sizeof(afState));
+
+	// Hadamard matrix: three stages of sums and differences of rows i and i + 4 into rows 2i and 2i + 1:
+	for (lStage = 0; lStage < 3; lStage++) {
+		for (lPair = 0; lPair < FDN_LINES / 2; lPair++) {
+			const LADSPA_Data * pfA = pfFrom + lPair * FDN_BLOCK;
+			const LADSPA_Data * pfB = pfFrom + (lPair + FDN_LINES / 2) * FDN_BLOCK;
+			LADSPA_Data * pfSum = pfTo + 2 * lPair * FDN_BLOCK;
+			LADSPA_Data * pfDifference = pfTo + (2 * lPair + 1) * FDN_BLOCK;
+			for (lSampleIndex = 0; lSampleIndex < Count; lSampleIndex++) {
+				pfSum[lSampleIndex] = pfA[lSampleIndex] + pfB[lSampleIndex];
+				pfDifference[lSampleIndex] = pfA[lSampleIndex] - pfB[lSampleIndex];
+			}
+		}
+		pfSwap = pfFrom;
+		pfFrom = pfTo;
+		pfTo = pfSwap;
+	}
+
+	// Feed in the input, L to the even lines and R to the odd ones:
+	for (lLine = 0; lLine < FDN_LINES; lLine++) {
+		pfInput = (lLine & 1) ? InputR : InputL;
+		fSign = 0.5f * g_afFDNInputSigns[lLine];
+		for (lSampleIndex = 0; lSampleIndex < Count; lSampleIndex++)
+			pfFrom[lLine * FDN_BLOCK + lSampleIndex] += cmeDenormalBias(fSign * pfInput[lSampleIndex]);
+	}
+
+	writeLines(psFDN, pfFrom, Count);
+	psFDN->Position += Count;
+
+	// Count the zeros going into the lines (with silent input, as that could cancel what's in them):
+	for (lLine = 0; lLine < FDN_LINES; lLine++)
+		if (!g_sCMEKernels.IsSilent(pfFrom + lLine * FDN_BLOCK, Count))
+			break;
+	if (lLine < FDN_LINES
+	    || !g_sCMEKernels.IsSilent(InputL, Count) || !g_sCMEKernels.IsSilent(InputR, Count))
+		psFDN->QuietSamples = 0;
+	else if ((psFDN->QuietSamples += Count) > psFDN->RingMask)
+		psFDN->QuietSamples = psFDN->RingMask + 1;
+}
+
+
+/* Shared by run() and run_adding(): the output is the input and the reverb mixed according to the Mix control, times Gain, and either replaces or (if Adding) is added to the output buffers. */
+static inline void
+processFDN(FDN * psFDN,
+	   unsigned long SampleCount,
+	   LADSPA_Data Gain,
+	   int Adding) {
+
+	LADSPA_Data afInputL[FDN_BLOCK], afInputR[FDN_BLOCK];
+	LADSPA_Data afWetL[FDN_BLOCK], afWetR[FDN_BLOCK];
+	LADSPA_Data fMix = *(psFDN->Mix);
+	LADSPA_Data fDryGain, fWetGain;
+	LADSPA_Data fL, fR;
+	unsigned long lDone, lCount, lSampleIndex;
+	CMEDenormalGuard sGuard;
+
+	cmeDenormalGuardEnter(&sGuard);
+	updateCoefficients(psFDN);
+
+	if (!(fMix >= 0))
+		fMix = 0;
+	if (fMix > 1)
+		fMix = 1;
+	fDryGain = (1 - fMix) * Gain;
+	fWetGain = fMix * 0.5f * Gain;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lCount) {
+		lCount = SampleCount - lDone < FDN_BLOCK ? SampleCount - lDone : FDN_BLOCK;
+
+		// Take copies of the inputs first, in case the host has connected an output to the same buffer:
+		memcpy(afInputL, psFDN->InputBuffer1 + lDone, lCount * sizeof(LADSPA_Data));
+		memcpy(afInputR, psFDN->InputBuffer2 + lDone, lCount * sizeof(LADSPA_Data));
+
+		// An empty network fed silence stays empty, and outputs silence:
+		if (psFDN->QuietSamples > psFDN->RingMask
+		    && g_sCMEKernels.IsSilent(afInputL, lCount) && g_sCMEKernels.IsSilent(afInputR, lCount)) {
+			if (!Adding) {
+				g_sCMEKernels.Zero(psFDN->OutputBuffer1 + lDone, lCount);
+				g_sCMEKernels.Zero(psFDN->OutputBuffer2 + lDone, lCount);
+			}
+			psFDN->Position += lCount;
+			continue;
+		}
+
+		processBlock(psFDN, afInputL, afInputR, afWetL, afWetR, lCount);
+
+		for (lSampleIndex = 0; lSampleIndex < lCount; lSampleIndex++) {
+			fL = fDryGain * afInputL[lSampleIndex] + fWetGain * afWetL[lSampleIndex];
+			fR = fDryGain * afInputR[lSampleIndex] + fWetGain * afWetR[lSampleIndex];
+			if (Adding) {
+				psFDN->OutputBuffer1[lDone + lSampleIndex] += fL;
+				psFDN->OutputBuffer2[lDone + lSampleIndex] += fR;
+			}
+			else {
+				psFDN->OutputBuffer1[lDone + lSampleIndex] = fL;
+				psFDN->OutputBuffer2[lDone + lSampleIndex] = fR;
+			}
+		}
+	}
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+void
+runFDN(LADSPA_Handle Instance,
+       unsigned long SampleCount) {
+	processFDN((FDN *)Instance, SampleCount, 1, 0);
+}
+
+
+void
+setFDNRunAddingGain(LADSPA_Handle Instance,
+		    LADSPA_Data Gain) {
+	((FDN *)Instance)->RunAddingGain = Gain;
+}
+
+
+void
+runAddingFDN(LADSPA_Handle Instance,
+	     unsigned long SampleCount) {
+	processFDN((FDN *)Instance, SampleCount, ((FDN *)Instance)->RunAddingGain, 1);
+}
+
+
+/* Throw away the delay lines. */
+void
+cleanupFDN(LADSPA_Handle Instance) {
+
+	FDN * psFDN;
+
+	psFDN = (FDN *)Instance;
+	free(psFDN->Lines);
+	free(psFDN);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiFDNPortDescriptors[CMEFDN_PORT_COUNT] = {
+	[FDN_DECAY] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[FDN_DAMPING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[FDN_SIZE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[FDN_MIX] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[FDN_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[FDN_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[FDN_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[FDN_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO
+};
+
+static const char * const g_apcFDNPortNames[CMEFDN_PORT_COUNT] = {
+	[FDN_DECAY] = "Decay time (s)",
+	[FDN_DAMPING] = "High-frequency decay (ratio)",
+	[FDN_SIZE] = "Room size",
+	[FDN_MIX] = "Mix (dry/wet)",
+	[FDN_INPUT1] = "Input (Left)",
+	[FDN_OUTPUT1] = "Output (Left)",
+	[FDN_INPUT2] = "Input (Right)",
+	[FDN_OUTPUT2] = "Output (Right)"
+};
+
+static const LADSPA_PortRangeHint g_asFDNPortRangeHints[CMEFDN_PORT_COUNT] = {
+	// Default is the geometric middle of the range, about 1.4 s:
+	[FDN_DECAY] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_LOGARITHMIC |
+		LADSPA_HINT_DEFAULT_MIDDLE,
+		0.1, 20
+	},
+	[FDN_DAMPING] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_MIDDLE,
+		0.1, 1
+	},
+	// Default (geometric middle) is 1:
+	[FDN_SIZE] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_LOGARITHMIC |
+		LADSPA_HINT_DEFAULT_MIDDLE,
+		FDN_MIN_SIZE, FDN_MAX_SIZE
+	},
+	[FDN_MIX] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_LOW,
+		0, 1
+	}
+};
+
+
+const LADSPA_Descriptor g_sFDNDescriptor = {
+	.UniqueID = CMEFDN_LADSPA_ID,
+	.Label = "cme_fdn",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "FDN Reverb (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEFDN_PORT_COUNT,
+	.PortDescriptors = g_aiFDNPortDescriptors,
+	.PortNames = g_apcFDNPortNames,
+	.PortRangeHints = g_asFDNPortRangeHints,
+	.instantiate = instantiateFDN,
+	.connect_port = connectPortToFDN,
+	.activate = activateFDN,
+	.run = runFDN,
+	.run_adding = runAddingFDN,
+	.set_run_adding_gain = setFDNRunAddingGain,
+	.cleanup = cleanupFDN
+};
+
+
+#ifndef CME_BUNDLE
+
+void
+_init() {
+	cmeKernelsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type (there's only one). */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+	/* Return the requested descriptor or null if the index is out of range. */
+	switch (Index) {
+	case 0:
+		return &g_sFDNDescriptor;
+	default:
+		return NULL;
+	}
+}
+
+#endif /* CME_BUNDLE */
+
+
+/* EOF */
@@ -0,0 +1,234 @@
+/*
+Real FFT for the convolution plugin.  See cmefft.h.
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "cmefft.h"
+
+
+struct CMEFFT {
+	unsigned long Size;		// Real samples
+	unsigned long Half;		// Points in the complex transform (Size / 2)
+	unsigned long * BitReverse;	// Half entries
+	// Twiddle factors for the complex transform, by stage: the stage combining transforms of H points uses entries H - 1 .. 2H - 2.
+	LADSPA_Data * TwiddleRe;
+	LADSPA_Data * TwiddleIm;	// Forward (-sin)
+	LADSPA_Data * TwiddleImInverse;	// Inverse (+sin)
+	// cos and sin of 2 pi k / Size, for k = 0 .. Half / 2, for the split step:
+	LADSPA_Data * SplitCos;
+	LADSPA_Data * SplitSin;
+};
+
+
+CMEFFT *
+cmeFFTCreate(unsigned long Size) {
+
+	CMEFFT * psFFT;
+	unsigned long lHalf = Size / 2;
+	unsigned long lBits, lIndex, lReverse, lBit, lStage, lTwiddle;
+
+	if (Size < 4 || (Size & (Size - 1)) != 0)
+		return NULL;
+
+	psFFT = (CMEFFT *)calloc(1, sizeof(CMEFFT));
+	if (!psFFT)
+		return NULL;
+	psFFT->Size = Size;
+	psFFT->Half = lHalf;
+	psFFT->BitReverse = (unsigned long *)malloc(lHalf * sizeof(unsigned long));
+	psFFT->TwiddleRe = (LADSPA_Data *)malloc(lHalf * sizeof(LADSPA_Data));
+	psFFT->TwiddleIm = (LADSPA_Data *)malloc(lHalf * sizeof(LADSPA_Data));
+	psFFT->TwiddleImInverse = (LADSPA_Data *)malloc(lHalf * sizeof(LADSPA_Data));
+	psFFT->SplitCos = (LADSPA_Data *)malloc((lHalf / 2 + 1) * sizeof(LADSPA_Data));
+	psFFT->SplitSin = (LADSPA_Data *)malloc((lHalf / 2 + 1) * sizeof(LADSPA_Data));
+	if (!psFFT->BitReverse || !psFFT->TwiddleRe || !psFFT->TwiddleIm || !psFFT->TwiddleImInverse || !psFFT->SplitCos || !psFFT->SplitSin) {
+		cmeFFTDestroy(psFFT);
+		return NULL;
+	}
+
+	for (lBits = 0; (1UL << lBits) < lHalf; lBits++)
+		;
+	for (lIndex = 0; lIndex < lHalf; lIndex++) {
+		lReverse = 0;
+		for (lBit = 0; lBit < lBits; lBit++)
+			if (lIndex & (1UL << lBit))
+				lReverse |= 1UL << (lBits - 1 - lBit);
+		psFFT->BitReverse[lIndex] = lReverse;
+	}
+
+	for (lStage = 1; lStage < lHalf; lStage *= 2) {
+		for (lTwiddle = 0; lTwiddle < lStage; lTwiddle++) {
+			psFFT->TwiddleRe[lStage - 1 + lTwiddle] = cos(M_PI * lTwiddle / lStage);
+			psFFT->TwiddleIm[lStage - 1 + lTwiddle] = -sin(M_PI * lTwiddle / lStage);
+			psFFT->TwiddleImInverse[lStage - 1 + lTwiddle] = sin(M_PI * lTwiddle / lStage);
+		}
+	}
+
+	for (lIndex = 0; lIndex <= lHalf / 2; lIndex++) {
+		psFFT->SplitCos[lIndex] = cos(2 * M_PI * lIndex / Size);
+		psFFT->SplitSin[lIndex] = sin(2 * M_PI * lIndex / Size);
+	}
+
+	return psFFT;
+}
+
+
+void
+cmeFFTDestroy(CMEFFT * psFFT) {
+
+	if (!psFFT)
+		return;
+	free(psFFT->BitReverse);
+	free(psFFT->TwiddleRe);
+	free(psFFT->TwiddleIm);
+	free(psFFT->TwiddleImInverse);
+	free(psFFT->SplitCos);
+	free(psFFT->SplitSin);
+	free(psFFT);
+}
+
+
+
+/* In-place radix-2 decimation-in-time transform of Half points, which must already be in bit-reversed order.  The inner loop runs along contiguous twiddles, so it vectorises once the stages are wide enough. */
+static void
+complexTransform(const CMEFFT * psFFT,
+		 LADSPA_Data * Re,
+		 LADSPA_Data * Im,
+		 const LADSPA_Data * TwiddleIm) {
+
+	unsigned long lStage, lStart, lIndex;
+	const LADSPA_Data * pfWRe;
+	const LADSPA_Data * pfWIm;
+	LADSPA_Data * pfARe;
+	LADSPA_Data * pfAIm;
+	LADSPA_Data * pfBRe;
+	LADSPA_Data * pfBIm;
+	LADSPA_Data fTRe, fTIm;
+
+	for (lStage = 1; lStage < psFFT->Half; lStage *= 2) {
+		pfWRe = psFFT->TwiddleRe + lStage - 1;
+		pfWIm = TwiddleIm + lStage - 1;
+		for (lStart = 0; lStart < psFFT->Half; lStart += 2 * lStage) {
+			pfARe = Re + lStart;
+			pfAIm = Im + lStart;
+			pfBRe = pfARe + lStage;
+			pfBIm = pfAIm + lStage;
+			for (lIndex = 0; lIndex < lStage; lIndex++) {
+				fTRe = pfWRe[lIndex] * pfBRe[lIndex] - pfWIm[lIndex] * pfBIm[lIndex];
+				fTIm = pfWRe[lIndex] * pfBIm[lIndex] + pfWIm[lIndex] * pfBRe[lIndex];
+				pfBRe[lIndex] = pfARe[lIndex] - fTRe;
+				pfBIm[lIndex] = pfAIm[lIndex] - fTIm;
+				pfARe[lIndex] += fTRe;
+				pfAIm[lIndex] += fTIm;
+			}
+		}
+	}
+}
+
+
+void
+cmeFFTForward(const CMEFFT * psFFT,
+	      const LADSPA_Data * Input,
+	      LADSPA_Data * Spectrum) {
+
+	unsigned long lHalf = psFFT->Half;
+	LADSPA_Data * pfRe = Spectrum;
+	LADSPA_Data * pfIm = Spectrum + lHalf + 1;
+	LADSPA_Data fARe, fAIm, fBRe, fBIm;
+	LADSPA_Data fERe, fEIm, fORe, fOIm;
+	LADSPA_Data fCos, fSin;
+	unsigned long lIndex;
+
+	// Even samples as the real parts, odd as the imaginary, in bit-reversed order:
+	for (lIndex = 0; lIndex < lHalf; lIndex++) {
+		pfRe[psFFT->BitReverse[lIndex]] = Input[2 * lIndex];
+		pfIm[psFFT->BitReverse[lIndex]] = Input[2 * lIndex + 1];
+	}
+
+	complexTransform(psFFT, pfRe, pfIm, psFFT->TwiddleIm);
+
+	// Split Z into the transforms E and O of the even and odd samples, and combine them: X[k] = E[k] + W^k O[k].  Bins k and Half - k come from the same pair of Z values, so this can be done in place.
+	fARe = pfRe[0];
+	fAIm = pfIm[0];
+	pfRe[0] = fARe + fAIm;
+	pfIm[0] = 0;
+	pfRe[lHalf] = fARe - fAIm;
+	pfIm[lHalf] = 0;
+	for (lIndex = 1; lIndex <= lHalf / 2; lIndex++) {
+		fARe = pfRe[lIndex];
+		fAIm = pfIm[lIndex];
+		fBRe = pfRe[lHalf - lIndex];
+		fBIm = pfIm[lHalf - lIndex];
+		fERe = 0.5f * (fARe + fBRe);
+		fEIm = 0.5f * (fAIm - fBIm);
+		fORe = 0.5f * (fAIm + fBIm);
+		fOIm = -0.5f * (fARe - fBRe);
+		fCos = psFFT->SplitCos[lIndex];
+		fSin = psFFT->SplitSin[lIndex];
+		pfRe[lIndex] = fERe + fCos * fORe + fSin * fOIm;
+		pfIm[lIndex] = fEIm + fCos * fOIm - fSin * fORe;
+		pfRe[lHalf - lIndex] = fERe - fCos * fORe - fSin * fOIm;
+		pfIm[lHalf - lIndex] = -fEIm + fCos * fOIm - fSin * fORe;
+	}
+}
+
+
+void
+cmeFFTInverse(const CMEFFT * psFFT,
+	      LADSPA_Data * Spectrum,
+	      LADSPA_Data * Output) {
+
+	unsigned long lHalf = psFFT->Half;
+	LADSPA_Data * pfRe = Spectrum;
+	LADSPA_Data * pfIm = Spectrum + lHalf + 1;
+	LADSPA_Data fPRe, fPIm, fQRe, fQIm;
+	LADSPA_Data fERe, fEIm, fDRe, fDIm, fORe, fOIm;
+	LADSPA_Data fCos, fSin, fSwap;
+	unsigned long lIndex, lReverse;
+
+	// Undo the split step: E[k] = (X[k] + conj X[Half - k]) / 2, O[k] = (X[k] - conj X[Half - k]) / 2 W^-k, Z[k] = E[k] + i O[k].
+	fPRe = pfRe[0];
+	fQRe = pfRe[lHalf];
+	pfRe[0] = 0.5f * (fPRe + fQRe);
+	pfIm[0] = 0.5f * (fPRe - fQRe);
+	for (lIndex = 1; lIndex <= lHalf / 2; lIndex++) {
+		fPRe = pfRe[lIndex];
+		fPIm = pfIm[lIndex];
+		fQRe = pfRe[lHalf - lIndex];
+		fQIm = pfIm[lHalf - lIndex];
+		fERe = 0.5f * (fPRe + fQRe);
+		fEIm = 0.5f * (fPIm - fQIm);
+		fDRe = 0.5f * (fPRe - fQRe);
+		fDIm = 0.5f * (fPIm + fQIm);
+		fCos = psFFT->SplitCos[lIndex];
+		fSin = psFFT->SplitSin[lIndex];
+		fORe = fDRe * fCos - fDIm * fSin;
+		fOIm = fDRe * fSin + fDIm * fCos;
+		pfRe[lIndex] = fERe - fOIm;
+		pfIm[lIndex] = fEIm + fORe;
+		pfRe[lHalf - lIndex] = fERe + fOIm;
+		pfIm[lHalf - lIndex] = -fEIm + fORe;
+	}
+
+	for (lIndex = 0; lIndex < lHalf; lIndex++) {
+		lReverse = psFFT->BitReverse[lIndex];
+		if (lReverse > lIndex) {
+			fSwap = pfRe[lIndex]; pfRe[lIndex] = pfRe[lReverse]; pfRe[lReverse] = fSwap;
+			fSwap = pfIm[lIndex]; pfIm[lIndex] = pfIm[lReverse]; pfIm[lReverse] = fSwap;
+		}
+	}
+
+	complexTransform(psFFT, pfRe, pfIm, psFFT->TwiddleImInverse);
+
+	for (lIndex = 0; lIndex < lHalf; lIndex++) {
+		Output[2 * lIndex] = pfRe[lIndex];
+		Output[2 * lIndex + 1] = pfIm[lIndex];
+	}
+}
+
+
+/* EOF */
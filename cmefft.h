@@ -0,0 +1,45 @@
+/*
+Real FFT for the convolution plugin.
+
+A real transform of Size samples (a power of two, at least 4) is done as a complex transform of Size / 2 points (the even samples as the real parts, the odd samples as the imaginary parts) followed by a split step.  Spectra are kept in split form, Size / 2 + 1 real parts followed by Size / 2 + 1 imaginary parts (CME_FFT_SPECTRUM_SIZE floats in all), so that multiplying spectra together is a straight loop over bins that the compiler vectorises.
+
+Neither direction is normalised: cmeFFTInverse(cmeFFTForward(x)) is Size / 2 times x.  The convolution plugin folds the 2 / Size into the impulse response spectra.
+
+Plans are set up (and allocate) in cmeFFTCreate(); the transforms themselves don't allocate, and one plan can be used by several threads at once, as long as each has its own buffers.
+
+CME 2026-10
+*/
+
+#ifndef CMEFFT_H
+#define CMEFFT_H
+
+#include "ladspa.h"
+
+#pragma GCC visibility push(hidden)
+
+
+/* Floats in the spectrum of a Size-point real transform. */
+#define CME_FFT_SPECTRUM_SIZE(Size)	((Size) + 2)
+
+
+typedef struct CMEFFT CMEFFT;
+
+/* Set up a transform of Size real samples.  Returns NULL if Size isn't a power of two >= 4, or memory runs out. */
+CMEFFT * cmeFFTCreate(unsigned long Size);
+
+void cmeFFTDestroy(CMEFFT * FFT);
+
+/* Spectrum (split real/imaginary, see above) of Size real samples.  Input and Spectrum must not overlap. */
+void cmeFFTForward(const CMEFFT * FFT,
+		   const LADSPA_Data * Input,
+		   LADSPA_Data * Spectrum);
+
+/* Size real samples (times Size / 2) from a spectrum.  Spectrum is used as scratch space, so is destroyed. */
+void cmeFFTInverse(const CMEFFT * FFT,
+		   LADSPA_Data * Spectrum,
+		   LADSPA_Data * Output);
+
+
+#pragma GCC visibility pop
+
+#endif /* CMEFFT_H */
@@ -0,0 +1,194 @@
+/*
+Run-time instrumentation: shared-memory stats writer and reader.  See cmeinstrument.h.
+CME 2026-10
+*/
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cmeinstrument.h"
+
+
+struct CMEInstrumentWriter {
+	char * Name;
+	CMEInstrumentHeader * Header;
+	CMEInstrumentStats * Stats;
+	size_t Size;
+};
+
+struct CMEInstrumentReader {
+	const CMEInstrumentHeader * Header;
+	const CMEInstrumentStats * Stats;
+	size_t Size;
+};
+
+
+/* The stats start on a 64-byte boundary after the header. */
+static size_t
+statsOffset(void) {
+	return (sizeof(CMEInstrumentHeader) + 63) & ~(size_t)63;
+}
+
+
+
+/*****************************************************************************/
+
+/* Writer */
+
+CMEInstrumentWriter *
+cmeInstrumentCreate(const char * Prefix,
+		    unsigned long Instance,
+		    const LADSPA_Descriptor * Descriptor,
+		    double SampleRate) {
+
+	CMEInstrumentWriter * psWriter;
+	int iFile;
+	void * pvMemory;
+
+	psWriter = (CMEInstrumentWriter *)calloc(1, sizeof(CMEInstrumentWriter));
+	if (!psWriter)
+		return NULL;
+	if (asprintf(&psWriter->Name, "/%s.%ld.%lu", Prefix, (long)getpid(), Instance) < 0) {
+		free(psWriter);
+		return NULL;
+	}
+	psWriter->Size = statsOffset() + sizeof(CMEInstrumentStats);
+
+	iFile = shm_open(psWriter->Name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (iFile < 0) {
+		free(psWriter->Name);
+		free(psWriter);
+		return NULL;
+	}
+	if (ftruncate(iFile, psWriter->Size) != 0
+	    || (pvMemory = mmap(NULL, psWriter->Size, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0)) == MAP_FAILED) {
+		close(iFile);
+		shm_unlink(psWriter->Name);
+		free(psWriter->Name);
+		free(psWriter);
+		return NULL;
+	}
+	close(iFile);
+
+	// Touch every page now, so that run() never takes a page fault:
+	memset(pvMemory, 0, psWriter->Size);
+
+	psWriter->Header = (CMEInstrumentHeader *)pvMemory;
+	psWriter->Stats = (CMEInstrumentStats *)((char *)pvMemory + statsOffset());
+	psWriter->Header->Version = CME_INSTRUMENT_VERSION;
+	psWriter->Header->StatsSize = sizeof(CMEInstrumentStats);
+	psWriter->Header->UniqueID = Descriptor->UniqueID;
+	psWriter->Header->SampleRate = SampleRate;
+	strncpy(psWriter->Header->Label, Descriptor->Label, sizeof(psWriter->Header->Label) - 1);
+	// The magic number goes in last, so a reader never sees a half-initialised header as valid:
+	__atomic_store_n(&psWriter->Header->Magic, CME_INSTRUMENT_MAGIC, __ATOMIC_RELEASE);
+
+	return psWriter;
+}
+
+
+CMEInstrumentStats *
+cmeInstrumentStats(CMEInstrumentWriter * psWriter) {
+	return psWriter->Stats;
+}
+
+
+void
+cmeInstrumentDestroy(CMEInstrumentWriter * psWriter) {
+
+	if (!psWriter)
+		return;
+	munmap(psWriter->Header, psWriter->Size);
+	shm_unlink(psWriter->Name);
+	free(psWriter->Name);
+	free(psWriter);
+}
+
+
+
+/*****************************************************************************/
+
+/* Reader */
+
+CMEInstrumentReader *
+cmeInstrumentOpen(const char * Name) {
+
+	CMEInstrumentReader * psReader;
+	const CMEInstrumentHeader * psHeader;
+	struct stat sStat;
+	void * pvMemory;
+	int iFile;
+
+	iFile = shm_open(Name, O_RDONLY, 0);
+	if (iFile < 0)
+		return NULL;
+	if (fstat(iFile, &sStat) != 0 || (size_t)sStat.st_size < statsOffset() + sizeof(CMEInstrumentStats)) {
+		close(iFile);
+		return NULL;
+	}
+	pvMemory = mmap(NULL, sStat.st_size, PROT_READ, MAP_SHARED, iFile, 0);
+	close(iFile);
+	if (pvMemory == MAP_FAILED)
+		return NULL;
+
+	psHeader = (const CMEInstrumentHeader *)pvMemory;
+	if (__atomic_load_n(&psHeader->Magic, __ATOMIC_ACQUIRE) != CME_INSTRUMENT_MAGIC
+	    || psHeader->Version != CME_INSTRUMENT_VERSION
+	    || psHeader->StatsSize != sizeof(CMEInstrumentStats)) {
+		munmap(pvMemory, sStat.st_size);
+		return NULL;
+	}
+
+	psReader = (CMEInstrumentReader *)calloc(1, sizeof(CMEInstrumentReader));
+	if (!psReader) {
+		munmap(pvMemory, sStat.st_size);
+		return NULL;
+	}
+	psReader->Header = psHeader;
+	psReader->Stats = (const CMEInstrumentStats *)((const char *)pvMemory + statsOffset());
+	psReader->Size = sStat.st_size;
+	return psReader;
+}
+
+
+const CMEInstrumentHeader *
+cmeInstrumentHeader(const CMEInstrumentReader * psReader) {
+	return psReader->Header;
+}
+
+
+void
+cmeInstrumentSnapshot(const CMEInstrumentReader * psReader,
+		      CMEInstrumentStats * psStats) {
+
+	const CMEInstrumentStats * psShared = psReader->Stats;
+	int iBucket;
+
+	psStats->Runs = __atomic_load_n(&psShared->Runs, __ATOMIC_RELAXED);
+	psStats->Samples = __atomic_load_n(&psShared->Samples, __ATOMIC_RELAXED);
+	psStats->Cycles = __atomic_load_n(&psShared->Cycles, __ATOMIC_RELAXED);
+	psStats->WorstCycles = __atomic_load_n(&psShared->WorstCycles, __ATOMIC_RELAXED);
+	psStats->WorstSamples = __atomic_load_n(&psShared->WorstSamples, __ATOMIC_RELAXED);
+	for (iBucket = 0; iBucket < CME_INSTRUMENT_BUCKETS; iBucket++)
+		psStats->Histogram[iBucket] = __atomic_load_n(&psShared->Histogram[iBucket], __ATOMIC_RELAXED);
+}
+
+
+void
+cmeInstrumentClose(CMEInstrumentReader * psReader) {
+
+	if (!psReader)
+		return;
+	munmap((void *)psReader->Header, psReader->Size);
+	free(psReader);
+}
+
+
+/* EOF */
@@ -0,0 +1,150 @@
+/*
+Run-time instrumentation: how long each plugin instance's run() takes, for finding which of many instances is eating the audio deadline, and where the jitter comes from, without a profiler.
+
+This is an optional build ("make clean; make INSTRUMENT=1", which compiles everything with -DCME_INSTRUMENT).  The plugin sources are unchanged: cmeplugins.h renames each library's ladspa_descriptor() to cmeUninstrumentedDescriptor(), and cmeinstrumentwrap.c provides a ladspa_descriptor() that wraps every descriptor.  The wrapper has the same ID and label, and the same ports plus two output controls at the end:
+
+	"DSP load (cycles/sample)"		average over the last second or so of audio
+	"DSP load, worst (cycles/sample)"	the slowest run() since instantiate(), per sample
+
+Its run() and run_adding() read a cycle counter (rdtsc: reference cycles at the TSC rate, which doesn't follow frequency scaling; nanoseconds on other machines) either side of the plugin's, and record each call in a CMEInstrumentStats: totals, the worst call, and a histogram of call durations in power-of-two buckets.  That costs two counter reads and a few dozen instructions per call.  (For the reverbs, only the time run() itself takes is counted, not that of their worker threads.)
+
+If the environment variable CME_INSTRUMENT_SHM is set, each instance's CMEInstrumentStats lives in a POSIX shared-memory segment, "/<prefix>.<pid>.<instance>" as for the meter telemetry (see cmetelemetry.h), so a monitoring process can read any instance's histogram at any time; run() only does plain stores into memory that instantiate() has already touched, so this is real-time safe.  The segment is a CMEInstrumentHeader (which says whose it is) followed by the CMEInstrumentStats.  The reader side is in libcmetelemetry.a:
+
+	CMEInstrumentReader * psReader = cmeInstrumentOpen("/cme_load.1234.7");
+	...
+	cmeInstrumentSnapshot(psReader, &sStats);
+	...
+	cmeInstrumentClose(psReader);
+
+Each field is stored atomically, but a snapshot taken during a run() may have counted that run() in some fields and not yet in others.
+
+CME 2026-10
+*/
+
+#ifndef CMEINSTRUMENT_H
+#define CMEINSTRUMENT_H
+
+#include <stdint.h>
+
+#include "ladspa.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#pragma GCC visibility push(hidden)
+
+
+#define CME_INSTRUMENT_MAGIC	0x4C454D43	// "CMEL"
+#define CME_INSTRUMENT_VERSION	1
+
+/* Environment variable holding the segment name prefix: */
+#define CME_INSTRUMENT_ENV	"CME_INSTRUMENT_SHM"
+
+/* The load outputs' names start with this (so that cmebench -i can leave them out; they are timings, so never the same twice): */
+#define CME_INSTRUMENT_PORT_PREFIX	"DSP load"
+
+/* Histogram bucket k counts the calls taking 2^k to 2^(k + 1) - 1 cycles (bucket 0 also those taking 0); the last one counts everything longer. */
+#define CME_INSTRUMENT_BUCKETS	32
+
+
+typedef struct {
+	uint64_t Runs;			// run() and run_adding() calls
+	uint64_t Samples;		// Samples in them
+	uint64_t Cycles;		// Cycles they took
+	uint64_t WorstCycles;		// The call with the most cycles per sample took this many cycles...
+	uint64_t WorstSamples;		// ...for this many samples
+	uint64_t Histogram[CME_INSTRUMENT_BUCKETS];
+} CMEInstrumentStats;
+
+
+/* Segment header.  All of it is fixed when the segment is created. */
+typedef struct {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t StatsSize;		// sizeof(CMEInstrumentStats)
+	uint32_t UniqueID;		// The plugin's
+	double SampleRate;
+	char Label[64];			// The plugin's (truncated if need be)
+	uint64_t Reserved[4];
+} CMEInstrumentHeader;
+
+
+/* The cycle counter. */
+static inline uint64_t
+cmeInstrumentClock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec sTime;
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+	return (uint64_t)sTime.tv_sec * 1000000000 + sTime.tv_nsec;
+#endif
+}
+
+
+/* Count one call of SampleCount samples that took Cycles.  Only the thread in run() writes the stats, so each field is a plain read and add, stored atomically so that a reader never sees half of one. */
+static inline void
+cmeInstrumentRecord(CMEInstrumentStats * psStats,
+		    uint64_t Cycles,
+		    unsigned long SampleCount) {
+
+	int iBucket = 63 - __builtin_clzll(Cycles | 1);
+
+	if (iBucket >= CME_INSTRUMENT_BUCKETS)
+		iBucket = CME_INSTRUMENT_BUCKETS - 1;
+	__atomic_store_n(&psStats->Histogram[iBucket], psStats->Histogram[iBucket] + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&psStats->Runs, psStats->Runs + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&psStats->Samples, psStats->Samples + SampleCount, __ATOMIC_RELAXED);
+	__atomic_store_n(&psStats->Cycles, psStats->Cycles + Cycles, __ATOMIC_RELAXED);
+	// (Cycles / SampleCount > WorstCycles / WorstSamples, without dividing:)
+	if (SampleCount && Cycles * psStats->WorstSamples >= psStats->WorstCycles * SampleCount) {
+		__atomic_store_n(&psStats->WorstCycles, Cycles, __ATOMIC_RELAXED);
+		__atomic_store_n(&psStats->WorstSamples, SampleCount, __ATOMIC_RELAXED);
+	}
+}
+
+
+/* Writer (the instrumented plugin): */
+
+typedef struct CMEInstrumentWriter CMEInstrumentWriter;
+
+/* Create a segment named "/<Prefix>.<pid>.<Instance>" for an instance of Descriptor, with zeroed stats.  Returns NULL if it can't be set up; the instance then keeps its stats to itself.  Not real-time safe (call from instantiate()). */
+CMEInstrumentWriter * cmeInstrumentCreate(const char * Prefix,
+					  unsigned long Instance,
+					  const LADSPA_Descriptor * Descriptor,
+					  double SampleRate);
+
+/* The stats in the segment, for cmeInstrumentRecord(). */
+CMEInstrumentStats * cmeInstrumentStats(CMEInstrumentWriter * Writer);
+
+/* Unmap and remove the segment. */
+void cmeInstrumentDestroy(CMEInstrumentWriter * Writer);
+
+
+/* Reader (the monitoring process): */
+
+typedef struct CMEInstrumentReader CMEInstrumentReader;
+
+/* Map an existing segment read-only.  Returns NULL if it doesn't exist or isn't an instrumentation segment of this version. */
+CMEInstrumentReader * cmeInstrumentOpen(const char * Name);
+
+/* Which plugin, and at what sample rate, the segment is for. */
+const CMEInstrumentHeader * cmeInstrumentHeader(const CMEInstrumentReader * Reader);
+
+/* Copy the stats as they are now. */
+void cmeInstrumentSnapshot(const CMEInstrumentReader * Reader,
+			   CMEInstrumentStats * Stats);
+
+void cmeInstrumentClose(CMEInstrumentReader * Reader);
+
+
+/* The library's own ladspa_descriptor(), renamed in the instrumented build (see cmeplugins.h): */
+const LADSPA_Descriptor * cmeUninstrumentedDescriptor(unsigned long Index);
+
+
+#pragma GCC visibility pop
+
+#endif /* CMEINSTRUMENT_H */
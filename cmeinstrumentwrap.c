@@ -0,0 +1,300 @@
+/*
+The instrumented build's ladspa_descriptor(): each of the library's descriptors, wrapped to time run() and add the two load outputs.  See cmeinstrument.h.
+
+The wrapped descriptors (and their port tables, two entries longer) are built on the heap the first time the host asks for each one, and freed when the library is unloaded.  This is the only heap work any of the libraries does at load time, and only in this build.
+
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ladspa.h"
+#include "cmeinstrument.h"
+
+
+/* More than any library has: */
+#define INSTRUMENT_MAX_DESCRIPTORS	64
+
+/* Samples per "DSP load" reading (as a fraction of the sample rate): */
+#define INSTRUMENT_LOAD_PERIOD	1.0
+
+
+typedef struct {
+	const LADSPA_Descriptor * Inner;
+	LADSPA_Handle InnerInstance;
+	LADSPA_Data * LoadValue;	// (NULL if the host hasn't connected it)
+	LADSPA_Data * WorstValue;
+	CMEInstrumentStats * Stats;	// In the shared-memory segment, or LocalStats
+	CMEInstrumentWriter * Writer;	// NULL unless CME_INSTRUMENT_SHM is set
+	unsigned long Period;		// Samples per load reading
+	unsigned long PeriodSamples;	// So far in this period...
+	uint64_t PeriodCycles;		// ...and the cycles they took
+	LADSPA_Data Load;		// Last reading
+	CMEInstrumentStats LocalStats;
+} Instrumented;
+
+
+static LADSPA_Descriptor * g_apsInstrumentedDescriptors[INSTRUMENT_MAX_DESCRIPTORS];
+
+
+
+LADSPA_Handle
+instantiateInstrumented(const LADSPA_Descriptor * Descriptor,
+			unsigned long SampleRate) {
+
+	const LADSPA_Descriptor * psInner = (const LADSPA_Descriptor *)Descriptor->ImplementationData;
+	Instrumented * psInstrumented;
+	const char * pcPrefix;
+	static unsigned long s_lInstances = 0;
+
+	psInstrumented = (Instrumented *)calloc(1, sizeof(Instrumented));
+	if (!psInstrumented)
+		return NULL;
+	psInstrumented->Inner = psInner;
+	psInstrumented->InnerInstance = psInner->instantiate(psInner, SampleRate);
+	if (!psInstrumented->InnerInstance) {
+		free(psInstrumented);
+		return NULL;
+	}
+
+	psInstrumented->Stats = &psInstrumented->LocalStats;
+	pcPrefix = getenv(CME_INSTRUMENT_ENV);
+	if (pcPrefix && *pcPrefix) {
+		psInstrumented->Writer = cmeInstrumentCreate(pcPrefix, __atomic_fetch_add(&s_lInstances, 1, __ATOMIC_RELAXED), psInner, SampleRate);
+		if (psInstrumented->Writer)
+			psInstrumented->Stats = cmeInstrumentStats(psInstrumented->Writer);
+	}
+	psInstrumented->Period = (unsigned long)(INSTRUMENT_LOAD_PERIOD * SampleRate);
+	if (psInstrumented->Period < 1)
+		psInstrumented->Period = 1;
+	return psInstrumented;
+}
+
+
+void
+connectPortToInstrumented(LADSPA_Handle Instance,
+			  unsigned long Port,
+			  LADSPA_Data * DataLocation) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+	unsigned long lPorts = psInstrumented->Inner->PortCount;
+
+	if (Port < lPorts)
+		psInstrumented->Inner->connect_port(psInstrumented->InnerInstance, Port, DataLocation);
+	else if (Port == lPorts)
+		psInstrumented->LoadValue = DataLocation;
+	else if (Port == lPorts + 1)
+		psInstrumented->WorstValue = DataLocation;
+}
+
+
+void
+activateInstrumented(LADSPA_Handle Instance) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+
+	if (psInstrumented->Inner->activate)
+		psInstrumented->Inner->activate(psInstrumented->InnerInstance);
+}
+
+
+void
+deactivateInstrumented(LADSPA_Handle Instance) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+
+	if (psInstrumented->Inner->deactivate)
+		psInstrumented->Inner->deactivate(psInstrumented->InnerInstance);
+}
+
+
+/* Count a call, and update the load outputs. */
+static void
+recordCall(Instrumented * psInstrumented,
+	   uint64_t Cycles,
+	   unsigned long SampleCount) {
+
+	const CMEInstrumentStats * psStats = psInstrumented->Stats;
+
+	cmeInstrumentRecord(psInstrumented->Stats, Cycles, SampleCount);
+
+	// The load is read over whole periods (until the first one is over, over what there has been so far):
+	psInstrumented->PeriodSamples += SampleCount;
+	psInstrumented->PeriodCycles += Cycles;
+	if (psInstrumented->PeriodSamples >= psInstrumented->Period || psStats->Samples == psInstrumented->PeriodSamples) {
+		if (psInstrumented->PeriodSamples)
+			psInstrumented->Load = (LADSPA_Data)psInstrumented->PeriodCycles / psInstrumented->PeriodSamples;
+		if (psInstrumented->PeriodSamples >= psInstrumented->Period) {
+			psInstrumented->PeriodSamples = 0;
+			psInstrumented->PeriodCycles = 0;
+		}
+	}
+
+	if (psInstrumented->LoadValue)
+		*(psInstrumented->LoadValue) = psInstrumented->Load;
+	if (psInstrumented->WorstValue && psStats->WorstSamples)
+		*(psInstrumented->WorstValue) = (LADSPA_Data)psStats->WorstCycles / psStats->WorstSamples;
+}
+
+
+void
+runInstrumented(LADSPA_Handle Instance,
+		unsigned long SampleCount) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+	uint64_t lStart;
+
+	lStart = cmeInstrumentClock();
+	psInstrumented->Inner->run(psInstrumented->InnerInstance, SampleCount);
+	recordCall(psInstrumented, cmeInstrumentClock() - lStart, SampleCount);
+}
+
+
+void
+runAddingInstrumented(LADSPA_Handle Instance,
+		      unsigned long SampleCount) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+	uint64_t lStart;
+
+	lStart = cmeInstrumentClock();
+	psInstrumented->Inner->run_adding(psInstrumented->InnerInstance, SampleCount);
+	recordCall(psInstrumented, cmeInstrumentClock() - lStart, SampleCount);
+}
+
+
+void
+setInstrumentedRunAddingGain(LADSPA_Handle Instance,
+			     LADSPA_Data Gain) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+
+	psInstrumented->Inner->set_run_adding_gain(psInstrumented->InnerInstance, Gain);
+}
+
+
+void
+cleanupInstrumented(LADSPA_Handle Instance) {
+
+	Instrumented * psInstrumented = (Instrumented *)Instance;
+
+	psInstrumented->Inner->cleanup(psInstrumented->InnerInstance);
+	cmeInstrumentDestroy(psInstrumented->Writer);
+	free(psInstrumented);
+}
+
+
+
+static void
+freeDescriptor(LADSPA_Descriptor * psDescriptor) {
+
+	if (!psDescriptor)
+		return;
+	free((char *)psDescriptor->Name);
+	free((LADSPA_PortDescriptor *)psDescriptor->PortDescriptors);
+	free((char **)psDescriptor->PortNames);
+	free((LADSPA_PortRangeHint *)psDescriptor->PortRangeHints);
+	free(psDescriptor);
+}
+
+
+/* A copy of Inner with the load outputs added and the instrumented callbacks, or NULL if out of memory. */
+static LADSPA_Descriptor *
+wrapDescriptor(const LADSPA_Descriptor * psInner) {
+
+	LADSPA_Descriptor * psDescriptor;
+	unsigned long lPorts = psInner->PortCount;
+	LADSPA_PortDescriptor * piPortDescriptors;
+	const char ** ppcPortNames;
+	LADSPA_PortRangeHint * psPortRangeHints;
+	char * pcName;
+
+	psDescriptor = (LADSPA_Descriptor *)calloc(1, sizeof(LADSPA_Descriptor));
+	if (!psDescriptor)
+		return NULL;
+	*psDescriptor = *psInner;
+	psDescriptor->Name = NULL;
+	psDescriptor->PortDescriptors = NULL;
+	psDescriptor->PortNames = NULL;
+	psDescriptor->PortRangeHints = NULL;
+
+	pcName = (char *)malloc(strlen(psInner->Name) + sizeof(" [instrumented]"));
+	piPortDescriptors = (LADSPA_PortDescriptor *)calloc(lPorts + 2, sizeof(LADSPA_PortDescriptor));
+	ppcPortNames = (const char **)calloc(lPorts + 2, sizeof(const char *));
+	psPortRangeHints = (LADSPA_PortRangeHint *)calloc(lPorts + 2, sizeof(LADSPA_PortRangeHint));
+	psDescriptor->Name = pcName;
+	psDescriptor->PortDescriptors = piPortDescriptors;
+	psDescriptor->PortNames = ppcPortNames;
+	psDescriptor->PortRangeHints = psPortRangeHints;
+	if (!pcName || !piPortDescriptors || !ppcPortNames || !psPortRangeHints) {
+		freeDescriptor(psDescriptor);
+		return NULL;
+	}
+
+	strcpy(pcName, psInner->Name);
+	strcat(pcName, " [instrumented]");
+	memcpy(piPortDescriptors, psInner->PortDescriptors, lPorts * sizeof(LADSPA_PortDescriptor));
+	memcpy(ppcPortNames, psInner->PortNames, lPorts * sizeof(const char *));
+	memcpy(psPortRangeHints, psInner->PortRangeHints, lPorts * sizeof(LADSPA_PortRangeHint));
+	piPortDescriptors[lPorts] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+	piPortDescriptors[lPorts + 1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+	ppcPortNames[lPorts] = CME_INSTRUMENT_PORT_PREFIX " (cycles/sample)";
+	ppcPortNames[lPorts + 1] = CME_INSTRUMENT_PORT_PREFIX ", worst (cycles/sample)";
+
+	psDescriptor->PortCount = lPorts + 2;
+	psDescriptor->ImplementationData = (void *)psInner;
+	psDescriptor->instantiate = instantiateInstrumented;
+	psDescriptor->connect_port = connectPortToInstrumented;
+	psDescriptor->activate = psInner->activate ? activateInstrumented : NULL;
+	psDescriptor->run = runInstrumented;
+	psDescriptor->run_adding = psInner->run_adding ? runAddingInstrumented : NULL;
+	psDescriptor->set_run_adding_gain = psInner->set_run_adding_gain ? setInstrumentedRunAddingGain : NULL;
+	psDescriptor->deactivate = psInner->deactivate ? deactivateInstrumented : NULL;
+	psDescriptor->cleanup = cleanupInstrumented;
+	return psDescriptor;
+}
+
+
+/* Return the instrumented version of the library's descriptor Index, building it the first time. */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+
+	const LADSPA_Descriptor * psInner;
+	LADSPA_Descriptor * psDescriptor;
+	LADSPA_Descriptor * psExpected = NULL;
+
+	if (Index >= INSTRUMENT_MAX_DESCRIPTORS)
+		return NULL;
+	psDescriptor = __atomic_load_n(&g_apsInstrumentedDescriptors[Index], __ATOMIC_ACQUIRE);
+	if (psDescriptor)
+		return psDescriptor;
+
+	psInner = cmeUninstrumentedDescriptor(Index);
+	if (!psInner)
+		return NULL;
+	psDescriptor = wrapDescriptor(psInner);
+	if (!psDescriptor)
+		return NULL;
+	// (If another thread got there first, use its copy:)
+	if (!__atomic_compare_exchange_n(&g_apsInstrumentedDescriptors[Index], &psExpected, psDescriptor, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		freeDescriptor(psDescriptor);
+		return psExpected;
+	}
+	return psDescriptor;
+}
+
+
+__attribute__((destructor))
+static void
+freeDescriptors(void) {
+
+	int iIndex;
+
+	for (iIndex = 0; iIndex < INSTRUMENT_MAX_DESCRIPTORS; iIndex++)
+		freeDescriptor(g_apsInstrumentedDescriptors[iIndex]);
+}
+
+
+/* EOF */
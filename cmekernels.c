@@ -0,0 +1,475 @@
+/*
+Shared kernels: scalar reference versions and run-time CPU dispatch.  See cmekernels.h.
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#define CME_KERNEL_IMPLEMENTATION
+#include "cmekernels.h"
+
+#ifndef CME_NO_X86_KERNELS
+#include <cpuid.h>
+#endif
+
+
+
+/*****************************************************************************/
+
+/* Scalar reference kernels.  Keep these simple: they define what the ISA versions have to reproduce. */
+
+static void
+scaleScalar(const LADSPA_Data * Input,
+	    LADSPA_Data * Output,
+	    LADSPA_Data Gain,
+	    unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gain;
+}
+
+
+static void
+dualScaleScalar(const LADSPA_Data * LInput,
+		const LADSPA_Data * RInput,
+		LADSPA_Data * LOutput,
+		LADSPA_Data * ROutput,
+		LADSPA_Data LGain,
+		LADSPA_Data RGain,
+		unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+	LADSPA_Data fL, fR;
+
+	// Read both inputs before writing either output, so that e.g. pan with the input connected to the left output still works.
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] = fL * LGain;
+		ROutput[lSampleIndex] = fR * RGain;
+	}
+}
+
+
+static void
+scaleAddScalar(const LADSPA_Data * Input,
+	       LADSPA_Data * Output,
+	       LADSPA_Data Gain,
+	       unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gain;
+}
+
+
+static void
+dualScaleAddScalar(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   LADSPA_Data LGain,
+		   LADSPA_Data RGain,
+		   unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+	LADSPA_Data fL, fR;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] += fL * LGain;
+		ROutput[lSampleIndex] += fR * RGain;
+	}
+}
+
+
+static void
+zeroScalar(LADSPA_Data * Output,
+	   unsigned long SampleCount) {
+
+	memset(Output, 0, SampleCount * sizeof(LADSPA_Data));
+}
+
+
+static void
+statsScalar(const LADSPA_Data * Input,
+	    unsigned long SampleCount,
+	    CMEStats * psStats) {
+
+	LADSPA_Data afSums[CME_STATS_LANES] = { 0 };
+	LADSPA_Data fMin = psStats->Min;
+	LADSPA_Data fMax = psStats->Max;
+	LADSPA_Data fAbs;
+	unsigned long lSampleIndex;
+	unsigned long lLane;
+
+	for (lSampleIndex = 0; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES)
+		for (lLane = 0; lLane < CME_STATS_LANES; lLane++) {
+			fAbs = fabsf(Input[lSampleIndex + lLane]);
+			if (fAbs < fMin)	fMin = fAbs;
+			if (fAbs > fMax)	fMax = fAbs;
+			afSums[lLane] += Input[lSampleIndex + lLane] * Input[lSampleIndex + lLane];
+		}
+
+	cmeStatsFinish(afSums, fMin, fMax, Input + lSampleIndex, SampleCount - lSampleIndex, psStats);
+}
+
+
+static void
+truePeakScalar(const LADSPA_Data * Input,
+	       LADSPA_Data * Output,
+	       unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = cmeTruePeakSample(Input + lSampleIndex);
+}
+
+
+static int
+isSilentScalar(const LADSPA_Data * Input,
+	       unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+	uint32_t lBits;
+	uint32_t lAll = 0;
+
+	// (Compare the bits rather than the values, so subnormals count as signal whatever the FPU's DAZ setting, as they do in the vector versions.)
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		memcpy(&lBits, Input + lSampleIndex, sizeof(lBits));
+		lAll |= lBits;
+		if ((lSampleIndex & 15) == 15 && (lAll & 0x7FFFFFFF))
+			return 0;
+	}
+	return (lAll & 0x7FFFFFFF) == 0;
+}
+
+
+static void
+dualScaleStatsScalar(const LADSPA_Data * LInput,
+		     const LADSPA_Data * RInput,
+		     LADSPA_Data * LOutput,
+		     LADSPA_Data * ROutput,
+		     LADSPA_Data LGain,
+		     LADSPA_Data RGain,
+		     unsigned long SampleCount,
+		     CMEStats * psLStats,
+		     CMEStats * psRStats) {
+
+	LADSPA_Data afLSums[CME_STATS_LANES] = { 0 };
+	LADSPA_Data afRSums[CME_STATS_LANES] = { 0 };
+	LADSPA_Data fLMin = psLStats->Min, fLMax = psLStats->Max;
+	LADSPA_Data fRMin = psRStats->Min, fRMax = psRStats->Max;
+	LADSPA_Data fL, fR, fAbs;
+	unsigned long lSampleIndex;
+	unsigned long lLane;
+
+	for (lSampleIndex = 0; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES)
+		for (lLane = 0; lLane < CME_STATS_LANES; lLane++) {
+			fL = LInput[lSampleIndex + lLane] * LGain;
+			fR = RInput[lSampleIndex + lLane] * RGain;
+			LOutput[lSampleIndex + lLane] = fL;
+			ROutput[lSampleIndex + lLane] = fR;
+			fAbs = fabsf(fL);
+			if (fAbs < fLMin)	fLMin = fAbs;
+			if (fAbs > fLMax)	fLMax = fAbs;
+			afLSums[lLane] += fL * fL;
+			fAbs = fabsf(fR);
+			if (fAbs < fRMin)	fRMin = fAbs;
+			if (fAbs > fRMax)	fRMax = fAbs;
+			afRSums[lLane] += fR * fR;
+		}
+
+	cmeDualScaleStatsFinish(LInput, RInput, LOutput, ROutput, LGain, RGain, lSampleIndex, SampleCount,
+				afLSums, fLMin, fLMax, afRSums, fRMin, fRMax, psLStats, psRStats);
+}
+
+
+static void
+dbToGainScalar(const LADSPA_Data * GainDB,
+	       LADSPA_Data * Gains,
+	       LADSPA_Data Gain,
+	       unsigned long SampleCount) {
+	cmeDBToGainFinish(GainDB, Gains, Gain, 0, SampleCount);
+}
+
+
+static void
+panLawGainsScalar(const LADSPA_Data * Pan,
+		  const float * Table,
+		  LADSPA_Data * LGains,
+		  LADSPA_Data * RGains,
+		  LADSPA_Data Gain,
+		  unsigned long SampleCount) {
+	cmePanLawGainsFinish(Pan, Table, LGains, RGains, Gain, 0, SampleCount);
+}
+
+
+static void
+multiplyScalar(const LADSPA_Data * Input,
+	       const LADSPA_Data * Gains,
+	       LADSPA_Data * Output,
+	       unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gains[lSampleIndex];
+}
+
+
+static void
+multiplyAddScalar(const LADSPA_Data * Input,
+		  const LADSPA_Data * Gains,
+		  LADSPA_Data * Output,
+		  unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gains[lSampleIndex];
+}
+
+
+static void
+dualMultiplyScalar(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   const LADSPA_Data * LGains,
+		   const LADSPA_Data * RGains,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+	LADSPA_Data fL, fR;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] = fL;
+		ROutput[lSampleIndex] = fR;
+	}
+}
+
+
+static void
+dualMultiplyAddScalar(const LADSPA_Data * LInput,
+		      const LADSPA_Data * RInput,
+		      const LADSPA_Data * LGains,
+		      const LADSPA_Data * RGains,
+		      LADSPA_Data * LOutput,
+		      LADSPA_Data * ROutput,
+		      unsigned long SampleCount) {
+
+	unsigned long lSampleIndex;
+	LADSPA_Data fL, fR;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] += fL;
+		ROutput[lSampleIndex] += fR;
+	}
+}
+
+
+static void
+scaleRampScalar(const LADSPA_Data * Input,
+		LADSPA_Data * Output,
+		LADSPA_Data Gain,
+		LADSPA_Data Step,
+		unsigned long SampleCount) {
+	cmeScaleRampFinish(Input, Output, Gain, Step, 0, SampleCount, 0);
+}
+
+
+static void
+scaleRampAddScalar(const LADSPA_Data * Input,
+		   LADSPA_Data * Output,
+		   LADSPA_Data Gain,
+		   LADSPA_Data Step,
+		   unsigned long SampleCount) {
+	cmeScaleRampFinish(Input, Output, Gain, Step, 0, SampleCount, 1);
+}
+
+
+static void
+dualScaleRampScalar(const LADSPA_Data * LInput,
+		    const LADSPA_Data * RInput,
+		    LADSPA_Data * LOutput,
+		    LADSPA_Data * ROutput,
+		    LADSPA_Data LGain,
+		    LADSPA_Data LStep,
+		    LADSPA_Data RGain,
+		    LADSPA_Data RStep,
+		    unsigned long SampleCount) {
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, 0, SampleCount, 0);
+}
+
+
+static void
+dualScaleRampAddScalar(const LADSPA_Data * LInput,
+		       const LADSPA_Data * RInput,
+		       LADSPA_Data * LOutput,
+		       LADSPA_Data * ROutput,
+		       LADSPA_Data LGain,
+		       LADSPA_Data LStep,
+		       LADSPA_Data RGain,
+		       LADSPA_Data RStep,
+		       unsigned long SampleCount) {
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, 0, SampleCount, 1);
+}
+
+
+const CMEKernelTable g_sCMEKernelsScalar = {
+	"scalar",
+	scaleScalar,
+	dualScaleScalar,
+	scaleAddScalar,
+	dualScaleAddScalar,
+	zeroScalar,
+	statsScalar,
+	truePeakScalar,
+	isSilentScalar,
+	dualScaleStatsScalar,
+	dbToGainScalar,
+	panLawGainsScalar,
+	multiplyScalar,
+	multiplyAddScalar,
+	dualMultiplyScalar,
+	dualMultiplyAddScalar,
+	scaleRampScalar,
+	scaleRampAddScalar,
+	dualScaleRampScalar,
+	dualScaleRampAddScalar
+};
+
+
+
+/*****************************************************************************/
+
+/* Run-time dispatch. */
+
+CMEKernelTable g_sCMEKernels = {
+	"scalar",
+	scaleScalar,
+	dualScaleScalar,
+	scaleAddScalar,
+	dualScaleAddScalar,
+	zeroScalar,
+	statsScalar,
+	truePeakScalar,
+	isSilentScalar,
+	dualScaleStatsScalar,
+	dbToGainScalar,
+	panLawGainsScalar,
+	multiplyScalar,
+	multiplyAddScalar,
+	dualMultiplyScalar,
+	dualMultiplyAddScalar,
+	scaleRampScalar,
+	scaleRampAddScalar,
+	dualScaleRampScalar,
+	dualScaleRampAddScalar
+};
+
+
+#ifndef CME_NO_X86_KERNELS
+
+/* Read an extended control register; tells us which register states the OS saves on context switch. */
+static unsigned long long
+readXCR0(void) {
+	unsigned int uiLow, uiHigh;
+	__asm__ __volatile__ ("xgetbv" : "=a" (uiLow), "=d" (uiHigh) : "c" (0));
+	return ((unsigned long long)uiHigh << 32) | uiLow;
+}
+
+
+#define CME_ISA_SSE2	1
+#define CME_ISA_AVX2	2
+#define CME_ISA_AVX512	4
+
+static int
+detectISAs(void) {
+
+	unsigned int uiEAX, uiEBX, uiECX, uiEDX;
+	unsigned long long ullXCR0 = 0;
+	int iISAs = 0;
+
+	if (!__get_cpuid(1, &uiEAX, &uiEBX, &uiECX, &uiEDX))
+		return 0;
+
+	if (uiEDX & bit_SSE2)
+		iISAs |= CME_ISA_SSE2;
+
+	// AVX state has to be enabled by the OS as well as present in the CPU.
+	if (!(uiECX & bit_OSXSAVE) || !(uiECX & bit_AVX))
+		return iISAs;
+	ullXCR0 = readXCR0();
+	if ((ullXCR0 & 0x6) != 0x6)	// XMM and YMM state
+		return iISAs;
+
+	if (!__get_cpuid_count(7, 0, &uiEAX, &uiEBX, &uiECX, &uiEDX))
+		return iISAs;
+
+	if (uiEBX & bit_AVX2)
+		iISAs |= CME_ISA_AVX2;
+
+	if ((uiEBX & bit_AVX512F) && (ullXCR0 & 0xE6) == 0xE6)	// ...plus opmask and ZMM state
+		iISAs |= CME_ISA_AVX512;
+
+	return iISAs;
+}
+
+#endif
+
+
+const CMEKernelTable *
+cmeKernelsAvailable(unsigned long Index) {
+
+	const CMEKernelTable * apsTables[4];
+	unsigned long lCount = 0;
+
+	apsTables[lCount++] = &g_sCMEKernelsScalar;
+
+#ifndef CME_NO_X86_KERNELS
+	int iISAs = detectISAs();
+	if (iISAs & CME_ISA_SSE2)	apsTables[lCount++] = &g_sCMEKernelsSSE2;
+	if (iISAs & CME_ISA_AVX2)	apsTables[lCount++] = &g_sCMEKernelsAVX2;
+	if (iISAs & CME_ISA_AVX512)	apsTables[lCount++] = &g_sCMEKernelsAVX512;
+#endif
+
+	return Index < lCount ? apsTables[Index] : NULL;
+}
+
+
+void
+cmeKernelsInit(void) {
+
+	const CMEKernelTable * psTable;
+	const CMEKernelTable * psBest = &g_sCMEKernelsScalar;
+	const CMEKernelTable * psForced = NULL;
+	const char * pcForced = getenv("CME_KERNELS");
+	unsigned long lIndex;
+
+	// The available sets are listed in order of preference, so the last one wins unless the user asked for a particular (supported) one.
+	for (lIndex = 0; (psTable = cmeKernelsAvailable(lIndex)) != NULL; lIndex++) {
+		psBest = psTable;
+		if (pcForced && strcmp(pcForced, psTable->Name) == 0)
+			psForced = psTable;
+	}
+
+	g_sCMEKernels = psForced ? *psForced : *psBest;
+}
+
+
+/* EOF */
@@ -0,0 +1,419 @@
+/*
+Shared inner-loop kernels for the CME LADSPA plugins.
+
+Each plugin library links a copy of these objects.  There is a plain C reference version of every kernel, plus hand-written SSE2, AVX2 and AVX-512 versions on x86.  cmeKernelsInit() picks the best set the CPU (and OS) supports, once, from the plugin's _init(); run() functions then call through g_sCMEKernels.
+
+All ISA versions produce bit-identical results to the reference version, including the sum-of-squares reduction: every version accumulates into the same CME_STATS_LANES partial sums and then reduces them in the same fixed order (see cmeStatsFinish()).  For that reason the kernels are compiled with -ffp-contract=off, so the compiler doesn't fuse multiplies and adds behind our backs.  Min and max skip NaN samples everywhere, as the scalar comparisons do.  The one thing that isn't pinned down is which NaN comes out where the result is NaN (its sign and payload depend on operand order, which C lets the compiler choose): every version gives a NaN there, but not necessarily the same one.  "make check" holds every version to all this (see cmecheck.c).
+
+Every kernel but TruePeak (which reads the samples before each one) may be run in place: any output may be the very same buffer as any input (e.g. DualScale with LOutput == RInput and ROutput == LInput), because each version loads sample i (or the vector holding it) from all its inputs before it stores sample i to any output.  The pointers aren't restrict for the same reason.  Buffers that overlap only partly, offset from each other, aren't supported.
+
+Setting the environment variable CME_KERNELS to "scalar", "sse2", "avx2" or "avx512" forces a particular set (if it's supported), which is handy for benchmarking.
+
+CME 2026-10
+*/
+
+#ifndef CMEKERNELS_H
+#define CMEKERNELS_H
+
+#include "ladspa.h"
+
+/* Keep the kernel symbols private to each plugin library, so that two of our libraries loaded into the same host can't interpose on each other. */
+#pragma GCC visibility push(hidden)
+
+
+/* Number of partial sums kept by the sum-of-squares reduction (the width of one AVX-512 register). */
+#define CME_STATS_LANES	16
+
+
+/* Shape of the true-peak oversampling filter: a 48-tap FIR split into 4 polyphase branches of 12 taps (ITU-R BS.1770-4, Annex 2). */
+#define CME_TRUE_PEAK_PHASES	4
+#define CME_TRUE_PEAK_TAPS	12
+
+
+/* Audio-rate (per-sample) gain and pan controls are turned into gains this many samples at a time, by DBToGain or PanLawGains into a buffer on the stack, which (Dual)Multiply(Add) then applies.  Working out a chunk's gains before writing any of its output keeps that in-place safe, even when an output is on the control's own buffer. */
+#define CME_GAIN_CHUNK	64
+
+
+/* Pan laws are tabulated at this many equal segments of the pan position, -1 .. 1, for PanLawGains (see cmepanlaw.h). */
+#define CME_PAN_LAW_SEGMENTS	1024
+
+
+/* Running block statistics, as used by the level meter.  The Stats kernel merges a buffer into these, so initialise them before the first call. */
+typedef struct {
+	LADSPA_Data Min;		// Smallest absolute sample value
+	LADSPA_Data Max;		// Largest absolute sample value
+	LADSPA_Data SumOfSquares;
+} CMEStats;
+
+
+typedef struct {
+	const char * Name;
+
+	/* Output[i] = Input[i] * Gain */
+	void (*Scale)(const LADSPA_Data * Input,
+		      LADSPA_Data * Output,
+		      LADSPA_Data Gain,
+		      unsigned long SampleCount);
+
+	/* LOutput[i] = LInput[i] * LGain; ROutput[i] = RInput[i] * RGain.  LInput and RInput may be the same buffer (pan). */
+	void (*DualScale)(const LADSPA_Data * LInput,
+			  const LADSPA_Data * RInput,
+			  LADSPA_Data * LOutput,
+			  LADSPA_Data * ROutput,
+			  LADSPA_Data LGain,
+			  LADSPA_Data RGain,
+			  unsigned long SampleCount);
+
+	/* Output[i] += Input[i] * Gain (for run_adding()) */
+	void (*ScaleAdd)(const LADSPA_Data * Input,
+			 LADSPA_Data * Output,
+			 LADSPA_Data Gain,
+			 unsigned long SampleCount);
+
+	/* LOutput[i] += LInput[i] * LGain; ROutput[i] += RInput[i] * RGain */
+	void (*DualScaleAdd)(const LADSPA_Data * LInput,
+			     const LADSPA_Data * RInput,
+			     LADSPA_Data * LOutput,
+			     LADSPA_Data * ROutput,
+			     LADSPA_Data LGain,
+			     LADSPA_Data RGain,
+			     unsigned long SampleCount);
+
+	/* Output[i] = 0 */
+	void (*Zero)(LADSPA_Data * Output,
+		     unsigned long SampleCount);
+
+	/* Merge min/max of |Input[i]| and the sum of Input[i]^2 into *Stats. */
+	void (*Stats)(const LADSPA_Data * Input,
+		      unsigned long SampleCount,
+		      CMEStats * Stats);
+
+	/* Output[i] = the largest |y| of the four 4x-oversampled values y interpolated at Input[i], i.e. the true peak of that sample period.  Input[-(CME_TRUE_PEAK_TAPS - 1)] .. Input[-1] must hold the preceding samples, and Output can't be Input. */
+	void (*TruePeak)(const LADSPA_Data * Input,
+			 LADSPA_Data * Output,
+			 unsigned long SampleCount);
+
+	/* 1 if every Input[i] is +0 or -0, else 0.  Stops at the first group of samples with anything in it, so it's cheapest on signal and costs a read of the buffer on silence. */
+	int (*IsSilent)(const LADSPA_Data * Input,
+			unsigned long SampleCount);
+
+	/* DualScale and then Stats of each output into *LStats and *RStats, in one pass: the statistics are exactly those Stats would give on LOutput and ROutput afterwards. */
+	void (*DualScaleStats)(const LADSPA_Data * LInput,
+			       const LADSPA_Data * RInput,
+			       LADSPA_Data * LOutput,
+			       LADSPA_Data * ROutput,
+			       LADSPA_Data LGain,
+			       LADSPA_Data RGain,
+			       unsigned long SampleCount,
+			       CMEStats * LStats,
+			       CMEStats * RStats);
+
+	/* Gains[i] = cmeDBToGain(GainDB[i]) * Gain (see cmemath.h), bit for bit */
+	void (*DBToGain)(const LADSPA_Data * GainDB,
+			 LADSPA_Data * Gains,
+			 LADSPA_Data Gain,
+			 unsigned long SampleCount);
+
+	/* LGains[i] = g(-x) * Gain; RGains[i] = g(x) * Gain, where x is Pan[i] clamped to -1 .. 1 (NaN reads as -1), and g is a pan law interpolated linearly from Table: CME_PAN_LAW_SEGMENTS {value, delta} pairs, g(-1 + 2k / CME_PAN_LAW_SEGMENTS) at Table[2k] and the change to the next point at Table[2k + 1].  Table must be 8-byte aligned */
+	void (*PanLawGains)(const LADSPA_Data * Pan,
+			    const float * Table,
+			    LADSPA_Data * LGains,
+			    LADSPA_Data * RGains,
+			    LADSPA_Data Gain,
+			    unsigned long SampleCount);
+
+	/* Output[i] = Input[i] * Gains[i] */
+	void (*Multiply)(const LADSPA_Data * Input,
+			 const LADSPA_Data * Gains,
+			 LADSPA_Data * Output,
+			 unsigned long SampleCount);
+
+	/* Output[i] += Input[i] * Gains[i] */
+	void (*MultiplyAdd)(const LADSPA_Data * Input,
+			    const LADSPA_Data * Gains,
+			    LADSPA_Data * Output,
+			    unsigned long SampleCount);
+
+	/* LOutput[i] = LInput[i] * LGains[i]; ROutput[i] = RInput[i] * RGains[i].  LInput and RInput may be the same buffer (pan), as may LGains and RGains (stereo gain). */
+	void (*DualMultiply)(const LADSPA_Data * LInput,
+			     const LADSPA_Data * RInput,
+			     const LADSPA_Data * LGains,
+			     const LADSPA_Data * RGains,
+			     LADSPA_Data * LOutput,
+			     LADSPA_Data * ROutput,
+			     unsigned long SampleCount);
+
+	/* LOutput[i] += LInput[i] * LGains[i]; ROutput[i] += RInput[i] * RGains[i] */
+	void (*DualMultiplyAdd)(const LADSPA_Data * LInput,
+				const LADSPA_Data * RInput,
+				const LADSPA_Data * LGains,
+				const LADSPA_Data * RGains,
+				LADSPA_Data * LOutput,
+				LADSPA_Data * ROutput,
+				unsigned long SampleCount);
+
+	/* Output[i] = Input[i] * (Gain + i * Step): Scale with the gain ramping linearly, for smoothing control changes (see cmesmooth.h).  SampleCount must be below 2^24, so that i is exact as a float. */
+	void (*ScaleRamp)(const LADSPA_Data * Input,
+			  LADSPA_Data * Output,
+			  LADSPA_Data Gain,
+			  LADSPA_Data Step,
+			  unsigned long SampleCount);
+
+	/* Output[i] += Input[i] * (Gain + i * Step) */
+	void (*ScaleRampAdd)(const LADSPA_Data * Input,
+			     LADSPA_Data * Output,
+			     LADSPA_Data Gain,
+			     LADSPA_Data Step,
+			     unsigned long SampleCount);
+
+	/* LOutput[i] = LInput[i] * (LGain + i * LStep); ROutput[i] = RInput[i] * (RGain + i * RStep) */
+	void (*DualScaleRamp)(const LADSPA_Data * LInput,
+			      const LADSPA_Data * RInput,
+			      LADSPA_Data * LOutput,
+			      LADSPA_Data * ROutput,
+			      LADSPA_Data LGain,
+			      LADSPA_Data LStep,
+			      LADSPA_Data RGain,
+			      LADSPA_Data RStep,
+			      unsigned long SampleCount);
+
+	/* LOutput[i] += LInput[i] * (LGain + i * LStep); ROutput[i] += RInput[i] * (RGain + i * RStep) */
+	void (*DualScaleRampAdd)(const LADSPA_Data * LInput,
+				 const LADSPA_Data * RInput,
+				 LADSPA_Data * LOutput,
+				 LADSPA_Data * ROutput,
+				 LADSPA_Data LGain,
+				 LADSPA_Data LStep,
+				 LADSPA_Data RGain,
+				 LADSPA_Data RStep,
+				 unsigned long SampleCount);
+} CMEKernelTable;
+
+
+/* The kernel set chosen by cmeKernelsInit(). */
+extern CMEKernelTable g_sCMEKernels;
+
+/* Choose the kernel set for this CPU.  Safe to call more than once. */
+void cmeKernelsInit(void);
+
+/* Return the Index'th kernel set supported on this machine (0 is always the scalar reference), or NULL past the end.  Used for benchmarking and checking the ISA versions against each other. */
+const CMEKernelTable * cmeKernelsAvailable(unsigned long Index);
+
+
+/* The individual kernel sets.  The ISA-specific ones are only compiled on x86, and must only be used if cmeKernelsAvailable() says so. */
+extern const CMEKernelTable g_sCMEKernelsScalar;
+#ifndef CME_NO_X86_KERNELS
+extern const CMEKernelTable g_sCMEKernelsSSE2;
+extern const CMEKernelTable g_sCMEKernelsAVX2;
+extern const CMEKernelTable g_sCMEKernelsAVX512;
+#endif
+
+
+#ifdef CME_KERNEL_IMPLEMENTATION
+
+#include <math.h>
+
+#include "cmemath.h"
+
+/* Shared tail handling for the Stats kernels.  The vector loops handle whole groups of CME_STATS_LANES samples, leaving lane j's partial sum in LaneSums[j]; the (< CME_STATS_LANES) remaining samples are added here, lane by lane, and the lanes are then reduced pairwise (16 -> 8 -> 4 -> 2 -> 1).  Using this for every ISA is what makes their results identical. */
+static inline void
+cmeStatsFinish(LADSPA_Data * LaneSums,
+	       LADSPA_Data Min,
+	       LADSPA_Data Max,
+	       const LADSPA_Data * Tail,
+	       unsigned long TailCount,
+	       CMEStats * psStats) {
+
+	unsigned long lIndex;
+	unsigned long lWidth;
+	LADSPA_Data fAbs;
+
+	for (lIndex = 0; lIndex < TailCount; lIndex++) {
+		fAbs = fabsf(Tail[lIndex]);
+		if (fAbs < Min)	Min = fAbs;
+		if (fAbs > Max)	Max = fAbs;
+		LaneSums[lIndex] += Tail[lIndex] * Tail[lIndex];
+	}
+
+	for (lWidth = CME_STATS_LANES / 2; lWidth > 0; lWidth /= 2)
+		for (lIndex = 0; lIndex < lWidth; lIndex++)
+			LaneSums[lIndex] += LaneSums[lIndex + lWidth];
+
+	if (Min < psStats->Min)	psStats->Min = Min;
+	if (Max > psStats->Max)	psStats->Max = Max;
+	psStats->SumOfSquares += LaneSums[0];
+}
+
+
+/* Shared tail handling for the DualScaleStats kernels: scale samples Index .. SampleCount - 1 (reading both inputs before writing either output, for in-place use), then finish each channel's statistics as cmeStatsFinish() does, over the output. */
+static inline void
+cmeDualScaleStatsFinish(const LADSPA_Data * LInput,
+			const LADSPA_Data * RInput,
+			LADSPA_Data * LOutput,
+			LADSPA_Data * ROutput,
+			LADSPA_Data LGain,
+			LADSPA_Data RGain,
+			unsigned long Index,
+			unsigned long SampleCount,
+			LADSPA_Data * LLaneSums,
+			LADSPA_Data LMin,
+			LADSPA_Data LMax,
+			LADSPA_Data * RLaneSums,
+			LADSPA_Data RMin,
+			LADSPA_Data RMax,
+			CMEStats * LStats,
+			CMEStats * RStats) {
+
+	unsigned long lSampleIndex;
+	LADSPA_Data fL, fR;
+
+	for (lSampleIndex = Index; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] = fL * LGain;
+		ROutput[lSampleIndex] = fR * RGain;
+	}
+	cmeStatsFinish(LLaneSums, LMin, LMax, LOutput + Index, SampleCount - Index, LStats);
+	cmeStatsFinish(RLaneSums, RMin, RMax, ROutput + Index, SampleCount - Index, RStats);
+}
+
+
+/* The BS.1770-4 interpolation filter, by phase.  Tap k of each phase is applied to Input[-k].  (Phases 2 and 3 are phases 1 and 0 reversed.) */
+static const LADSPA_Data g_aafCMETruePeakTaps[CME_TRUE_PEAK_PHASES][CME_TRUE_PEAK_TAPS] = {
+	{  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+	  -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+	   0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+	{ -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+	  -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+	   0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+	{ -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+	  -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+	   0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+	{ -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+	  -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+	   0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+};
+
+
+/* True peak of one sample period, for the scalar kernel and the vector kernels' tails.  Each phase is summed tap 0 first, tap 11 last, which is the order every vector version uses in each lane. */
+static inline LADSPA_Data
+cmeTruePeakSample(const LADSPA_Data * Input) {
+
+	LADSPA_Data fSum;
+	LADSPA_Data fPeak = 0.0f;
+	int iPhase, iTap;
+
+	for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++) {
+		fSum = g_aafCMETruePeakTaps[iPhase][0] * Input[0];
+		for (iTap = 1; iTap < CME_TRUE_PEAK_TAPS; iTap++)
+			fSum += g_aafCMETruePeakTaps[iPhase][iTap] * Input[-iTap];
+		if (fabsf(fSum) > fPeak)
+			fPeak = fabsf(fSum);
+	}
+	return fPeak;
+}
+
+
+/* Scalar tails of the ScaleRamp kernels, from sample Index on (and the scalar versions, from 0).  Adding selects the Add versions; it's a constant wherever this is inlined. */
+static inline void
+cmeScaleRampFinish(const LADSPA_Data * Input,
+		   LADSPA_Data * Output,
+		   LADSPA_Data Gain,
+		   LADSPA_Data Step,
+		   unsigned long Index,
+		   unsigned long SampleCount,
+		   int Adding) {
+
+	LADSPA_Data fOut;
+
+	for (; Index < SampleCount; Index++) {
+		fOut = Input[Index] * (Gain + (LADSPA_Data)Index * Step);
+		if (Adding)
+			Output[Index] += fOut;
+		else
+			Output[Index] = fOut;
+	}
+}
+
+
+static inline void
+cmeDualScaleRampFinish(const LADSPA_Data * LInput,
+		       const LADSPA_Data * RInput,
+		       LADSPA_Data * LOutput,
+		       LADSPA_Data * ROutput,
+		       LADSPA_Data LGain,
+		       LADSPA_Data LStep,
+		       LADSPA_Data RGain,
+		       LADSPA_Data RStep,
+		       unsigned long Index,
+		       unsigned long SampleCount,
+		       int Adding) {
+
+	LADSPA_Data fL, fR;
+
+	for (; Index < SampleCount; Index++) {
+		fL = LInput[Index] * (LGain + (LADSPA_Data)Index * LStep);
+		fR = RInput[Index] * (RGain + (LADSPA_Data)Index * RStep);
+		if (Adding) {
+			LOutput[Index] += fL;
+			ROutput[Index] += fR;
+		}
+		else {
+			LOutput[Index] = fL;
+			ROutput[Index] = fR;
+		}
+	}
+}
+
+
+/* Scalar tails of the DBToGain and PanLawGains kernels, from sample Index on. */
+static inline void
+cmeDBToGainFinish(const LADSPA_Data * GainDB,
+		  LADSPA_Data * Gains,
+		  LADSPA_Data Gain,
+		  unsigned long Index,
+		  unsigned long SampleCount) {
+
+	for (; Index < SampleCount; Index++)
+		Gains[Index] = cmeDBToGain(GainDB[Index]) * Gain;
+}
+
+
+/* One side's gain, from the position (0 .. CME_PAN_LAW_SEGMENTS) along the table, in the same order of operations as the vector versions. */
+static inline LADSPA_Data
+cmePanLawInterpolate(const float * Table,
+		     LADSPA_Data Position) {
+
+	LADSPA_Data fIndex = Position < CME_PAN_LAW_SEGMENTS - 1 ? Position : CME_PAN_LAW_SEGMENTS - 1;
+	int iIndex = (int)fIndex;
+
+	return Table[2 * iIndex] + (Position - (LADSPA_Data)iIndex) * Table[2 * iIndex + 1];
+}
+
+
+static inline void
+cmePanLawGainsFinish(const LADSPA_Data * Pan,
+		     const float * Table,
+		     LADSPA_Data * LGains,
+		     LADSPA_Data * RGains,
+		     LADSPA_Data Gain,
+		     unsigned long Index,
+		     unsigned long SampleCount) {
+
+	LADSPA_Data fPan;
+
+	for (; Index < SampleCount; Index++) {
+		fPan = Pan[Index];
+		fPan = fPan > -1.0f ? fPan : -1.0f;	// (as _mm_max_ps(), so NaN goes to -1)
+		fPan = fPan < 1.0f ? fPan : 1.0f;
+		LGains[Index] = cmePanLawInterpolate(Table, (1.0f - fPan) * (CME_PAN_LAW_SEGMENTS / 2)) * Gain;
+		RGains[Index] = cmePanLawInterpolate(Table, (fPan + 1.0f) * (CME_PAN_LAW_SEGMENTS / 2)) * Gain;
+	}
+}
+
+#endif /* CME_KERNEL_IMPLEMENTATION */
+
+
+#pragma GCC visibility pop
+
+#endif /* CMEKERNELS_H */
@@ -0,0 +1,607 @@
+/*
+Shared kernels: AVX2 versions.  Compiled with -mavx2; only called if cmeKernelsInit() found AVX2 (and OS support for the YMM registers).
+CME 2026-10
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#define CME_KERNEL_IMPLEMENTATION
+#include "cmekernels.h"
+
+
+
+static void
+scaleAVX2(const LADSPA_Data * Input,
+	  LADSPA_Data * Output,
+	  LADSPA_Data Gain,
+	  unsigned long SampleCount) {
+
+	__m256 vGain = _mm256_set1_ps(Gain);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		__m256 v0 = _mm256_loadu_ps(Input + lSampleIndex);
+		__m256 v1 = _mm256_loadu_ps(Input + lSampleIndex + 8);
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_mul_ps(v0, vGain));
+		_mm256_storeu_ps(Output + lSampleIndex + 8, _mm256_mul_ps(v1, vGain));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gain;
+}
+
+
+static void
+dualScaleAVX2(const LADSPA_Data * LInput,
+	      const LADSPA_Data * RInput,
+	      LADSPA_Data * LOutput,
+	      LADSPA_Data * ROutput,
+	      LADSPA_Data LGain,
+	      LADSPA_Data RGain,
+	      unsigned long SampleCount) {
+
+	__m256 vLGain = _mm256_set1_ps(LGain);
+	__m256 vRGain = _mm256_set1_ps(RGain);
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vL = _mm256_loadu_ps(LInput + lSampleIndex);
+		__m256 vR = _mm256_loadu_ps(RInput + lSampleIndex);
+		_mm256_storeu_ps(LOutput + lSampleIndex, _mm256_mul_ps(vL, vLGain));
+		_mm256_storeu_ps(ROutput + lSampleIndex, _mm256_mul_ps(vR, vRGain));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] = fL * LGain;
+		ROutput[lSampleIndex] = fR * RGain;
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleAddAVX2(const LADSPA_Data * Input,
+	     LADSPA_Data * Output,
+	     LADSPA_Data Gain,
+	     unsigned long SampleCount) {
+
+	__m256 vGain = _mm256_set1_ps(Gain);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		__m256 v0 = _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex), vGain);
+		__m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex + 8), vGain);
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(Output + lSampleIndex), v0));
+		_mm256_storeu_ps(Output + lSampleIndex + 8, _mm256_add_ps(_mm256_loadu_ps(Output + lSampleIndex + 8), v1));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gain;
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleAddAVX2(const LADSPA_Data * LInput,
+		 const LADSPA_Data * RInput,
+		 LADSPA_Data * LOutput,
+		 LADSPA_Data * ROutput,
+		 LADSPA_Data LGain,
+		 LADSPA_Data RGain,
+		 unsigned long SampleCount) {
+
+	__m256 vLGain = _mm256_set1_ps(LGain);
+	__m256 vRGain = _mm256_set1_ps(RGain);
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vL = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), vLGain);
+		__m256 vR = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), vRGain);
+		_mm256_storeu_ps(LOutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm256_storeu_ps(ROutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] += fL * LGain;
+		ROutput[lSampleIndex] += fR * RGain;
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+zeroAVX2(LADSPA_Data * Output,
+	 unsigned long SampleCount) {
+
+	__m256 vZero = _mm256_setzero_ps();
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		_mm256_storeu_ps(Output + lSampleIndex, vZero);
+		_mm256_storeu_ps(Output + lSampleIndex + 8, vZero);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = 0.0;
+	_mm256_zeroupper();
+}
+
+
+static void
+statsAVX2(const LADSPA_Data * Input,
+	  unsigned long SampleCount,
+	  CMEStats * psStats) {
+
+	// Two registers of eight lanes make up the CME_STATS_LANES partial sums.
+	__m256 vSum0 = _mm256_setzero_ps(), vSum1 = _mm256_setzero_ps();
+	__m256 vMin = _mm256_set1_ps(psStats->Min);
+	__m256 vMax = _mm256_set1_ps(psStats->Max);
+	__m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	__m128 vMin4, vMax4;
+	LADSPA_Data afSums[CME_STATS_LANES];
+	LADSPA_Data fMin, fMax;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		__m256 v0 = _mm256_loadu_ps(Input + lSampleIndex);
+		__m256 v1 = _mm256_loadu_ps(Input + lSampleIndex + 8);
+		vSum0 = _mm256_add_ps(vSum0, _mm256_mul_ps(v0, v0));
+		vSum1 = _mm256_add_ps(vSum1, _mm256_mul_ps(v1, v1));
+		v0 = _mm256_and_ps(v0, vAbsMask);
+		v1 = _mm256_and_ps(v1, vAbsMask);
+		// (New values first: min/max give the second operand if either is NaN, so NaN samples are skipped, as in the scalar version.)
+		vMin = _mm256_min_ps(v1, _mm256_min_ps(v0, vMin));
+		vMax = _mm256_max_ps(v1, _mm256_max_ps(v0, vMax));
+	}
+
+	_mm256_storeu_ps(afSums, vSum0);
+	_mm256_storeu_ps(afSums + 8, vSum1);
+
+	// Horizontal min/max (exact, so the order doesn't matter):
+	vMin4 = _mm_min_ps(_mm256_castps256_ps128(vMin), _mm256_extractf128_ps(vMin, 1));
+	vMax4 = _mm_max_ps(_mm256_castps256_ps128(vMax), _mm256_extractf128_ps(vMax, 1));
+	vMin4 = _mm_min_ps(vMin4, _mm_movehl_ps(vMin4, vMin4));
+	vMax4 = _mm_max_ps(vMax4, _mm_movehl_ps(vMax4, vMax4));
+	vMin4 = _mm_min_ss(vMin4, _mm_shuffle_ps(vMin4, vMin4, 1));
+	vMax4 = _mm_max_ss(vMax4, _mm_shuffle_ps(vMax4, vMax4, 1));
+	fMin = _mm_cvtss_f32(vMin4);
+	fMax = _mm_cvtss_f32(vMax4);
+	_mm256_zeroupper();
+
+	cmeStatsFinish(afSums, fMin, fMax, Input + lSampleIndex, SampleCount - lSampleIndex, psStats);
+}
+
+
+static void
+truePeakAVX2(const LADSPA_Data * Input,
+	      LADSPA_Data * Output,
+	      unsigned long SampleCount) {
+
+	// 8 output samples per step, one per lane; each lane sums its taps in the same order as cmeTruePeakSample().
+	__m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	unsigned long lSampleIndex = 0;
+	int iPhase, iTap;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 avSum[CME_TRUE_PEAK_PHASES];
+		__m256 vInput = _mm256_loadu_ps(Input + lSampleIndex);
+		__m256 vPeak;
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			avSum[iPhase] = _mm256_mul_ps(_mm256_set1_ps(g_aafCMETruePeakTaps[iPhase][0]), vInput);
+		for (iTap = 1; iTap < CME_TRUE_PEAK_TAPS; iTap++) {
+			vInput = _mm256_loadu_ps(Input + lSampleIndex - iTap);
+			for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+				avSum[iPhase] = _mm256_add_ps(avSum[iPhase], _mm256_mul_ps(_mm256_set1_ps(g_aafCMETruePeakTaps[iPhase][iTap]), vInput));
+		}
+		// (Phase by phase from 0, as cmeTruePeakSample(), so a NaN phase is skipped:)
+		vPeak = _mm256_setzero_ps();
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			vPeak = _mm256_max_ps(_mm256_and_ps(avSum[iPhase], vAbsMask), vPeak);
+		_mm256_storeu_ps(Output + lSampleIndex, vPeak);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = cmeTruePeakSample(Input + lSampleIndex);
+	_mm256_zeroupper();
+}
+
+
+static int
+isSilentAVX2(const LADSPA_Data * Input,
+	     unsigned long SampleCount) {
+
+	// OR the bits of 32 samples together, drop the sign bits and see if anything is left:
+	__m256i vAbsMask = _mm256_set1_epi32(0x7FFFFFFF);
+	__m256i vBits;
+	unsigned long lSampleIndex = 0;
+	uint32_t lBits;
+
+	for (; lSampleIndex + 32 <= SampleCount; lSampleIndex += 32) {
+		vBits = _mm256_or_si256(_mm256_or_si256(_mm256_castps_si256(_mm256_loadu_ps(Input + lSampleIndex)),
+							_mm256_castps_si256(_mm256_loadu_ps(Input + lSampleIndex + 8))),
+					_mm256_or_si256(_mm256_castps_si256(_mm256_loadu_ps(Input + lSampleIndex + 16)),
+							_mm256_castps_si256(_mm256_loadu_ps(Input + lSampleIndex + 24))));
+		if (!_mm256_testz_si256(vBits, vAbsMask)) {
+			_mm256_zeroupper();
+			return 0;
+		}
+	}
+	_mm256_zeroupper();
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		memcpy(&lBits, Input + lSampleIndex, sizeof(lBits));
+		if (lBits & 0x7FFFFFFF)
+			return 0;
+	}
+	return 1;
+}
+
+
+static void
+dualScaleStatsAVX2(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   LADSPA_Data LGain,
+		   LADSPA_Data RGain,
+		   unsigned long SampleCount,
+		   CMEStats * psLStats,
+		   CMEStats * psRStats) {
+
+	// As statsAVX2(), for both outputs: two registers of eight lanes each make up the CME_STATS_LANES partial sums.
+	__m256 vLSum0 = _mm256_setzero_ps(), vLSum1 = _mm256_setzero_ps();
+	__m256 vRSum0 = _mm256_setzero_ps(), vRSum1 = _mm256_setzero_ps();
+	__m256 vLMin = _mm256_set1_ps(psLStats->Min), vLMax = _mm256_set1_ps(psLStats->Max);
+	__m256 vRMin = _mm256_set1_ps(psRStats->Min), vRMax = _mm256_set1_ps(psRStats->Max);
+	__m256 vLGain = _mm256_set1_ps(LGain);
+	__m256 vRGain = _mm256_set1_ps(RGain);
+	__m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	LADSPA_Data afLSums[CME_STATS_LANES], afRSums[CME_STATS_LANES];
+	LADSPA_Data afLMin[8], afLMax[8], afRMin[8], afRMax[8];
+	LADSPA_Data fLMin, fLMax, fRMin, fRMax;
+	unsigned long lSampleIndex = 0;
+	int iLane;
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		__m256 vL0 = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), vLGain);
+		__m256 vR0 = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), vRGain);
+		__m256 vL1 = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex + 8), vLGain);
+		__m256 vR1 = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex + 8), vRGain);
+		_mm256_storeu_ps(LOutput + lSampleIndex, vL0);
+		_mm256_storeu_ps(ROutput + lSampleIndex, vR0);
+		_mm256_storeu_ps(LOutput + lSampleIndex + 8, vL1);
+		_mm256_storeu_ps(ROutput + lSampleIndex + 8, vR1);
+		vLSum0 = _mm256_add_ps(vLSum0, _mm256_mul_ps(vL0, vL0));
+		vLSum1 = _mm256_add_ps(vLSum1, _mm256_mul_ps(vL1, vL1));
+		vRSum0 = _mm256_add_ps(vRSum0, _mm256_mul_ps(vR0, vR0));
+		vRSum1 = _mm256_add_ps(vRSum1, _mm256_mul_ps(vR1, vR1));
+		vL0 = _mm256_and_ps(vL0, vAbsMask);
+		vL1 = _mm256_and_ps(vL1, vAbsMask);
+		vR0 = _mm256_and_ps(vR0, vAbsMask);
+		vR1 = _mm256_and_ps(vR1, vAbsMask);
+		vLMin = _mm256_min_ps(vL1, _mm256_min_ps(vL0, vLMin));	// (as in statsAVX2())
+		vLMax = _mm256_max_ps(vL1, _mm256_max_ps(vL0, vLMax));
+		vRMin = _mm256_min_ps(vR1, _mm256_min_ps(vR0, vRMin));
+		vRMax = _mm256_max_ps(vR1, _mm256_max_ps(vR0, vRMax));
+	}
+
+	_mm256_storeu_ps(afLSums, vLSum0);
+	_mm256_storeu_ps(afLSums + 8, vLSum1);
+	_mm256_storeu_ps(afRSums, vRSum0);
+	_mm256_storeu_ps(afRSums + 8, vRSum1);
+	_mm256_storeu_ps(afLMin, vLMin);
+	_mm256_storeu_ps(afLMax, vLMax);
+	_mm256_storeu_ps(afRMin, vRMin);
+	_mm256_storeu_ps(afRMax, vRMax);
+	_mm256_zeroupper();
+	fLMin = afLMin[0];	fLMax = afLMax[0];
+	fRMin = afRMin[0];	fRMax = afRMax[0];
+	for (iLane = 1; iLane < 8; iLane++) {
+		if (afLMin[iLane] < fLMin)	fLMin = afLMin[iLane];
+		if (afLMax[iLane] > fLMax)	fLMax = afLMax[iLane];
+		if (afRMin[iLane] < fRMin)	fRMin = afRMin[iLane];
+		if (afRMax[iLane] > fRMax)	fRMax = afRMax[iLane];
+	}
+
+	cmeDualScaleStatsFinish(LInput, RInput, LOutput, ROutput, LGain, RGain, lSampleIndex, SampleCount,
+				afLSums, fLMin, fLMax, afRSums, fRMin, fRMax, psLStats, psRStats);
+}
+
+
+/* Vector cmeExp2f(): the same steps, lane by lane (rounding x + 0.5 down with floor, which is what the scalar truncate-and-correct comes to). */
+static inline __m256
+exp2AVX2(__m256 vX) {
+
+	__m256 vUnderflow = _mm256_cmp_ps(vX, _mm256_set1_ps(-126.0f), _CMP_LT_OQ);
+	__m256 vFrac, vScale, vPoly;
+	__m256i viWhole;
+
+	vX = _mm256_min_ps(_mm256_set1_ps(127.0f), vX);	// (NaN stays NaN)
+	viWhole = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(vX, _mm256_set1_ps(0.5f))));
+	vFrac = _mm256_sub_ps(vX, _mm256_cvtepi32_ps(viWhole));
+	vScale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(viWhole, _mm256_set1_epi32(127)), 23));
+
+	vPoly = _mm256_add_ps(_mm256_set1_ps(CME_EXP2_C4), _mm256_mul_ps(vFrac, _mm256_set1_ps(CME_EXP2_C5)));
+	vPoly = _mm256_add_ps(_mm256_set1_ps(CME_EXP2_C3), _mm256_mul_ps(vFrac, vPoly));
+	vPoly = _mm256_add_ps(_mm256_set1_ps(CME_EXP2_C2), _mm256_mul_ps(vFrac, vPoly));
+	vPoly = _mm256_add_ps(_mm256_set1_ps(CME_EXP2_C1), _mm256_mul_ps(vFrac, vPoly));
+	vPoly = _mm256_add_ps(_mm256_set1_ps(CME_EXP2_C0), _mm256_mul_ps(vFrac, vPoly));
+
+	return _mm256_andnot_ps(vUnderflow, _mm256_mul_ps(vScale, vPoly));
+}
+
+
+static void
+dbToGainAVX2(const LADSPA_Data * GainDB,
+	     LADSPA_Data * Gains,
+	     LADSPA_Data Gain,
+	     unsigned long SampleCount) {
+
+	__m256 vGain = _mm256_set1_ps(Gain);
+	__m256 vDBToLog2 = _mm256_set1_ps(CME_DB_TO_LOG2);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vDB = _mm256_loadu_ps(GainDB + lSampleIndex);
+		_mm256_storeu_ps(Gains + lSampleIndex, _mm256_mul_ps(exp2AVX2(_mm256_mul_ps(vDB, vDBToLog2)), vGain));
+	}
+	cmeDBToGainFinish(GainDB, Gains, Gain, lSampleIndex, SampleCount);
+	_mm256_zeroupper();
+}
+
+
+/* Interpolate one side's table for 8 positions: gather the {value, delta} pairs as doubles, 4 at a time (which takes half the gathered elements of separate value and delta gathers), and split them into values and deltas. */
+static inline __m256
+panLawSideAVX2(const float * Table,
+	       __m256i Index,
+	       __m256 Fraction) {
+
+	// Pairs 0, 1, 4, 5 into the first gather and 2, 3, 6, 7 into the second, so that the in-lane shuffles below give them back in order:
+	__m256i viIndex = _mm256_permute4x64_epi64(Index, 0xD8);
+	__m256 vLow = _mm256_castpd_ps(_mm256_i32gather_pd((const double *)Table, _mm256_castsi256_si128(viIndex), 8));
+	__m256 vHigh = _mm256_castpd_ps(_mm256_i32gather_pd((const double *)Table, _mm256_extracti128_si256(viIndex, 1), 8));
+
+	return _mm256_add_ps(_mm256_shuffle_ps(vLow, vHigh, 0x88), _mm256_mul_ps(Fraction, _mm256_shuffle_ps(vLow, vHigh, 0xDD)));
+}
+
+
+static void
+panLawGainsAVX2(const LADSPA_Data * Pan,
+		const float * Table,
+		LADSPA_Data * LGains,
+		LADSPA_Data * RGains,
+		LADSPA_Data Gain,
+		unsigned long SampleCount) {
+
+	__m256 vGain = _mm256_set1_ps(Gain);
+	__m256 vOne = _mm256_set1_ps(1.0f);
+	__m256 vMinusOne = _mm256_set1_ps(-1.0f);
+	__m256 vScale = _mm256_set1_ps(CME_PAN_LAW_SEGMENTS / 2);
+	__m256 vLast = _mm256_set1_ps(CME_PAN_LAW_SEGMENTS - 1);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vPan = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(Pan + lSampleIndex), vMinusOne), vOne);
+		__m256 vLPosition = _mm256_mul_ps(_mm256_sub_ps(vOne, vPan), vScale);
+		__m256 vRPosition = _mm256_mul_ps(_mm256_add_ps(vPan, vOne), vScale);
+		__m256i viL = _mm256_cvttps_epi32(_mm256_min_ps(vLPosition, vLast));
+		__m256i viR = _mm256_cvttps_epi32(_mm256_min_ps(vRPosition, vLast));
+		__m256 vLFraction = _mm256_sub_ps(vLPosition, _mm256_cvtepi32_ps(viL));
+		__m256 vRFraction = _mm256_sub_ps(vRPosition, _mm256_cvtepi32_ps(viR));
+		_mm256_storeu_ps(LGains + lSampleIndex, _mm256_mul_ps(panLawSideAVX2(Table, viL, vLFraction), vGain));
+		_mm256_storeu_ps(RGains + lSampleIndex, _mm256_mul_ps(panLawSideAVX2(Table, viR, vRFraction), vGain));
+	}
+	cmePanLawGainsFinish(Pan, Table, LGains, RGains, Gain, lSampleIndex, SampleCount);
+	_mm256_zeroupper();
+}
+
+
+static void
+multiplyAVX2(const LADSPA_Data * Input,
+	     const LADSPA_Data * Gains,
+	     LADSPA_Data * Output,
+	     unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8)
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex), _mm256_loadu_ps(Gains + lSampleIndex)));
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gains[lSampleIndex];
+	_mm256_zeroupper();
+}
+
+
+static void
+multiplyAddAVX2(const LADSPA_Data * Input,
+		const LADSPA_Data * Gains,
+		LADSPA_Data * Output,
+		unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 v = _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex), _mm256_loadu_ps(Gains + lSampleIndex));
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(Output + lSampleIndex), v));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gains[lSampleIndex];
+	_mm256_zeroupper();
+}
+
+
+static void
+dualMultiplyAVX2(const LADSPA_Data * LInput,
+		 const LADSPA_Data * RInput,
+		 const LADSPA_Data * LGains,
+		 const LADSPA_Data * RGains,
+		 LADSPA_Data * LOutput,
+		 LADSPA_Data * ROutput,
+		 unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vL = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), _mm256_loadu_ps(LGains + lSampleIndex));
+		__m256 vR = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), _mm256_loadu_ps(RGains + lSampleIndex));
+		_mm256_storeu_ps(LOutput + lSampleIndex, vL);
+		_mm256_storeu_ps(ROutput + lSampleIndex, vR);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] = fL;
+		ROutput[lSampleIndex] = fR;
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualMultiplyAddAVX2(const LADSPA_Data * LInput,
+		    const LADSPA_Data * RInput,
+		    const LADSPA_Data * LGains,
+		    const LADSPA_Data * RGains,
+		    LADSPA_Data * LOutput,
+		    LADSPA_Data * ROutput,
+		    unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vL = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), _mm256_loadu_ps(LGains + lSampleIndex));
+		__m256 vR = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), _mm256_loadu_ps(RGains + lSampleIndex));
+		_mm256_storeu_ps(LOutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm256_storeu_ps(ROutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] += fL;
+		ROutput[lSampleIndex] += fR;
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleRampAVX2(const LADSPA_Data * Input,
+              LADSPA_Data * Output,
+              LADSPA_Data Gain,
+              LADSPA_Data Step,
+              unsigned long SampleCount) {
+
+	__m256 vLane = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vIndex = _mm256_add_ps(vLane, _mm256_set1_ps((LADSPA_Data)lSampleIndex));
+		__m256 vGain = _mm256_add_ps(_mm256_set1_ps(Gain), _mm256_mul_ps(vIndex, _mm256_set1_ps(Step)));
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex), vGain));
+	}
+	cmeScaleRampFinish(Input, Output, Gain, Step, lSampleIndex, SampleCount, 0);
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleRampAddAVX2(const LADSPA_Data * Input,
+                 LADSPA_Data * Output,
+                 LADSPA_Data Gain,
+                 LADSPA_Data Step,
+                 unsigned long SampleCount) {
+
+	__m256 vLane = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vIndex = _mm256_add_ps(vLane, _mm256_set1_ps((LADSPA_Data)lSampleIndex));
+		__m256 vGain = _mm256_add_ps(_mm256_set1_ps(Gain), _mm256_mul_ps(vIndex, _mm256_set1_ps(Step)));
+		_mm256_storeu_ps(Output + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(Output + lSampleIndex), _mm256_mul_ps(_mm256_loadu_ps(Input + lSampleIndex), vGain)));
+	}
+	cmeScaleRampFinish(Input, Output, Gain, Step, lSampleIndex, SampleCount, 1);
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleRampAVX2(const LADSPA_Data * LInput,
+                  const LADSPA_Data * RInput,
+                  LADSPA_Data * LOutput,
+                  LADSPA_Data * ROutput,
+                  LADSPA_Data LGain,
+                  LADSPA_Data LStep,
+                  LADSPA_Data RGain,
+                  LADSPA_Data RStep,
+                  unsigned long SampleCount) {
+
+	__m256 vLane = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vIndex = _mm256_add_ps(vLane, _mm256_set1_ps((LADSPA_Data)lSampleIndex));
+		__m256 vL = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), _mm256_add_ps(_mm256_set1_ps(LGain), _mm256_mul_ps(vIndex, _mm256_set1_ps(LStep))));
+		__m256 vR = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), _mm256_add_ps(_mm256_set1_ps(RGain), _mm256_mul_ps(vIndex, _mm256_set1_ps(RStep))));
+		_mm256_storeu_ps(LOutput + lSampleIndex, vL);
+		_mm256_storeu_ps(ROutput + lSampleIndex, vR);
+	}
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, lSampleIndex, SampleCount, 0);
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleRampAddAVX2(const LADSPA_Data * LInput,
+                     const LADSPA_Data * RInput,
+                     LADSPA_Data * LOutput,
+                     LADSPA_Data * ROutput,
+                     LADSPA_Data LGain,
+                     LADSPA_Data LStep,
+                     LADSPA_Data RGain,
+                     LADSPA_Data RStep,
+                     unsigned long SampleCount) {
+
+	__m256 vLane = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m256 vIndex = _mm256_add_ps(vLane, _mm256_set1_ps((LADSPA_Data)lSampleIndex));
+		__m256 vL = _mm256_mul_ps(_mm256_loadu_ps(LInput + lSampleIndex), _mm256_add_ps(_mm256_set1_ps(LGain), _mm256_mul_ps(vIndex, _mm256_set1_ps(LStep))));
+		__m256 vR = _mm256_mul_ps(_mm256_loadu_ps(RInput + lSampleIndex), _mm256_add_ps(_mm256_set1_ps(RGain), _mm256_mul_ps(vIndex, _mm256_set1_ps(RStep))));
+		_mm256_storeu_ps(LOutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm256_storeu_ps(ROutput + lSampleIndex, _mm256_add_ps(_mm256_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, lSampleIndex, SampleCount, 1);
+	_mm256_zeroupper();
+}
+
+
+const CMEKernelTable g_sCMEKernelsAVX2 = {
+	"avx2",
+	scaleAVX2,
+	dualScaleAVX2,
+	scaleAddAVX2,
+	dualScaleAddAVX2,
+	zeroAVX2,
+	statsAVX2,
+	truePeakAVX2,
+	isSilentAVX2,
+	dualScaleStatsAVX2,
+	dbToGainAVX2,
+	panLawGainsAVX2,
+	multiplyAVX2,
+	multiplyAddAVX2,
+	dualMultiplyAVX2,
+	dualMultiplyAddAVX2,
+	scaleRampAVX2,
+	scaleRampAddAVX2,
+	dualScaleRampAVX2,
+	dualScaleRampAddAVX2
+};
+
+
+/* EOF */
@@ -0,0 +1,603 @@
+/*
+Shared kernels: AVX-512 versions.  Compiled with -mavx512f; only called if cmeKernelsInit() found AVX-512F (and OS support for the ZMM and opmask registers).
+Loop tails are done with masked loads and stores rather than scalar code.
+CME 2026-10
+*/
+
+
+#include <immintrin.h>
+
+#define CME_KERNEL_IMPLEMENTATION
+#include "cmekernels.h"
+
+
+
+/* Mask selecting the first Count (< 16) lanes. */
+static inline __mmask16
+tailMask(unsigned long Count) {
+	return (__mmask16)((1u << Count) - 1);
+}
+
+
+static void
+scaleAVX512(const LADSPA_Data * Input,
+	    LADSPA_Data * Output,
+	    LADSPA_Data Gain,
+	    unsigned long SampleCount) {
+
+	__m512 vGain = _mm512_set1_ps(Gain);
+	__mmask16 kTail;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 32 <= SampleCount; lSampleIndex += 32) {
+		__m512 v0 = _mm512_loadu_ps(Input + lSampleIndex);
+		__m512 v1 = _mm512_loadu_ps(Input + lSampleIndex + 16);
+		_mm512_storeu_ps(Output + lSampleIndex, _mm512_mul_ps(v0, vGain));
+		_mm512_storeu_ps(Output + lSampleIndex + 16, _mm512_mul_ps(v1, vGain));
+	}
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16)
+		_mm512_storeu_ps(Output + lSampleIndex, _mm512_mul_ps(_mm512_loadu_ps(Input + lSampleIndex), vGain));
+	if (lSampleIndex < SampleCount) {
+		kTail = tailMask(SampleCount - lSampleIndex);
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail,
+				      _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), vGain));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleAVX512(const LADSPA_Data * LInput,
+		const LADSPA_Data * RInput,
+		LADSPA_Data * LOutput,
+		LADSPA_Data * ROutput,
+		LADSPA_Data LGain,
+		LADSPA_Data RGain,
+		unsigned long SampleCount) {
+
+	__m512 vLGain = _mm512_set1_ps(LGain);
+	__m512 vRGain = _mm512_set1_ps(RGain);
+	__mmask16 kTail;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		__m512 vL = _mm512_loadu_ps(LInput + lSampleIndex);
+		__m512 vR = _mm512_loadu_ps(RInput + lSampleIndex);
+		_mm512_storeu_ps(LOutput + lSampleIndex, _mm512_mul_ps(vL, vLGain));
+		_mm512_storeu_ps(ROutput + lSampleIndex, _mm512_mul_ps(vR, vRGain));
+	}
+	if (lSampleIndex < SampleCount) {
+		kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vL = _mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex);
+		__m512 vR = _mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex);
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail, _mm512_mul_ps(vL, vLGain));
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail, _mm512_mul_ps(vR, vRGain));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleAddAVX512(const LADSPA_Data * Input,
+	       LADSPA_Data * Output,
+	       LADSPA_Data Gain,
+	       unsigned long SampleCount) {
+
+	__m512 vGain = _mm512_set1_ps(Gain);
+	__mmask16 kTail;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		__m512 v = _mm512_mul_ps(_mm512_loadu_ps(Input + lSampleIndex), vGain);
+		_mm512_storeu_ps(Output + lSampleIndex, _mm512_add_ps(_mm512_loadu_ps(Output + lSampleIndex), v));
+	}
+	if (lSampleIndex < SampleCount) {
+		kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 v = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), vGain);
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail,
+				      _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, Output + lSampleIndex), v));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleAddAVX512(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   LADSPA_Data LGain,
+		   LADSPA_Data RGain,
+		   unsigned long SampleCount) {
+
+	__m512 vLGain = _mm512_set1_ps(LGain);
+	__m512 vRGain = _mm512_set1_ps(RGain);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vL = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex), vLGain);
+		__m512 vR = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex), vRGain);
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail,
+				      _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, LOutput + lSampleIndex), vL));
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail,
+				      _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, ROutput + lSampleIndex), vR));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+zeroAVX512(LADSPA_Data * Output,
+	   unsigned long SampleCount) {
+
+	__m512 vZero = _mm512_setzero_ps();
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16)
+		_mm512_storeu_ps(Output + lSampleIndex, vZero);
+	if (lSampleIndex < SampleCount)
+		_mm512_mask_storeu_ps(Output + lSampleIndex, tailMask(SampleCount - lSampleIndex), vZero);
+	_mm256_zeroupper();
+}
+
+
+static void
+statsAVX512(const LADSPA_Data * Input,
+	    unsigned long SampleCount,
+	    CMEStats * psStats) {
+
+	// One register holds all CME_STATS_LANES partial sums.
+	__m512 vSum = _mm512_setzero_ps();
+	__m512 vMin = _mm512_set1_ps(psStats->Min);
+	__m512 vMax = _mm512_set1_ps(psStats->Max);
+	LADSPA_Data afSums[CME_STATS_LANES];
+	LADSPA_Data fMin, fMax;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		__m512 v = _mm512_loadu_ps(Input + lSampleIndex);
+		vSum = _mm512_add_ps(vSum, _mm512_mul_ps(v, v));
+		v = _mm512_abs_ps(v);
+		vMin = _mm512_min_ps(v, vMin);	// (New values first: min/max give the second operand if either is NaN, so NaN samples are skipped, as in the scalar version.)
+		vMax = _mm512_max_ps(v, vMax);
+	}
+
+	_mm512_storeu_ps(afSums, vSum);
+	fMin = _mm512_reduce_min_ps(vMin);
+	fMax = _mm512_reduce_max_ps(vMax);
+	_mm256_zeroupper();
+
+	// The tail goes through the shared scalar code rather than a masked step, so that it is summed exactly as the reference does it.
+	cmeStatsFinish(afSums, fMin, fMax, Input + lSampleIndex, SampleCount - lSampleIndex, psStats);
+}
+
+
+static void
+truePeakAVX512(const LADSPA_Data * Input,
+	       LADSPA_Data * Output,
+	       unsigned long SampleCount) {
+
+	// 16 output samples per step, one per lane; each lane sums its taps in the same order as cmeTruePeakSample(), so the masked tail step gives the same results too.
+	__m512 avSum[CME_TRUE_PEAK_PHASES];
+	__m512 vInput, vPeak;
+	__mmask16 kLanes = 0xFFFF;
+	unsigned long lSampleIndex;
+	int iPhase, iTap;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kLanes = tailMask(SampleCount - lSampleIndex);
+		vInput = _mm512_maskz_loadu_ps(kLanes, Input + lSampleIndex);
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			avSum[iPhase] = _mm512_mul_ps(_mm512_set1_ps(g_aafCMETruePeakTaps[iPhase][0]), vInput);
+		for (iTap = 1; iTap < CME_TRUE_PEAK_TAPS; iTap++) {
+			vInput = _mm512_maskz_loadu_ps(kLanes, Input + lSampleIndex - iTap);
+			for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+				avSum[iPhase] = _mm512_add_ps(avSum[iPhase], _mm512_mul_ps(_mm512_set1_ps(g_aafCMETruePeakTaps[iPhase][iTap]), vInput));
+		}
+		// (Phase by phase from 0, as cmeTruePeakSample(), so a NaN phase is skipped:)
+		vPeak = _mm512_setzero_ps();
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			vPeak = _mm512_max_ps(_mm512_abs_ps(avSum[iPhase]), vPeak);
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kLanes, vPeak);
+	}
+	_mm256_zeroupper();
+}
+
+
+static int
+isSilentAVX512(const LADSPA_Data * Input,
+	       unsigned long SampleCount) {
+
+	// OR the bits of 64 samples together, drop the sign bits and see if anything is left:
+	__m512i vAbsMask = _mm512_set1_epi32(0x7FFFFFFF);
+	__m512i vBits;
+	unsigned long lSampleIndex = 0;
+	int iSilent = 1;
+
+	for (; lSampleIndex + 64 <= SampleCount; lSampleIndex += 64) {
+		vBits = _mm512_or_si512(_mm512_or_si512(_mm512_castps_si512(_mm512_loadu_ps(Input + lSampleIndex)),
+							_mm512_castps_si512(_mm512_loadu_ps(Input + lSampleIndex + 16))),
+					_mm512_or_si512(_mm512_castps_si512(_mm512_loadu_ps(Input + lSampleIndex + 32)),
+							_mm512_castps_si512(_mm512_loadu_ps(Input + lSampleIndex + 48))));
+		if (_mm512_test_epi32_mask(vBits, vAbsMask)) {
+			iSilent = 0;
+			break;
+		}
+	}
+	for (; iSilent && lSampleIndex + 16 <= SampleCount; lSampleIndex += 16)
+		if (_mm512_test_epi32_mask(_mm512_castps_si512(_mm512_loadu_ps(Input + lSampleIndex)), vAbsMask))
+			iSilent = 0;
+	// (The masked load fills the lanes past the end with zeros.)
+	if (iSilent && lSampleIndex < SampleCount
+	    && _mm512_test_epi32_mask(_mm512_castps_si512(_mm512_maskz_loadu_ps(tailMask(SampleCount - lSampleIndex), Input + lSampleIndex)), vAbsMask))
+		iSilent = 0;
+	_mm256_zeroupper();
+	return iSilent;
+}
+
+
+static void
+dualScaleStatsAVX512(const LADSPA_Data * LInput,
+		     const LADSPA_Data * RInput,
+		     LADSPA_Data * LOutput,
+		     LADSPA_Data * ROutput,
+		     LADSPA_Data LGain,
+		     LADSPA_Data RGain,
+		     unsigned long SampleCount,
+		     CMEStats * psLStats,
+		     CMEStats * psRStats) {
+
+	// As statsAVX512(), for both outputs: one register each holds the CME_STATS_LANES partial sums.
+	__m512 vLSum = _mm512_setzero_ps(), vRSum = _mm512_setzero_ps();
+	__m512 vLMin = _mm512_set1_ps(psLStats->Min), vLMax = _mm512_set1_ps(psLStats->Max);
+	__m512 vRMin = _mm512_set1_ps(psRStats->Min), vRMax = _mm512_set1_ps(psRStats->Max);
+	__m512 vLGain = _mm512_set1_ps(LGain);
+	__m512 vRGain = _mm512_set1_ps(RGain);
+	LADSPA_Data afLSums[CME_STATS_LANES], afRSums[CME_STATS_LANES];
+	LADSPA_Data fLMin, fLMax, fRMin, fRMax;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		__m512 vL = _mm512_mul_ps(_mm512_loadu_ps(LInput + lSampleIndex), vLGain);
+		__m512 vR = _mm512_mul_ps(_mm512_loadu_ps(RInput + lSampleIndex), vRGain);
+		_mm512_storeu_ps(LOutput + lSampleIndex, vL);
+		_mm512_storeu_ps(ROutput + lSampleIndex, vR);
+		vLSum = _mm512_add_ps(vLSum, _mm512_mul_ps(vL, vL));
+		vRSum = _mm512_add_ps(vRSum, _mm512_mul_ps(vR, vR));
+		vL = _mm512_abs_ps(vL);
+		vR = _mm512_abs_ps(vR);
+		vLMin = _mm512_min_ps(vL, vLMin);	// (as in statsAVX512())
+		vLMax = _mm512_max_ps(vL, vLMax);
+		vRMin = _mm512_min_ps(vR, vRMin);
+		vRMax = _mm512_max_ps(vR, vRMax);
+	}
+
+	_mm512_storeu_ps(afLSums, vLSum);
+	_mm512_storeu_ps(afRSums, vRSum);
+	fLMin = _mm512_reduce_min_ps(vLMin);
+	fLMax = _mm512_reduce_max_ps(vLMax);
+	fRMin = _mm512_reduce_min_ps(vRMin);
+	fRMax = _mm512_reduce_max_ps(vRMax);
+	_mm256_zeroupper();
+
+	cmeDualScaleStatsFinish(LInput, RInput, LOutput, ROutput, LGain, RGain, lSampleIndex, SampleCount,
+				afLSums, fLMin, fLMax, afRSums, fRMin, fRMax, psLStats, psRStats);
+}
+
+
+/* Vector cmeExp2f(): the same steps, lane by lane (rounding x + 0.5 down with roundscale, which is what the scalar truncate-and-correct comes to). */
+static inline __m512
+exp2AVX512(__m512 vX) {
+
+	__mmask16 kUnderflow = _mm512_cmp_ps_mask(vX, _mm512_set1_ps(-126.0f), _CMP_LT_OQ);
+	__m512 vFrac, vScale, vPoly;
+	__m512i viWhole;
+
+	vX = _mm512_min_ps(_mm512_set1_ps(127.0f), vX);	// (NaN stays NaN)
+	viWhole = _mm512_cvttps_epi32(_mm512_roundscale_ps(_mm512_add_ps(vX, _mm512_set1_ps(0.5f)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+	vFrac = _mm512_sub_ps(vX, _mm512_cvtepi32_ps(viWhole));
+	vScale = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(viWhole, _mm512_set1_epi32(127)), 23));
+
+	vPoly = _mm512_add_ps(_mm512_set1_ps(CME_EXP2_C4), _mm512_mul_ps(vFrac, _mm512_set1_ps(CME_EXP2_C5)));
+	vPoly = _mm512_add_ps(_mm512_set1_ps(CME_EXP2_C3), _mm512_mul_ps(vFrac, vPoly));
+	vPoly = _mm512_add_ps(_mm512_set1_ps(CME_EXP2_C2), _mm512_mul_ps(vFrac, vPoly));
+	vPoly = _mm512_add_ps(_mm512_set1_ps(CME_EXP2_C1), _mm512_mul_ps(vFrac, vPoly));
+	vPoly = _mm512_add_ps(_mm512_set1_ps(CME_EXP2_C0), _mm512_mul_ps(vFrac, vPoly));
+
+	return _mm512_maskz_mov_ps(~kUnderflow, _mm512_mul_ps(vScale, vPoly));
+}
+
+
+static void
+dbToGainAVX512(const LADSPA_Data * GainDB,
+	       LADSPA_Data * Gains,
+	       LADSPA_Data Gain,
+	       unsigned long SampleCount) {
+
+	__m512 vGain = _mm512_set1_ps(Gain);
+	__m512 vDBToLog2 = _mm512_set1_ps(CME_DB_TO_LOG2);
+	__mmask16 kTail;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		__m512 vDB = _mm512_loadu_ps(GainDB + lSampleIndex);
+		_mm512_storeu_ps(Gains + lSampleIndex, _mm512_mul_ps(exp2AVX512(_mm512_mul_ps(vDB, vDBToLog2)), vGain));
+	}
+	if (lSampleIndex < SampleCount) {
+		kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vDB = _mm512_maskz_loadu_ps(kTail, GainDB + lSampleIndex);
+		_mm512_mask_storeu_ps(Gains + lSampleIndex, kTail, _mm512_mul_ps(exp2AVX512(_mm512_mul_ps(vDB, vDBToLog2)), vGain));
+	}
+	_mm256_zeroupper();
+}
+
+
+/* Interpolate one side's table for 16 positions: gather the {value, delta} pairs as doubles, 8 at a time (which takes half the gathered elements of separate value and delta gathers), and split them into values and deltas. */
+static inline __m512
+panLawSideAVX512(const float * Table,
+		 __m512i Index,
+		 __m512 Fraction) {
+
+	const __m512i viValues = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+	const __m512i viDeltas = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+	__m512 vLow = _mm512_castpd_ps(_mm512_i32gather_pd(_mm512_castsi512_si256(Index), (const double *)Table, 8));
+	__m512 vHigh = _mm512_castpd_ps(_mm512_i32gather_pd(_mm512_extracti64x4_epi64(Index, 1), (const double *)Table, 8));
+
+	return _mm512_add_ps(_mm512_permutex2var_ps(vLow, viValues, vHigh), _mm512_mul_ps(Fraction, _mm512_permutex2var_ps(vLow, viDeltas, vHigh)));
+}
+
+
+static void
+panLawGainsAVX512(const LADSPA_Data * Pan,
+		  const float * Table,
+		  LADSPA_Data * LGains,
+		  LADSPA_Data * RGains,
+		  LADSPA_Data Gain,
+		  unsigned long SampleCount) {
+
+	__m512 vGain = _mm512_set1_ps(Gain);
+	__m512 vOne = _mm512_set1_ps(1.0f);
+	__m512 vMinusOne = _mm512_set1_ps(-1.0f);
+	__m512 vScale = _mm512_set1_ps(CME_PAN_LAW_SEGMENTS / 2);
+	__m512 vLast = _mm512_set1_ps(CME_PAN_LAW_SEGMENTS - 1);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		// (Lanes past the tail read as pan 0, so they gather from inside the table too.)
+		__m512 vPan = _mm512_min_ps(_mm512_max_ps(_mm512_maskz_loadu_ps(kTail, Pan + lSampleIndex), vMinusOne), vOne);
+		__m512 vLPosition = _mm512_mul_ps(_mm512_sub_ps(vOne, vPan), vScale);
+		__m512 vRPosition = _mm512_mul_ps(_mm512_add_ps(vPan, vOne), vScale);
+		__m512i viL = _mm512_cvttps_epi32(_mm512_min_ps(vLPosition, vLast));
+		__m512i viR = _mm512_cvttps_epi32(_mm512_min_ps(vRPosition, vLast));
+		__m512 vLFraction = _mm512_sub_ps(vLPosition, _mm512_cvtepi32_ps(viL));
+		__m512 vRFraction = _mm512_sub_ps(vRPosition, _mm512_cvtepi32_ps(viR));
+		_mm512_mask_storeu_ps(LGains + lSampleIndex, kTail, _mm512_mul_ps(panLawSideAVX512(Table, viL, vLFraction), vGain));
+		_mm512_mask_storeu_ps(RGains + lSampleIndex, kTail, _mm512_mul_ps(panLawSideAVX512(Table, viR, vRFraction), vGain));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+multiplyAVX512(const LADSPA_Data * Input,
+	       const LADSPA_Data * Gains,
+	       LADSPA_Data * Output,
+	       unsigned long SampleCount) {
+
+	__mmask16 kTail;
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16)
+		_mm512_storeu_ps(Output + lSampleIndex, _mm512_mul_ps(_mm512_loadu_ps(Input + lSampleIndex), _mm512_loadu_ps(Gains + lSampleIndex)));
+	if (lSampleIndex < SampleCount) {
+		kTail = tailMask(SampleCount - lSampleIndex);
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail,
+				      _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), _mm512_maskz_loadu_ps(kTail, Gains + lSampleIndex)));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+multiplyAddAVX512(const LADSPA_Data * Input,
+		  const LADSPA_Data * Gains,
+		  LADSPA_Data * Output,
+		  unsigned long SampleCount) {
+
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 v = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), _mm512_maskz_loadu_ps(kTail, Gains + lSampleIndex));
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, Output + lSampleIndex), v));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualMultiplyAVX512(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   const LADSPA_Data * LGains,
+		   const LADSPA_Data * RGains,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   unsigned long SampleCount) {
+
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vL = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex), _mm512_maskz_loadu_ps(kTail, LGains + lSampleIndex));
+		__m512 vR = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex), _mm512_maskz_loadu_ps(kTail, RGains + lSampleIndex));
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail, vL);
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail, vR);
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualMultiplyAddAVX512(const LADSPA_Data * LInput,
+		      const LADSPA_Data * RInput,
+		      const LADSPA_Data * LGains,
+		      const LADSPA_Data * RGains,
+		      LADSPA_Data * LOutput,
+		      LADSPA_Data * ROutput,
+		      unsigned long SampleCount) {
+
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vL = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex), _mm512_maskz_loadu_ps(kTail, LGains + lSampleIndex));
+		__m512 vR = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex), _mm512_maskz_loadu_ps(kTail, RGains + lSampleIndex));
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, LOutput + lSampleIndex), vL));
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, ROutput + lSampleIndex), vR));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleRampAVX512(const LADSPA_Data * Input,
+                LADSPA_Data * Output,
+                LADSPA_Data Gain,
+                LADSPA_Data Step,
+                unsigned long SampleCount) {
+
+	__m512 vLane = _mm512_set_ps(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vIndex = _mm512_add_ps(vLane, _mm512_set1_ps((LADSPA_Data)lSampleIndex));
+		__m512 vGain = _mm512_add_ps(_mm512_set1_ps(Gain), _mm512_mul_ps(vIndex, _mm512_set1_ps(Step)));
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail, _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), vGain));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+scaleRampAddAVX512(const LADSPA_Data * Input,
+                   LADSPA_Data * Output,
+                   LADSPA_Data Gain,
+                   LADSPA_Data Step,
+                   unsigned long SampleCount) {
+
+	__m512 vLane = _mm512_set_ps(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vIndex = _mm512_add_ps(vLane, _mm512_set1_ps((LADSPA_Data)lSampleIndex));
+		__m512 vGain = _mm512_add_ps(_mm512_set1_ps(Gain), _mm512_mul_ps(vIndex, _mm512_set1_ps(Step)));
+		_mm512_mask_storeu_ps(Output + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, Output + lSampleIndex), _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, Input + lSampleIndex), vGain)));
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleRampAVX512(const LADSPA_Data * LInput,
+                    const LADSPA_Data * RInput,
+                    LADSPA_Data * LOutput,
+                    LADSPA_Data * ROutput,
+                    LADSPA_Data LGain,
+                    LADSPA_Data LStep,
+                    LADSPA_Data RGain,
+                    LADSPA_Data RStep,
+                    unsigned long SampleCount) {
+
+	__m512 vLane = _mm512_set_ps(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vIndex = _mm512_add_ps(vLane, _mm512_set1_ps((LADSPA_Data)lSampleIndex));
+		__m512 vL = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex),
+					  _mm512_add_ps(_mm512_set1_ps(LGain), _mm512_mul_ps(vIndex, _mm512_set1_ps(LStep))));
+		__m512 vR = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex),
+					  _mm512_add_ps(_mm512_set1_ps(RGain), _mm512_mul_ps(vIndex, _mm512_set1_ps(RStep))));
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail, vL);
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail, vR);
+	}
+	_mm256_zeroupper();
+}
+
+
+static void
+dualScaleRampAddAVX512(const LADSPA_Data * LInput,
+                       const LADSPA_Data * RInput,
+                       LADSPA_Data * LOutput,
+                       LADSPA_Data * ROutput,
+                       LADSPA_Data LGain,
+                       LADSPA_Data LStep,
+                       LADSPA_Data RGain,
+                       LADSPA_Data RStep,
+                       unsigned long SampleCount) {
+
+	__m512 vLane = _mm512_set_ps(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__mmask16 kTail = 0xFFFF;
+	unsigned long lSampleIndex;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex += 16) {
+		if (SampleCount - lSampleIndex < 16)
+			kTail = tailMask(SampleCount - lSampleIndex);
+		__m512 vIndex = _mm512_add_ps(vLane, _mm512_set1_ps((LADSPA_Data)lSampleIndex));
+		__m512 vL = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, LInput + lSampleIndex),
+					  _mm512_add_ps(_mm512_set1_ps(LGain), _mm512_mul_ps(vIndex, _mm512_set1_ps(LStep))));
+		__m512 vR = _mm512_mul_ps(_mm512_maskz_loadu_ps(kTail, RInput + lSampleIndex),
+					  _mm512_add_ps(_mm512_set1_ps(RGain), _mm512_mul_ps(vIndex, _mm512_set1_ps(RStep))));
+		_mm512_mask_storeu_ps(LOutput + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, LOutput + lSampleIndex), vL));
+		_mm512_mask_storeu_ps(ROutput + lSampleIndex, kTail, _mm512_add_ps(_mm512_maskz_loadu_ps(kTail, ROutput + lSampleIndex), vR));
+	}
+	_mm256_zeroupper();
+}
+
+
+const CMEKernelTable g_sCMEKernelsAVX512 = {
+	"avx512",
+	scaleAVX512,
+	dualScaleAVX512,
+	scaleAddAVX512,
+	dualScaleAddAVX512,
+	zeroAVX512,
+	statsAVX512,
+	truePeakAVX512,
+	isSilentAVX512,
+	dualScaleStatsAVX512,
+	dbToGainAVX512,
+	panLawGainsAVX512,
+	multiplyAVX512,
+	multiplyAddAVX512,
+	dualMultiplyAVX512,
+	dualMultiplyAddAVX512,
+	scaleRampAVX512,
+	scaleRampAddAVX512,
+	dualScaleRampAVX512,
+	dualScaleRampAddAVX512
+};
+
+
+/* EOF */
@@ -0,0 +1,591 @@
+/*
+Shared kernels: SSE2 versions.  Compiled with -msse2; only called if cmeKernelsInit() found SSE2.
+CME 2026-10
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+#include <emmintrin.h>
+
+#define CME_KERNEL_IMPLEMENTATION
+#include "cmekernels.h"
+
+
+
+static void
+scaleSSE2(const LADSPA_Data * Input,
+	  LADSPA_Data * Output,
+	  LADSPA_Data Gain,
+	  unsigned long SampleCount) {
+
+	__m128 vGain = _mm_set1_ps(Gain);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m128 v0 = _mm_loadu_ps(Input + lSampleIndex);
+		__m128 v1 = _mm_loadu_ps(Input + lSampleIndex + 4);
+		_mm_storeu_ps(Output + lSampleIndex, _mm_mul_ps(v0, vGain));
+		_mm_storeu_ps(Output + lSampleIndex + 4, _mm_mul_ps(v1, vGain));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gain;
+}
+
+
+static void
+dualScaleSSE2(const LADSPA_Data * LInput,
+	      const LADSPA_Data * RInput,
+	      LADSPA_Data * LOutput,
+	      LADSPA_Data * ROutput,
+	      LADSPA_Data LGain,
+	      LADSPA_Data RGain,
+	      unsigned long SampleCount) {
+
+	__m128 vLGain = _mm_set1_ps(LGain);
+	__m128 vRGain = _mm_set1_ps(RGain);
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vL = _mm_loadu_ps(LInput + lSampleIndex);
+		__m128 vR = _mm_loadu_ps(RInput + lSampleIndex);
+		_mm_storeu_ps(LOutput + lSampleIndex, _mm_mul_ps(vL, vLGain));
+		_mm_storeu_ps(ROutput + lSampleIndex, _mm_mul_ps(vR, vRGain));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] = fL * LGain;
+		ROutput[lSampleIndex] = fR * RGain;
+	}
+}
+
+
+static void
+scaleAddSSE2(const LADSPA_Data * Input,
+	     LADSPA_Data * Output,
+	     LADSPA_Data Gain,
+	     unsigned long SampleCount) {
+
+	__m128 vGain = _mm_set1_ps(Gain);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		__m128 v0 = _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex), vGain);
+		__m128 v1 = _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex + 4), vGain);
+		_mm_storeu_ps(Output + lSampleIndex, _mm_add_ps(_mm_loadu_ps(Output + lSampleIndex), v0));
+		_mm_storeu_ps(Output + lSampleIndex + 4, _mm_add_ps(_mm_loadu_ps(Output + lSampleIndex + 4), v1));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gain;
+}
+
+
+static void
+dualScaleAddSSE2(const LADSPA_Data * LInput,
+		 const LADSPA_Data * RInput,
+		 LADSPA_Data * LOutput,
+		 LADSPA_Data * ROutput,
+		 LADSPA_Data LGain,
+		 LADSPA_Data RGain,
+		 unsigned long SampleCount) {
+
+	__m128 vLGain = _mm_set1_ps(LGain);
+	__m128 vRGain = _mm_set1_ps(RGain);
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex), vLGain);
+		__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex), vRGain);
+		_mm_storeu_ps(LOutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm_storeu_ps(ROutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex];
+		fR = RInput[lSampleIndex];
+		LOutput[lSampleIndex] += fL * LGain;
+		ROutput[lSampleIndex] += fR * RGain;
+	}
+}
+
+
+static void
+zeroSSE2(LADSPA_Data * Output,
+	 unsigned long SampleCount) {
+
+	__m128 vZero = _mm_setzero_ps();
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 8 <= SampleCount; lSampleIndex += 8) {
+		_mm_storeu_ps(Output + lSampleIndex, vZero);
+		_mm_storeu_ps(Output + lSampleIndex + 4, vZero);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = 0.0;
+}
+
+
+static void
+statsSSE2(const LADSPA_Data * Input,
+	  unsigned long SampleCount,
+	  CMEStats * psStats) {
+
+	// Four registers of four lanes make up the CME_STATS_LANES partial sums.
+	__m128 vSum0 = _mm_setzero_ps(), vSum1 = _mm_setzero_ps();
+	__m128 vSum2 = _mm_setzero_ps(), vSum3 = _mm_setzero_ps();
+	__m128 vMin = _mm_set1_ps(psStats->Min);
+	__m128 vMax = _mm_set1_ps(psStats->Max);
+	__m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	LADSPA_Data afSums[CME_STATS_LANES];
+	LADSPA_Data afMin[4], afMax[4];
+	LADSPA_Data fMin, fMax;
+	unsigned long lSampleIndex = 0;
+	int iLane;
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		__m128 v0 = _mm_loadu_ps(Input + lSampleIndex);
+		__m128 v1 = _mm_loadu_ps(Input + lSampleIndex + 4);
+		__m128 v2 = _mm_loadu_ps(Input + lSampleIndex + 8);
+		__m128 v3 = _mm_loadu_ps(Input + lSampleIndex + 12);
+		vSum0 = _mm_add_ps(vSum0, _mm_mul_ps(v0, v0));
+		vSum1 = _mm_add_ps(vSum1, _mm_mul_ps(v1, v1));
+		vSum2 = _mm_add_ps(vSum2, _mm_mul_ps(v2, v2));
+		vSum3 = _mm_add_ps(vSum3, _mm_mul_ps(v3, v3));
+		v0 = _mm_and_ps(v0, vAbsMask);
+		v1 = _mm_and_ps(v1, vAbsMask);
+		v2 = _mm_and_ps(v2, vAbsMask);
+		v3 = _mm_and_ps(v3, vAbsMask);
+		// (New values first: min/max give the second operand if either is NaN, so NaN samples are skipped, as in the scalar version.)
+		vMin = _mm_min_ps(v3, _mm_min_ps(v2, _mm_min_ps(v1, _mm_min_ps(v0, vMin))));
+		vMax = _mm_max_ps(v3, _mm_max_ps(v2, _mm_max_ps(v1, _mm_max_ps(v0, vMax))));
+	}
+
+	_mm_storeu_ps(afSums, vSum0);
+	_mm_storeu_ps(afSums + 4, vSum1);
+	_mm_storeu_ps(afSums + 8, vSum2);
+	_mm_storeu_ps(afSums + 12, vSum3);
+	_mm_storeu_ps(afMin, vMin);
+	_mm_storeu_ps(afMax, vMax);
+	fMin = afMin[0];
+	fMax = afMax[0];
+	for (iLane = 1; iLane < 4; iLane++) {
+		if (afMin[iLane] < fMin)	fMin = afMin[iLane];
+		if (afMax[iLane] > fMax)	fMax = afMax[iLane];
+	}
+
+	cmeStatsFinish(afSums, fMin, fMax, Input + lSampleIndex, SampleCount - lSampleIndex, psStats);
+}
+
+
+static void
+truePeakSSE2(const LADSPA_Data * Input,
+	      LADSPA_Data * Output,
+	      unsigned long SampleCount) {
+
+	// 4 output samples per step, one per lane; each lane sums its taps in the same order as cmeTruePeakSample().
+	__m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	unsigned long lSampleIndex = 0;
+	int iPhase, iTap;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 avSum[CME_TRUE_PEAK_PHASES];
+		__m128 vInput = _mm_loadu_ps(Input + lSampleIndex);
+		__m128 vPeak;
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			avSum[iPhase] = _mm_mul_ps(_mm_set1_ps(g_aafCMETruePeakTaps[iPhase][0]), vInput);
+		for (iTap = 1; iTap < CME_TRUE_PEAK_TAPS; iTap++) {
+			vInput = _mm_loadu_ps(Input + lSampleIndex - iTap);
+			for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+				avSum[iPhase] = _mm_add_ps(avSum[iPhase], _mm_mul_ps(_mm_set1_ps(g_aafCMETruePeakTaps[iPhase][iTap]), vInput));
+		}
+		// (Phase by phase from 0, as cmeTruePeakSample(), so a NaN phase is skipped:)
+		vPeak = _mm_setzero_ps();
+		for (iPhase = 0; iPhase < CME_TRUE_PEAK_PHASES; iPhase++)
+			vPeak = _mm_max_ps(_mm_and_ps(avSum[iPhase], vAbsMask), vPeak);
+		_mm_storeu_ps(Output + lSampleIndex, vPeak);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = cmeTruePeakSample(Input + lSampleIndex);
+}
+
+
+static int
+isSilentSSE2(const LADSPA_Data * Input,
+	     unsigned long SampleCount) {
+
+	// OR the bits of 16 samples together, drop the sign bits and see if anything is left:
+	__m128i vAbsMask = _mm_set1_epi32(0x7FFFFFFF);
+	__m128i vZero = _mm_setzero_si128();
+	__m128i vBits;
+	unsigned long lSampleIndex = 0;
+	uint32_t lBits;
+
+	for (; lSampleIndex + 16 <= SampleCount; lSampleIndex += 16) {
+		vBits = _mm_or_si128(_mm_or_si128(_mm_castps_si128(_mm_loadu_ps(Input + lSampleIndex)),
+						  _mm_castps_si128(_mm_loadu_ps(Input + lSampleIndex + 4))),
+				     _mm_or_si128(_mm_castps_si128(_mm_loadu_ps(Input + lSampleIndex + 8)),
+						  _mm_castps_si128(_mm_loadu_ps(Input + lSampleIndex + 12))));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(vBits, vAbsMask), vZero)) != 0xFFFF)
+			return 0;
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		memcpy(&lBits, Input + lSampleIndex, sizeof(lBits));
+		if (lBits & 0x7FFFFFFF)
+			return 0;
+	}
+	return 1;
+}
+
+
+static void
+dualScaleStatsSSE2(const LADSPA_Data * LInput,
+		   const LADSPA_Data * RInput,
+		   LADSPA_Data * LOutput,
+		   LADSPA_Data * ROutput,
+		   LADSPA_Data LGain,
+		   LADSPA_Data RGain,
+		   unsigned long SampleCount,
+		   CMEStats * psLStats,
+		   CMEStats * psRStats) {
+
+	// As statsSSE2(), for both outputs: four registers of four lanes each make up the CME_STATS_LANES partial sums.
+	__m128 avLSum[4], avRSum[4];
+	__m128 vLMin = _mm_set1_ps(psLStats->Min), vLMax = _mm_set1_ps(psLStats->Max);
+	__m128 vRMin = _mm_set1_ps(psRStats->Min), vRMax = _mm_set1_ps(psRStats->Max);
+	__m128 vLGain = _mm_set1_ps(LGain);
+	__m128 vRGain = _mm_set1_ps(RGain);
+	__m128 vAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	LADSPA_Data afLSums[CME_STATS_LANES], afRSums[CME_STATS_LANES];
+	LADSPA_Data afLMin[4], afLMax[4], afRMin[4], afRMax[4];
+	LADSPA_Data fLMin, fLMax, fRMin, fRMax;
+	unsigned long lSampleIndex = 0;
+	int iLane;
+
+	for (iLane = 0; iLane < 4; iLane++)
+		avLSum[iLane] = avRSum[iLane] = _mm_setzero_ps();
+
+	for (; lSampleIndex + CME_STATS_LANES <= SampleCount; lSampleIndex += CME_STATS_LANES) {
+		for (iLane = 0; iLane < 4; iLane++) {
+			__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex + 4 * iLane), vLGain);
+			__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex + 4 * iLane), vRGain);
+			_mm_storeu_ps(LOutput + lSampleIndex + 4 * iLane, vL);
+			_mm_storeu_ps(ROutput + lSampleIndex + 4 * iLane, vR);
+			avLSum[iLane] = _mm_add_ps(avLSum[iLane], _mm_mul_ps(vL, vL));
+			avRSum[iLane] = _mm_add_ps(avRSum[iLane], _mm_mul_ps(vR, vR));
+			vL = _mm_and_ps(vL, vAbsMask);
+			vR = _mm_and_ps(vR, vAbsMask);
+			vLMin = _mm_min_ps(vL, vLMin);	// (as in statsSSE2())
+			vLMax = _mm_max_ps(vL, vLMax);
+			vRMin = _mm_min_ps(vR, vRMin);
+			vRMax = _mm_max_ps(vR, vRMax);
+		}
+	}
+
+	for (iLane = 0; iLane < 4; iLane++) {
+		_mm_storeu_ps(afLSums + 4 * iLane, avLSum[iLane]);
+		_mm_storeu_ps(afRSums + 4 * iLane, avRSum[iLane]);
+	}
+	_mm_storeu_ps(afLMin, vLMin);
+	_mm_storeu_ps(afLMax, vLMax);
+	_mm_storeu_ps(afRMin, vRMin);
+	_mm_storeu_ps(afRMax, vRMax);
+	fLMin = afLMin[0];	fLMax = afLMax[0];
+	fRMin = afRMin[0];	fRMax = afRMax[0];
+	for (iLane = 1; iLane < 4; iLane++) {
+		if (afLMin[iLane] < fLMin)	fLMin = afLMin[iLane];
+		if (afLMax[iLane] > fLMax)	fLMax = afLMax[iLane];
+		if (afRMin[iLane] < fRMin)	fRMin = afRMin[iLane];
+		if (afRMax[iLane] > fRMax)	fRMax = afRMax[iLane];
+	}
+
+	cmeDualScaleStatsFinish(LInput, RInput, LOutput, ROutput, LGain, RGain, lSampleIndex, SampleCount,
+				afLSums, fLMin, fLMax, afRSums, fRMin, fRMax, psLStats, psRStats);
+}
+
+
+/* Vector cmeExp2f(): the same steps, lane by lane, down to rounding x + 0.5 down by truncating and then correcting. */
+static inline __m128
+exp2SSE2(__m128 vX) {
+
+	__m128 vUnderflow = _mm_cmplt_ps(vX, _mm_set1_ps(-126.0f));
+	__m128 vHalf, vFrac, vScale, vPoly;
+	__m128i viWhole;
+
+	vX = _mm_min_ps(_mm_set1_ps(127.0f), vX);	// (NaN stays NaN)
+	vHalf = _mm_add_ps(vX, _mm_set1_ps(0.5f));
+	viWhole = _mm_cvttps_epi32(vHalf);
+	viWhole = _mm_add_epi32(viWhole, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(viWhole), vHalf)));
+	vFrac = _mm_sub_ps(vX, _mm_cvtepi32_ps(viWhole));
+	vScale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(viWhole, _mm_set1_epi32(127)), 23));
+
+	vPoly = _mm_add_ps(_mm_set1_ps(CME_EXP2_C4), _mm_mul_ps(vFrac, _mm_set1_ps(CME_EXP2_C5)));
+	vPoly = _mm_add_ps(_mm_set1_ps(CME_EXP2_C3), _mm_mul_ps(vFrac, vPoly));
+	vPoly = _mm_add_ps(_mm_set1_ps(CME_EXP2_C2), _mm_mul_ps(vFrac, vPoly));
+	vPoly = _mm_add_ps(_mm_set1_ps(CME_EXP2_C1), _mm_mul_ps(vFrac, vPoly));
+	vPoly = _mm_add_ps(_mm_set1_ps(CME_EXP2_C0), _mm_mul_ps(vFrac, vPoly));
+
+	return _mm_andnot_ps(vUnderflow, _mm_mul_ps(vScale, vPoly));
+}
+
+
+static void
+dbToGainSSE2(const LADSPA_Data * GainDB,
+	     LADSPA_Data * Gains,
+	     LADSPA_Data Gain,
+	     unsigned long SampleCount) {
+
+	__m128 vGain = _mm_set1_ps(Gain);
+	__m128 vDBToLog2 = _mm_set1_ps(CME_DB_TO_LOG2);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vDB = _mm_loadu_ps(GainDB + lSampleIndex);
+		_mm_storeu_ps(Gains + lSampleIndex, _mm_mul_ps(exp2SSE2(_mm_mul_ps(vDB, vDBToLog2)), vGain));
+	}
+	cmeDBToGainFinish(GainDB, Gains, Gain, lSampleIndex, SampleCount);
+}
+
+
+static void
+panLawGainsSSE2(const LADSPA_Data * Pan,
+		const float * Table,
+		LADSPA_Data * LGains,
+		LADSPA_Data * RGains,
+		LADSPA_Data Gain,
+		unsigned long SampleCount) {
+
+	__m128 vGain = _mm_set1_ps(Gain);
+	__m128 vOne = _mm_set1_ps(1.0f);
+	__m128 vMinusOne = _mm_set1_ps(-1.0f);
+	__m128 vScale = _mm_set1_ps(CME_PAN_LAW_SEGMENTS / 2);
+	__m128 vLast = _mm_set1_ps(CME_PAN_LAW_SEGMENTS - 1);
+	const double * pdSegments = (const double *)Table;	// (one {value, delta} pair per load)
+	int aiL[4], aiR[4];
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vPan = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(Pan + lSampleIndex), vMinusOne), vOne);
+		__m128 vLPosition = _mm_mul_ps(_mm_sub_ps(vOne, vPan), vScale);
+		__m128 vRPosition = _mm_mul_ps(_mm_add_ps(vPan, vOne), vScale);
+		__m128i viL = _mm_cvttps_epi32(_mm_min_ps(vLPosition, vLast));
+		__m128i viR = _mm_cvttps_epi32(_mm_min_ps(vRPosition, vLast));
+		__m128 vLFraction = _mm_sub_ps(vLPosition, _mm_cvtepi32_ps(viL));
+		__m128 vRFraction = _mm_sub_ps(vRPosition, _mm_cvtepi32_ps(viR));
+
+		// No gather before AVX2, so load the pairs two to a register, and split them into values and deltas:
+		_mm_storeu_si128((__m128i *)aiL, viL);
+		_mm_storeu_si128((__m128i *)aiR, viR);
+		__m128 vL01 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(pdSegments + aiL[0]), pdSegments + aiL[1]));
+		__m128 vL23 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(pdSegments + aiL[2]), pdSegments + aiL[3]));
+		__m128 vR01 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(pdSegments + aiR[0]), pdSegments + aiR[1]));
+		__m128 vR23 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(pdSegments + aiR[2]), pdSegments + aiR[3]));
+		__m128 vL = _mm_add_ps(_mm_shuffle_ps(vL01, vL23, 0x88), _mm_mul_ps(vLFraction, _mm_shuffle_ps(vL01, vL23, 0xDD)));
+		__m128 vR = _mm_add_ps(_mm_shuffle_ps(vR01, vR23, 0x88), _mm_mul_ps(vRFraction, _mm_shuffle_ps(vR01, vR23, 0xDD)));
+		_mm_storeu_ps(LGains + lSampleIndex, _mm_mul_ps(vL, vGain));
+		_mm_storeu_ps(RGains + lSampleIndex, _mm_mul_ps(vR, vGain));
+	}
+	cmePanLawGainsFinish(Pan, Table, LGains, RGains, Gain, lSampleIndex, SampleCount);
+}
+
+
+static void
+multiplySSE2(const LADSPA_Data * Input,
+	     const LADSPA_Data * Gains,
+	     LADSPA_Data * Output,
+	     unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4)
+		_mm_storeu_ps(Output + lSampleIndex, _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex), _mm_loadu_ps(Gains + lSampleIndex)));
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] = Input[lSampleIndex] * Gains[lSampleIndex];
+}
+
+
+static void
+multiplyAddSSE2(const LADSPA_Data * Input,
+		const LADSPA_Data * Gains,
+		LADSPA_Data * Output,
+		unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 v = _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex), _mm_loadu_ps(Gains + lSampleIndex));
+		_mm_storeu_ps(Output + lSampleIndex, _mm_add_ps(_mm_loadu_ps(Output + lSampleIndex), v));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++)
+		Output[lSampleIndex] += Input[lSampleIndex] * Gains[lSampleIndex];
+}
+
+
+static void
+dualMultiplySSE2(const LADSPA_Data * LInput,
+		 const LADSPA_Data * RInput,
+		 const LADSPA_Data * LGains,
+		 const LADSPA_Data * RGains,
+		 LADSPA_Data * LOutput,
+		 LADSPA_Data * ROutput,
+		 unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex), _mm_loadu_ps(LGains + lSampleIndex));
+		__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex), _mm_loadu_ps(RGains + lSampleIndex));
+		_mm_storeu_ps(LOutput + lSampleIndex, vL);
+		_mm_storeu_ps(ROutput + lSampleIndex, vR);
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] = fL;
+		ROutput[lSampleIndex] = fR;
+	}
+}
+
+
+static void
+dualMultiplyAddSSE2(const LADSPA_Data * LInput,
+		    const LADSPA_Data * RInput,
+		    const LADSPA_Data * LGains,
+		    const LADSPA_Data * RGains,
+		    LADSPA_Data * LOutput,
+		    LADSPA_Data * ROutput,
+		    unsigned long SampleCount) {
+
+	unsigned long lSampleIndex = 0;
+	LADSPA_Data fL, fR;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex), _mm_loadu_ps(LGains + lSampleIndex));
+		__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex), _mm_loadu_ps(RGains + lSampleIndex));
+		_mm_storeu_ps(LOutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm_storeu_ps(ROutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	for (; lSampleIndex < SampleCount; lSampleIndex++) {
+		fL = LInput[lSampleIndex] * LGains[lSampleIndex];
+		fR = RInput[lSampleIndex] * RGains[lSampleIndex];
+		LOutput[lSampleIndex] += fL;
+		ROutput[lSampleIndex] += fR;
+	}
+}
+
+
+static void
+scaleRampSSE2(const LADSPA_Data * Input,
+              LADSPA_Data * Output,
+              LADSPA_Data Gain,
+              LADSPA_Data Step,
+              unsigned long SampleCount) {
+
+	__m128 vLane = _mm_set_ps(3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vIndex = _mm_add_ps(vLane, _mm_set1_ps((LADSPA_Data)lSampleIndex));
+		__m128 vGain = _mm_add_ps(_mm_set1_ps(Gain), _mm_mul_ps(vIndex, _mm_set1_ps(Step)));
+		_mm_storeu_ps(Output + lSampleIndex, _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex), vGain));
+	}
+	cmeScaleRampFinish(Input, Output, Gain, Step, lSampleIndex, SampleCount, 0);
+}
+
+
+static void
+scaleRampAddSSE2(const LADSPA_Data * Input,
+                 LADSPA_Data * Output,
+                 LADSPA_Data Gain,
+                 LADSPA_Data Step,
+                 unsigned long SampleCount) {
+
+	__m128 vLane = _mm_set_ps(3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vIndex = _mm_add_ps(vLane, _mm_set1_ps((LADSPA_Data)lSampleIndex));
+		__m128 vGain = _mm_add_ps(_mm_set1_ps(Gain), _mm_mul_ps(vIndex, _mm_set1_ps(Step)));
+		_mm_storeu_ps(Output + lSampleIndex, _mm_add_ps(_mm_loadu_ps(Output + lSampleIndex), _mm_mul_ps(_mm_loadu_ps(Input + lSampleIndex), vGain)));
+	}
+	cmeScaleRampFinish(Input, Output, Gain, Step, lSampleIndex, SampleCount, 1);
+}
+
+
+static void
+dualScaleRampSSE2(const LADSPA_Data * LInput,
+                  const LADSPA_Data * RInput,
+                  LADSPA_Data * LOutput,
+                  LADSPA_Data * ROutput,
+                  LADSPA_Data LGain,
+                  LADSPA_Data LStep,
+                  LADSPA_Data RGain,
+                  LADSPA_Data RStep,
+                  unsigned long SampleCount) {
+
+	__m128 vLane = _mm_set_ps(3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vIndex = _mm_add_ps(vLane, _mm_set1_ps((LADSPA_Data)lSampleIndex));
+		__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex), _mm_add_ps(_mm_set1_ps(LGain), _mm_mul_ps(vIndex, _mm_set1_ps(LStep))));
+		__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex), _mm_add_ps(_mm_set1_ps(RGain), _mm_mul_ps(vIndex, _mm_set1_ps(RStep))));
+		_mm_storeu_ps(LOutput + lSampleIndex, vL);
+		_mm_storeu_ps(ROutput + lSampleIndex, vR);
+	}
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, lSampleIndex, SampleCount, 0);
+}
+
+
+static void
+dualScaleRampAddSSE2(const LADSPA_Data * LInput,
+                     const LADSPA_Data * RInput,
+                     LADSPA_Data * LOutput,
+                     LADSPA_Data * ROutput,
+                     LADSPA_Data LGain,
+                     LADSPA_Data LStep,
+                     LADSPA_Data RGain,
+                     LADSPA_Data RStep,
+                     unsigned long SampleCount) {
+
+	__m128 vLane = _mm_set_ps(3, 2, 1, 0);
+	unsigned long lSampleIndex = 0;
+
+	for (; lSampleIndex + 4 <= SampleCount; lSampleIndex += 4) {
+		__m128 vIndex = _mm_add_ps(vLane, _mm_set1_ps((LADSPA_Data)lSampleIndex));
+		__m128 vL = _mm_mul_ps(_mm_loadu_ps(LInput + lSampleIndex), _mm_add_ps(_mm_set1_ps(LGain), _mm_mul_ps(vIndex, _mm_set1_ps(LStep))));
+		__m128 vR = _mm_mul_ps(_mm_loadu_ps(RInput + lSampleIndex), _mm_add_ps(_mm_set1_ps(RGain), _mm_mul_ps(vIndex, _mm_set1_ps(RStep))));
+		_mm_storeu_ps(LOutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(LOutput + lSampleIndex), vL));
+		_mm_storeu_ps(ROutput + lSampleIndex, _mm_add_ps(_mm_loadu_ps(ROutput + lSampleIndex), vR));
+	}
+	cmeDualScaleRampFinish(LInput, RInput, LOutput, ROutput, LGain, LStep, RGain, RStep, lSampleIndex, SampleCount, 1);
+}
+
+
+const CMEKernelTable g_sCMEKernelsSSE2 = {
+	"sse2",
+	scaleSSE2,
+	dualScaleSSE2,
+	scaleAddSSE2,
+	dualScaleAddSSE2,
+	zeroSSE2,
+	statsSSE2,
+	truePeakSSE2,
+	isSilentSSE2,
+	dualScaleStatsSSE2,
+	dbToGainSSE2,
+	panLawGainsSSE2,
+	multiplySSE2,
+	multiplyAddSSE2,
+	dualMultiplySSE2,
+	dualMultiplyAddSSE2,
+	scaleRampSSE2,
+	scaleRampAddSSE2,
+	dualScaleRampSSE2,
+	dualScaleRampAddSSE2
+};
+
+
+/* EOF */
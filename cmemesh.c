@@ -0,0 +1,823 @@
+/*
+LADSPA plugins implementing the 2D and 3D waveguide-mesh reverbs from Notes.txt: stereo in, stereo out.
+
+The mesh is a rectilinear digital waveguide mesh, run in its finite-difference form: each node's next value is 2/N times the sum of its N neighbours' current values, less its own previous value (N = 4 in 2D, 6 in 3D), all times a loss factor set from the Decay control.  The edges are rigid (fixed at zero).  The two inputs are injected at two nodes and the two outputs picked up at two others, all off-centre so the two sides are decorrelated.  The mesh runs at the sample rate, so a node is about 1 cm across at 48 kHz (the speed of sound over sqrt(N/2) nodes per sample): the 2D mesh is a small plate, and the 3D ones are boxes tens of cm across, with correspondingly dense, metallic early reflections.
+
+Layout: each mesh is a stack of planes along its slowest axis (rows, in 2D), each plane padded with a zero border and rows rounded up to a whole number of cache lines, so the stencil's inner loop is a straight run along x that the compiler vectorises, with every neighbour at a fixed offset.
+
+Threading: the planes are split into slabs, one per worker; the worker count is fixed in instantiate(), from the number of CPUs and the size of the mesh (or the environment variable CME_MESH_THREADS), and the threads are started in activate().  Each worker keeps its own copy of its slab plus MESH_STEPS planes either side (ghost zones), so after exchanging those with its neighbours it can run MESH_STEPS samples on its own, redoing a shrinking margin of its neighbours' work rather than synchronising every sample.  So the workers meet at a barrier twice per MESH_STEPS samples, and each slab (with its ghost zones) stays small enough to live in its core's cache.  run() does one slab itself and spins at the barriers; the other workers sleep between run()s.  If the threads can't be started, run() does every slab itself, one after another, with the same result.
+
+Real time: run() waits at each barrier for the slowest worker, so it only makes its deadline if every worker gets a core as soon as it is woken.  So the workers take on the scheduling policy and priority of whichever thread calls run() (if the process is allowed to set them; they are checked at the start of each run(), and only changed when the caller's change), and an RT host's workers aren't held up behind its ordinary threads.  Even so, a threaded run() is only bounded if there are as many free cores as workers, which no plugin can promise, so only the 2D mesh, which is small enough for one thread, is marked hard-RT capable (unless CME_MESH_THREADS gives it more).  The 3D meshes are split over up to 3 and 6 workers, and the large one is too big to run in real time on one core.
+
+Silence: the mesh never dies away to exact zeros, as the FDN's lines do: with the denormal guard on it settles into a limit cycle just above the smallest normal float (the neighbour sums that are flushed to zero feed it), and without it, at the denormal bias.  So at the end of each MESH_CHUNK samples of silent input (counted from activate(), so it doesn't depend on how the host splits its blocks) the slabs are checked with the Stats kernel, a plane at a time, both levels, and if every node is below MESH_QUIET_LEVEL (-600 dB) the mesh is zeroed and known to be empty.  That costs up to a pass over the mesh, about as much as one of the chunk's samples, and changes nothing above -600 dB.  From then on, silent input produces silence without waking the workers or touching the mesh, until the input comes back.  (Where FTZ is missing the bias keeps the mesh above the level, and it always runs.)
+
+The result doesn't depend on the number of workers.
+
+CME 2026-10
+*/
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "ladspa.h"
+#include "cmedenormal.h"
+#include "cmekernels.h"
+#include "cmeplugins.h"
+
+
+
+#define CMEMESH_LADSPA_ID	72	// ...to 74; see g_asMeshDescriptors
+
+#define CMEMESH_PORT_COUNT	6
+
+/* The internal ID numbers for the plugin's ports: */
+#define MESH_DECAY	0
+#define MESH_MIX	1
+#define MESH_INPUT1	2
+#define MESH_OUTPUT1	3
+#define MESH_INPUT2	4
+#define MESH_OUTPUT2	5
+
+#define MESH_CHANNELS	2
+
+/* Samples run between exchanges of ghost zones, and so the depth of the ghost zones. */
+#define MESH_STEPS	8
+
+/* Samples handed to the workers at a time. */
+#define MESH_CHUNK	256
+
+/* Below this everywhere, on a whole chunk of silent input, the mesh is zeroed (see "Silence" above). */
+#define MESH_QUIET_LEVEL	1e-30f
+
+/* Rows are padded to a multiple of this many floats (a cache line). */
+#define MESH_ROW_ALIGN	16
+
+/* Nodes per worker below which another thread isn't worth waking. */
+#define MESH_NODES_PER_WORKER	16384
+
+#define MESH_THREADS_ENV	"CME_MESH_THREADS"
+
+/* Spins at a barrier before yielding the CPU. */
+#define MESH_SPINS	1000
+
+
+/* The sizes on offer, in nodes (NY is 1 in 2D). */
+typedef struct {
+	unsigned long Dimensions;
+	unsigned long NX, NY, NZ;
+	LADSPA_Data WetGain;		// Brings noise out at about the level it went in, at the default decay time
+} MeshShape;
+
+/* ...in descriptor order (see g_asMeshDescriptors, which also has their labels and names): */
+static const MeshShape g_asMeshShapes[] = {
+	{ 2, 160, 1, 120, 0.9f },
+	{ 3, 48, 36, 32, 2.7f },
+	{ 3, 72, 54, 48, 5.0f }
+};
+#define MESH_SHAPES	(sizeof(g_asMeshShapes) / sizeof(g_asMeshShapes[0]))
+
+/* Where the inputs go in and the outputs are taken, as fractions of each dimension. */
+static const float g_aafMeshSources[MESH_CHANNELS][3] = { { 0.31f, 0.43f, 0.37f }, { 0.69f, 0.41f, 0.59f } };
+static const float g_aafMeshPickups[MESH_CHANNELS][3] = { { 0.23f, 0.71f, 0.62f }, { 0.77f, 0.67f, 0.29f } };
+
+
+
+/* A node, as a plane number (1 .. NZ) and an offset within the plane. */
+typedef struct {
+	unsigned long Plane;
+	unsigned long Offset;
+} MeshNode;
+
+
+/* A sense-reversing spin barrier. */
+typedef struct {
+	unsigned long Arrived;
+	unsigned long Generation;
+	unsigned long Threads;
+} MeshBarrier;
+
+
+struct Mesh;
+
+/* One slab of planes, and the thread that runs it. */
+typedef struct {
+	struct Mesh * Mesh;
+	unsigned long First;		// First plane owned
+	unsigned long Last;		// One past the last plane owned
+	unsigned long BufferFirst;	// The plane at the start of Level[]
+	unsigned long BufferEnd;	// One past the last plane in Level[]
+	LADSPA_Data * Level[2];		// The slab and its ghost zones at two successive samples; Level[Parity] is the newer
+	unsigned long Parity;
+
+	pthread_t Thread;
+	sem_t Start;
+	int Running;
+} MeshWorker;
+
+
+/* The structure used to hold port connection information and state. */
+
+typedef struct Mesh {
+	LADSPA_Data * DecayTime;
+	LADSPA_Data * Mix;
+	LADSPA_Data * InputBuffer[MESH_CHANNELS];
+	LADSPA_Data * OutputBuffer[MESH_CHANNELS];
+
+	LADSPA_Data SampleRate;
+	LADSPA_Data RunAddingGain;
+
+	const MeshShape * Shape;
+	unsigned long RowStride;	// Floats
+	unsigned long PlaneSize;	// Floats
+	MeshNode Source[MESH_CHANNELS];
+	MeshNode Pickup[MESH_CHANNELS];
+
+	LADSPA_Data LastDecayTime;
+	LADSPA_Data Loss;		// Applied to every update
+	LADSPA_Data Coupling;		// 2/N
+
+	unsigned long Workers;
+	MeshWorker * Worker;
+	MeshWorker ** PlaneOwner;	// For planes 0 .. NZ + 1 (NULL at the edges)
+	int Threaded;			// The threads are running
+	int SchedulingPolicy;		// ...and priority the workers were last given
+	int SchedulingPriority;
+	int Quit;
+	MeshBarrier Barrier;
+	int Empty;			// Every node is zero (see "Silence" above)
+	unsigned long Phase;		// Samples into the current MESH_CHUNK since activate()
+	int ChunkSilent;		// ...and whether they were all silent
+
+	// The current chunk:
+	unsigned long Count;
+	LADSPA_Data Input[MESH_CHANNELS][MESH_CHUNK];
+	LADSPA_Data Output[MESH_CHANNELS][MESH_CHUNK];
+} Mesh;
+
+
+void
+cleanupMesh(LADSPA_Handle Instance);
+
+static void
+stopWorkers(Mesh * psMesh);
+
+static void *
+meshWorkerThread(void * Arg);
+
+
+
+/* The node at the given fractions of the way across the mesh. */
+static MeshNode
+meshNode(const Mesh * psMesh,
+	 const float * Position) {
+
+	const MeshShape * psShape = psMesh->Shape;
+	MeshNode sNode;
+	unsigned long lX = 1 + (unsigned long)(Position[0] * psShape->NX);
+	unsigned long lY = psShape->Dimensions == 3 ? 1 + (unsigned long)(Position[1] * psShape->NY) : 0;
+
+	sNode.Plane = 1 + (unsigned long)(Position[2] * psShape->NZ);
+	sNode.Offset = lY * psMesh->RowStride + lX;
+	return sNode;
+}
+
+
+/* How many workers to split the mesh between. */
+static unsigned long
+countWorkers(const MeshShape * psShape) {
+
+	const char * pcThreads = getenv(MESH_THREADS_ENV);
+	long lCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned long lWorkers;
+
+	if (pcThreads && *pcThreads)
+		lWorkers = strtoul(pcThreads, NULL, 10);
+	else {
+		lWorkers = psShape->NX * psShape->NY * psShape->NZ / MESH_NODES_PER_WORKER;
+		if (lCPUs > 0 && lWorkers > (unsigned long)lCPUs)
+			lWorkers = lCPUs;
+	}
+	// Slabs thinner than the ghost zones would mean most of the work was redone:
+	if (lWorkers > psShape->NZ / MESH_STEPS)
+		lWorkers = psShape->NZ / MESH_STEPS;
+	return lWorkers ? lWorkers : 1;
+}
+
+
+/* Construct a new plugin instance. */
+LADSPA_Handle
+instantiateMesh(const LADSPA_Descriptor * Descriptor,
+		unsigned long             SampleRate) {
+
+	Mesh * psMesh;
+	MeshWorker * psWorker;
+	const MeshShape * psShape = (const MeshShape *)Descriptor->ImplementationData;
+	unsigned long lWorker, lPlane, lChannel, lLevel;
+
+	psMesh = (Mesh *)calloc(1, sizeof(Mesh));
+	if (!psMesh)
+		return NULL;
+
+	psMesh->SampleRate = SampleRate;
+	psMesh->RunAddingGain = 1;
+	psMesh->Shape = psShape;
+	psMesh->RowStride = (psShape->NX + 2 + MESH_ROW_ALIGN - 1) / MESH_ROW_ALIGN * MESH_ROW_ALIGN;
+	psMesh->PlaneSize = psShape->Dimensions == 3 ? (psShape->NY + 2) * psMesh->RowStride : psMesh->RowStride;
+	psMesh->Coupling = psShape->Dimensions == 3 ? 1.0f / 3.0f : 0.5f;
+	for (lChannel = 0; lChannel < MESH_CHANNELS; lChannel++) {
+		psMesh->Source[lChannel] = meshNode(psMesh, g_aafMeshSources[lChannel]);
+		psMesh->Pickup[lChannel] = meshNode(psMesh, g_aafMeshPickups[lChannel]);
+	}
+
+	psMesh->Workers = countWorkers(psShape);
+	psMesh->Worker = (MeshWorker *)calloc(psMesh->Workers, sizeof(MeshWorker));
+	psMesh->PlaneOwner = (MeshWorker **)calloc(psShape->NZ + 2, sizeof(MeshWorker *));
+	if (!psMesh->Worker || !psMesh->PlaneOwner) {
+		cleanupMesh(psMesh);
+		return NULL;
+	}
+
+	for (lWorker = 0; lWorker < psMesh->Workers; lWorker++) {
+		psWorker = &psMesh->Worker[lWorker];
+		psWorker->Mesh = psMesh;
+		psWorker->First = 1 + lWorker * psShape->NZ / psMesh->Workers;
+		psWorker->Last = 1 + (lWorker + 1) * psShape->NZ / psMesh->Workers;
+		psWorker->BufferFirst = psWorker->First > MESH_STEPS ? psWorker->First - MESH_STEPS : 0;
+		psWorker->BufferEnd = psWorker->Last + MESH_STEPS < psShape->NZ + 2 ? psWorker->Last + MESH_STEPS : psShape->NZ + 2;
+		for (lLevel = 0; lLevel < 2; lLevel++) {
+			if (posix_memalign((void **)&psWorker->Level[lLevel], MESH_ROW_ALIGN * sizeof(LADSPA_Data),
+					   (psWorker->BufferEnd - psWorker->BufferFirst) * psMesh->PlaneSize * sizeof(LADSPA_Data)) != 0) {
+				psWorker->Level[lLevel] = NULL;
+				cleanupMesh(psMesh);
+				return NULL;
+			}
+		}
+		for (lPlane = psWorker->First; lPlane < psWorker->Last; lPlane++)
+			psMesh->PlaneOwner[lPlane] = psWorker;
+	}
+
+	return psMesh;
+}
+
+
+/* Zero every worker's slab and ghost zones, at both levels. */
+static void
+clearMesh(Mesh * psMesh) {
+
+	MeshWorker * psWorker;
+	unsigned long lWorker, lLevel;
+
+	for (lWorker = 0; lWorker < psMesh->Workers; lWorker++) {
+		psWorker = &psMesh->Worker[lWorker];
+		for (lLevel = 0; lLevel < 2; lLevel++)
+			memset(psWorker->Level[lLevel], 0, (psWorker->BufferEnd - psWorker->BufferFirst) * psMesh->PlaneSize * sizeof(LADSPA_Data));
+	}
+	psMesh->Empty = 1;
+}
+
+
+/* Silence the mesh and start the worker threads. */
+void
+activateMesh(LADSPA_Handle Instance) {
+
+	Mesh * psMesh;
+	MeshWorker * psWorker;
+	unsigned long lWorker;
+	struct sched_param sParam;
+
+	psMesh = (Mesh *)Instance;
+	stopWorkers(psMesh);
+
+	clearMesh(psMesh);
+	for (lWorker = 0; lWorker < psMesh->Workers; lWorker++)
+		psMesh->Worker[lWorker].Parity = 0;
+	psMesh->Phase = 0;
+	psMesh->LastDecayTime = NAN;	// (forces the loss to be computed on the next run())
+
+	if (psMesh->Workers < 2)
+		return;
+
+	// Worker 0 is whichever thread calls run(), and the others start with this thread's scheduling (see followCaller()):
+	if (pthread_getschedparam(pthread_self(), &psMesh->SchedulingPolicy, &sParam) != 0) {
+		psMesh->SchedulingPolicy = SCHED_OTHER;
+		sParam.sched_priority = 0;
+	}
+	psMesh->SchedulingPriority = sParam.sched_priority;
+	psMesh->Quit = 0;
+	psMesh->Barrier.Arrived = 0;
+	psMesh->Barrier.Threads = psMesh->Workers;
+	psMesh->Threaded = 1;
+	for (lWorker = 1; lWorker < psMesh->Workers; lWorker++) {
+		psWorker = &psMesh->Worker[lWorker];
+		if (sem_init(&psWorker->Start, 0, 0) != 0) {
+			psMesh->Threaded = 0;
+			break;
+		}
+		if (pthread_create(&psWorker->Thread, NULL, meshWorkerThread, psWorker) != 0) {
+			sem_destroy(&psWorker->Start);
+			psMesh->Threaded = 0;
+			break;
+		}
+		psWorker->Running = 1;
+	}
+	// (if they couldn't all be started, run() does every slab itself)
+	if (!psMesh->Threaded)
+		stopWorkers(psMesh);
+}
+
+
+/* Stop any worker threads. */
+static void
+stopWorkers(Mesh * psMesh) {
+
+	MeshWorker * psWorker;
+	unsigned long lWorker;
+
+	__atomic_store_n(&psMesh->Quit, 1, __ATOMIC_RELEASE);
+	for (lWorker = 1; lWorker < psMesh->Workers; lWorker++) {
+		psWorker = &psMesh->Worker[lWorker];
+		if (!psWorker->Running)
+			continue;
+		sem_post(&psWorker->Start);
+		pthread_join(psWorker->Thread, NULL);
+		sem_destroy(&psWorker->Start);
+		psWorker->Running = 0;
+	}
+	psMesh->Threaded = 0;
+}
+
+
+void
+deactivateMesh(LADSPA_Handle Instance) {
+	stopWorkers((Mesh *)Instance);
+}
+
+
+/* Connect a port to a data location. */
+void
+connectPortToMesh(LADSPA_Handle Instance,
+		  unsigned long Port,
+		  LADSPA_Data * DataLocation) {
+
+	Mesh * psMesh;
+
+	psMesh = (Mesh *)Instance;
+	switch (Port) {
+		case MESH_DECAY:
+			psMesh->DecayTime = DataLocation;
+			break;
+		case MESH_MIX:
+			psMesh->Mix = DataLocation;
+			break;
+		case MESH_INPUT1:
+			psMesh->InputBuffer[0] = DataLocation;
+			break;
+		case MESH_OUTPUT1:
+			psMesh->OutputBuffer[0] = DataLocation;
+			break;
+		case MESH_INPUT2:
+			psMesh->InputBuffer[1] = DataLocation;
+			break;
+		case MESH_OUTPUT2:
+			psMesh->OutputBuffer[1] = DataLocation;
+			break;
+	}
+}
+
+
+
+/* Wait until all the workers have arrived.  Only the last to arrive writes anything but the count, and nobody sleeps. */
+static void
+waitAtBarrier(MeshBarrier * psBarrier) {
+
+	unsigned long lGeneration = __atomic_load_n(&psBarrier->Generation, __ATOMIC_ACQUIRE);
+	unsigned long lSpins = 0;
+
+	if (__atomic_add_fetch(&psBarrier->Arrived, 1, __ATOMIC_ACQ_REL) == psBarrier->Threads) {
+		__atomic_store_n(&psBarrier->Arrived, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&psBarrier->Generation, lGeneration + 1, __ATOMIC_RELEASE);
+		return;
+	}
+	while (__atomic_load_n(&psBarrier->Generation, __ATOMIC_ACQUIRE) == lGeneration) {
+		// (yielding now and then keeps this working when there are more workers than free CPUs)
+		if (++lSpins == MESH_SPINS) {
+			sched_yield();
+			lSpins = 0;
+		}
+	}
+}
+
+
+/* Copy the worker's ghost zones, at both levels, from the slabs that own them. */
+static void
+exchangeGhostZones(MeshWorker * psWorker) {
+
+	Mesh * psMesh = psWorker->Mesh;
+	MeshWorker * psOwner;
+	unsigned long lPlane, lLevel;
+
+	for (lPlane = psWorker->BufferFirst; lPlane < psWorker->BufferEnd; lPlane++) {
+		if (lPlane == psWorker->First)
+			lPlane = psWorker->Last;
+		if (lPlane >= psWorker->BufferEnd)
+			break;
+		psOwner = psMesh->PlaneOwner[lPlane];
+		if (!psOwner)
+			continue;	// (an edge, which is always zero)
+		for (lLevel = 0; lLevel < 2; lLevel++)
+			memcpy(psWorker->Level[lLevel] + (lPlane - psWorker->BufferFirst) * psMesh->PlaneSize,
+			       psOwner->Level[lLevel] + (lPlane - psOwner->BufferFirst) * psMesh->PlaneSize,
+			       psMesh->PlaneSize * sizeof(LADSPA_Data));
+	}
+}
+
+
+/* One step of one plane: Previous (the older level) becomes the next one.  The loops along x are what gets vectorised. */
+static inline void
+updatePlane(const Mesh * psMesh,
+	    const LADSPA_Data * Current,
+	    LADSPA_Data * Previous) {
+
+	const MeshShape * psShape = psMesh->Shape;
+	const LADSPA_Data * pfBelow = Current - psMesh->PlaneSize;
+	const LADSPA_Data * pfAbove = Current + psMesh->PlaneSize;
+	LADSPA_Data fLoss = psMesh->Loss;
+	LADSPA_Data fCoupling = psMesh->Coupling;
+	unsigned long lRowStride = psMesh->RowStride;
+	unsigned long lRow, lRowStart, lX;
+
+	if (psShape->Dimensions == 2) {
+		for (lX = 1; lX <= psShape->NX; lX++)
+			Previous[lX] = fLoss * (fCoupling * (Current[lX - 1] + Current[lX + 1] + pfBelow[lX] + pfAbove[lX]) - Previous[lX]);
+		return;
+	}
+
+	for (lRow = 1; lRow <= psShape->NY; lRow++) {
+		lRowStart = lRow * lRowStride;
+		for (lX = lRowStart + 1; lX <= lRowStart + psShape->NX; lX++)
+			Previous[lX] = fLoss * (fCoupling * (Current[lX - 1] + Current[lX + 1]
+							     + Current[lX - lRowStride] + Current[lX + lRowStride]
+							     + pfBelow[lX] + pfAbove[lX]) - Previous[lX]);
+	}
+}
+
+
+/* Run Steps samples (<= MESH_STEPS), starting Offset samples into the chunk, on the worker's slab.  Each step also updates the ghost zones, less one plane each side than the step before, so the slab itself is right at the end. */
+static void
+stepWorker(MeshWorker * psWorker,
+	   unsigned long Offset,
+	   unsigned long Steps) {
+
+	Mesh * psMesh = psWorker->Mesh;
+	unsigned long lNZ = psMesh->Shape->NZ;
+	unsigned long lStep, lMargin, lFrom, lTo, lPlane, lChannel;
+	LADSPA_Data * pfCurrent;
+	LADSPA_Data * pfNext;
+	const MeshNode * psNode;
+
+	for (lStep = 0; lStep < Steps; lStep++) {
+		lMargin = Steps - 1 - lStep;
+		lFrom = psWorker->First > lMargin + 1 ? psWorker->First - lMargin : 1;
+		lTo = psWorker->Last + lMargin < lNZ + 1 ? psWorker->Last + lMargin : lNZ + 1;
+
+		pfCurrent = psWorker->Level[psWorker->Parity] - psWorker->BufferFirst * psMesh->PlaneSize;
+		pfNext = psWorker->Level[psWorker->Parity ^ 1] - psWorker->BufferFirst * psMesh->PlaneSize;
+		for (lPlane = lFrom; lPlane < lTo; lPlane++)
+			updatePlane(psMesh, pfCurrent + lPlane * psMesh->PlaneSize, pfNext + lPlane * psMesh->PlaneSize);
+		psWorker->Parity ^= 1;
+
+		for (lChannel = 0; lChannel < MESH_CHANNELS; lChannel++) {
+			psNode = &psMesh->Source[lChannel];
+			if (psNode->Plane >= lFrom && psNode->Plane < lTo)
+				pfNext[psNode->Plane * psMesh->PlaneSize + psNode->Offset] += cmeDenormalBias(psMesh->Input[lChannel][Offset + lStep]);
+			psNode = &psMesh->Pickup[lChannel];
+			if (psNode->Plane >= psWorker->First && psNode->Plane < psWorker->Last)
+				psMesh->Output[lChannel][Offset + lStep] = pfNext[psNode->Plane * psMesh->PlaneSize + psNode->Offset];
+		}
+	}
+}
+
+
+/* A worker's share of the current chunk, when the workers are running in parallel. */
+static void
+runWorkerChunk(MeshWorker * psWorker) {
+
+	Mesh * psMesh = psWorker->Mesh;
+	unsigned long lOffset, lSteps;
+
+	for (lOffset = 0; lOffset < psMesh->Count; lOffset += lSteps) {
+		lSteps = psMesh->Count - lOffset < MESH_STEPS ? psMesh->Count - lOffset : MESH_STEPS;
+		waitAtBarrier(&psMesh->Barrier);	// (everyone's slab is up to date)
+		exchangeGhostZones(psWorker);
+		waitAtBarrier(&psMesh->Barrier);	// (nobody is still reading ours)
+		stepWorker(psWorker, lOffset, lSteps);
+	}
+	waitAtBarrier(&psMesh->Barrier);
+}
+
+
+/* Workers other than 0: one chunk per post of Start. */
+static void *
+meshWorkerThread(void * Arg) {
+
+	MeshWorker * psWorker = (MeshWorker *)Arg;
+
+	cmeDenormalsOff();
+	for (;;) {
+		while (sem_wait(&psWorker->Start) != 0 && errno == EINTR)
+			;
+		if (__atomic_load_n(&psWorker->Mesh->Quit, __ATOMIC_ACQUIRE))
+			break;
+		runWorkerChunk(psWorker);
+	}
+	return NULL;
+}
+
+
+/* Give the workers the scheduling policy and priority of the thread calling run(), if they have changed.  (pthread_getschedparam() normally reads the thread library's copy, without a system call.) */
+static void
+followCaller(Mesh * psMesh) {
+
+	struct sched_param sParam;
+	int iPolicy;
+	unsigned long lWorker;
+
+	if (pthread_getschedparam(pthread_self(), &iPolicy, &sParam) != 0
+	    || (iPolicy == psMesh->SchedulingPolicy && sParam.sched_priority == psMesh->SchedulingPriority))
+		return;
+	// (if the process isn't allowed to, the workers carry on as they were, and this isn't tried again until the caller's scheduling next changes)
+	for (lWorker = 1; lWorker < psMesh->Workers; lWorker++)
+		pthread_setschedparam(psMesh->Worker[lWorker].Thread, iPolicy, &sParam);
+	psMesh->SchedulingPolicy = iPolicy;
+	psMesh->SchedulingPriority = sParam.sched_priority;
+}
+
+
+/* Run the mesh over the chunk in Input, leaving the pickups in Output. */
+static void
+runChunk(Mesh * psMesh) {
+
+	unsigned long lWorker, lOffset, lSteps;
+
+	if (psMesh->Threaded) {
+		for (lWorker = 1; lWorker < psMesh->Workers; lWorker++)
+			sem_post(&psMesh->Worker[lWorker].Start);
+		runWorkerChunk(&psMesh->Worker[0]);
+		return;
+	}
+
+	// The same schedule, one slab at a time:
+	for (lOffset = 0; lOffset < psMesh->Count; lOffset += lSteps) {
+		lSteps = psMesh->Count - lOffset < MESH_STEPS ? psMesh->Count - lOffset : MESH_STEPS;
+		if (psMesh->Workers > 1)
+			for (lWorker = 0; lWorker < psMesh->Workers; lWorker++)
+				exchangeGhostZones(&psMesh->Worker[lWorker]);
+		for (lWorker = 0; lWorker < psMesh->Workers; lWorker++)
+			stepWorker(&psMesh->Worker[lWorker], lOffset, lSteps);
+	}
+}
+
+
+/* Whether every node of the mesh is below MESH_QUIET_LEVEL, at both levels.  Only the planes each worker owns are looked at (its ghost zones are part-way through its neighbours' work), so the answer doesn't depend on the number of workers. */
+static int
+meshIsQuiet(const Mesh * psMesh) {
+
+	const MeshWorker * psWorker;
+	CMEStats sStats;
+	unsigned long lWorker, lLevel, lPlane;
+
+	sStats.Min = HUGE_VALF;
+	sStats.Max = 0;
+	sStats.SumOfSquares = 0;
+	for (lWorker = 0; lWorker < psMesh->Workers; lWorker++) {
+		psWorker = &psMesh->Worker[lWorker];
+		for (lPlane = psWorker->First; lPlane < psWorker->Last; lPlane++)
+			for (lLevel = 0; lLevel < 2; lLevel++) {
+				g_sCMEKernels.Stats(psWorker->Level[lLevel] + (lPlane - psWorker->BufferFirst) * psMesh->PlaneSize, psMesh->PlaneSize, &sStats);
+				if (!(sStats.Max < MESH_QUIET_LEVEL))
+					return 0;
+			}
+	}
+	return 1;
+}
+
+
+/* Shared by run() and run_adding(): the output is the input and the reverb mixed according to the Mix control, times Gain, and either replaces or (if Adding) is added to the output buffers. */
+static inline void
+processMesh(Mesh * psMesh,
+	    unsigned long SampleCount,
+	    LADSPA_Data Gain,
+	    int Adding) {
+
+	LADSPA_Data fDecayTime = *(psMesh->DecayTime);
+	LADSPA_Data fMix = *(psMesh->Mix);
+	LADSPA_Data fDryGain, fWetGain, fOutput;
+	LADSPA_Data * pfOutput;
+	unsigned long lDone, lChannel, lSampleIndex;
+	int iSilent;
+	CMEDenormalGuard sGuard;
+
+	cmeDenormalGuardEnter(&sGuard);
+	if (psMesh->Threaded)
+		followCaller(psMesh);
+	if (fDecayTime != psMesh->LastDecayTime) {
+		psMesh->LastDecayTime = fDecayTime;
+		if (!(fDecayTime >= 0.1f))
+			fDecayTime = 0.1f;
+		// Scaling the whole update by g makes every mode decay by sqrt(g) per sample:
+		psMesh->Loss = powf(0.001f, 2.0f / (fDecayTime * psMesh->SampleRate));
+	}
+
+	if (!(fMix >= 0))
+		fMix = 0;
+	if (fMix > 1)
+		fMix = 1;
+	fDryGain = (1 - fMix) * Gain;
+	fWetGain = fMix * Gain * psMesh->Shape->WetGain;
+
+	for (lDone = 0; lDone < SampleCount; lDone += psMesh->Count) {
+		psMesh->Count = SampleCount - lDone < MESH_CHUNK - psMesh->Phase ? SampleCount - lDone : MESH_CHUNK - psMesh->Phase;
+
+		// Taking a copy of the input first also means the host can connect an output to the same buffer:
+		for (lChannel = 0; lChannel < MESH_CHANNELS; lChannel++)
+			memcpy(psMesh->Input[lChannel], psMesh->InputBuffer[lChannel] + lDone, psMesh->Count * sizeof(LADSPA_Data));
+		iSilent = g_sCMEKernels.IsSilent(psMesh->Input[0], psMesh->Count) && g_sCMEKernels.IsSilent(psMesh->Input[1], psMesh->Count);
+		if (psMesh->Phase == 0)
+			psMesh->ChunkSilent = 1;
+		if (!iSilent)
+			psMesh->ChunkSilent = 0;
+
+		// Silence into an empty mesh is silence out (the dry part included), and leaves it empty:
+		if (psMesh->Empty && iSilent) {
+			if (!Adding)
+				for (lChannel = 0; lChannel < MESH_CHANNELS; lChannel++)
+					g_sCMEKernels.Zero(psMesh->OutputBuffer[lChannel] + lDone, psMesh->Count);
+		}
+		else {
+			psMesh->Empty = 0;
+			runChunk(psMesh);
+
+			for (lChannel = 0; lChannel < MESH_CHANNELS; lChannel++) {
+				pfOutput = psMesh->OutputBuffer[lChannel] + lDone;
+				for (lSampleIndex = 0; lSampleIndex < psMesh->Count; lSampleIndex++) {
+					fOutput = fDryGain * psMesh->Input[lChannel][lSampleIndex] + fWetGain * psMesh->Output[lChannel][lSampleIndex];
+					if (Adding)
+						pfOutput[lSampleIndex] += fOutput;
+					else
+						pfOutput[lSampleIndex] = fOutput;
+				}
+			}
+		}
+
+		psMesh->Phase += psMesh->Count;
+		if (psMesh->Phase == MESH_CHUNK) {
+			psMesh->Phase = 0;
+			if (!psMesh->Empty && psMesh->ChunkSilent && meshIsQuiet(psMesh))
+				clearMesh(psMesh);
+		}
+	}
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+void
+runMesh(LADSPA_Handle Instance,
+	unsigned long SampleCount) {
+	processMesh((Mesh *)Instance, SampleCount, 1, 0);
+}
+
+
+void
+setMeshRunAddingGain(LADSPA_Handle Instance,
+		     LADSPA_Data Gain) {
+	((Mesh *)Instance)->RunAddingGain = Gain;
+}
+
+
+void
+runAddingMesh(LADSPA_Handle Instance,
+	      unsigned long SampleCount) {
+	processMesh((Mesh *)Instance, SampleCount, ((Mesh *)Instance)->RunAddingGain, 1);
+}
+
+
+/* Stop the workers and throw the mesh away. */
+void
+cleanupMesh(LADSPA_Handle Instance) {
+
+	Mesh * psMesh;
+	unsigned long lWorker;
+
+	psMesh = (Mesh *)Instance;
+	if (psMesh->Worker) {
+		stopWorkers(psMesh);
+		for (lWorker = 0; lWorker < psMesh->Workers; lWorker++) {
+			free(psMesh->Worker[lWorker].Level[0]);
+			free(psMesh->Worker[lWorker].Level[1]);
+		}
+	}
+	free(psMesh->Worker);
+	free(psMesh->PlaneOwner);
+	free(psMesh);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiMeshPortDescriptors[CMEMESH_PORT_COUNT] = {
+	[MESH_DECAY] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[MESH_MIX] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[MESH_INPUT1] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[MESH_OUTPUT1] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[MESH_INPUT2] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[MESH_OUTPUT2] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO
+};
+
+static const char * const g_apcMeshPortNames[CMEMESH_PORT_COUNT] = {
+	[MESH_DECAY] = "Decay time (s)",
+	[MESH_MIX] = "Mix (dry/wet)",
+	[MESH_INPUT1] = "Input (Left)",
+	[MESH_OUTPUT1] = "Output (Left)",
+	[MESH_INPUT2] = "Input (Right)",
+	[MESH_OUTPUT2] = "Output (Right)"
+};
+
+static const LADSPA_PortRangeHint g_asMeshPortRangeHints[CMEMESH_PORT_COUNT] = {
+	// Default is the geometric middle of the range, about 1.4 s:
+	[MESH_DECAY] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_LOGARITHMIC |
+		LADSPA_HINT_DEFAULT_MIDDLE,
+		0.1, 20
+	},
+	[MESH_MIX] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_LOW,
+		0, 1
+	}
+};
+
+
+/* The descriptor for shape Index of g_asMeshShapes: */
+#define MESH_DESCRIPTOR(Index, ShapeProperties, ShapeLabel, ShapeName) { \
+	.UniqueID = CMEMESH_LADSPA_ID + Index, \
+	.Label = ShapeLabel, \
+	.Properties = ShapeProperties, \
+	.Name = ShapeName, \
+	.Maker = "Chris Edwards", \
+	.Copyright = "None", \
+	.PortCount = CMEMESH_PORT_COUNT, \
+	.PortDescriptors = g_aiMeshPortDescriptors, \
+	.PortNames = g_apcMeshPortNames, \
+	.PortRangeHints = g_asMeshPortRangeHints, \
+	.ImplementationData = (void *)&g_asMeshShapes[Index], \
+	.instantiate = instantiateMesh, \
+	.connect_port = connectPortToMesh, \
+	.activate = activateMesh, \
+	.run = runMesh, \
+	.run_adding = runAddingMesh, \
+	.set_run_adding_gain = setMeshRunAddingGain, \
+	.deactivate = deactivateMesh, \
+	.cleanup = cleanupMesh \
+}
+
+const LADSPA_Descriptor g_asMeshDescriptors[MESH_SHAPES] = {
+	// (only the 2D mesh runs on one thread; see "Real time" above)
+	MESH_DESCRIPTOR(0, LADSPA_PROPERTY_HARD_RT_CAPABLE, "cme_mesh2d", "2D Waveguide Mesh Reverb (CME)"),
+	MESH_DESCRIPTOR(1, 0, "cme_mesh3d", "3D Waveguide Mesh Reverb, multi-threaded (CME)"),
+	MESH_DESCRIPTOR(2, 0, "cme_mesh3d_large", "3D Waveguide Mesh Reverb, large, needs several cores (CME)")
+};
+
+
+#ifndef CME_BUNDLE
+
+void
+_init() {
+	cmeKernelsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type: 2D, then 3D from smallest to largest. */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+	/* Return the requested descriptor or null if the index is out of range. */
+	if (Index < MESH_SHAPES)
+		return &g_asMeshDescriptors[Index];
+	return NULL;
+}
+
+#endif /* CME_BUNDLE */
+
+
+/* EOF */
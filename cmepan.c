@@ -1,21 +1,39 @@
 /*
 LADSPA plugin implementing a simple pan control (mono input, stereo output).
 CME 2007-10-05
+
+Silent input isn't multiplied: the outputs are zero-filled (apart from one that is the input buffer, which already holds the zeros), and the "Silent" output goes to 1.
+CME 2026-10
+
+Pan changes are smoothed (see cmesmooth.h): both sides' gains ramp linearly to a new setting over the time set by the "Smoothing" control (10 ms by default), so moving the pan between blocks doesn't click.  Once the ramp has finished, run() uses the routine the smoother picked for the setting (see cmesmooth.h): at centre under the default law both gains are 1, so that is a copy of the input to each side; elsewhere, the plain DualScale again.
+CME 2026-10
+
+cme_pan_mod (ID 68) takes the pan position as an audio-rate input, for sample-accurate automation and modulation.  The PanLawGains kernel works out both sides' gains for CME_GAIN_CHUNK samples at a time, and DualMultiply applies them, so a constant pan signal gives exactly what cme_pan gives for the same control value.  Pan signals beyond -1 .. 1 are clamped.  There's nothing to smooth, so it has no "Smoothing" control.
+CME 2026-10
+
+The "Law" control selects the pan law (see cmepanlaw.h): 0 is the original one (0 dB at the centre, +3 dB at the edges), then constant power (sin/cos), and -3, -4.5 and -6 dB at the centre.  All of them are tables interpolated by the PanLawGains kernel, at control rate as well, so changing law costs nothing per sample, and a law change is smoothed like a pan change.
+CME 2026-10
 */
 
 
 #include <stdlib.h>
-#define _GNU_SOURCE
 #include <string.h>
 #include <math.h>
 
 #include "ladspa.h"
+#include "cmekernels.h"
+#include "cmesmooth.h"
+#include "cmepanlaw.h"
+#include "cmepool.h"
+#include "cmeplugins.h"
 
 
 
 #define CMEPAN_LADSPA_ID	51
+#define CMEPAN_MOD_LADSPA_ID	68
 
-#define CMEPAN_PORT_COUNT 4
+#define CMEPAN_PORT_COUNT 7
+#define CMEPAN_MOD_PORT_COUNT 6	// (no PAN_SMOOTHING, so the law is port 5)
 
 /* The internal ID numbers for the plugin's ports: */
 
@@ -24,28 +42,58 @@ CME 2007-10-05
 #define PAN_INPUT	1
 #define PAN_OUTPUT_L	2
 #define PAN_OUTPUT_R	3
+#define PAN_SILENT	4
+#define PAN_SMOOTHING	5
+#define PAN_LAW	6
+
+#define PAN_MOD_LAW	5
 
 
 
 
 
 /* The structure used to hold port connection information and state
-   (actually gain controls require no further state). */
+   (the gain factors for the last setting, and the ramp to them). */
 
 
 typedef struct {
-	LADSPA_Data * ControlValue;
+	LADSPA_Data * ControlValue;	// (An audio buffer, for cme_pan_mod)
 	LADSPA_Data * InputBuffer;
 	LADSPA_Data * LOutputBuffer;
 	LADSPA_Data * ROutputBuffer;
+	LADSPA_Data * SilentValue;	// (NULL if the host hasn't connected it)
+	LADSPA_Data * SmoothingValue;
+	LADSPA_Data * LawValue;
+	LADSPA_Data LastControlValue;	// Setting and law the gain factors below were computed for
+	int LastLaw;
+	LADSPA_Data LGainFactor;
+	LADSPA_Data RGainFactor;
+	LADSPA_Data RunAddingGain;
+	CMESmoother Smoother;
 } Pan;
 
+/* Both versions' instances come from here (see cmepool.h): */
+static CMEInstancePool g_sPanPool = CME_INSTANCE_POOL(Pan);
+
 
 /* Construct a new plugin instance. */
 LADSPA_Handle 
 instantiatePan(const LADSPA_Descriptor * Descriptor,
 		     unsigned long             SampleRate) {
-	return malloc(sizeof(Pan));
+
+	Pan * psPan;
+
+	psPan = (Pan *)cmePoolAllocate(&g_sPanPool);
+	if (psPan) {
+		psPan->SilentValue = NULL;
+		psPan->LastControlValue = NAN;	// (never equal to anything, so the first run() computes the factors)
+		psPan->LastLaw = 0;
+		psPan->LGainFactor = 1.0;
+		psPan->RGainFactor = 1.0;
+		psPan->RunAddingGain = 1.0;
+		cmeSmootherInit(&psPan->Smoother, SampleRate);
+	}
+	return psPan;
 }
 
 
@@ -71,7 +119,56 @@ connectPortToPan(LADSPA_Handle Instance,
 		case PAN_OUTPUT_R:
 			psPan->ROutputBuffer = DataLocation;
 			break;
+		case PAN_SILENT:
+			psPan->SilentValue = DataLocation;
+			break;
+		case PAN_SMOOTHING:
+			psPan->SmoothingValue = DataLocation;
+			break;
+		case PAN_LAW:
+			psPan->LawValue = DataLocation;
+			break;
+	}
+}
+
+
+/* The same for cme_pan_mod, whose law is port PAN_MOD_LAW. */
+void 
+connectPortToModulatedPan(LADSPA_Handle Instance,
+			  unsigned long Port,
+			  LADSPA_Data * DataLocation) {
+	if (Port == PAN_MOD_LAW)
+		((Pan *)Instance)->LawValue = DataLocation;
+	else
+		connectPortToPan(Instance, Port, DataLocation);
+}
+
+
+
+/* Update the cached L and R gain factors if the control or the law has changed since the last run(), and ramp to them. */
+static void
+updatePanGains(Pan * psPan) {
+
+	LADSPA_Data PanValue;
+	int iLaw;
+
+	PanValue = *(psPan->ControlValue);
+	iLaw = cmePanLawSelect(*(psPan->LawValue));
+	if (PanValue != psPan->LastControlValue || iLaw != psPan->LastLaw) {
+		psPan->LastControlValue = PanValue;
+		psPan->LastLaw = iLaw;
+		cmePanLawGains(iLaw, PanValue, 1.0f, &psPan->LGainFactor, &psPan->RGainFactor);
 	}
+	cmeSmootherSetTarget(&psPan->Smoother, psPan->LGainFactor, psPan->RGainFactor, *(psPan->SmoothingValue));
+}
+
+
+/* Report whether this block of output was all zeros, if the host wants to know. */
+static inline void
+setPanSilent(Pan * psPan,
+	     int Silent) {
+	if (psPan->SilentValue)
+		*(psPan->SilentValue) = Silent ? 1 : 0;
 }
 
 
@@ -83,31 +180,32 @@ runPan(LADSPA_Handle Instance,
 	LADSPA_Data * Input;
 	LADSPA_Data * LOutput;
 	LADSPA_Data * ROutput;
-	LADSPA_Data PanValue;
-	LADSPA_Data LGainFactor;	// Store it to reduce CPU load.
-	LADSPA_Data RGainFactor;
 
 	Pan * psPan;
-	unsigned long SampleIndex;
 
 	psPan = (Pan *)Instance;
 
 	Input = psPan->InputBuffer;
 	LOutput = psPan->LOutputBuffer;
 	ROutput = psPan->ROutputBuffer;
-	PanValue = *(psPan->ControlValue);
 
-	// Logarithmic gain functions, intersecting at (0, 0 dB), and with +3 dB boost at extremes (pan = -1 and 1):
-	LGainFactor = pow(10.0, 3 * log2(1 - PanValue) / 20.0);
-	RGainFactor = pow(10.0, 3 * log2(1 + PanValue) / 20.0);
+	// Gain factors are stored in the instance to reduce CPU load:
+	updatePanGains(psPan);
 
-	// Process the sample buffer:
-	for (SampleIndex = 0; SampleIndex < SampleCount; SampleIndex++)
-	{
-			*(LOutput++) = *(Input) * LGainFactor;
-			*(ROutput++) = *(Input) * RGainFactor;
-			Input++;
+	// Silence in, silence out:
+	if (g_sCMEKernels.IsSilent(Input, SampleCount)) {
+		if (LOutput != Input)
+			g_sCMEKernels.Zero(LOutput, SampleCount);
+		if (ROutput != Input)
+			g_sCMEKernels.Zero(ROutput, SampleCount);
+		setPanSilent(psPan, 1);
 	}
+	else {
+		// Process the sample buffer (the same input feeds both sides):
+		cmeSmoothedDualScale(&psPan->Smoother, Input, Input, LOutput, ROutput, 1.0f, SampleCount, 0);
+		setPanSilent(psPan, 0);
+	}
+	cmeSmootherAdvance(&psPan->Smoother, SampleCount);
 }
 
 
@@ -115,113 +213,241 @@ runPan(LADSPA_Handle Instance,
 
 
 
-/* Throw away a simple delay line. */
+/* run_adding() version: accumulates into the outputs, with the host's run-adding gain folded into both gain factors (and ramps).  Silent input adds nothing. */
+
 void 
-cleanupPan(LADSPA_Handle Instance) {
-	free(Instance);
+setPanRunAddingGain(LADSPA_Handle Instance,
+		    LADSPA_Data Gain) {
+	((Pan *)Instance)->RunAddingGain = Gain;
 }
 
 
+void 
+runAddingPan(LADSPA_Handle Instance,
+	     unsigned long SampleCount) {
 
-LADSPA_Descriptor * g_psPanDescriptor = NULL;
+	Pan * psPan;
 
+	psPan = (Pan *)Instance;
 
+	updatePanGains(psPan);
+	if (g_sCMEKernels.IsSilent(psPan->InputBuffer, SampleCount))
+		setPanSilent(psPan, 1);
+	else {
+		setPanSilent(psPan, 0);
+		cmeSmoothedDualScale(&psPan->Smoother, psPan->InputBuffer, psPan->InputBuffer,
+				     psPan->LOutputBuffer, psPan->ROutputBuffer,
+				     psPan->RunAddingGain, SampleCount, 1);
+	}
+	cmeSmootherAdvance(&psPan->Smoother, SampleCount);
+}
 
 
-void 
-_init() {
 
-	char ** pcPortNames;
-	LADSPA_PortDescriptor * piPortDescriptors;
-	LADSPA_PortRangeHint * psPortRangeHints;
 
-	g_psPanDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
 
-  
-		g_psPanDescriptor->UniqueID = CMEPAN_LADSPA_ID;
-		g_psPanDescriptor->Label = strdup("cme_pan");
-		g_psPanDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-		g_psPanDescriptor->Name = strdup("Pan (CME)");
-		g_psPanDescriptor->Maker = strdup("Chris Edwards");
-		g_psPanDescriptor->Copyright = strdup("None");
-
-		g_psPanDescriptor->PortCount = CMEPAN_PORT_COUNT;
-		piPortDescriptors = (LADSPA_PortDescriptor *)calloc(CMEPAN_PORT_COUNT, sizeof(LADSPA_PortDescriptor));
-		g_psPanDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)piPortDescriptors;
-		piPortDescriptors[PAN_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[PAN_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[PAN_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[PAN_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
-		
-		pcPortNames = (char **)calloc(CMEPAN_PORT_COUNT, sizeof(char *));
-		g_psPanDescriptor->PortNames = (const char **)pcPortNames;
-		pcPortNames[PAN_CONTROL] = strdup("Pan");
-		pcPortNames[PAN_INPUT] = strdup("Input");
-		pcPortNames[PAN_OUTPUT_L] = strdup("Output (L)");
-		pcPortNames[PAN_OUTPUT_R] = strdup("Output (R)");
-		psPortRangeHints = ((LADSPA_PortRangeHint *) calloc(CMEPAN_PORT_COUNT, sizeof(LADSPA_PortRangeHint)));
-		g_psPanDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)psPortRangeHints;
-
-		psPortRangeHints[PAN_CONTROL].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[PAN_CONTROL].LowerBound = -1;
-		psPortRangeHints[PAN_CONTROL].UpperBound = 1;
-
-		psPortRangeHints[PAN_INPUT].HintDescriptor = 0;
-		psPortRangeHints[PAN_OUTPUT_L].HintDescriptor = 0;
-		psPortRangeHints[PAN_OUTPUT_R].HintDescriptor = 0;
-
-		g_psPanDescriptor->instantiate = instantiatePan;
-		g_psPanDescriptor->connect_port = connectPortToPan;
-		g_psPanDescriptor->activate = NULL;
-		g_psPanDescriptor->run = runPan;
-		g_psPanDescriptor->run_adding = NULL;
-		g_psPanDescriptor->set_run_adding_gain = NULL;
-		g_psPanDescriptor->deactivate = NULL;
-		g_psPanDescriptor->cleanup = cleanupPan;
 
+/* Audio-rate version: the same ports, but PAN_CONTROL is an audio input (and there's no PAN_SMOOTHING). */
 
+/* Pan a chunk at a time, each chunk's gains worked out before any of its output is written (so it's safe in place, even on the pan signal's buffer). */
+static void
+modulatePan(Pan * psPan,
+	    LADSPA_Data Gain,
+	    unsigned long SampleCount,
+	    int Adding) {
+
+	LADSPA_Data afLGains[CME_GAIN_CHUNK];
+	LADSPA_Data afRGains[CME_GAIN_CHUNK];
+	const CMEPanLawTable * psLaw = &g_asCMEPanLaws[cmePanLawSelect(*(psPan->LawValue))];
+	unsigned long lDone, lLength;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = SampleCount - lDone < CME_GAIN_CHUNK ? SampleCount - lDone : CME_GAIN_CHUNK;
+		g_sCMEKernels.PanLawGains(psPan->ControlValue + lDone, psLaw->Segments, afLGains, afRGains, Gain, lLength);
+		if (Adding)
+			g_sCMEKernels.DualMultiplyAdd(psPan->InputBuffer + lDone, psPan->InputBuffer + lDone, afLGains, afRGains,
+						      psPan->LOutputBuffer + lDone, psPan->ROutputBuffer + lDone, lLength);
+		else
+			g_sCMEKernels.DualMultiply(psPan->InputBuffer + lDone, psPan->InputBuffer + lDone, afLGains, afRGains,
+						   psPan->LOutputBuffer + lDone, psPan->ROutputBuffer + lDone, lLength);
+	}
 }
 
 
-void
-deleteDescriptor(LADSPA_Descriptor * psDescriptor) {
-  unsigned long lIndex;
-	if (psDescriptor) {
-		free((char *)psDescriptor->Label);
-		free((char *)psDescriptor->Name);
-		free((char *)psDescriptor->Maker);
-		free((char *)psDescriptor->Copyright);
-		free((LADSPA_PortDescriptor *)psDescriptor->PortDescriptors);
-		for (lIndex = 0; lIndex < psDescriptor->PortCount; lIndex++)
-			free((char *)(psDescriptor->PortNames[lIndex]));
-		free((char **)psDescriptor->PortNames);
-		free((LADSPA_PortRangeHint *)psDescriptor->PortRangeHints);
-		free(psDescriptor);
+void 
+runModulatedPan(LADSPA_Handle Instance,
+		unsigned long SampleCount) {
+
+	Pan * psPan;
+
+	psPan = (Pan *)Instance;
+
+	if (g_sCMEKernels.IsSilent(psPan->InputBuffer, SampleCount)) {
+		if (psPan->LOutputBuffer != psPan->InputBuffer)
+			g_sCMEKernels.Zero(psPan->LOutputBuffer, SampleCount);
+		if (psPan->ROutputBuffer != psPan->InputBuffer)
+			g_sCMEKernels.Zero(psPan->ROutputBuffer, SampleCount);
+		setPanSilent(psPan, 1);
+		return;
 	}
+	setPanSilent(psPan, 0);
+	modulatePan(psPan, 1.0f, SampleCount, 0);
 }
 
 
-void
-_fini() {
-	deleteDescriptor(g_psPanDescriptor);
+void 
+runAddingModulatedPan(LADSPA_Handle Instance,
+		      unsigned long SampleCount) {
+
+	Pan * psPan;
+
+	psPan = (Pan *)Instance;
+
+	if (g_sCMEKernels.IsSilent(psPan->InputBuffer, SampleCount)) {
+		setPanSilent(psPan, 1);
+		return;
+	}
+	setPanSilent(psPan, 0);
+	modulatePan(psPan, psPan->RunAddingGain, SampleCount, 1);
 }
 
 
-/* Return a descriptor of the requested plugin type. There are two
-   plugin types available in this library (pan and balance). */
+
+
+
+
+/* Throw away a simple delay line. */
+void 
+cleanupPan(LADSPA_Handle Instance) {
+	cmePoolRelease(&g_sPanPool, Instance);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiPanPortDescriptors[CMEPAN_PORT_COUNT] = {
+	[PAN_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[PAN_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[PAN_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[PAN_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[PAN_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[PAN_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[PAN_LAW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcPanPortNames[CMEPAN_PORT_COUNT] = {
+	[PAN_CONTROL] = "Pan",
+	[PAN_INPUT] = "Input",
+	[PAN_OUTPUT_L] = "Output (L)",
+	[PAN_OUTPUT_R] = "Output (R)",
+	[PAN_SILENT] = "Silent",
+	[PAN_SMOOTHING] = "Smoothing (ms)",
+	[PAN_LAW] = "Law"
+};
+
+static const LADSPA_PortRangeHint g_asPanPortRangeHints[CMEPAN_PORT_COUNT] = {
+	[PAN_CONTROL] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE |
+		LADSPA_HINT_DEFAULT_0,
+		-1, 1
+	},
+	[PAN_SILENT] = { LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 },
+	[PAN_SMOOTHING] = CME_SMOOTH_HINT,
+	[PAN_LAW] = CME_PAN_LAW_HINT
+};
+
+
+const LADSPA_Descriptor g_sPanDescriptor = {
+	.UniqueID = CMEPAN_LADSPA_ID,
+	.Label = "cme_pan",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Pan (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEPAN_PORT_COUNT,
+	.PortDescriptors = g_aiPanPortDescriptors,
+	.PortNames = g_apcPanPortNames,
+	.PortRangeHints = g_asPanPortRangeHints,
+	.instantiate = instantiatePan,
+	.connect_port = connectPortToPan,
+	.run = runPan,
+	.run_adding = runAddingPan,
+	.set_run_adding_gain = setPanRunAddingGain,
+	.cleanup = cleanupPan
+};
+
+
+static const LADSPA_PortDescriptor g_aiModulatedPanPortDescriptors[CMEPAN_MOD_PORT_COUNT] = {
+	[PAN_CONTROL] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[PAN_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[PAN_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[PAN_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[PAN_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[PAN_MOD_LAW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcModulatedPanPortNames[CMEPAN_MOD_PORT_COUNT] = {
+	[PAN_CONTROL] = "Pan",
+	[PAN_INPUT] = "Input",
+	[PAN_OUTPUT_L] = "Output (L)",
+	[PAN_OUTPUT_R] = "Output (R)",
+	[PAN_SILENT] = "Silent",
+	[PAN_MOD_LAW] = "Law"
+};
+
+static const LADSPA_PortRangeHint g_asModulatedPanPortRangeHints[CMEPAN_MOD_PORT_COUNT] = {
+	[PAN_CONTROL] = {
+		LADSPA_HINT_BOUNDED_BELOW |
+		LADSPA_HINT_BOUNDED_ABOVE,
+		-1, 1
+	},
+	[PAN_SILENT] = { LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 },
+	[PAN_MOD_LAW] = CME_PAN_LAW_HINT
+};
+
+
+const LADSPA_Descriptor g_sModulatedPanDescriptor = {
+	.UniqueID = CMEPAN_MOD_LADSPA_ID,
+	.Label = "cme_pan_mod",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Pan, audio-rate (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEPAN_MOD_PORT_COUNT,
+	.PortDescriptors = g_aiModulatedPanPortDescriptors,
+	.PortNames = g_apcModulatedPanPortNames,
+	.PortRangeHints = g_asModulatedPanPortRangeHints,
+	.instantiate = instantiatePan,
+	.connect_port = connectPortToModulatedPan,
+	.run = runModulatedPan,
+	.run_adding = runAddingModulatedPan,
+	.set_run_adding_gain = setPanRunAddingGain,
+	.cleanup = cleanupPan
+};
+
+
+
+#ifndef CME_BUNDLE
+
+void 
+_init() {
+	cmeKernelsInit();
+	cmePanLawsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type: control-rate or audio-rate pan (balance is in cmebal.so). */
 const LADSPA_Descriptor * 
 ladspa_descriptor(unsigned long Index) {
 	/* Return the requested descriptor or null if the index is out of range. */
 	switch (Index) {
 	case 0:
-		return g_psPanDescriptor;
+		return &g_sPanDescriptor;
+	case 1:
+		return &g_sModulatedPanDescriptor;
 	default:
 		return NULL;
 	}
 }
 
-
+#endif /* CME_BUNDLE */
@@ -0,0 +1,63 @@
+/*
+Pan law tables.  See cmepanlaw.h.
+CME 2026-10
+*/
+
+
+#include <math.h>
+
+#include "cmepanlaw.h"
+
+
+
+CMEPanLawTable g_asCMEPanLaws[CME_PAN_LAWS];
+
+static int g_iCMEPanLawsBuilt = 0;
+
+
+/* One side's gain under Law, at pan position x (-1 .. 1). */
+static double
+panLaw(int Law,
+       double x) {
+
+	double p = (1 + x) / 2;
+
+	switch (Law) {
+	case CME_PAN_LAW_SINE:
+		return sin(p * M_PI / 2);
+	case CME_PAN_LAW_3DB:
+		return sqrt(p);
+	case CME_PAN_LAW_4_5DB:
+		return pow(p, 0.75);
+	case CME_PAN_LAW_6DB:
+		return p;
+	default:
+		return 1 + x > 0 ? pow(10.0, 3 * log2(1 + x) / 20) : 0;
+	}
+}
+
+
+void
+cmePanLawsInit(void) {
+
+	float * pfSegments;
+	float fValue, fNext;
+	int iLaw, iIndex;
+
+	if (g_iCMEPanLawsBuilt)
+		return;
+	for (iLaw = 0; iLaw < CME_PAN_LAWS; iLaw++) {
+		pfSegments = g_asCMEPanLaws[iLaw].Segments;
+		fNext = (float)panLaw(iLaw, -1);
+		for (iIndex = 0; iIndex < CME_PAN_LAW_SEGMENTS; iIndex++) {
+			fValue = fNext;
+			fNext = (float)panLaw(iLaw, -1 + 2.0 * (iIndex + 1) / CME_PAN_LAW_SEGMENTS);
+			pfSegments[2 * iIndex] = fValue;
+			pfSegments[2 * iIndex + 1] = fNext - fValue;	// (exact, so the last segment ends exactly on g(1))
+		}
+	}
+	g_iCMEPanLawsBuilt = 1;
+}
+
+
+/* EOF */
@@ -0,0 +1,76 @@
+/*
+Pan laws, for the pan and balance plugins.
+
+Each law is the gain for one side as a function of the pan position x (-1 .. 1, the right side being g(x) and the left g(-x)), tabulated at CME_PAN_LAW_SEGMENTS + 1 equally spaced positions and interpolated linearly between them by the PanLawGains kernel (see cmekernels.h).  Each segment is stored as a {value, delta} pair, so one 8-byte load (or gathered element) per side per sample fetches all the kernel needs.  That makes any law cost the same (a lookup and a multiply-add per side), which is what lets cme_pan_mod and cme_balance_mod follow an audio-rate pan signal cheaply; the old CME law needed a log2() and an exp2() per side per sample.  The tables are worked out in double, once, when the library is loaded (cmePanLawsInit(), from _init()), so run() never builds them.
+
+With p = (1 + x) / 2, the laws are:
+
+	CME_PAN_LAW_CME		10^(3 * log2(1 + x) / 20): 0 dB at the centre, +3 dB at the edges (the original law; see cmePanGain())
+	CME_PAN_LAW_SINE	sin(p * pi / 2): constant power, -3 dB at the centre
+	CME_PAN_LAW_3DB		p^0.5: -3 dB at the centre
+	CME_PAN_LAW_4_5DB	p^0.75: -4.5 dB at the centre
+	CME_PAN_LAW_6DB		p: -6 dB at the centre (constant amplitude)
+
+The centre and the edges are table positions, so they are exact; in between, the interpolation is within 0.01 dB of the law wherever the gain is above -20 dB.  The laws that go like a square root near silence (CME_PAN_LAW_CME and CME_PAN_LAW_3DB) are too steep there for a straight line in the last segment before each edge (|x| > 0.998), where the quiet side can be out by up to 0.011 in gain (-39 dB, against the other side at 0 dB or more).
+
+cmePanLawGains() is the same kernel on one value, for the control-rate plugins, so a constant pan signal in the audio-rate versions gives exactly the control-rate output.
+
+CME 2026-10
+*/
+
+#ifndef CMEPANLAW_H
+#define CMEPANLAW_H
+
+#include "ladspa.h"
+#include "cmekernels.h"
+
+#pragma GCC visibility push(hidden)
+
+
+#define CME_PAN_LAW_CME		0
+#define CME_PAN_LAW_SINE	1
+#define CME_PAN_LAW_3DB		2
+#define CME_PAN_LAW_4_5DB	3
+#define CME_PAN_LAW_6DB		4
+#define CME_PAN_LAWS		5
+
+/* Port range hint for a "Law" control: an integer, CME_PAN_LAW_CME by default. */
+#define CME_PAN_LAW_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0, 0, CME_PAN_LAWS - 1 }
+
+
+typedef struct {
+	float Segments[2 * CME_PAN_LAW_SEGMENTS] __attribute__((aligned(64)));	// g(-1 + 2k / CME_PAN_LAW_SEGMENTS), then the change to the next point
+} CMEPanLawTable;
+
+extern CMEPanLawTable g_asCMEPanLaws[CME_PAN_LAWS];
+
+
+/* Build the tables (once; later calls do nothing). */
+void cmePanLawsInit(void);
+
+
+/* The law selected by a "Law" control: rounded, and clamped to the laws there are. */
+static inline int
+cmePanLawSelect(LADSPA_Data Control) {
+	if (!(Control >= 0.5f))	// (also catches NaN)
+		return 0;
+	if (Control >= CME_PAN_LAWS - 1)
+		return CME_PAN_LAWS - 1;
+	return (int)(Control + 0.5f);
+}
+
+
+/* L and R gains for one pan position, times Gain. */
+static inline void
+cmePanLawGains(int Law,
+	       LADSPA_Data Pan,
+	       LADSPA_Data Gain,
+	       LADSPA_Data * LGain,
+	       LADSPA_Data * RGain) {
+	g_sCMEKernels.PanLawGains(&Pan, g_asCMEPanLaws[Law].Segments, LGain, RGain, Gain, 1);
+}
+
+
+#pragma GCC visibility pop
+
+#endif /* CMEPANLAW_H */
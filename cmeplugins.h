@@ -0,0 +1,64 @@
+/*
+The descriptors of every CME plugin, for the combined library libcme.so (see cmebundle.c).
+
+Each plugin source defines its descriptors, port tables and all, as const static data, so loading any of the libraries does no heap work.  (The gain, pan, balance and meter instances come from per-library pools of aligned slots; see cmepool.h.)  Built on its own, a source also defines ladspa_descriptor() (and, if it uses the kernels, an _init() that calls cmeKernelsInit()) for its own .so; built with -DCME_BUNDLE it leaves those out, and cmebundle.c provides one set for everything.
+
+In the instrumented build (-DCME_INSTRUMENT; see cmeinstrument.h), the ladspa_descriptor() a source defines is renamed cmeUninstrumentedDescriptor(), and cmeinstrumentwrap.c wraps what it returns.
+
+None of the plugins sets LADSPA_PROPERTY_INPLACE_BROKEN: the host may connect any audio output to the same buffer as any input.  The gain, pan, balance and channel strip plugins only use the kernels, which are in-place safe (see cmekernels.h); the reverbs copy all their inputs before writing any output; and the meters have no audio outputs.  "cmebench -i" checks this, for every plugin, by comparing aliased and separate buffers bit for bit; run it after changing any run().
+
+Offline hosts set the environment variable CME_OFFLINE_ENV (to anything) before instantiating any plugin, and then every plugin's output depends only on its input and controls, however fast run() is called.  The only plugin this changes is the convolution reverb, whose tail is rendered on a worker thread: in real time a block the worker hasn't finished is left out, so as not to hold up run(), while offline run() waits for it (see cmeconv.c).  The mesh's output never depends on its threads.  cmebatch sets it, and "make check" checks that it works.
+
+CME 2026-10
+*/
+
+#ifndef CMEPLUGINS_H
+#define CMEPLUGINS_H
+
+#include "ladspa.h"
+
+
+#ifdef CME_INSTRUMENT
+#include "cmeinstrument.h"
+#define ladspa_descriptor	cmeUninstrumentedDescriptor
+#endif
+
+
+#define CME_WIDE_AMPLIFIER_VARIANTS	6
+#define CME_MULTIMETER_VARIANTS	5
+#define CME_MESH_SHAPES	3
+
+#define CME_OFFLINE_ENV	"CME_OFFLINE"
+
+
+/* For spelling out the port tables of the multichannel plugins: CME_CHANNELS_n(M) expands M(1) .. M(n). */
+#define CME_CHANNELS_2(M)	M(1) M(2)
+#define CME_CHANNELS_4(M)	CME_CHANNELS_2(M) M(3) M(4)
+#define CME_CHANNELS_6(M)	CME_CHANNELS_4(M) M(5) M(6)
+#define CME_CHANNELS_8(M)	CME_CHANNELS_6(M) M(7) M(8)
+#define CME_CHANNELS_16(M)	CME_CHANNELS_8(M) M(9) M(10) M(11) M(12) M(13) M(14) M(15) M(16)
+#define CME_CHANNELS_32(M)	CME_CHANNELS_16(M) \
+	M(17) M(18) M(19) M(20) M(21) M(22) M(23) M(24) M(25) M(26) M(27) M(28) M(29) M(30) M(31) M(32)
+#define CME_CHANNELS_64(M)	CME_CHANNELS_32(M) \
+	M(33) M(34) M(35) M(36) M(37) M(38) M(39) M(40) M(41) M(42) M(43) M(44) M(45) M(46) M(47) M(48) \
+	M(49) M(50) M(51) M(52) M(53) M(54) M(55) M(56) M(57) M(58) M(59) M(60) M(61) M(62) M(63) M(64)
+
+
+extern const LADSPA_Descriptor g_sMonoAmplifierDescriptor;	// cmeamp.c
+extern const LADSPA_Descriptor g_sStereoAmplifierDescriptor;
+extern const LADSPA_Descriptor g_asWideAmplifierDescriptors[CME_WIDE_AMPLIFIER_VARIANTS];
+extern const LADSPA_Descriptor g_sModulatedMonoAmplifierDescriptor;
+extern const LADSPA_Descriptor g_sModulatedStereoAmplifierDescriptor;
+extern const LADSPA_Descriptor g_sPanDescriptor;		// cmepan.c
+extern const LADSPA_Descriptor g_sModulatedPanDescriptor;
+extern const LADSPA_Descriptor g_sBalanceDescriptor;		// cmebal.c
+extern const LADSPA_Descriptor g_sModulatedBalanceDescriptor;
+extern const LADSPA_Descriptor g_sMeterDescriptor;		// cmeter.c
+extern const LADSPA_Descriptor g_asMultiMeterDescriptors[CME_MULTIMETER_VARIANTS];
+extern const LADSPA_Descriptor g_sStripDescriptor;		// cmestrip.c
+extern const LADSPA_Descriptor g_sFDNDescriptor;		// cmefdn.c
+extern const LADSPA_Descriptor g_sConvDescriptor;		// cmeconv.c
+extern const LADSPA_Descriptor g_asMeshDescriptors[CME_MESH_SHAPES];	// cmemesh.c
+
+
+#endif /* CMEPLUGINS_H */
@@ -0,0 +1,123 @@
+/*
+Instance pools.  See cmepool.h.
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "cmepool.h"
+
+
+/* At most this many slots per chunk (the smallest slot in the smallest chunk, less the header): */
+#define POOL_MAX_SLOTS	((CME_POOL_MIN_CHUNK - CME_INSTANCE_ALIGNMENT) / CME_INSTANCE_ALIGNMENT)
+#define POOL_MAP_WORDS	((POOL_MAX_SLOTS + 63) / 64)
+
+
+/* The first CME_INSTANCE_ALIGNMENT bytes of each chunk; the slots follow. */
+struct CMEPoolChunk {
+	CMEPoolChunk * Next;
+	unsigned long Used;
+	uint64_t InUse[POOL_MAP_WORDS];	// Bit per slot
+};
+
+_Static_assert(sizeof(CMEPoolChunk) <= CME_INSTANCE_ALIGNMENT, "chunk header must fit before the first slot");
+
+
+/* Slot and chunk sizes for a pool, and how many slots a chunk holds. */
+static void
+poolGeometry(const CMEInstancePool * psPool,
+	     size_t * SlotSize,
+	     size_t * ChunkSize,
+	     unsigned long * Slots) {
+
+	*SlotSize = (psPool->InstanceSize + CME_INSTANCE_ALIGNMENT - 1) & ~(size_t)(CME_INSTANCE_ALIGNMENT - 1);
+	for (*ChunkSize = CME_POOL_MIN_CHUNK; *ChunkSize < CME_INSTANCE_ALIGNMENT + CME_POOL_MIN_SLOTS * *SlotSize; *ChunkSize *= 2)
+		;
+	*Slots = (*ChunkSize - CME_INSTANCE_ALIGNMENT) / *SlotSize;
+}
+
+
+static void
+lockPool(CMEInstancePool * psPool) {
+	while (__atomic_exchange_n(&psPool->Lock, 1, __ATOMIC_ACQUIRE))
+		;
+}
+
+static void
+unlockPool(CMEInstancePool * psPool) {
+	__atomic_store_n(&psPool->Lock, 0, __ATOMIC_RELEASE);
+}
+
+
+
+void *
+cmePoolAllocate(CMEInstancePool * psPool) {
+
+	CMEPoolChunk * psChunk;
+	CMEPoolChunk ** ppsLink;
+	size_t lSlotSize, lChunkSize;
+	unsigned long lSlots, lSlot = 0;
+	char * pcSlot;
+
+	poolGeometry(psPool, &lSlotSize, &lChunkSize, &lSlots);
+
+	lockPool(psPool);
+	for (ppsLink = &psPool->Chunks; (psChunk = *ppsLink) != NULL; ppsLink = &psChunk->Next)
+		if (psChunk->Used < lSlots)
+			break;
+	if (!psChunk) {
+		// (New chunks go on the end, so the first ones fill up first.)
+		psChunk = (CMEPoolChunk *)aligned_alloc(lChunkSize, lChunkSize);
+		if (!psChunk) {
+			unlockPool(psPool);
+			return NULL;
+		}
+		memset(psChunk, 0, sizeof(CMEPoolChunk));
+		*ppsLink = psChunk;
+	}
+	while (psChunk->InUse[lSlot / 64] & ((uint64_t)1 << (lSlot % 64)))
+		lSlot++;
+	psChunk->InUse[lSlot / 64] |= (uint64_t)1 << (lSlot % 64);
+	psChunk->Used++;
+	unlockPool(psPool);
+
+	pcSlot = (char *)psChunk + CME_INSTANCE_ALIGNMENT + lSlot * lSlotSize;
+	memset(pcSlot, 0, lSlotSize);
+	return pcSlot;
+}
+
+
+void
+cmePoolRelease(CMEInstancePool * psPool,
+	       void * pvInstance) {
+
+	CMEPoolChunk * psChunk;
+	CMEPoolChunk ** ppsLink;
+	size_t lSlotSize, lChunkSize;
+	unsigned long lSlots, lSlot;
+
+	if (!pvInstance)
+		return;
+	poolGeometry(psPool, &lSlotSize, &lChunkSize, &lSlots);
+	psChunk = (CMEPoolChunk *)((uintptr_t)pvInstance & ~(uintptr_t)(lChunkSize - 1));
+	lSlot = ((char *)pvInstance - (char *)psChunk - CME_INSTANCE_ALIGNMENT) / lSlotSize;
+
+	lockPool(psPool);
+	psChunk->InUse[lSlot / 64] &= ~((uint64_t)1 << (lSlot % 64));
+	if (--psChunk->Used == 0) {
+		for (ppsLink = &psPool->Chunks; *ppsLink != psChunk; ppsLink = &(*ppsLink)->Next)
+			;
+		*ppsLink = psChunk->Next;
+	}
+	else
+		psChunk = NULL;
+	unlockPool(psPool);
+
+	free(psChunk);
+}
+
+
+/* EOF */
@@ -0,0 +1,53 @@
+/*
+Instance pools, for the plugins whose instances are small structs (gain, pan, balance and the meters).
+
+A session with hundreds of these, run() from several host threads, used to malloc() each one separately: structs of 100-200 bytes, packed next to one another and to whatever else the host allocated, so two instances run by different threads could share a cache line, and every run() writing its state (the smoother, the last control value) would steal that line from the other core.  And the instances of one bus ended up wherever the heap had room.
+
+So each of those sources has a static CMEInstancePool per struct, and instantiate() takes a slot from it.  A slot is the struct rounded up to CME_INSTANCE_ALIGNMENT bytes, and starts on such a boundary, so no two instances ever share a line, nor a pair of lines (Intel's adjacent-line prefetcher fetches 128-byte pairs, so 64 isn't quite enough).  Slots come from chunks of CME_POOL_MIN_CHUNK bytes or more (a power of two, aligned to its own size, so a slot's chunk is found by masking its address), filled from the lowest free slot of the first chunk with room, so instances created together sit together.  Slots are zeroed, as by calloc().  A chunk is freed when its last slot is released, so unloading a library after cleaning up every instance leaves nothing behind.
+
+instantiate() and cleanup() aren't real-time (LADSPA says so), but they can be called from different threads, so the pool is guarded by a spinlock; nothing in run() touches it.
+
+Only the instance struct is pooled: the meters' rings, which are large, are still allocated separately (and being large, are page-aligned anyway).
+
+CME 2026-10
+*/
+
+#ifndef CMEPOOL_H
+#define CMEPOOL_H
+
+#include <stddef.h>
+
+#pragma GCC visibility push(hidden)
+
+
+/* Slot alignment and size granularity (bytes): */
+#define CME_INSTANCE_ALIGNMENT	128
+
+/* Smallest chunk (bytes); a chunk holds at least CME_POOL_MIN_SLOTS slots. */
+#define CME_POOL_MIN_CHUNK	16384
+#define CME_POOL_MIN_SLOTS	8
+
+
+typedef struct CMEPoolChunk CMEPoolChunk;
+
+typedef struct {
+	size_t InstanceSize;		// sizeof the struct (slots are this rounded up to CME_INSTANCE_ALIGNMENT)
+	int Lock;
+	CMEPoolChunk * Chunks;
+} CMEInstancePool;
+
+/* A pool for instances of Type, for a static initialiser. */
+#define CME_INSTANCE_POOL(Type)	{ sizeof(Type), 0, NULL }
+
+
+/* A zeroed, aligned slot, or NULL if out of memory. */
+void * cmePoolAllocate(CMEInstancePool * Pool);
+
+/* Give a slot back (NULL is ignored). */
+void cmePoolRelease(CMEInstancePool * Pool,
+		    void * Instance);
+
+
+#pragma GCC visibility pop
+
+#endif /* CMEPOOL_H */
@@ -0,0 +1,288 @@
+/*
+Smoothing of gain changes, for the gain, pan and balance plugins.
+
+A gain control that moves between blocks would otherwise take effect as a step at the start of the next block, which clicks (and the bigger the step, the louder the click: mute is the worst).  So each instance keeps the gain factor it is applying now, and when the control moves it ramps linearly to the new one over the time set by its "Smoothing" control (ms), however many blocks that takes.  Up to two factors (L and R) ramp together, over the same number of samples.
+
+cmeSmoothedScale() and cmeSmoothedDualScale() do the kernel part for the usual case.  Spelt out, a run() goes:
+
+	cmeSmootherSetTarget(&sSmoother, LGainFactor, RGainFactor, *Smoothing);
+	lRamp = cmeSmootherRampLength(&sSmoother, SampleCount);
+	...ScaleRamp kernel over samples 0 .. lRamp - 1, from cmeSmootherStart(&sSmoother, channel) by Step[channel]...
+	...Scale kernel over the rest, by Target[channel]...
+	cmeSmootherAdvance(&sSmoother, SampleCount);
+
+(A block that is skipped, e.g. for silent input, still advances.)  Once a ramp has finished, Current is exactly the target.  The first target after cmeSmootherInit() takes effect at once (there's nothing to ramp from), as does any change with Smoothing at 0.
+
+Most instances sit at one setting for hours, and most often at unity (0 dB, centre balance) or muted, so the steady state isn't always the Scale kernel: whenever the target moves, cmeSmootherSetTarget() picks the cheapest routine that gives the same output for it, and keeps it in Settled, which the smoothed kernels call for the samples after the ramp.  A target of 1 (both factors) is nothing at all in place, or a copy; 0 is a zero-fill; one factor for both channels is Scale (or DualScale with it twice); otherwise DualScale.  x * 1 is x, bit for bit, so unity gives exactly the output it did when it was multiplied.  Only run() uses Settled: run_adding() has to read the output anyway, and folds in the host's gain.
+
+CME 2026-10
+*/
+
+#ifndef CMESMOOTH_H
+#define CMESMOOTH_H
+
+#include "ladspa.h"
+#include "cmekernels.h"
+
+#pragma GCC visibility push(hidden)
+
+
+/* Range of the smoothing time (ms), and its default (DEFAULT_LOW, i.e. 10 ms): */
+#define CME_SMOOTH_MAX_MS	40
+#define CME_SMOOTH_HINT		{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_LOW, 0, CME_SMOOTH_MAX_MS }
+
+
+typedef struct CMESmoother CMESmoother;
+
+/* What a settled smoother does to a block (not adding): L by factor 0 and R by factor 1, or just L if ROutput is NULL.  Safe in place, like the kernels. */
+typedef void (*CMESettledRun)(const CMESmoother * Smoother,
+			      const LADSPA_Data * LInput,
+			      const LADSPA_Data * RInput,
+			      LADSPA_Data * LOutput,
+			      LADSPA_Data * ROutput,
+			      unsigned long SampleCount);
+
+struct CMESmoother {
+	LADSPA_Data SampleRate;
+	int Started;			// 0 until the first target
+	unsigned long Remaining;	// Samples left in the ramp (0 when settled)
+	LADSPA_Data Current[2];		// Factors reached so far
+	LADSPA_Data Target[2];
+	LADSPA_Data Step[2];		// Change per sample
+	CMESettledRun Settled;		// For Target (chosen by cmeSmootherSetTarget())
+};
+
+
+/* Target 1: the input as it is, so nothing to do for a channel processed in place.  Channels that aren't are copied by the kernels' own loop (times 1): glibc's memcpy() is no faster, and on buffers a whole number of pages plus a little apart, as hosts often allocate them, it can be half the speed.  (DualScale also covers outputs on the other channel's input, e.g. balance swapped in place.) */
+static inline void
+cmeSettledCopy(const CMESmoother * psSmoother,
+	       const LADSPA_Data * LInput,
+	       const LADSPA_Data * RInput,
+	       LADSPA_Data * LOutput,
+	       LADSPA_Data * ROutput,
+	       unsigned long SampleCount) {
+
+	if (!ROutput || ROutput == RInput) {
+		if (LOutput != LInput)
+			g_sCMEKernels.Scale(LInput, LOutput, 1.0f, SampleCount);
+	}
+	else if (LOutput == LInput)
+		g_sCMEKernels.Scale(RInput, ROutput, 1.0f, SampleCount);
+	else
+		g_sCMEKernels.DualScale(LInput, RInput, LOutput, ROutput, 1.0f, 1.0f, SampleCount);
+}
+
+
+/* Target 0 (faded out): silence. */
+static inline void
+cmeSettledZero(const CMESmoother * psSmoother,
+	       const LADSPA_Data * LInput,
+	       const LADSPA_Data * RInput,
+	       LADSPA_Data * LOutput,
+	       LADSPA_Data * ROutput,
+	       unsigned long SampleCount) {
+
+	g_sCMEKernels.Zero(LOutput, SampleCount);
+	if (ROutput)
+		g_sCMEKernels.Zero(ROutput, SampleCount);
+}
+
+
+/* One factor for both channels. */
+static inline void
+cmeSettledScale(const CMESmoother * psSmoother,
+		const LADSPA_Data * LInput,
+		const LADSPA_Data * RInput,
+		LADSPA_Data * LOutput,
+		LADSPA_Data * ROutput,
+		unsigned long SampleCount) {
+
+	if (ROutput)
+		g_sCMEKernels.DualScale(LInput, RInput, LOutput, ROutput, psSmoother->Target[0], psSmoother->Target[0], SampleCount);
+	else
+		g_sCMEKernels.Scale(LInput, LOutput, psSmoother->Target[0], SampleCount);
+}
+
+
+/* A factor each. */
+static inline void
+cmeSettledDualScale(const CMESmoother * psSmoother,
+		    const LADSPA_Data * LInput,
+		    const LADSPA_Data * RInput,
+		    LADSPA_Data * LOutput,
+		    LADSPA_Data * ROutput,
+		    unsigned long SampleCount) {
+
+	if (ROutput)
+		g_sCMEKernels.DualScale(LInput, RInput, LOutput, ROutput, psSmoother->Target[0], psSmoother->Target[1], SampleCount);
+	else
+		g_sCMEKernels.Scale(LInput, LOutput, psSmoother->Target[0], SampleCount);
+}
+
+
+/* The routine for a target of L and R. */
+static inline CMESettledRun
+cmeSettledSelect(LADSPA_Data L,
+		 LADSPA_Data R) {
+	if (L != R)
+		return cmeSettledDualScale;
+	if (L == 1)
+		return cmeSettledCopy;
+	if (L == 0)
+		return cmeSettledZero;
+	return cmeSettledScale;
+}
+
+
+static inline void
+cmeSmootherInit(CMESmoother * psSmoother,
+		unsigned long SampleRate) {
+	psSmoother->SampleRate = SampleRate;
+	psSmoother->Started = 0;
+	psSmoother->Remaining = 0;
+	psSmoother->Settled = cmeSettledScale;
+}
+
+
+/* Start ramping from where we are now to L and R over Milliseconds (clamped to 0 .. CME_SMOOTH_MAX_MS), if they aren't the target already. */
+static inline void
+cmeSmootherSetTarget(CMESmoother * psSmoother,
+		     LADSPA_Data L,
+		     LADSPA_Data R,
+		     LADSPA_Data Milliseconds) {
+
+	LADSPA_Data fLength;
+
+	if (psSmoother->Started && L == psSmoother->Target[0] && R == psSmoother->Target[1])
+		return;
+	psSmoother->Target[0] = L;
+	psSmoother->Target[1] = R;
+	psSmoother->Settled = cmeSettledSelect(L, R);
+
+	if (!(Milliseconds > 0))	// (also catches NaN)
+		Milliseconds = 0;
+	if (Milliseconds > CME_SMOOTH_MAX_MS)
+		Milliseconds = CME_SMOOTH_MAX_MS;
+	fLength = (LADSPA_Data)(unsigned long)(Milliseconds * 0.001f * psSmoother->SampleRate + 0.5f);
+	if (!psSmoother->Started || fLength < 1) {
+		psSmoother->Started = 1;
+		psSmoother->Remaining = 0;
+		psSmoother->Current[0] = L;
+		psSmoother->Current[1] = R;
+		return;
+	}
+	psSmoother->Remaining = (unsigned long)fLength;
+	psSmoother->Step[0] = (L - psSmoother->Current[0]) / fLength;
+	psSmoother->Step[1] = (R - psSmoother->Current[1]) / fLength;
+}
+
+
+/* Samples (at most Count) still to ramp. */
+static inline unsigned long
+cmeSmootherRampLength(const CMESmoother * psSmoother,
+		      unsigned long Count) {
+	return psSmoother->Remaining < Count ? psSmoother->Remaining : Count;
+}
+
+
+/* The factor for the first sample still to ramp, for the ScaleRamp kernels. */
+static inline LADSPA_Data
+cmeSmootherStart(const CMESmoother * psSmoother,
+		 int Channel) {
+	return psSmoother->Current[Channel] + psSmoother->Step[Channel];
+}
+
+
+/* Count samples have gone by: move on along the ramp, landing exactly on the target at the end. */
+static inline void
+cmeSmootherAdvance(CMESmoother * psSmoother,
+		   unsigned long Count) {
+
+	if (!psSmoother->Remaining)	// (settled, the usual case)
+		return;
+	if (Count >= psSmoother->Remaining) {
+		psSmoother->Remaining = 0;
+		psSmoother->Current[0] = psSmoother->Target[0];
+		psSmoother->Current[1] = psSmoother->Target[1];
+		return;
+	}
+	psSmoother->Remaining -= Count;
+	psSmoother->Current[0] += (LADSPA_Data)Count * psSmoother->Step[0];
+	psSmoother->Current[1] += (LADSPA_Data)Count * psSmoother->Step[1];
+}
+
+
+/* 1 if the factors have settled at 0 (i.e. faded right out), so the output is silence. */
+static inline int
+cmeSmootherIsOff(const CMESmoother * psSmoother) {
+	return psSmoother->Remaining == 0 && psSmoother->Current[0] == 0 && psSmoother->Current[1] == 0;
+}
+
+
+
+/* Scale (or scale and add, if Adding) by the smoothed factor times Gain: the ramp, if any, then the target (by Settled, if Gain is 1 and not Adding).  Safe in place, like the kernels.  This doesn't advance the smoother. */
+static inline void
+cmeSmoothedScale(const CMESmoother * psSmoother,
+		 const LADSPA_Data * Input,
+		 LADSPA_Data * Output,
+		 LADSPA_Data Gain,
+		 unsigned long SampleCount,
+		 int Adding) {
+
+	unsigned long lRamp = cmeSmootherRampLength(psSmoother, SampleCount);
+
+	if (lRamp) {
+		if (Adding)
+			g_sCMEKernels.ScaleRampAdd(Input, Output, cmeSmootherStart(psSmoother, 0) * Gain, psSmoother->Step[0] * Gain, lRamp);
+		else
+			g_sCMEKernels.ScaleRamp(Input, Output, cmeSmootherStart(psSmoother, 0) * Gain, psSmoother->Step[0] * Gain, lRamp);
+		if (lRamp == SampleCount)
+			return;
+	}
+	if (Adding)
+		g_sCMEKernels.ScaleAdd(Input + lRamp, Output + lRamp, psSmoother->Target[0] * Gain, SampleCount - lRamp);
+	else if (Gain == 1)
+		psSmoother->Settled(psSmoother, Input + lRamp, NULL, Output + lRamp, NULL, SampleCount - lRamp);
+	else
+		g_sCMEKernels.Scale(Input + lRamp, Output + lRamp, psSmoother->Target[0] * Gain, SampleCount - lRamp);
+}
+
+
+/* The same for two channels, L by factor 0 and R by factor 1. */
+static inline void
+cmeSmoothedDualScale(const CMESmoother * psSmoother,
+		     const LADSPA_Data * LInput,
+		     const LADSPA_Data * RInput,
+		     LADSPA_Data * LOutput,
+		     LADSPA_Data * ROutput,
+		     LADSPA_Data Gain,
+		     unsigned long SampleCount,
+		     int Adding) {
+
+	unsigned long lRamp = cmeSmootherRampLength(psSmoother, SampleCount);
+	LADSPA_Data fLGain, fRGain;
+
+	if (lRamp) {
+		fLGain = cmeSmootherStart(psSmoother, 0) * Gain;
+		fRGain = cmeSmootherStart(psSmoother, 1) * Gain;
+		if (Adding)
+			g_sCMEKernels.DualScaleRampAdd(LInput, RInput, LOutput, ROutput, fLGain, psSmoother->Step[0] * Gain, fRGain, psSmoother->Step[1] * Gain, lRamp);
+		else
+			g_sCMEKernels.DualScaleRamp(LInput, RInput, LOutput, ROutput, fLGain, psSmoother->Step[0] * Gain, fRGain, psSmoother->Step[1] * Gain, lRamp);
+		if (lRamp == SampleCount)
+			return;
+	}
+	fLGain = psSmoother->Target[0] * Gain;
+	fRGain = psSmoother->Target[1] * Gain;
+	if (Adding)
+		g_sCMEKernels.DualScaleAdd(LInput + lRamp, RInput + lRamp, LOutput + lRamp, ROutput + lRamp, fLGain, fRGain, SampleCount - lRamp);
+	else if (Gain == 1)
+		psSmoother->Settled(psSmoother, LInput + lRamp, RInput + lRamp, LOutput + lRamp, ROutput + lRamp, SampleCount - lRamp);
+	else
+		g_sCMEKernels.DualScale(LInput + lRamp, RInput + lRamp, LOutput + lRamp, ROutput + lRamp, fLGain, fRGain, SampleCount - lRamp);
+}
+
+
+#pragma GCC visibility pop
+
+#endif /* CMESMOOTH_H */
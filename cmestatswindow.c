@@ -0,0 +1,261 @@
+/*
+Sliding-window level statistics over blocks.  See cmestatswindow.h.
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "cmestatswindow.h"
+
+
+
+int
+cmeStatsWindowInit(CMEStatsWindow * psWindow,
+		   unsigned long Channels,
+		   unsigned long SampleRate) {
+
+	unsigned long lCells;
+
+	memset(psWindow, 0, sizeof(CMEStatsWindow));
+	psWindow->Channels = Channels;
+	psWindow->SampleRate = SampleRate;
+	psWindow->RingBlocks = (unsigned long)(CME_WINDOW_MAX_MS * 0.001 * SampleRate / CME_WINDOW_BLOCK) + 1;
+	lCells = psWindow->RingBlocks * Channels;
+
+	psWindow->Current = (CMEStats *)calloc(Channels, sizeof(CMEStats));
+	psWindow->BlockMax = (LADSPA_Data *)calloc(lCells, sizeof(LADSPA_Data));
+	psWindow->BlockMin = (LADSPA_Data *)calloc(lCells, sizeof(LADSPA_Data));
+	psWindow->BlockSum = (LADSPA_Data *)calloc(lCells, sizeof(LADSPA_Data));
+	psWindow->SuffixMax = (LADSPA_Data *)calloc(lCells, sizeof(LADSPA_Data));
+	psWindow->SuffixMin = (LADSPA_Data *)calloc(lCells, sizeof(LADSPA_Data));
+	psWindow->SuffixSum = (double *)calloc(lCells, sizeof(double));
+	psWindow->PrefixMax = (LADSPA_Data *)calloc(Channels, sizeof(LADSPA_Data));
+	psWindow->PrefixMin = (LADSPA_Data *)calloc(Channels, sizeof(LADSPA_Data));
+	psWindow->PrefixSum = (double *)calloc(Channels, sizeof(double));
+	if (!psWindow->Current
+	    || !psWindow->BlockMax || !psWindow->BlockMin || !psWindow->BlockSum
+	    || !psWindow->SuffixMax || !psWindow->SuffixMin || !psWindow->SuffixSum
+	    || !psWindow->PrefixMax || !psWindow->PrefixMin || !psWindow->PrefixSum) {
+		cmeStatsWindowFree(psWindow);
+		return 0;
+	}
+
+	cmeStatsWindowReset(psWindow);
+	return 1;
+}
+
+
+void
+cmeStatsWindowFree(CMEStatsWindow * psWindow) {
+
+	free(psWindow->Current);
+	free(psWindow->BlockMax);
+	free(psWindow->BlockMin);
+	free(psWindow->BlockSum);
+	free(psWindow->SuffixMax);
+	free(psWindow->SuffixMin);
+	free(psWindow->SuffixSum);
+	free(psWindow->PrefixMax);
+	free(psWindow->PrefixMin);
+	free(psWindow->PrefixSum);
+	memset(psWindow, 0, sizeof(CMEStatsWindow));
+}
+
+
+/* Start a new segment with nothing in it. */
+static void
+resetPrefix(CMEStatsWindow * psWindow) {
+
+	unsigned long lChannel;
+
+	for (lChannel = 0; lChannel < psWindow->Channels; lChannel++) {
+		psWindow->PrefixMax[lChannel] = 0;
+		psWindow->PrefixMin[lChannel] = HUGE_VALF;
+		psWindow->PrefixSum[lChannel] = 0;
+	}
+	psWindow->SegmentStart = psWindow->BlockCount;
+}
+
+
+static void
+resetBlock(CMEStatsWindow * psWindow) {
+
+	unsigned long lChannel;
+
+	for (lChannel = 0; lChannel < psWindow->Channels; lChannel++) {
+		psWindow->Current[lChannel].Max = 0;
+		psWindow->Current[lChannel].Min = HUGE_VALF;
+		psWindow->Current[lChannel].SumOfSquares = 0;
+	}
+	psWindow->BlockFill = 0;
+}
+
+
+void
+cmeStatsWindowReset(CMEStatsWindow * psWindow) {
+
+	psWindow->LastLength = NAN;
+	psWindow->WindowBlocks = 1;
+	psWindow->BlockCount = 0;
+	resetPrefix(psWindow);
+	resetBlock(psWindow);
+}
+
+
+/* Work out the suffix values of blocks First .. End - 1: for each block, the max/min/sum from it to block End - 1. */
+static void
+buildSuffix(CMEStatsWindow * psWindow,
+	    unsigned long First,
+	    unsigned long End) {
+
+	const unsigned long lChannels = psWindow->Channels;
+	const LADSPA_Data * pfMax, * pfMin, * pfSum;
+	LADSPA_Data * pfSuffixMax, * pfSuffixMin;
+	double * pdSuffixSum;
+	const LADSPA_Data * pfLaterMax = NULL, * pfLaterMin = NULL;
+	const double * pdLaterSum = NULL;
+	unsigned long lBlock, lRow, lChannel;
+
+	for (lBlock = End; lBlock-- > First; ) {
+		lRow = (lBlock % psWindow->RingBlocks) * lChannels;
+		pfMax = psWindow->BlockMax + lRow;
+		pfMin = psWindow->BlockMin + lRow;
+		pfSum = psWindow->BlockSum + lRow;
+		pfSuffixMax = psWindow->SuffixMax + lRow;
+		pfSuffixMin = psWindow->SuffixMin + lRow;
+		pdSuffixSum = psWindow->SuffixSum + lRow;
+		if (!pfLaterMax) {
+			for (lChannel = 0; lChannel < lChannels; lChannel++) {
+				pfSuffixMax[lChannel] = pfMax[lChannel];
+				pfSuffixMin[lChannel] = pfMin[lChannel];
+				pdSuffixSum[lChannel] = pfSum[lChannel];
+			}
+		}
+		else {
+			for (lChannel = 0; lChannel < lChannels; lChannel++) {
+				pfSuffixMax[lChannel] = pfMax[lChannel] > pfLaterMax[lChannel] ? pfMax[lChannel] : pfLaterMax[lChannel];
+				pfSuffixMin[lChannel] = pfMin[lChannel] < pfLaterMin[lChannel] ? pfMin[lChannel] : pfLaterMin[lChannel];
+				pdSuffixSum[lChannel] = pfSum[lChannel] + pdLaterSum[lChannel];
+			}
+		}
+		pfLaterMax = pfSuffixMax;
+		pfLaterMin = pfSuffixMin;
+		pdLaterSum = pdSuffixSum;
+	}
+}
+
+
+/* A block is complete (for all channels): store it, add it to the current segment, and close the segment once it is W blocks long. */
+static void
+endBlock(CMEStatsWindow * psWindow) {
+
+	const unsigned long lChannels = psWindow->Channels;
+	const unsigned long lRow = (psWindow->BlockCount % psWindow->RingBlocks) * lChannels;
+	LADSPA_Data * pfMax = psWindow->BlockMax + lRow;
+	LADSPA_Data * pfMin = psWindow->BlockMin + lRow;
+	LADSPA_Data * pfSum = psWindow->BlockSum + lRow;
+	unsigned long lChannel;
+
+	for (lChannel = 0; lChannel < lChannels; lChannel++) {
+		pfMax[lChannel] = psWindow->Current[lChannel].Max;
+		pfMin[lChannel] = psWindow->Current[lChannel].Min;
+		pfSum[lChannel] = psWindow->Current[lChannel].SumOfSquares;
+	}
+	for (lChannel = 0; lChannel < lChannels; lChannel++) {
+		if (pfMax[lChannel] > psWindow->PrefixMax[lChannel])	psWindow->PrefixMax[lChannel] = pfMax[lChannel];
+		if (pfMin[lChannel] < psWindow->PrefixMin[lChannel])	psWindow->PrefixMin[lChannel] = pfMin[lChannel];
+		psWindow->PrefixSum[lChannel] += pfSum[lChannel];
+	}
+	resetBlock(psWindow);
+
+	psWindow->BlockCount++;
+	if (psWindow->BlockCount - psWindow->SegmentStart == psWindow->WindowBlocks) {
+		buildSuffix(psWindow, psWindow->SegmentStart, psWindow->BlockCount);
+		resetPrefix(psWindow);
+	}
+}
+
+
+void
+cmeStatsWindowSetLength(CMEStatsWindow * psWindow,
+			LADSPA_Data Milliseconds) {
+
+	unsigned long lBlocks;
+
+	if (Milliseconds == psWindow->LastLength)
+		return;
+	psWindow->LastLength = Milliseconds;
+
+	if (!(Milliseconds >= CME_WINDOW_MIN_MS))	// (also catches NaN)
+		Milliseconds = CME_WINDOW_MIN_MS;
+	if (Milliseconds > CME_WINDOW_MAX_MS)
+		Milliseconds = CME_WINDOW_MAX_MS;
+	lBlocks = (unsigned long)(Milliseconds * 0.001 * psWindow->SampleRate / CME_WINDOW_BLOCK + 0.5);
+	if (lBlocks < 1)
+		lBlocks = 1;
+	if (lBlocks > psWindow->RingBlocks)
+		lBlocks = psWindow->RingBlocks;
+
+	psWindow->WindowBlocks = lBlocks;
+	buildSuffix(psWindow, psWindow->BlockCount > lBlocks ? psWindow->BlockCount - lBlocks : 0, psWindow->BlockCount);
+	resetPrefix(psWindow);
+}
+
+
+void
+cmeStatsWindowAdvance(CMEStatsWindow * psWindow,
+		      unsigned long Count) {
+
+	psWindow->BlockFill += Count;
+	if (psWindow->BlockFill == CME_WINDOW_BLOCK)
+		endBlock(psWindow);
+}
+
+
+void
+cmeStatsWindowRead(const CMEStatsWindow * psWindow,
+		   LADSPA_Data * const * ppfOutputs) {
+
+	const unsigned long lChannels = psWindow->Channels;
+	unsigned long lStart, lRow, lSamples, lChannel;
+	int iUseSuffix;
+	LADSPA_Data fMax, fMin;
+	double dSum;
+	LADSPA_Data fPeak, fRMS;
+
+	if (psWindow->BlockCount == 0 && psWindow->BlockFill == 0)
+		return;
+
+	// The window is the last W blocks plus the current one so far.  Those before the current segment are covered by the suffix values of the block at the start of the window:
+	lStart = psWindow->BlockCount > psWindow->WindowBlocks ? psWindow->BlockCount - psWindow->WindowBlocks : 0;
+	iUseSuffix = lStart < psWindow->SegmentStart;
+	lRow = (lStart % psWindow->RingBlocks) * lChannels;
+	lSamples = (psWindow->BlockCount - lStart) * CME_WINDOW_BLOCK + psWindow->BlockFill;
+
+	for (lChannel = 0; lChannel < lChannels; lChannel++) {
+		fMax = psWindow->PrefixMax[lChannel];
+		fMin = psWindow->PrefixMin[lChannel];
+		dSum = psWindow->PrefixSum[lChannel] + psWindow->Current[lChannel].SumOfSquares;
+		if (iUseSuffix) {
+			if (psWindow->SuffixMax[lRow + lChannel] > fMax)	fMax = psWindow->SuffixMax[lRow + lChannel];
+			if (psWindow->SuffixMin[lRow + lChannel] < fMin)	fMin = psWindow->SuffixMin[lRow + lChannel];
+			dSum += psWindow->SuffixSum[lRow + lChannel];
+		}
+		if (psWindow->Current[lChannel].Max > fMax)	fMax = psWindow->Current[lChannel].Max;
+		if (psWindow->Current[lChannel].Min < fMin)	fMin = psWindow->Current[lChannel].Min;
+
+		fPeak = cmeLevelToDB(fMax);
+		fRMS = cmeLevelToDB(sqrt(dSum / lSamples));
+		*ppfOutputs[CME_WINDOW_PEAK] = fPeak;
+		*ppfOutputs[CME_WINDOW_RMS] = fRMS;
+		*ppfOutputs[CME_WINDOW_TROUGH] = cmeLevelToDB(fMin);
+		*ppfOutputs[CME_WINDOW_CREST] = fPeak - fRMS;
+		ppfOutputs += CME_WINDOW_OUTPUTS_PER_CHANNEL;
+	}
+}
+
+
+/* EOF */
@@ -0,0 +1,118 @@
+/*
+Sliding-window level statistics over blocks, for the multichannel meters and the channel strip.
+
+Each channel's samples go into the statistics of the current CME_WINDOW_BLOCK-sample block (Current[channel], a CMEStats, filled by the Stats or DualScaleStats kernel), and the window is then kept over the block statistics, with the window length rounded to whole blocks (0.7 ms at 48 kHz).  The window's max, min and sum come from a streaming van Herk/Gil-Werman scheme: running prefix values over the current W-block segment, and suffix values over the previous one, worked out once per segment.  That is O(1) per block whatever the window length, and exact (no running sum to drift).  All of this state is stored structure-of-arrays, as [block][channel] rows, so each update is a short loop across the channels that the compiler vectorises.  Memory is about 28 bytes per channel per block of window.
+
+A run() goes:
+
+	cmeStatsWindowSetLength(&sWindow, *WindowLength);
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = cmeStatsWindowSpace(&sWindow, SampleCount - lDone);
+		...Stats of lLength samples of each channel into sWindow.Current[channel]...
+		cmeStatsWindowAdvance(&sWindow, lLength);
+	}
+	cmeStatsWindowRead(&sWindow, Outputs);
+
+Levels are reported in dB, and those at or below CME_LEVEL_FLOOR_DB read as exactly that, without calling log10().
+
+CME 2026-10
+*/
+
+#ifndef CMESTATSWINDOW_H
+#define CMESTATSWINDOW_H
+
+#include <math.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+
+#pragma GCC visibility push(hidden)
+
+
+/* Samples per block: */
+#define CME_WINDOW_BLOCK	32
+
+/* Range of the window length (ms): */
+#define CME_WINDOW_MIN_MS	30
+#define CME_WINDOW_MAX_MS	3000
+
+/* The readings for each channel, in the order cmeStatsWindowRead() writes them: */
+#define CME_WINDOW_PEAK	0
+#define CME_WINDOW_RMS	1
+#define CME_WINDOW_TROUGH	2
+#define CME_WINDOW_CREST	3
+#define CME_WINDOW_OUTPUTS_PER_CHANNEL	4
+
+// Level readings (dB) bottom out here:
+#define CME_LEVEL_FLOOR_DB	-120
+#define CME_LEVEL_FLOOR	1e-6	// (= CME_LEVEL_FLOOR_DB)
+
+
+typedef struct {
+	unsigned long Channels;
+
+	LADSPA_Data SampleRate;
+	LADSPA_Data LastLength;		// (ms) WindowBlocks was computed from
+	unsigned long WindowBlocks;	// W
+	unsigned long RingBlocks;	// Rows in the block rings (the longest window)
+	unsigned long BlockFill;	// Samples in the current (incomplete) block
+	unsigned long BlockCount;	// Blocks completed since the last reset
+	unsigned long SegmentStart;	// First block of the current segment
+
+	CMEStats * Current;		// [Channels]: the current block so far
+
+	// Rings of [RingBlocks][Channels], indexed by block number % RingBlocks:
+	LADSPA_Data * BlockMax;
+	LADSPA_Data * BlockMin;
+	LADSPA_Data * BlockSum;
+	LADSPA_Data * SuffixMax;	// ...of the previous segment, from each block to its end
+	LADSPA_Data * SuffixMin;
+	double * SuffixSum;
+
+	// [Channels]: the current segment so far
+	LADSPA_Data * PrefixMax;
+	LADSPA_Data * PrefixMin;
+	double * PrefixSum;
+} CMEStatsWindow;
+
+
+/* A level in dB, or CME_LEVEL_FLOOR_DB for anything at or below it (including 0). */
+static inline LADSPA_Data
+cmeLevelToDB(double Level) {
+	return Level > CME_LEVEL_FLOOR ? 20 * log10(Level) : CME_LEVEL_FLOOR_DB;
+}
+
+
+/* Allocate a window of up to CME_WINDOW_MAX_MS for Channels channels, and reset it.  Returns 0 (having freed anything it did allocate) if memory runs out. */
+int cmeStatsWindowInit(CMEStatsWindow * Window,
+		       unsigned long Channels,
+		       unsigned long SampleRate);
+
+void cmeStatsWindowFree(CMEStatsWindow * Window);
+
+/* Forget everything, as activate() should. */
+void cmeStatsWindowReset(CMEStatsWindow * Window);
+
+/* Apply the window length control (ms), if it has changed: the blocks already in the new window become the "previous segment". */
+void cmeStatsWindowSetLength(CMEStatsWindow * Window,
+			     LADSPA_Data Milliseconds);
+
+/* Samples (at most Count) that still fit in the current block. */
+static inline unsigned long
+cmeStatsWindowSpace(const CMEStatsWindow * Window,
+		    unsigned long Count) {
+	return CME_WINDOW_BLOCK - Window->BlockFill < Count ? CME_WINDOW_BLOCK - Window->BlockFill : Count;
+}
+
+/* Count samples have gone into every channel's Current statistics: complete the block if it is full. */
+void cmeStatsWindowAdvance(CMEStatsWindow * Window,
+			   unsigned long Count);
+
+/* Write each channel's peak, RMS, trough and crest factor over the window (dB) to *Outputs[channel * CME_WINDOW_OUTPUTS_PER_CHANNEL + CME_WINDOW_PEAK] etc.  Writes nothing if no samples have gone in yet. */
+void cmeStatsWindowRead(const CMEStatsWindow * Window,
+			LADSPA_Data * const * Outputs);
+
+
+#pragma GCC visibility pop
+
+#endif /* CMESTATSWINDOW_H */
@@ -0,0 +1,474 @@
+/*
+LADSPA plugin implementing a channel strip: gain with mute, balance and a stereo meter, for the usual cmeamp -> cmebal -> cmeter chain on every channel.
+
+The chain costs three run() calls, three instances and three passes over the audio (the meter's a read-only one, but of a buffer the balance has only just written).  Here it is one pass: the gain law is the stereo gain's (dB, -120..+120, mute), the balance law is cmebal's, from the same tables and chosen by the same "Law" control (see cmepanlaw.h; so with the same buffer on both inputs it is cmepan's pan law), and the two are folded into one factor per side, worked out only when a control moves.  The DualScaleStats kernel then multiplies each sample, stores it and merges it into the meter's block statistics while it is still in a register, so each channel is read once and written once.
+
+Gain, mute and balance changes are smoothed as in the gain and balance plugins (see cmesmooth.h): the two factors ramp together to their new values over the time set by the "Smoothing" control, and mute is a fade out and back in.  The ramp goes through the DualScaleRamp kernel, and the Stats kernel then meters what it wrote, while it is still in L1; the rest of the block is the one DualScaleStats pass as before.  So only the 10 ms or so of a ramp is read twice, and a settled strip costs what it did.  The metering is the multichannel meters' (peak, RMS, trough and crest factor over a sliding window of whole 32-sample blocks, see cmestatswindow.h), taken of the output, i.e. post-fader, so the readings are exactly what cme_meter_2 on the strip's outputs would give.
+
+Muted (once faded out) and silent input work as in the gain plugin: the outputs are zero-filled (or, for silent input, left alone if they are the input buffers), the meter is fed silence without looking at the samples, and the "Silent" output goes to 1.  run_adding() meters the strip's own contribution, before the host's run-adding gain, rather than the bus it is added to.
+
+"Smoothing" and "Law" are the last two ports, so the others kept their numbers when they were added.
+
+Folding the gains together means the output can differ from the chain's in the last bit (x * (g * b) rather than (x * g) * b).
+
+CME 2026-10
+*/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ladspa.h"
+#include "cmekernels.h"
+#include "cmemath.h"
+#include "cmestatswindow.h"
+#include "cmesmooth.h"
+#include "cmepanlaw.h"
+#include "cmedenormal.h"
+#include "cmeplugins.h"
+
+
+
+#define CMESTRIP_LADSPA_ID	75
+
+#define CMESTRIP_PORT_COUNT	19
+
+/* The internal ID numbers for the plugin's ports: */
+#define STRIP_GAIN	0
+#define STRIP_MUTE	1
+#define STRIP_BALANCE	2
+#define STRIP_WINDOW	3
+#define STRIP_INPUT_L	4
+#define STRIP_INPUT_R	5
+#define STRIP_OUTPUT_L	6
+#define STRIP_OUTPUT_R	7
+#define STRIP_METER_L	8	// Peak, RMS, trough and crest factor, in cmeStatsWindowRead()'s order
+#define STRIP_METER_R	(STRIP_METER_L + CME_WINDOW_OUTPUTS_PER_CHANNEL)
+#define STRIP_SILENT	(STRIP_METER_R + CME_WINDOW_OUTPUTS_PER_CHANNEL)
+#define STRIP_SMOOTHING	(STRIP_SILENT + 1)
+#define STRIP_LAW	(STRIP_SILENT + 2)
+
+#define STRIP_CHANNELS	2
+
+
+
+
+typedef struct {
+	LADSPA_Data * GainValue;
+	LADSPA_Data * MuteValue;
+	LADSPA_Data * BalanceValue;
+	LADSPA_Data * WindowLength;
+	LADSPA_Data * InputBuffer[STRIP_CHANNELS];
+	LADSPA_Data * OutputBuffer[STRIP_CHANNELS];
+	LADSPA_Data * MeterOutputs[STRIP_CHANNELS * CME_WINDOW_OUTPUTS_PER_CHANNEL];
+	LADSPA_Data * SilentValue;	// (NULL if the host hasn't connected it)
+	LADSPA_Data * SmoothingValue;
+	LADSPA_Data * LawValue;
+
+	LADSPA_Data LastGain;		// Settings the smoother's target was computed for
+	LADSPA_Data LastMute;
+	LADSPA_Data LastBalance;
+	int LastLaw;
+	CMESmoother Smoother;		// Gain times balance, L and R
+	LADSPA_Data RunAddingGain;
+
+	CMEStatsWindow Window;
+} Strip;
+
+
+void
+cleanupStrip(LADSPA_Handle Instance);
+
+
+/* Construct a new plugin instance. */
+LADSPA_Handle
+instantiateStrip(const LADSPA_Descriptor * Descriptor,
+		 unsigned long             SampleRate) {
+
+	Strip * psStrip;
+
+	psStrip = (Strip *)calloc(1, sizeof(Strip));
+	if (!psStrip)
+		return NULL;
+
+	psStrip->LastGain = NAN;	// (never equal to anything, so the first run() computes the factors)
+	psStrip->LastMute = NAN;
+	psStrip->LastBalance = NAN;
+	psStrip->LastLaw = 0;
+	psStrip->RunAddingGain = 1.0;
+	cmeSmootherInit(&psStrip->Smoother, SampleRate);
+	if (!cmeStatsWindowInit(&psStrip->Window, STRIP_CHANNELS, SampleRate)) {
+		free(psStrip);
+		return NULL;
+	}
+	return psStrip;
+}
+
+
+void
+activateStrip(LADSPA_Handle Instance) {
+	cmeStatsWindowReset(&((Strip *)Instance)->Window);
+}
+
+
+/* Connect a port to a data location. */
+void
+connectPortToStrip(LADSPA_Handle Instance,
+		   unsigned long Port,
+		   LADSPA_Data * DataLocation) {
+
+	Strip * psStrip;
+
+	psStrip = (Strip *)Instance;
+	switch (Port) {
+		case STRIP_GAIN:
+			psStrip->GainValue = DataLocation;
+			break;
+		case STRIP_MUTE:
+			psStrip->MuteValue = DataLocation;
+			break;
+		case STRIP_BALANCE:
+			psStrip->BalanceValue = DataLocation;
+			break;
+		case STRIP_WINDOW:
+			psStrip->WindowLength = DataLocation;
+			break;
+		case STRIP_INPUT_L:
+		case STRIP_INPUT_R:
+			psStrip->InputBuffer[Port - STRIP_INPUT_L] = DataLocation;
+			break;
+		case STRIP_OUTPUT_L:
+		case STRIP_OUTPUT_R:
+			psStrip->OutputBuffer[Port - STRIP_OUTPUT_L] = DataLocation;
+			break;
+		case STRIP_SILENT:
+			psStrip->SilentValue = DataLocation;
+			break;
+		case STRIP_SMOOTHING:
+			psStrip->SmoothingValue = DataLocation;
+			break;
+		case STRIP_LAW:
+			psStrip->LawValue = DataLocation;
+			break;
+		default:
+			if (Port >= STRIP_METER_L && Port < STRIP_SILENT)
+				psStrip->MeterOutputs[Port - STRIP_METER_L] = DataLocation;
+			break;
+	}
+}
+
+
+
+/* Set the L and R gain factors for the smoother to ramp to, if any of the controls has moved since the last run(). */
+static void
+updateStripGains(Strip * psStrip) {
+
+	LADSPA_Data fGain = *(psStrip->GainValue);
+	LADSPA_Data fMute = *(psStrip->MuteValue);
+	LADSPA_Data fBalance = *(psStrip->BalanceValue);
+	int iLaw = cmePanLawSelect(*(psStrip->LawValue));
+	LADSPA_Data fGainFactor, fLBalance, fRBalance;
+
+	if (fGain == psStrip->LastGain && fMute == psStrip->LastMute && fBalance == psStrip->LastBalance && iLaw == psStrip->LastLaw)
+		return;
+	psStrip->LastGain = fGain;
+	psStrip->LastMute = fMute;
+	psStrip->LastBalance = fBalance;
+	psStrip->LastLaw = iLaw;
+
+	// The gain plugin's dB law (see cmemath.h) and the balance plugin's law tables, and 0 when muted (so mute is a fade):
+	fGainFactor = fMute == 1 ? 0 : cmeDBToGain(fGain);
+	cmePanLawGains(iLaw, fBalance, 1.0f, &fLBalance, &fRBalance);
+	cmeSmootherSetTarget(&psStrip->Smoother, fGainFactor * fLBalance, fGainFactor * fRBalance, *(psStrip->SmoothingValue));
+}
+
+
+/* 1 if the strip's output is silence this block (muted and faded out, or both inputs silent), and say so on the "Silent" output if the host wants to know. */
+static int
+checkStripSilent(Strip * psStrip,
+		 unsigned long SampleCount) {
+
+	int iSilent;
+
+	iSilent = cmeSmootherIsOff(&psStrip->Smoother)
+		|| (g_sCMEKernels.IsSilent(psStrip->InputBuffer[0], SampleCount)
+		    && g_sCMEKernels.IsSilent(psStrip->InputBuffer[1], SampleCount));
+	if (psStrip->SilentValue)
+		*(psStrip->SilentValue) = iSilent ? 1 : 0;
+	return iSilent;
+}
+
+
+/* Scale Count samples (no more than the meter block has room for), starting Offset samples into the run(), into the outputs and the meter: through the smoother's ramp, if any of it falls here, and then DualScaleStats by the target factors. */
+static void
+scaleStripBlock(Strip * psStrip,
+		const LADSPA_Data * LInput,
+		const LADSPA_Data * RInput,
+		LADSPA_Data * LOutput,
+		LADSPA_Data * ROutput,
+		unsigned long Offset,
+		unsigned long Count) {
+
+	const CMESmoother * psSmoother = &psStrip->Smoother;
+	CMEStatsWindow * psWindow = &psStrip->Window;
+	unsigned long lRamp = cmeSmootherRampLength(psSmoother, Offset + Count);
+
+	if (lRamp > Offset) {
+		lRamp -= Offset;
+		g_sCMEKernels.DualScaleRamp(LInput, RInput, LOutput, ROutput,
+					    cmeSmootherStart(psSmoother, 0) + (LADSPA_Data)Offset * psSmoother->Step[0], psSmoother->Step[0],
+					    cmeSmootherStart(psSmoother, 1) + (LADSPA_Data)Offset * psSmoother->Step[1], psSmoother->Step[1],
+					    lRamp);
+		g_sCMEKernels.Stats(LOutput, lRamp, &psWindow->Current[0]);
+		g_sCMEKernels.Stats(ROutput, lRamp, &psWindow->Current[1]);
+	}
+	else
+		lRamp = 0;
+	if (lRamp < Count)
+		g_sCMEKernels.DualScaleStats(LInput + lRamp, RInput + lRamp, LOutput + lRamp, ROutput + lRamp,
+					     psSmoother->Target[0], psSmoother->Target[1], Count - lRamp,
+					     &psWindow->Current[0], &psWindow->Current[1]);
+}
+
+
+/* Meter SampleCount samples of silence: exactly what the Stats kernel would make of them (the trough goes to 0, and nothing else changes), without reading them. */
+static void
+meterSilence(CMEStatsWindow * psWindow,
+	     unsigned long SampleCount) {
+
+	unsigned long lDone, lLength, lChannel;
+
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = cmeStatsWindowSpace(psWindow, SampleCount - lDone);
+		for (lChannel = 0; lChannel < STRIP_CHANNELS; lChannel++)
+			psWindow->Current[lChannel].Min = 0;
+		cmeStatsWindowAdvance(psWindow, lLength);
+	}
+}
+
+
+
+void
+runStrip(LADSPA_Handle Instance,
+	 unsigned long SampleCount) {
+
+	LADSPA_Data * LInput;
+	LADSPA_Data * RInput;
+	LADSPA_Data * LOutput;
+	LADSPA_Data * ROutput;
+	CMEStatsWindow * psWindow;
+	unsigned long lDone, lLength;
+	CMEDenormalGuard sGuard;
+
+	Strip * psStrip;
+
+	psStrip = (Strip *)Instance;
+	psWindow = &psStrip->Window;
+	cmeDenormalGuardEnter(&sGuard);
+
+	LInput = psStrip->InputBuffer[0];
+	RInput = psStrip->InputBuffer[1];
+	LOutput = psStrip->OutputBuffer[0];
+	ROutput = psStrip->OutputBuffer[1];
+
+	cmeStatsWindowSetLength(psWindow, *(psStrip->WindowLength));
+	updateStripGains(psStrip);
+
+	if (checkStripSilent(psStrip, SampleCount)) {
+		// Silence out (already there if in place, unless muted):
+		if (cmeSmootherIsOff(&psStrip->Smoother) || (LOutput != LInput && LOutput != RInput))
+			g_sCMEKernels.Zero(LOutput, SampleCount);
+		if (cmeSmootherIsOff(&psStrip->Smoother) || (ROutput != LInput && ROutput != RInput))
+			g_sCMEKernels.Zero(ROutput, SampleCount);
+		meterSilence(psWindow, SampleCount);
+	}
+	else {
+		// Gain, balance and metering in one pass, a meter block (or what's left of one) at a time:
+		for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+			lLength = cmeStatsWindowSpace(psWindow, SampleCount - lDone);
+			scaleStripBlock(psStrip, LInput + lDone, RInput + lDone, LOutput + lDone, ROutput + lDone, lDone, lLength);
+			cmeStatsWindowAdvance(psWindow, lLength);
+		}
+	}
+	cmeSmootherAdvance(&psStrip->Smoother, SampleCount);
+
+	cmeStatsWindowRead(psWindow, psStrip->MeterOutputs);
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+
+/* run_adding() version: accumulates into the outputs, with the host's run-adding gain on top.  Each meter block is scaled and metered into a scratch block on the stack (which stays in L1) and then added, so the outputs are still only read and written once.  Mute (once faded out) and silent input add nothing. */
+
+void
+setStripRunAddingGain(LADSPA_Handle Instance,
+		      LADSPA_Data Gain) {
+	((Strip *)Instance)->RunAddingGain = Gain;
+}
+
+
+void
+runAddingStrip(LADSPA_Handle Instance,
+	       unsigned long SampleCount) {
+
+	LADSPA_Data afL[CME_WINDOW_BLOCK];
+	LADSPA_Data afR[CME_WINDOW_BLOCK];
+	CMEStatsWindow * psWindow;
+	unsigned long lDone, lLength;
+	CMEDenormalGuard sGuard;
+
+	Strip * psStrip;
+
+	psStrip = (Strip *)Instance;
+	psWindow = &psStrip->Window;
+	cmeDenormalGuardEnter(&sGuard);
+
+	cmeStatsWindowSetLength(psWindow, *(psStrip->WindowLength));
+	updateStripGains(psStrip);
+
+	if (checkStripSilent(psStrip, SampleCount))
+		meterSilence(psWindow, SampleCount);
+	else {
+		for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+			lLength = cmeStatsWindowSpace(psWindow, SampleCount - lDone);
+			scaleStripBlock(psStrip, psStrip->InputBuffer[0] + lDone, psStrip->InputBuffer[1] + lDone, afL, afR, lDone, lLength);
+			g_sCMEKernels.DualScaleAdd(afL, afR, psStrip->OutputBuffer[0] + lDone, psStrip->OutputBuffer[1] + lDone,
+						   psStrip->RunAddingGain, psStrip->RunAddingGain, lLength);
+			cmeStatsWindowAdvance(psWindow, lLength);
+		}
+	}
+	cmeSmootherAdvance(&psStrip->Smoother, SampleCount);
+
+	cmeStatsWindowRead(psWindow, psStrip->MeterOutputs);
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+
+void
+cleanupStrip(LADSPA_Handle Instance) {
+
+	Strip * psStrip;
+
+	psStrip = (Strip *)Instance;
+	cmeStatsWindowFree(&psStrip->Window);
+	free(psStrip);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiStripPortDescriptors[CMESTRIP_PORT_COUNT] = {
+	[STRIP_GAIN] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[STRIP_MUTE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[STRIP_BALANCE] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[STRIP_WINDOW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[STRIP_INPUT_L] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[STRIP_INPUT_R] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[STRIP_OUTPUT_L] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[STRIP_OUTPUT_R] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+	[STRIP_METER_L + CME_WINDOW_PEAK] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_L + CME_WINDOW_RMS] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_L + CME_WINDOW_TROUGH] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_L + CME_WINDOW_CREST] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_R + CME_WINDOW_PEAK] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_R + CME_WINDOW_RMS] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_R + CME_WINDOW_TROUGH] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_METER_R + CME_WINDOW_CREST] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_SILENT] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[STRIP_SMOOTHING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[STRIP_LAW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcStripPortNames[CMESTRIP_PORT_COUNT] = {
+	[STRIP_GAIN] = "Gain",
+	[STRIP_MUTE] = "Mute",
+	[STRIP_BALANCE] = "Balance",
+	[STRIP_WINDOW] = "Window length (ms)",
+	[STRIP_INPUT_L] = "Input (Left)",
+	[STRIP_INPUT_R] = "Input (Right)",
+	[STRIP_OUTPUT_L] = "Output (Left)",
+	[STRIP_OUTPUT_R] = "Output (Right)",
+	[STRIP_METER_L + CME_WINDOW_PEAK] = "Peak level (Left) (dB)",
+	[STRIP_METER_L + CME_WINDOW_RMS] = "RMS level (Left) (dB)",
+	[STRIP_METER_L + CME_WINDOW_TROUGH] = "Trough level (Left) (dB)",
+	[STRIP_METER_L + CME_WINDOW_CREST] = "Crest factor (Left) (dB)",
+	[STRIP_METER_R + CME_WINDOW_PEAK] = "Peak level (Right) (dB)",
+	[STRIP_METER_R + CME_WINDOW_RMS] = "RMS level (Right) (dB)",
+	[STRIP_METER_R + CME_WINDOW_TROUGH] = "Trough level (Right) (dB)",
+	[STRIP_METER_R + CME_WINDOW_CREST] = "Crest factor (Right) (dB)",
+	[STRIP_SILENT] = "Silent",
+	[STRIP_SMOOTHING] = "Smoothing (ms)",
+	[STRIP_LAW] = "Law"
+};
+
+// As the gain, balance and meter plugins:
+#define STRIP_TOGGLE_HINT	{ LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0, 0, 0 }
+#define STRIP_LEVEL_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, CME_LEVEL_FLOOR_DB, 0 }
+#define STRIP_CREST_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, 0, 30 }
+
+static const LADSPA_PortRangeHint g_asStripPortRangeHints[CMESTRIP_PORT_COUNT] = {
+	[STRIP_GAIN] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 120 },
+	[STRIP_MUTE] = STRIP_TOGGLE_HINT,
+	[STRIP_BALANCE] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -1, 1 },
+	[STRIP_WINDOW] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_LOGARITHMIC | LADSPA_HINT_DEFAULT_MIDDLE, CME_WINDOW_MIN_MS, CME_WINDOW_MAX_MS },
+	[STRIP_METER_L + CME_WINDOW_PEAK] = STRIP_LEVEL_HINT,
+	[STRIP_METER_L + CME_WINDOW_RMS] = STRIP_LEVEL_HINT,
+	[STRIP_METER_L + CME_WINDOW_TROUGH] = STRIP_LEVEL_HINT,
+	[STRIP_METER_L + CME_WINDOW_CREST] = STRIP_CREST_HINT,
+	[STRIP_METER_R + CME_WINDOW_PEAK] = STRIP_LEVEL_HINT,
+	[STRIP_METER_R + CME_WINDOW_RMS] = STRIP_LEVEL_HINT,
+	[STRIP_METER_R + CME_WINDOW_TROUGH] = STRIP_LEVEL_HINT,
+	[STRIP_METER_R + CME_WINDOW_CREST] = STRIP_CREST_HINT,
+	[STRIP_SILENT] = STRIP_TOGGLE_HINT,
+	[STRIP_SMOOTHING] = CME_SMOOTH_HINT,
+	[STRIP_LAW] = CME_PAN_LAW_HINT
+};
+
+
+const LADSPA_Descriptor g_sStripDescriptor = {
+	.UniqueID = CMESTRIP_LADSPA_ID,
+	.Label = "cme_strip",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Channel strip: gain, mute, balance and meter (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMESTRIP_PORT_COUNT,
+	.PortDescriptors = g_aiStripPortDescriptors,
+	.PortNames = g_apcStripPortNames,
+	.PortRangeHints = g_asStripPortRangeHints,
+	.instantiate = instantiateStrip,
+	.connect_port = connectPortToStrip,
+	.activate = activateStrip,
+	.run = runStrip,
+	.run_adding = runAddingStrip,
+	.set_run_adding_gain = setStripRunAddingGain,
+	.cleanup = cleanupStrip
+};
+
+
+
+#ifndef CME_BUNDLE
+
+void
+_init() {
+	cmeKernelsInit();
+	cmePanLawsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type (there's only one). */
+const LADSPA_Descriptor *
+ladspa_descriptor(unsigned long Index) {
+	/* Return the requested descriptor or null if the index is out of range. */
+	switch (Index) {
+	case 0:
+		return &g_sStripDescriptor;
+	default:
+		return NULL;
+	}
+}
+
+#endif /* CME_BUNDLE */
@@ -0,0 +1,246 @@
+/*
+Meter telemetry: shared-memory ring writer and reader.  See cmetelemetry.h for the layout and protocol.
+CME 2026-10
+*/
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cmetelemetry.h"
+
+
+struct CMETelemetryWriter {
+	char * Name;
+	CMETelemetryHeader * Header;
+	CMETelemetryRecord * Records;
+	size_t Size;
+};
+
+struct CMETelemetryReader {
+	const CMETelemetryHeader * Header;
+	const CMETelemetryRecord * Records;
+	size_t Size;
+	uint64_t ReadIndex;
+};
+
+
+/* Records start on a 64-byte boundary after the header. */
+static size_t
+recordsOffset(void) {
+	return (sizeof(CMETelemetryHeader) + 63) & ~(size_t)63;
+}
+
+
+
+/*****************************************************************************/
+
+/* Writer */
+
+CMETelemetryWriter *
+cmeTelemetryCreate(const char * Prefix,
+		   unsigned long Instance,
+		   double SampleRate) {
+
+	CMETelemetryWriter * psWriter;
+	int iFile;
+	void * pvMemory;
+
+	psWriter = (CMETelemetryWriter *)calloc(1, sizeof(CMETelemetryWriter));
+	if (!psWriter)
+		return NULL;
+	if (asprintf(&psWriter->Name, "/%s.%ld.%lu", Prefix, (long)getpid(), Instance) < 0) {
+		free(psWriter);
+		return NULL;
+	}
+	psWriter->Size = recordsOffset() + CME_TELEMETRY_CAPACITY * sizeof(CMETelemetryRecord);
+
+	iFile = shm_open(psWriter->Name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (iFile < 0) {
+		free(psWriter->Name);
+		free(psWriter);
+		return NULL;
+	}
+	if (ftruncate(iFile, psWriter->Size) != 0
+	    || (pvMemory = mmap(NULL, psWriter->Size, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0)) == MAP_FAILED) {
+		close(iFile);
+		shm_unlink(psWriter->Name);
+		free(psWriter->Name);
+		free(psWriter);
+		return NULL;
+	}
+	close(iFile);
+
+	// Touch every page now, so that run() never takes a page fault:
+	memset(pvMemory, 0, psWriter->Size);
+
+	psWriter->Header = (CMETelemetryHeader *)pvMemory;
+	psWriter->Records = (CMETelemetryRecord *)((char *)pvMemory + recordsOffset());
+	psWriter->Header->Version = CME_TELEMETRY_VERSION;
+	psWriter->Header->RecordSize = sizeof(CMETelemetryRecord);
+	psWriter->Header->Capacity = CME_TELEMETRY_CAPACITY;
+	psWriter->Header->SampleRate = SampleRate;
+	// The magic number goes in last, so a reader never sees a half-initialised header as valid:
+	__atomic_store_n(&psWriter->Header->Magic, CME_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+	return psWriter;
+}
+
+
+void
+cmeTelemetryPublish(CMETelemetryWriter * psWriter,
+		    const CMETelemetryRecord * psRecord) {
+
+	// Only this thread writes, so a plain read of our own index is fine:
+	uint64_t lIndex = psWriter->Header->WriteIndex;
+	CMETelemetryRecord * psSlot = psWriter->Records + (lIndex & (CME_TELEMETRY_CAPACITY - 1));
+
+	__atomic_store_n(&psSlot->Sequence, 2 * lIndex + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	psSlot->SamplePosition = psRecord->SamplePosition;
+	psSlot->SampleCount = psRecord->SampleCount;
+	psSlot->Peak = psRecord->Peak;
+	psSlot->RMS = psRecord->RMS;
+	psSlot->Trough = psRecord->Trough;
+	psSlot->Crest = psRecord->Crest;
+	psSlot->TruePeak = psRecord->TruePeak;
+	psSlot->Momentary = psRecord->Momentary;
+	psSlot->ShortTerm = psRecord->ShortTerm;
+	psSlot->Integrated = psRecord->Integrated;
+	psSlot->Range = psRecord->Range;
+	__atomic_store_n(&psSlot->Sequence, 2 * lIndex + 2, __ATOMIC_RELEASE);
+
+	__atomic_store_n(&psWriter->Header->WriteIndex, lIndex + 1, __ATOMIC_RELEASE);
+}
+
+
+void
+cmeTelemetryDestroy(CMETelemetryWriter * psWriter) {
+
+	if (!psWriter)
+		return;
+	munmap(psWriter->Header, psWriter->Size);
+	shm_unlink(psWriter->Name);
+	free(psWriter->Name);
+	free(psWriter);
+}
+
+
+
+/*****************************************************************************/
+
+/* Reader */
+
+CMETelemetryReader *
+cmeTelemetryOpen(const char * Name) {
+
+	CMETelemetryReader * psReader;
+	const CMETelemetryHeader * psHeader;
+	struct stat sStat;
+	void * pvMemory;
+	uint64_t lWriteIndex;
+	int iFile;
+
+	iFile = shm_open(Name, O_RDONLY, 0);
+	if (iFile < 0)
+		return NULL;
+	if (fstat(iFile, &sStat) != 0 || (size_t)sStat.st_size < recordsOffset()) {
+		close(iFile);
+		return NULL;
+	}
+	pvMemory = mmap(NULL, sStat.st_size, PROT_READ, MAP_SHARED, iFile, 0);
+	close(iFile);
+	if (pvMemory == MAP_FAILED)
+		return NULL;
+
+	psHeader = (const CMETelemetryHeader *)pvMemory;
+	if (__atomic_load_n(&psHeader->Magic, __ATOMIC_ACQUIRE) != CME_TELEMETRY_MAGIC
+	    || psHeader->Version != CME_TELEMETRY_VERSION
+	    || psHeader->RecordSize != sizeof(CMETelemetryRecord)
+	    || psHeader->Capacity == 0
+	    || (psHeader->Capacity & (psHeader->Capacity - 1)) != 0
+	    || (size_t)sStat.st_size < recordsOffset() + psHeader->Capacity * sizeof(CMETelemetryRecord)) {
+		munmap(pvMemory, sStat.st_size);
+		return NULL;
+	}
+
+	psReader = (CMETelemetryReader *)calloc(1, sizeof(CMETelemetryReader));
+	if (!psReader) {
+		munmap(pvMemory, sStat.st_size);
+		return NULL;
+	}
+	psReader->Header = psHeader;
+	psReader->Records = (const CMETelemetryRecord *)((const char *)pvMemory + recordsOffset());
+	psReader->Size = sStat.st_size;
+	lWriteIndex = __atomic_load_n(&psHeader->WriteIndex, __ATOMIC_ACQUIRE);
+	psReader->ReadIndex = lWriteIndex > psHeader->Capacity ? lWriteIndex - psHeader->Capacity : 0;
+	return psReader;
+}
+
+
+double
+cmeTelemetrySampleRate(const CMETelemetryReader * psReader) {
+	return psReader->Header->SampleRate;
+}
+
+
+unsigned long
+cmeTelemetryRead(CMETelemetryReader * psReader,
+		 CMETelemetryRecord * psRecords,
+		 unsigned long MaxRecords,
+		 unsigned long * Lost) {
+
+	const CMETelemetryRecord * psSlot;
+	uint64_t lCapacity = psReader->Header->Capacity;
+	uint64_t lWriteIndex;
+	uint64_t lSequence;
+	unsigned long lCount = 0;
+	unsigned long lLost = 0;
+
+	lWriteIndex = __atomic_load_n(&psReader->Header->WriteIndex, __ATOMIC_ACQUIRE);
+	if (lWriteIndex - psReader->ReadIndex > lCapacity) {
+		lLost += lWriteIndex - psReader->ReadIndex - lCapacity;
+		psReader->ReadIndex = lWriteIndex - lCapacity;
+	}
+
+	for (; psReader->ReadIndex < lWriteIndex && lCount < MaxRecords; psReader->ReadIndex++) {
+		psSlot = psReader->Records + (psReader->ReadIndex & (lCapacity - 1));
+
+		// Copy the record, then check that the writer didn't start overwriting it meanwhile:
+		lSequence = __atomic_load_n(&psSlot->Sequence, __ATOMIC_ACQUIRE);
+		if (lSequence != 2 * psReader->ReadIndex + 2) {
+			lLost++;
+			continue;
+		}
+		memcpy(psRecords + lCount, (const void *)psSlot, sizeof(CMETelemetryRecord));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&psSlot->Sequence, __ATOMIC_RELAXED) != lSequence) {
+			lLost++;
+			continue;
+		}
+		lCount++;
+	}
+
+	if (Lost)
+		*Lost = lLost;
+	return lCount;
+}
+
+
+void
+cmeTelemetryClose(CMETelemetryReader * psReader) {
+
+	if (!psReader)
+		return;
+	munmap((void *)psReader->Header, psReader->Size);
+	free(psReader);
+}
+
+
+/* EOF */
@@ -0,0 +1,105 @@
+/*
+Meter telemetry: a shared-memory ring through which each Meter instance publishes its readings after every run(), for a monitoring process to collect at full resolution without going through the host.
+
+Telemetry is off unless the environment variable CME_METER_SHM is set (LADSPA control ports can only carry numbers, so the name can't come from a control).  Its value is a name prefix, e.g. "cme_meter"; each instance then creates the POSIX shared-memory segment "/<prefix>.<pid>.<instance>" (i.e. /dev/shm/<prefix>.<pid>.<instance> on Linux) in instantiate(), and removes it in cleanup().
+
+The segment is a CMETelemetryHeader followed by Capacity records.  The writer never waits for the reader: record n goes in slot n & (Capacity - 1), overwriting whatever was there, with a per-record sequence number acting as a seqlock (odd while being written, 2n + 2 once record n is complete), and the header's WriteIndex is then advanced.  A reader that falls more than Capacity records behind loses the oldest ones, and is told how many.
+
+The writer side (create/publish/destroy) is linked into cmeter.so.  The reader side is built into libcmetelemetry.a for the monitoring daemon:
+
+	CMETelemetryReader * psReader = cmeTelemetryOpen("/cme_meter.1234.0");
+	...
+	lCount = cmeTelemetryRead(psReader, asRecords, 256, &lLost);
+	...
+	cmeTelemetryClose(psReader);
+
+CME 2026-10
+*/
+
+#ifndef CMETELEMETRY_H
+#define CMETELEMETRY_H
+
+#include <stdint.h>
+
+#pragma GCC visibility push(hidden)
+
+
+#define CME_TELEMETRY_MAGIC	0x54454D43	// "CMET"
+#define CME_TELEMETRY_VERSION	1
+
+/* Environment variable holding the segment name prefix: */
+#define CME_TELEMETRY_ENV	"CME_METER_SHM"
+
+/* Records per segment (a power of two): about 10 s of history at 64-sample blocks and 48 kHz. */
+#define CME_TELEMETRY_CAPACITY	8192
+
+
+/* Segment header.  Everything but WriteIndex is fixed when the segment is created. */
+typedef struct {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t RecordSize;		// sizeof(CMETelemetryRecord)
+	uint32_t Capacity;		// Records in the ring
+	double SampleRate;
+	uint64_t WriteIndex;		// Records published so far (accessed atomically)
+	uint64_t Reserved[4];
+} CMETelemetryHeader;
+
+
+/* One run() worth of readings: the meter's output port values (dB, dBTP, LUFS, LU as on the ports) at the end of the block. */
+typedef struct {
+	uint64_t Sequence;		// Seqlock (accessed atomically)
+	uint64_t SamplePosition;	// Samples since activate(), at the end of the block
+	uint32_t SampleCount;		// Samples in the block
+	float Peak;
+	float RMS;
+	float Trough;
+	float Crest;
+	float TruePeak;
+	float Momentary;
+	float ShortTerm;
+	float Integrated;
+	float Range;
+	uint32_t Reserved[2];
+} CMETelemetryRecord;
+
+
+/* Writer (the plugin): */
+
+typedef struct CMETelemetryWriter CMETelemetryWriter;
+
+/* Create a segment named "/<Prefix>.<pid>.<Instance>".  Returns NULL if telemetry can't be set up; the meter then just runs without it.  Not real-time safe (call from instantiate()). */
+CMETelemetryWriter * cmeTelemetryCreate(const char * Prefix,
+					unsigned long Instance,
+					double SampleRate);
+
+/* Publish one record (the Sequence field is filled in).  Wait-free, no system calls: safe in run(). */
+void cmeTelemetryPublish(CMETelemetryWriter * Writer,
+			 const CMETelemetryRecord * Record);
+
+/* Unmap and remove the segment. */
+void cmeTelemetryDestroy(CMETelemetryWriter * Writer);
+
+
+/* Reader (the monitoring daemon): */
+
+typedef struct CMETelemetryReader CMETelemetryReader;
+
+/* Map an existing segment read-only, positioned at the oldest record still in the ring.  Returns NULL if it doesn't exist or isn't a telemetry segment of this version. */
+CMETelemetryReader * cmeTelemetryOpen(const char * Name);
+
+/* The sample rate of the meter instance writing the segment. */
+double cmeTelemetrySampleRate(const CMETelemetryReader * Reader);
+
+/* Copy up to MaxRecords new records, oldest first, and return how many.  *Lost (if not NULL) is set to the number of records that were overwritten before they could be read. */
+unsigned long cmeTelemetryRead(CMETelemetryReader * Reader,
+			       CMETelemetryRecord * Records,
+			       unsigned long MaxRecords,
+			       unsigned long * Lost);
+
+void cmeTelemetryClose(CMETelemetryReader * Reader);
+
+
+#pragma GCC visibility pop
+
+#endif /* CMETELEMETRY_H */
@@ -2,15 +2,35 @@
 LADSPA plugin implementing an (initially simple) level meter.  Will aim to include peak, RMS, trough, crest factor, histogram(?!) and subjective loudness eventually!
 Don't really see the point in implementing a stereo one of these - you should just be able to patch two of them to a stereo source in the host easily enough.
 CME 2007-10-05
+
+The readings are now taken over a sliding window of the most recent Window length (ms) of input, rather than over whatever buffer size the host happens to use.  The window is kept in a ring buffer with a running sum of squares for the RMS (kept with compensated addition, so it doesn't drift however long it runs) and monotonic queues (the "ascending minima" trick) for the peak and trough, so each sample costs O(1) (amortised) whatever the window length.  Changing the window length rescans the history once.  Memory is about 12 bytes per sample of the maximum window (3 s), allocated in instantiate().
+CME 2026-10
+
+True peak (dBTP) is measured as in ITU-R BS.1770-4 Annex 2: the input is upsampled 4x with the standard 48-tap polyphase FIR (the TruePeak kernel, see cmekernels.h), and the largest |x| of the oversampled signal over the window is reported.  This catches inter-sample overs that the sample peak misses, e.g. a sine at fs/4 sampled 45 degrees off its peaks reads 3 dB low as a sample peak.  The interpolation filter has a group delay of 23.5 oversampled samples, so the true-peak reading lags the other readings by about 6 input samples (0.12 ms at 48 kHz); there is no latency in any audio path, as the meter has no audio outputs.  The filter costs 48 multiply-adds per input sample, done 4/8/16 samples at a time with SSE2/AVX2/AVX-512.  Measured on an AVX-512 machine, the kernel alone takes about 2 ns per sample with AVX2 or AVX-512 (4.6 with SSE2, 5.5 scalar), and true peak adds 3-4 ns per sample to the whole meter (see "make bench"), which comes to about 12-13 ns per sample.  So a 64-channel show at 48 kHz spends about 1% of one core on true peak, and about 4% on the meters altogether.  True peak also adds another 8 bytes per sample of window to the memory use.
+
+Loudness follows EBU R128 / ITU-R BS.1770-4 for a single channel: the input is K-weighted (two biquads in double precision, designed for the actual sample rate) and its mean square is collected in 100 ms sub-blocks.  Momentary loudness is the last 4 sub-blocks (400 ms), short-term the last 30 (3 s); both are updated every 100 ms and ignore the Window length control.  Integrated loudness gates the 400 ms blocks (75% overlap) at -70 LUFS absolute and -10 LU relative, and loudness range (EBU Tech 3342) takes the 10th to 95th percentile of the short-term values gated at -70 LUFS and -20 LU.  Rather than keeping every block, both use a fixed histogram of 0.1 LU bins from -70 to +10 LUFS holding a count and the summed energy per bin, so memory (about 19 kB) and the cost of each update (a pass over 800 bins, ten times a second) stay the same however long the programme runs.  The energies are exact, so the only approximation is that the relative gate and the percentiles fall on bin boundaries, i.e. to within 0.1 LU.  Reset by activate().
+
+If the environment variable CME_METER_SHM is set, each instance also publishes all of its readings after every run() to a shared-memory ring, for monitoring software to read without involving the host (see cmetelemetry.h).  This costs run() a few dozen stores per block.
+
+Levels at or below the floor of the output ranges (-120 dB) read as exactly -120 dB, without calling log10(), so silence gives -120 dB levels and a crest factor of 0 dB rather than -infinity and NaN.  The loudness outputs bottom out at -120 LUFS the same way, which is also what they read before the first 100 ms sub-block, and what integrated loudness reads until a block has passed the gates.  And since most channels of a big session are silent most of the time, once the input has been silent (every sample +0 or -0, checked with the IsSilent kernel) for the whole window and the true-peak filter's history, run() no longer slides the window a sample at a time: the window is known to be all zeros, so it just clears that stretch of the rings and resets the queues.  The loudness filters are skipped too once their state has decayed to exactly zero (which the denormal guard makes happen within a few seconds), leaving only the 100 ms sub-block bookkeeping.
+
+On 32- and 64-channel buses, though, patching a mono meter per channel does add up (a run() call, a cold instance and an unvectorised reduction per channel), so there are also 2, 8, 16, 32 and 64 channel versions, measuring peak, RMS, trough and crest factor for every channel in one run().  Each channel's samples go through the Stats kernel in 32-sample blocks, and the sliding window is then kept over the block statistics, with the window length rounded to whole blocks (0.7 ms at 48 kHz).  The window's max, min and sum come from a streaming van Herk/Gil-Werman scheme: running prefix values over the current W-block segment, and suffix values over the previous one, worked out once per segment.  That is O(1) per block whatever the window length, and exact (no running sum to drift).  All of this state is stored structure-of-arrays, as [block][channel] rows, so each update is a short loop across the channels that the compiler vectorises.  Memory is about 28 bytes per channel per block of window (8 MB for 64 channels and 3 s at 48 kHz, against over 300 MB for 64 mono meters).  The window code is in cmestatswindow.c, as the channel strip (cmestrip.c) meters the same way.
 */
 
 
+#include <stdio.h>
 #include <stdlib.h>
-#define _GNU_SOURCE
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 
 #include "ladspa.h"
+#include "cmekernels.h"
+#include "cmestatswindow.h"
+#include "cmetelemetry.h"
+#include "cmedenormal.h"
+#include "cmepool.h"
+#include "cmeplugins.h"
 
 
 
@@ -19,7 +39,7 @@ CME 2007-10-05
 
 /* The internal ID numbers for the plugin's ports: */
 
-#define CMEMETER_PORT_COUNT 5
+#define CMEMETER_PORT_COUNT 11
 
 // Huh? You have to define these in numerical order?!  C is too low-level for this stuff, IMHO.
 #define METER_INPUT	0
@@ -27,6 +47,35 @@ CME 2007-10-05
 #define METER_RMS	2
 #define METER_TROUGH	3
 #define METER_CREST	4
+#define METER_WINDOW	5
+#define METER_TRUE_PEAK	6
+#define METER_MOMENTARY	7
+#define METER_SHORT_TERM	8
+#define METER_INTEGRATED	9
+#define METER_RANGE	10
+
+/* Range of the window length control (ms), the same for every meter: */
+#define METER_MIN_WINDOW	CME_WINDOW_MIN_MS
+#define METER_MAX_WINDOW	CME_WINDOW_MAX_MS
+
+/* run() feeds the true-peak kernel this many samples at a time: */
+#define METER_CHUNK	256
+
+/* Loudness: 100 ms sub-blocks, 4 to a momentary (gating) block and 30 to a short-term block; histogram of 0.1 LU bins from the -70 LUFS absolute gate up to +10 LUFS. */
+#define METER_MOMENTARY_SUBBLOCKS	4
+#define METER_SHORT_TERM_SUBBLOCKS	30
+#define METER_HISTOGRAM_FLOOR	-70.0
+#define METER_HISTOGRAM_BINS_PER_LU	10
+#define METER_HISTOGRAM_BINS	800
+
+// Level outputs (dB) bottom out here (see cmeLevelToDB()), as do their hints:
+#define METER_FLOOR_DB		CME_LEVEL_FLOOR_DB
+
+
+#define CMEMULTIMETER_LADSPA_ID	61	// ...to 65; see g_asMultiMeterDescriptors
+
+/* Multichannel meters: the ports for each channel (after the inputs), in cmeStatsWindowRead()'s order. */
+#define MULTIMETER_OUTPUTS_PER_CHANNEL	CME_WINDOW_OUTPUTS_PER_CHANNEL
 
 
 
@@ -34,7 +83,29 @@ CME 2007-10-05
 
 
 /* The structure used to hold port connection information and state
-   (actually gain controls require no further state). */
+   (the sliding window: a history of |x|, and queues of the positions of candidate maxima and minima within the window). */
+
+
+/* A biquad section, transposed direct form II. */
+typedef struct {
+	double B0, B1, B2, A1, A2;
+	double Z1, Z2;
+} Biquad;
+
+
+/* Distribution of block loudnesses, for gating: the number of blocks, and their total mean-square energy, in each bin. */
+typedef struct {
+	uint32_t Count[METER_HISTOGRAM_BINS];
+	double Energy[METER_HISTOGRAM_BINS];
+} LoudnessHistogram;
+
+
+/* A queue of sample positions, indexed (like the ring) by counter & RingMask. */
+typedef struct {
+	uint32_t * Positions;
+	uint32_t Head;
+	uint32_t Tail;
+} PositionQueue;
 
 
 typedef struct {
@@ -43,14 +114,167 @@ typedef struct {
 	LADSPA_Data * RMSLevel;
 	LADSPA_Data * TroughLevel;
 	LADSPA_Data * CrestFactor;
+	LADSPA_Data * WindowLength;
+	LADSPA_Data * TruePeakLevel;
+	LADSPA_Data * MomentaryLoudness;
+	LADSPA_Data * ShortTermLoudness;
+	LADSPA_Data * IntegratedLoudness;
+	LADSPA_Data * LoudnessRange;
+
+	LADSPA_Data SampleRate;
+	LADSPA_Data LastWindowLength;	// (ms) WindowSamples was computed from
+	unsigned long WindowSamples;
+	unsigned long Filled;		// Samples in the window so far (<= WindowSamples)
+	unsigned long Available;	// Samples of history in the ring (<= RingMask)
+	unsigned long SilentSamples;	// Input samples since the last non-silent block (capped at RingMask + CME_TRUE_PEAK_TAPS)
+
+	// The ring and both queues are RingMask + 1 (a power of two) long, and indexed by sample position & RingMask.
+	uint32_t RingMask;
+	uint32_t Position;		// Position of the next sample (wraps, harmlessly)
+	LADSPA_Data * Ring;		// |x|
+	double SumOfSquares;		// ...of the samples in the window (plus SumError)
+	double SumError;		// Rounding error of the additions to SumOfSquares (see addCompensated())
+
+	PositionQueue MaxQueue;		// |x| decreasing from head to tail
+	PositionQueue MinQueue;		// |x| increasing from head to tail
+
+	LADSPA_Data * TruePeakRing;	// True peak of each sample period, indexed like Ring
+	PositionQueue TruePeakQueue;	// True peak decreasing from head to tail
+
+	// Kernel input (the last CME_TRUE_PEAK_TAPS - 1 samples of the previous chunk, then the current chunk) and output:
+	LADSPA_Data TruePeakInput[CME_TRUE_PEAK_TAPS - 1 + METER_CHUNK];
+	LADSPA_Data TruePeakOutput[METER_CHUNK];
+
+	// Loudness (see above); energies are mean squares of the K-weighted signal:
+	Biquad KShelf;
+	Biquad KHighPass;
+	unsigned long SubBlockSamples;
+	unsigned long SubBlockFill;
+	double SubBlockSum;
+	double SubBlockEnergy[METER_SHORT_TERM_SUBBLOCKS];	// Ring of the most recent sub-blocks
+	unsigned long SubBlockCount;	// Completed since activate()
+	LoudnessHistogram BlockHistogram;	// 400 ms blocks, for integrated loudness
+	LoudnessHistogram ShortTermHistogram;	// 3 s blocks, for loudness range
+	LADSPA_Data Momentary, ShortTerm, Integrated, Range;	// Latest results
+
+	CMETelemetryWriter * Telemetry;	// NULL unless CME_METER_SHM is set
+	uint64_t SamplesSinceActivate;
 } Meter;
 
+/* Instances come from here (see cmepool.h); the rings are allocated separately. */
+static CMEInstancePool g_sMeterPool = CME_INSTANCE_POOL(Meter);
+
+
+void 
+cleanupMeter(LADSPA_Handle Instance);
+
+void 
+activateMeter(LADSPA_Handle Instance);
+
+
+/* Design the two K-weighting filters of BS.1770 for the given sample rate, from their analogue prototypes (the high-frequency shelf, then the RLB high-pass).  At 48 kHz these give the coefficients tabulated in the standard. */
+static void
+designKWeighting(Meter * psMeter,
+		 double SampleRate) {
+
+	double dK, dVh, dVb, dQ, dA0;
+
+	dK = tan(M_PI * 1681.974450955533 / SampleRate);
+	dQ = 0.7071752369554196;
+	dVh = pow(10.0, 3.999843853973347 / 20.0);
+	dVb = pow(dVh, 0.4996667741545416);
+	dA0 = 1.0 + dK / dQ + dK * dK;
+	psMeter->KShelf.B0 = (dVh + dVb * dK / dQ + dK * dK) / dA0;
+	psMeter->KShelf.B1 = 2.0 * (dK * dK - dVh) / dA0;
+	psMeter->KShelf.B2 = (dVh - dVb * dK / dQ + dK * dK) / dA0;
+	psMeter->KShelf.A1 = 2.0 * (dK * dK - 1.0) / dA0;
+	psMeter->KShelf.A2 = (1.0 - dK / dQ + dK * dK) / dA0;
+
+	dK = tan(M_PI * 38.13547087602444 / SampleRate);
+	dQ = 0.5003270373238773;
+	dA0 = 1.0 + dK / dQ + dK * dK;
+	psMeter->KHighPass.B0 = 1.0;
+	psMeter->KHighPass.B1 = -2.0;
+	psMeter->KHighPass.B2 = 1.0;
+	psMeter->KHighPass.A1 = 2.0 * (dK * dK - 1.0) / dA0;
+	psMeter->KHighPass.A2 = (1.0 - dK / dQ + dK * dK) / dA0;
+}
+
 
 /* Construct a new plugin instance. */
 LADSPA_Handle 
 instantiateMeter(const LADSPA_Descriptor * Descriptor,
 		     unsigned long             SampleRate) {
-	return malloc(sizeof(Meter));
+
+	Meter * psMeter;
+	unsigned long lRingSize;
+	const char * pcTelemetryPrefix;
+	static unsigned long s_lInstances = 0;
+
+	psMeter = (Meter *)cmePoolAllocate(&g_sMeterPool);
+	if (!psMeter)
+		return NULL;
+
+	// Room for the longest window plus the sample about to leave it:
+	for (lRingSize = 1; lRingSize < (unsigned long)(METER_MAX_WINDOW * 0.001 * SampleRate) + 2; lRingSize *= 2)
+		;
+	psMeter->SampleRate = SampleRate;
+	psMeter->RingMask = lRingSize - 1;
+	psMeter->SubBlockSamples = (unsigned long)(0.1 * SampleRate + 0.5);
+	if (psMeter->SubBlockSamples < 1)
+		psMeter->SubBlockSamples = 1;
+	designKWeighting(psMeter, SampleRate);
+	psMeter->Ring = (LADSPA_Data *)calloc(lRingSize, sizeof(LADSPA_Data));
+	psMeter->MaxQueue.Positions = (uint32_t *)calloc(lRingSize, sizeof(uint32_t));
+	psMeter->MinQueue.Positions = (uint32_t *)calloc(lRingSize, sizeof(uint32_t));
+	psMeter->TruePeakRing = (LADSPA_Data *)calloc(lRingSize, sizeof(LADSPA_Data));
+	psMeter->TruePeakQueue.Positions = (uint32_t *)calloc(lRingSize, sizeof(uint32_t));
+	if (!psMeter->Ring || !psMeter->MaxQueue.Positions || !psMeter->MinQueue.Positions
+	    || !psMeter->TruePeakRing || !psMeter->TruePeakQueue.Positions) {
+		cleanupMeter(psMeter);
+		return NULL;
+	}
+
+	pcTelemetryPrefix = getenv(CME_TELEMETRY_ENV);
+	if (pcTelemetryPrefix && *pcTelemetryPrefix)
+		psMeter->Telemetry = cmeTelemetryCreate(pcTelemetryPrefix, __atomic_fetch_add(&s_lInstances, 1, __ATOMIC_RELAXED), SampleRate);
+
+	activateMeter(psMeter);
+	return psMeter;
+}
+
+
+/* Forget the signal history. */
+void 
+activateMeter(LADSPA_Handle Instance) {
+
+	Meter * psMeter;
+
+	psMeter = (Meter *)Instance;
+	psMeter->LastWindowLength = NAN;	// (forces the window to be set up on the next run())
+	psMeter->WindowSamples = 1;
+	psMeter->Filled = 0;
+	psMeter->Available = 0;
+	psMeter->SilentSamples = 0;
+	psMeter->Position = 0;
+	psMeter->SumOfSquares = 0.0;
+	psMeter->SumError = 0.0;
+	psMeter->MaxQueue.Head = psMeter->MaxQueue.Tail = 0;
+	psMeter->MinQueue.Head = psMeter->MinQueue.Tail = 0;
+	psMeter->TruePeakQueue.Head = psMeter->TruePeakQueue.Tail = 0;
+	memset(psMeter->TruePeakInput, 0, sizeof(psMeter->TruePeakInput));
+
+	psMeter->KShelf.Z1 = psMeter->KShelf.Z2 = 0.0;
+	psMeter->KHighPass.Z1 = psMeter->KHighPass.Z2 = 0.0;
+	psMeter->SubBlockFill = 0;
+	psMeter->SubBlockSum = 0.0;
+	memset(psMeter->SubBlockEnergy, 0, sizeof(psMeter->SubBlockEnergy));
+	psMeter->SubBlockCount = 0;
+	memset(&psMeter->BlockHistogram, 0, sizeof(LoudnessHistogram));
+	memset(&psMeter->ShortTermHistogram, 0, sizeof(LoudnessHistogram));
+	psMeter->Momentary = psMeter->ShortTerm = psMeter->Integrated = METER_FLOOR_DB;
+	psMeter->Range = 0;
+	psMeter->SamplesSinceActivate = 0;
 }
 
 
@@ -79,6 +303,423 @@ connectPortToMeter(LADSPA_Handle Instance,
 		case METER_CREST:
 			psMeter->CrestFactor = DataLocation;
 			break;
+		case METER_WINDOW:
+			psMeter->WindowLength = DataLocation;
+			break;
+		case METER_TRUE_PEAK:
+			psMeter->TruePeakLevel = DataLocation;
+			break;
+		case METER_MOMENTARY:
+			psMeter->MomentaryLoudness = DataLocation;
+			break;
+		case METER_SHORT_TERM:
+			psMeter->ShortTermLoudness = DataLocation;
+			break;
+		case METER_INTEGRATED:
+			psMeter->IntegratedLoudness = DataLocation;
+			break;
+		case METER_RANGE:
+			psMeter->LoudnessRange = DataLocation;
+			break;
+	}
+}
+
+
+
+/* Add one sample's position to the back of a max (or min) queue.  Anything behind it that can no longer be the max (or min) of any window containing it is dropped.  (The queues are passed by pointer so that run() can keep local copies in registers.) */
+static inline void
+pushMaxQueue(const LADSPA_Data * Ring,
+	     uint32_t Mask,
+	     PositionQueue * Queue,
+	     uint32_t Position,
+	     LADSPA_Data Value) {
+
+	while (Queue->Tail != Queue->Head
+	       && Ring[Queue->Positions[(Queue->Tail - 1) & Mask] & Mask] <= Value)
+		Queue->Tail--;
+	Queue->Positions[Queue->Tail++ & Mask] = Position;
+}
+
+static inline void
+pushMinQueue(const LADSPA_Data * Ring,
+	     uint32_t Mask,
+	     PositionQueue * Queue,
+	     uint32_t Position,
+	     LADSPA_Data Value) {
+
+	while (Queue->Tail != Queue->Head
+	       && Ring[Queue->Positions[(Queue->Tail - 1) & Mask] & Mask] >= Value)
+		Queue->Tail--;
+	Queue->Positions[Queue->Tail++ & Mask] = Position;
+}
+
+
+/* Drop the head of a queue once it has fallen out of the window. */
+static inline void
+retireQueueHead(PositionQueue * Queue,
+		uint32_t Mask,
+		uint32_t Position,
+		uint32_t WindowSamples) {
+	if (Position - Queue->Positions[Queue->Head & Mask] >= WindowSamples)
+		Queue->Head++;
+}
+
+
+/* Value at the head of a queue, i.e. the max (or min) of the window. */
+static inline LADSPA_Data
+queueHeadValue(const LADSPA_Data * Ring,
+	       uint32_t Mask,
+	       const PositionQueue * Queue) {
+	return Ring[Queue->Positions[Queue->Head & Mask] & Mask];
+}
+
+
+/* Add Value to *Sum, adding the rounding error of that (worked out exactly, by Knuth's TwoSum) to *Error.  *Sum + *Error is then the exact total but for the rounding of the additions to *Error, which are about 2^-53 the size of those to *Sum, so the running sum of squares can't drift however many samples pass through it; it takes six more additions than a plain +=.  (No multiplies, so nothing for the compiler to contract into an FMA.) */
+static inline void
+addCompensated(double * Sum,
+	       double * Error,
+	       double Value) {
+
+	double dSum = *Sum + Value;
+	double dValuePart = dSum - *Sum;
+	double dSumPart = dSum - dValuePart;
+
+	*Error += (*Sum - dSumPart) + (Value - dValuePart);
+	*Sum = dSum;
+}
+
+
+/* Recompute the sum of squares and rebuild the queues from the history currently in the window.  O(window length), so only done when the window length changes. */
+static void
+rescanWindow(Meter * psMeter) {
+
+	uint32_t iPosition;
+	LADSPA_Data fValue;
+	double dSum = 0.0;
+
+	psMeter->MaxQueue.Head = psMeter->MaxQueue.Tail = 0;
+	psMeter->MinQueue.Head = psMeter->MinQueue.Tail = 0;
+	psMeter->TruePeakQueue.Head = psMeter->TruePeakQueue.Tail = 0;
+	for (iPosition = psMeter->Position - psMeter->Filled; iPosition != psMeter->Position; iPosition++) {
+		fValue = psMeter->Ring[iPosition & psMeter->RingMask];
+		dSum += fValue * fValue;
+		pushMaxQueue(psMeter->Ring, psMeter->RingMask, &psMeter->MaxQueue, iPosition, fValue);
+		pushMinQueue(psMeter->Ring, psMeter->RingMask, &psMeter->MinQueue, iPosition, fValue);
+		pushMaxQueue(psMeter->TruePeakRing, psMeter->RingMask, &psMeter->TruePeakQueue, iPosition,
+			     psMeter->TruePeakRing[iPosition & psMeter->RingMask]);
+	}
+	psMeter->SumOfSquares = dSum;
+	psMeter->SumError = 0.0;
+}
+
+
+/* Slide the window over SampleCount samples of silence when the whole window is (and stays) silent: the ring entries they land on are zeroed, the sum of squares is exactly 0, and as every value in the window is equal each queue holds just the newest position. */
+static void
+skipSilentWindow(Meter * psMeter,
+		 unsigned long SampleCount) {
+
+	uint32_t Mask = psMeter->RingMask;
+	uint32_t Start;
+	unsigned long lLength;
+	unsigned long lFirstRun;
+
+	lLength = SampleCount < (unsigned long)Mask + 1 ? SampleCount : (unsigned long)Mask + 1;
+	Start = (psMeter->Position + (uint32_t)(SampleCount - lLength)) & Mask;
+	lFirstRun = (unsigned long)Mask + 1 - Start < lLength ? (unsigned long)Mask + 1 - Start : lLength;
+	memset(psMeter->Ring + Start, 0, lFirstRun * sizeof(LADSPA_Data));
+	memset(psMeter->Ring, 0, (lLength - lFirstRun) * sizeof(LADSPA_Data));
+	memset(psMeter->TruePeakRing + Start, 0, lFirstRun * sizeof(LADSPA_Data));
+	memset(psMeter->TruePeakRing, 0, (lLength - lFirstRun) * sizeof(LADSPA_Data));
+	memset(psMeter->TruePeakInput, 0, (CME_TRUE_PEAK_TAPS - 1) * sizeof(LADSPA_Data));
+
+	psMeter->Position += (uint32_t)SampleCount;
+	psMeter->SumOfSquares = 0.0;
+	psMeter->SumError = 0.0;
+	psMeter->Filled = psMeter->Filled + SampleCount < psMeter->WindowSamples ? psMeter->Filled + SampleCount : psMeter->WindowSamples;
+	psMeter->MaxQueue.Head = psMeter->MinQueue.Head = psMeter->TruePeakQueue.Head = 0;
+	psMeter->MaxQueue.Tail = psMeter->MinQueue.Tail = psMeter->TruePeakQueue.Tail = 1;
+	psMeter->MaxQueue.Positions[0] = psMeter->MinQueue.Positions[0] = psMeter->TruePeakQueue.Positions[0] = psMeter->Position - 1;
+}
+
+
+/* Loudness (LUFS) of a mean-square energy, for a single channel. */
+static inline double
+energyToLoudness(double Energy) {
+	return -0.691 + 10 * log10(Energy);
+}
+
+
+/* The same for the outputs, which bottom out at METER_FLOOR_DB like the levels (so silence reads as the floor of their range, not -inf). */
+static inline double
+energyToLoudnessOutput(double Energy) {
+
+	double dLoudness = energyToLoudness(Energy);
+
+	return dLoudness > METER_FLOOR_DB ? dLoudness : METER_FLOOR_DB;	// (NaN too)
+}
+
+
+/* Add one block's energy to a histogram, unless it falls below the absolute gate. */
+static void
+addToHistogram(LoudnessHistogram * psHistogram,
+	       double Energy) {
+
+	double dBin = (energyToLoudness(Energy) - METER_HISTOGRAM_FLOOR) * METER_HISTOGRAM_BINS_PER_LU;
+	unsigned long lBin;
+
+	if (!(dBin > 0))	// (also catches silence, where the loudness is -inf)
+		return;
+	lBin = dBin < METER_HISTOGRAM_BINS ? (unsigned long)dBin : METER_HISTOGRAM_BINS - 1;
+	psHistogram->Count[lBin]++;
+	psHistogram->Energy[lBin] += Energy;
+}
+
+
+/* Apply the relative gate (RelativeGate LU below the loudness of everything above the absolute gate) and return the first bin that passes it, or METER_HISTOGRAM_BINS if the histogram is empty.  The gate is rounded to the nearest bin boundary. */
+static unsigned long
+gateHistogram(const LoudnessHistogram * psHistogram,
+	      double RelativeGate) {
+
+	double dEnergy = 0.0;
+	double dCount = 0.0;
+	double dGate;
+	unsigned long lBin;
+
+	for (lBin = 0; lBin < METER_HISTOGRAM_BINS; lBin++) {
+		dEnergy += psHistogram->Energy[lBin];
+		dCount += psHistogram->Count[lBin];
+	}
+	if (dCount == 0)
+		return METER_HISTOGRAM_BINS;
+
+	dGate = (energyToLoudness(dEnergy / dCount) - RelativeGate - METER_HISTOGRAM_FLOOR) * METER_HISTOGRAM_BINS_PER_LU + 0.5;
+	if (dGate < 0)
+		return 0;
+	return dGate < METER_HISTOGRAM_BINS ? (unsigned long)dGate : METER_HISTOGRAM_BINS - 1;
+}
+
+
+/* Integrated loudness: the mean energy of the 400 ms blocks that pass both gates (METER_FLOOR_DB if none has). */
+static double
+integratedLoudness(const LoudnessHistogram * psHistogram) {
+
+	double dEnergy = 0.0;
+	double dCount = 0.0;
+	unsigned long lBin;
+
+	for (lBin = gateHistogram(psHistogram, 10.0); lBin < METER_HISTOGRAM_BINS; lBin++) {
+		dEnergy += psHistogram->Energy[lBin];
+		dCount += psHistogram->Count[lBin];
+	}
+	return dCount > 0 ? energyToLoudnessOutput(dEnergy / dCount) : METER_FLOOR_DB;
+}
+
+
+/* Loudness range (EBU Tech 3342): the spread between the 10th and 95th percentiles of the gated short-term loudness, measured between bin centres. */
+static double
+loudnessRange(const LoudnessHistogram * psHistogram) {
+
+	unsigned long lFirst = gateHistogram(psHistogram, 20.0);
+	unsigned long lBin, lLow, lHigh;
+	double dTotal = 0.0;
+	double dSoFar = 0.0;
+
+	for (lBin = lFirst; lBin < METER_HISTOGRAM_BINS; lBin++)
+		dTotal += psHistogram->Count[lBin];
+	if (dTotal == 0)
+		return 0.0;
+
+	lLow = lHigh = lFirst;
+	for (lBin = lFirst; lBin < METER_HISTOGRAM_BINS; lBin++) {
+		if (dSoFar <= 0.10 * dTotal)
+			lLow = lBin;
+		dSoFar += psHistogram->Count[lBin];
+		if (dSoFar - psHistogram->Count[lBin] < 0.95 * dTotal)
+			lHigh = lBin;
+	}
+	return (double)(lHigh - lLow) / METER_HISTOGRAM_BINS_PER_LU;
+}
+
+
+/* Mean energy of the most recent Count sub-blocks (silence before activate()). */
+static double
+recentEnergy(const Meter * psMeter,
+	     unsigned long Count) {
+
+	double dSum = 0.0;
+	unsigned long lIndex;
+
+	for (lIndex = 1; lIndex <= Count; lIndex++)
+		dSum += psMeter->SubBlockEnergy[(psMeter->SubBlockCount - lIndex) % METER_SHORT_TERM_SUBBLOCKS];
+	return dSum / Count;
+}
+
+
+/* A 100 ms sub-block is complete: update the momentary and short-term loudness, and every 400 ms / 3 s block's histogram. */
+static void
+endSubBlock(Meter * psMeter) {
+
+	double dMomentary, dShortTerm;
+
+	psMeter->SubBlockEnergy[psMeter->SubBlockCount % METER_SHORT_TERM_SUBBLOCKS] = psMeter->SubBlockSum / psMeter->SubBlockSamples;
+	psMeter->SubBlockCount++;
+	psMeter->SubBlockSum = 0.0;
+	psMeter->SubBlockFill = 0;
+
+	dMomentary = recentEnergy(psMeter, METER_MOMENTARY_SUBBLOCKS);
+	dShortTerm = recentEnergy(psMeter, METER_SHORT_TERM_SUBBLOCKS);
+	psMeter->Momentary = energyToLoudnessOutput(dMomentary);
+	psMeter->ShortTerm = energyToLoudnessOutput(dShortTerm);
+
+	// Only whole blocks count towards the gated measurements:
+	if (psMeter->SubBlockCount >= METER_MOMENTARY_SUBBLOCKS) {
+		addToHistogram(&psMeter->BlockHistogram, dMomentary);
+		psMeter->Integrated = integratedLoudness(&psMeter->BlockHistogram);
+	}
+	if (psMeter->SubBlockCount >= METER_SHORT_TERM_SUBBLOCKS) {
+		addToHistogram(&psMeter->ShortTermHistogram, dShortTerm);
+		psMeter->Range = loudnessRange(&psMeter->ShortTermHistogram);
+	}
+}
+
+
+/* K-weight some input and collect its energy into sub-blocks. */
+static void
+measureLoudness(Meter * psMeter,
+		const LADSPA_Data * Input,
+		unsigned long SampleCount) {
+
+	Biquad sShelf = psMeter->KShelf;
+	Biquad sHighPass = psMeter->KHighPass;
+	double dSum = psMeter->SubBlockSum;
+	unsigned long lFill = psMeter->SubBlockFill;
+	unsigned long lSampleIndex;
+	double dX, dY;
+
+	for (lSampleIndex = 0; lSampleIndex < SampleCount; lSampleIndex++) {
+		dX = cmeDenormalBias(Input[lSampleIndex]);
+		dY = sShelf.B0 * dX + sShelf.Z1;
+		sShelf.Z1 = sShelf.B1 * dX - sShelf.A1 * dY + sShelf.Z2;
+		sShelf.Z2 = sShelf.B2 * dX - sShelf.A2 * dY;
+		dX = dY;
+		dY = sHighPass.B0 * dX + sHighPass.Z1;
+		sHighPass.Z1 = sHighPass.B1 * dX - sHighPass.A1 * dY + sHighPass.Z2;
+		sHighPass.Z2 = sHighPass.B2 * dX - sHighPass.A2 * dY;
+		dSum += dY * dY;
+
+		if (++lFill == psMeter->SubBlockSamples) {
+			psMeter->SubBlockSum = dSum;
+			endSubBlock(psMeter);
+			dSum = 0.0;
+			lFill = 0;
+		}
+	}
+
+	psMeter->KShelf = sShelf;
+	psMeter->KHighPass = sHighPass;
+	psMeter->SubBlockSum = dSum;
+	psMeter->SubBlockFill = lFill;
+}
+
+
+/* Account for SampleCount samples of silence fed to K-weighting filters that have come to rest: they add no energy, so only the sub-blocks move on. */
+static void
+skipSilentLoudness(Meter * psMeter,
+		   unsigned long SampleCount) {
+
+	unsigned long lStep;
+
+	while (SampleCount > 0) {
+		lStep = psMeter->SubBlockSamples - psMeter->SubBlockFill;
+		if (lStep > SampleCount) {
+			psMeter->SubBlockFill += SampleCount;
+			return;
+		}
+		SampleCount -= lStep;
+		endSubBlock(psMeter);
+	}
+}
+
+
+/* Whether the K-weighting filters hold no signal at all. */
+static inline int
+loudnessAtRest(const Meter * psMeter) {
+	return psMeter->KShelf.Z1 == 0.0 && psMeter->KShelf.Z2 == 0.0
+		&& psMeter->KHighPass.Z1 == 0.0 && psMeter->KHighPass.Z2 == 0.0;
+}
+
+
+/* Apply a new window length (ms), keeping as much of the history as fits. */
+static void
+setWindowLength(Meter * psMeter,
+		LADSPA_Data WindowLength) {
+
+	unsigned long lSamples;
+
+	psMeter->LastWindowLength = WindowLength;
+
+	if (!(WindowLength >= METER_MIN_WINDOW))	// (also catches NaN)
+		WindowLength = METER_MIN_WINDOW;
+	if (WindowLength > METER_MAX_WINDOW)
+		WindowLength = METER_MAX_WINDOW;
+	lSamples = (unsigned long)(WindowLength * 0.001 * psMeter->SampleRate + 0.5);
+	if (lSamples < 1)
+		lSamples = 1;
+	if (lSamples > psMeter->RingMask)
+		lSamples = psMeter->RingMask;
+
+	psMeter->WindowSamples = lSamples;
+	psMeter->Filled = psMeter->Available < lSamples ? psMeter->Available : lSamples;
+	rescanWindow(psMeter);
+}
+
+
+
+/* The rest of run(), once the window has moved on: update the history count and write out (and publish) all the readings. */
+static void
+finishMeterRun(Meter * psMeter,
+	       unsigned long SampleCount) {
+
+	// All meter outputs in dB re. 1.0.
+	LADSPA_Data PeakLevel;
+	LADSPA_Data RMSLevel;
+	CMETelemetryRecord sRecord;
+	const uint32_t Mask = psMeter->RingMask;
+
+	psMeter->Available += SampleCount;
+	if (psMeter->Available > Mask)
+		psMeter->Available = Mask;
+	psMeter->SamplesSinceActivate += SampleCount;
+
+	*psMeter->MomentaryLoudness = psMeter->Momentary;
+	*psMeter->ShortTermLoudness = psMeter->ShortTerm;
+	*psMeter->IntegratedLoudness = psMeter->Integrated;
+	*psMeter->LoudnessRange = psMeter->Range;
+
+	if (psMeter->Filled == 0)
+		return;
+
+	// Output the calculated values to the meter ports:
+	// We save PeakLevel and RMSLevel to make the crest factor calculation a bit cheaper (avoid recalculating)
+	PeakLevel = cmeLevelToDB(queueHeadValue(psMeter->Ring, Mask, &psMeter->MaxQueue)); *psMeter->PeakLevel = PeakLevel;
+	RMSLevel = cmeLevelToDB(sqrt(fmax(psMeter->SumOfSquares + psMeter->SumError, 0.0) / psMeter->Filled)); *psMeter->RMSLevel = RMSLevel;
+	*psMeter->TroughLevel = cmeLevelToDB(queueHeadValue(psMeter->Ring, Mask, &psMeter->MinQueue));
+	*psMeter->CrestFactor = PeakLevel - RMSLevel;
+	*psMeter->TruePeakLevel = cmeLevelToDB(queueHeadValue(psMeter->TruePeakRing, Mask, &psMeter->TruePeakQueue));
+
+	if (psMeter->Telemetry) {
+		sRecord.SamplePosition = psMeter->SamplesSinceActivate;
+		sRecord.SampleCount = SampleCount;
+		sRecord.Peak = PeakLevel;
+		sRecord.RMS = RMSLevel;
+		sRecord.Trough = *psMeter->TroughLevel;
+		sRecord.Crest = *psMeter->CrestFactor;
+		sRecord.TruePeak = *psMeter->TruePeakLevel;
+		sRecord.Momentary = psMeter->Momentary;
+		sRecord.ShortTerm = psMeter->ShortTerm;
+		sRecord.Integrated = psMeter->Integrated;
+		sRecord.Range = psMeter->Range;
+		cmeTelemetryPublish(psMeter->Telemetry, &sRecord);
 	}
 }
 
@@ -89,46 +730,119 @@ runMeter(LADSPA_Handle Instance,
 		 unsigned long SampleCount) {
   
 	LADSPA_Data * Input;
-	// All meter outputs in dB re. 1.0.
-	LADSPA_Data	PeakLevel;
-	LADSPA_Data	RMSLevel;
-	//LADSPA_Data	TroughLevel;
-	//LADSPA_Data	CrestFactor;
-
-	LADSPA_Data	RMSSumOfSquares = 0.0;
-	//LADSPA_Data	RMSWindowBuffer[SampleCount]
-
 	Meter * psMeter;
 	unsigned long SampleIndex;
+	unsigned long ChunkStart;
+	unsigned long ChunkLength;
+	LADSPA_Data * Ring;
+	LADSPA_Data * TruePeakRing;
+	const LADSPA_Data * TruePeak;
+	PositionQueue MaxQueue, MinQueue, TruePeakQueue;
+	double SumOfSquares;
+	double SumError;
+	uint32_t Position;
+	uint32_t Mask;
+	uint32_t WindowSamples;
+	LADSPA_Data Value;
+	LADSPA_Data Leaving;
+	CMEDenormalGuard sGuard;
 
 	psMeter = (Meter *)Instance;
+	cmeDenormalGuardEnter(&sGuard);
 
-	// Keep track of the largest and smallest sample encoured within the current window
-	LADSPA_Data	MaxSample = 0.0;
-	LADSPA_Data	MinSample = 1.0;
+	if (*(psMeter->WindowLength) != psMeter->LastWindowLength)
+		setWindowLength(psMeter, *(psMeter->WindowLength));
 
 	Input = psMeter->InputBuffer;
-	//PeakLevel = *(psMeter->PeakLevel);
+	Ring = psMeter->Ring;
+	TruePeakRing = psMeter->TruePeakRing;
+	TruePeak = psMeter->TruePeakOutput;
+	Mask = psMeter->RingMask;
+	WindowSamples = psMeter->WindowSamples;
+	MaxQueue = psMeter->MaxQueue;
+	MinQueue = psMeter->MinQueue;
+	TruePeakQueue = psMeter->TruePeakQueue;
+	SumOfSquares = psMeter->SumOfSquares;
+	SumError = psMeter->SumError;
+	Position = psMeter->Position;
+
+	if (!g_sCMEKernels.IsSilent(Input, SampleCount))
+		psMeter->SilentSamples = 0;
+	else {
+		psMeter->SilentSamples += SampleCount;
+		if (psMeter->SilentSamples > (unsigned long)psMeter->RingMask + CME_TRUE_PEAK_TAPS)
+			psMeter->SilentSamples = (unsigned long)psMeter->RingMask + CME_TRUE_PEAK_TAPS;
+
+		// Silent for the whole window, and long enough before it for the true-peak filter to have emptied:
+		if (psMeter->SilentSamples >= psMeter->WindowSamples + CME_TRUE_PEAK_TAPS) {
+			skipSilentWindow(psMeter, SampleCount);
+			if (loudnessAtRest(psMeter))
+				skipSilentLoudness(psMeter, SampleCount);
+			else
+				measureLoudness(psMeter, Input, SampleCount);
+			finishMeterRun(psMeter, SampleCount);
+			cmeDenormalGuardLeave(&sGuard);
+			return;
+		}
+	}
 
-	// Process the sample buffer:
-	for (SampleIndex = 0; SampleIndex < SampleCount; SampleIndex++)
-	{
-		// Update the largest and smallest absolute sample value encountered (if this window has a new record-holder):
-		if (fabs(*Input) < MinSample)	MinSample = fabs(*Input);
-		if (fabs(*Input) > MaxSample)	MaxSample = fabs(*Input);
+	for (ChunkStart = 0; ChunkStart < SampleCount; ChunkStart += ChunkLength) {
+
+		// Oversample the next chunk for the true peak, keeping the filter's history just in front of it:
+		ChunkLength = SampleCount - ChunkStart < METER_CHUNK ? SampleCount - ChunkStart : METER_CHUNK;
+		memcpy(psMeter->TruePeakInput + CME_TRUE_PEAK_TAPS - 1, Input + ChunkStart, ChunkLength * sizeof(LADSPA_Data));
+		g_sCMEKernels.TruePeak(psMeter->TruePeakInput + CME_TRUE_PEAK_TAPS - 1, psMeter->TruePeakOutput, ChunkLength);
+		memmove(psMeter->TruePeakInput, psMeter->TruePeakInput + ChunkLength, (CME_TRUE_PEAK_TAPS - 1) * sizeof(LADSPA_Data));
+		measureLoudness(psMeter, Input + ChunkStart, ChunkLength);
+
+		// Process the chunk, sliding the window along one sample at a time:
+		for (SampleIndex = 0; SampleIndex < ChunkLength; SampleIndex++)
+		{
+			Value = fabsf(Input[ChunkStart + SampleIndex]);
+			Ring[Position & Mask] = Value;
+			TruePeakRing[Position & Mask] = TruePeak[SampleIndex];
+
+			// Update the numerator for RMS calculation, and drop the oldest sample once the window is full:
+			addCompensated(&SumOfSquares, &SumError, Value * Value);
+			if (psMeter->Filled < WindowSamples)
+				psMeter->Filled++;
+			else {
+				Leaving = Ring[(Position - WindowSamples) & Mask];
+				addCompensated(&SumOfSquares, &SumError, -(Leaving * Leaving));
+			}
+
+			// Keep track of the largest and smallest sample within the current window (the heads of the queues), retiring them once they fall out of it:
+			pushMaxQueue(Ring, Mask, &MaxQueue, Position, Value);
+			pushMinQueue(Ring, Mask, &MinQueue, Position, Value);
+			pushMaxQueue(TruePeakRing, Mask, &TruePeakQueue, Position, TruePeak[SampleIndex]);
+			retireQueueHead(&MaxQueue, Mask, Position, WindowSamples);
+			retireQueueHead(&MinQueue, Mask, Position, WindowSamples);
+			retireQueueHead(&TruePeakQueue, Mask, Position, WindowSamples);
+
+			Position++;
+		}
+	}
 
-		// Update the numerator for RMS calculation:
-		RMSSumOfSquares += (*Input) * (*Input);
+	psMeter->MaxQueue = MaxQueue;
+	psMeter->MinQueue = MinQueue;
+	psMeter->TruePeakQueue = TruePeakQueue;
+	psMeter->SumOfSquares = SumOfSquares;
+	psMeter->SumError = SumError;
+	psMeter->Position = Position;
 
-		Input++;
-	}
+	finishMeterRun(psMeter, SampleCount);
+	cmeDenormalGuardLeave(&sGuard);
+}
 
-	// Output the calculated values to the meter ports:
-	// We save PeakLevel and RMSLevel to make the crest factor calculation a bit cheaper (avoid recalculating)
-	PeakLevel = 20 * log10(MaxSample); *psMeter->PeakLevel = PeakLevel;
-	RMSLevel = 20 * log10(sqrt(RMSSumOfSquares / SampleCount)); *psMeter->RMSLevel = RMSLevel;
-	*psMeter->TroughLevel = 20 * log10(MinSample);
-	*psMeter->CrestFactor = PeakLevel - RMSLevel;
+
+
+
+
+
+/* The meter has no audio outputs, so there is nothing for run_adding() to add to: it is the same as run(), and the run-adding gain is ignored.  They're provided so that hosts which mix everything with run_adding() can still use the meter. */
+void 
+setMeterRunAddingGain(LADSPA_Handle Instance,
+		      LADSPA_Data Gain) {
 }
 
 
@@ -139,140 +853,293 @@ runMeter(LADSPA_Handle Instance,
 /* Throw away a simple delay line. */
 void 
 cleanupMeter(LADSPA_Handle Instance) {
-	free(Instance);
+
+	Meter * psMeter;
+
+	psMeter = (Meter *)Instance;
+	free(psMeter->Ring);
+	free(psMeter->MaxQueue.Positions);
+	free(psMeter->MinQueue.Positions);
+	free(psMeter->TruePeakRing);
+	free(psMeter->TruePeakQueue.Positions);
+	cmeTelemetryDestroy(psMeter->Telemetry);
+	cmePoolRelease(&g_sMeterPool, psMeter);
 }
 
 
 
-LADSPA_Descriptor * g_psMeterDescriptor = NULL;
+/*****************************************************************************/
+
+/* Multichannel meters.  Ports: Channels inputs, then MULTIMETER_OUTPUTS_PER_CHANNEL outputs for each channel, then the window length.  The sliding window is kept by cmestatswindow.c. */
+
+typedef struct {
+	unsigned long Channels;
+
+	LADSPA_Data ** Inputs;		// [Channels]
+	LADSPA_Data ** Outputs;		// [Channels * MULTIMETER_OUTPUTS_PER_CHANNEL]
+	LADSPA_Data * WindowLength;
+
+	CMEStatsWindow Window;
+} MultiMeter;
 
+static CMEInstancePool g_sMultiMeterPool = CME_INSTANCE_POOL(MultiMeter);
 
 
+/* The multichannel descriptors (2, 8, 16, 32 and 64 channels) have consecutive IDs from CMEMULTIMETER_LADSPA_ID. */
+#define MULTIMETER_VARIANTS	CME_MULTIMETER_VARIANTS
+
 
 void 
-_init() {
+cleanupMultiMeter(LADSPA_Handle Instance);
 
-	char ** pcPortNames;
-	LADSPA_PortDescriptor * piPortDescriptors;
-	LADSPA_PortRangeHint * psPortRangeHints;
 
-	g_psMeterDescriptor = (LADSPA_Descriptor *)malloc(sizeof(LADSPA_Descriptor));
+LADSPA_Handle 
+instantiateMultiMeter(const LADSPA_Descriptor * Descriptor,
+		      unsigned long             SampleRate) {
 
-  
-		g_psMeterDescriptor->UniqueID = CMEMETER_LADSPA_ID;
-		g_psMeterDescriptor->Label = strdup("cme_meter");
-		g_psMeterDescriptor->Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE;
-		g_psMeterDescriptor->Name = strdup("Meter (CME)");
-		g_psMeterDescriptor->Maker = strdup("Chris Edwards");
-		g_psMeterDescriptor->Copyright = strdup("None");
-
-		g_psMeterDescriptor->PortCount = CMEMETER_PORT_COUNT;
-		piPortDescriptors = (LADSPA_PortDescriptor *)calloc(CMEMETER_PORT_COUNT, sizeof(LADSPA_PortDescriptor));
-		g_psMeterDescriptor->PortDescriptors = (const LADSPA_PortDescriptor *)piPortDescriptors;
-		piPortDescriptors[METER_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
-		piPortDescriptors[METER_PEAK] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[METER_RMS] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[METER_TROUGH] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
-		piPortDescriptors[METER_CREST] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
-		
-		pcPortNames = (char **)calloc(CMEMETER_PORT_COUNT, sizeof(char *));
-		g_psMeterDescriptor->PortNames = (const char **)pcPortNames;
-		pcPortNames[METER_INPUT] = strdup("Input");
-		pcPortNames[METER_PEAK] = strdup("Peak level (dB)");
-		pcPortNames[METER_RMS] = strdup("RMS level (dB)");
-		pcPortNames[METER_TROUGH] = strdup("Trough level (dB)");
-		pcPortNames[METER_CREST] = strdup("Crest factor (dB)");
-		psPortRangeHints = ((LADSPA_PortRangeHint *) calloc(CMEMETER_PORT_COUNT, sizeof(LADSPA_PortRangeHint)));
-		g_psMeterDescriptor->PortRangeHints = (const LADSPA_PortRangeHint *)psPortRangeHints;
-
-
-		psPortRangeHints[METER_PEAK].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[METER_PEAK].LowerBound = -120;
-		psPortRangeHints[METER_PEAK].UpperBound = 0;
-
-
-		psPortRangeHints[METER_RMS].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[METER_RMS].LowerBound = -120;
-		psPortRangeHints[METER_RMS].UpperBound = 0;
-
-
-		psPortRangeHints[METER_TROUGH].HintDescriptor = (
-		   	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[METER_TROUGH].LowerBound = -120;
-		psPortRangeHints[METER_TROUGH].UpperBound = 0;
-
-
-		psPortRangeHints[METER_CREST].HintDescriptor = (
-		    	LADSPA_HINT_BOUNDED_BELOW | 
-			LADSPA_HINT_BOUNDED_ABOVE | 
-			LADSPA_HINT_DEFAULT_0
-		);
-		psPortRangeHints[METER_CREST].LowerBound = 0;
-		psPortRangeHints[METER_CREST].UpperBound = 30;
-
-
-		psPortRangeHints[METER_INPUT].HintDescriptor = 0;
-
-
-		g_psMeterDescriptor->instantiate = instantiateMeter;
-		g_psMeterDescriptor->connect_port = connectPortToMeter;
-		g_psMeterDescriptor->activate = NULL;
-		g_psMeterDescriptor->run = runMeter;
-		g_psMeterDescriptor->run_adding = NULL;
-		g_psMeterDescriptor->set_run_adding_gain = NULL;
-		g_psMeterDescriptor->deactivate = NULL;
-		g_psMeterDescriptor->cleanup = cleanupMeter;
-
-
-}
-
-
-void
-deleteDescriptor(LADSPA_Descriptor * psDescriptor) {
-  unsigned long lIndex;
-	if (psDescriptor) {
-		free((char *)psDescriptor->Label);
-		free((char *)psDescriptor->Name);
-		free((char *)psDescriptor->Maker);
-		free((char *)psDescriptor->Copyright);
-		free((LADSPA_PortDescriptor *)psDescriptor->PortDescriptors);
-		for (lIndex = 0; lIndex < psDescriptor->PortCount; lIndex++)
-			free((char *)(psDescriptor->PortNames[lIndex]));
-		free((char **)psDescriptor->PortNames);
-		free((LADSPA_PortRangeHint *)psDescriptor->PortRangeHints);
-		free(psDescriptor);
+	MultiMeter * psMeter;
+	unsigned long lChannels = (unsigned long)(uintptr_t)Descriptor->ImplementationData;
+
+	psMeter = (MultiMeter *)cmePoolAllocate(&g_sMultiMeterPool);
+	if (!psMeter)
+		return NULL;
+
+	psMeter->Channels = lChannels;
+	psMeter->Inputs = (LADSPA_Data **)calloc(lChannels, sizeof(LADSPA_Data *));
+	psMeter->Outputs = (LADSPA_Data **)calloc(lChannels * MULTIMETER_OUTPUTS_PER_CHANNEL, sizeof(LADSPA_Data *));
+	if (!psMeter->Inputs || !psMeter->Outputs
+	    || !cmeStatsWindowInit(&psMeter->Window, lChannels, SampleRate)) {
+		cleanupMultiMeter(psMeter);
+		return NULL;
 	}
+	return psMeter;
 }
 
 
-void
-_fini() {
-	deleteDescriptor(g_psMeterDescriptor);
+void 
+activateMultiMeter(LADSPA_Handle Instance) {
+	cmeStatsWindowReset(&((MultiMeter *)Instance)->Window);
 }
 
 
-/* Return a descriptor of the requested plugin type. There are two
-   plugin types available in this library (pan and balance). */
+void 
+connectPortToMultiMeter(LADSPA_Handle Instance,
+			unsigned long Port,
+			LADSPA_Data * DataLocation) {
+
+	MultiMeter * psMeter;
+
+	psMeter = (MultiMeter *)Instance;
+	if (Port < psMeter->Channels)
+		psMeter->Inputs[Port] = DataLocation;
+	else if (Port < psMeter->Channels * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL))
+		psMeter->Outputs[Port - psMeter->Channels] = DataLocation;
+	else if (Port == psMeter->Channels * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL))
+		psMeter->WindowLength = DataLocation;
+}
+
+
+void 
+runMultiMeter(LADSPA_Handle Instance,
+	      unsigned long SampleCount) {
+
+	MultiMeter * psMeter;
+	CMEStatsWindow * psWindow;
+	unsigned long lChannel;
+	unsigned long lDone, lLength;
+	CMEDenormalGuard sGuard;
+
+	psMeter = (MultiMeter *)Instance;
+	psWindow = &psMeter->Window;
+	cmeDenormalGuardEnter(&sGuard);
+
+	cmeStatsWindowSetLength(psWindow, *(psMeter->WindowLength));
+
+	// Feed every channel through the Stats kernel, a block (or what's left of one) at a time:
+	for (lDone = 0; lDone < SampleCount; lDone += lLength) {
+		lLength = cmeStatsWindowSpace(psWindow, SampleCount - lDone);
+		for (lChannel = 0; lChannel < psMeter->Channels; lChannel++)
+			g_sCMEKernels.Stats(psMeter->Inputs[lChannel] + lDone, lLength, &psWindow->Current[lChannel]);
+		cmeStatsWindowAdvance(psWindow, lLength);
+	}
+
+	cmeStatsWindowRead(psWindow, psMeter->Outputs);
+
+	cmeDenormalGuardLeave(&sGuard);
+}
+
+
+void 
+cleanupMultiMeter(LADSPA_Handle Instance) {
+
+	MultiMeter * psMeter;
+
+	psMeter = (MultiMeter *)Instance;
+	free(psMeter->Inputs);
+	free(psMeter->Outputs);
+	cmeStatsWindowFree(&psMeter->Window);
+	cmePoolRelease(&g_sMultiMeterPool, psMeter);
+}
+
+
+
+static const LADSPA_PortDescriptor g_aiMeterPortDescriptors[CMEMETER_PORT_COUNT] = {
+	[METER_INPUT] = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+	[METER_PEAK] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_RMS] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_TROUGH] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_CREST] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_WINDOW] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,
+	[METER_TRUE_PEAK] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_MOMENTARY] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_SHORT_TERM] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_INTEGRATED] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+	[METER_RANGE] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL
+};
+
+static const char * const g_apcMeterPortNames[CMEMETER_PORT_COUNT] = {
+	[METER_INPUT] = "Input",
+	[METER_PEAK] = "Peak level (dB)",
+	[METER_RMS] = "RMS level (dB)",
+	[METER_TROUGH] = "Trough level (dB)",
+	[METER_CREST] = "Crest factor (dB)",
+	[METER_WINDOW] = "Window length (ms)",
+	[METER_TRUE_PEAK] = "True peak level (dBTP)",
+	[METER_MOMENTARY] = "Momentary loudness (LUFS)",
+	[METER_SHORT_TERM] = "Short-term loudness (LUFS)",
+	[METER_INTEGRATED] = "Integrated loudness (LUFS)",
+	[METER_RANGE] = "Loudness range (LU)"
+};
+
+
+/* Range hints shared by the mono and multichannel meters: */
+#define METER_LEVEL_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, METER_FLOOR_DB, 0 }
+#define METER_CREST_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, 0, 30 }
+// Default is the geometric middle of the range, i.e. 300 ms:
+#define METER_WINDOW_HINT	{ LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_LOGARITHMIC | LADSPA_HINT_DEFAULT_MIDDLE, METER_MIN_WINDOW, METER_MAX_WINDOW }
+
+static const LADSPA_PortRangeHint g_asMeterPortRangeHints[CMEMETER_PORT_COUNT] = {
+	[METER_PEAK] = METER_LEVEL_HINT,
+	[METER_RMS] = METER_LEVEL_HINT,
+	[METER_TROUGH] = METER_LEVEL_HINT,
+	[METER_CREST] = METER_CREST_HINT,
+	[METER_WINDOW] = METER_WINDOW_HINT,
+	// True peak can exceed 0 dBFS by a few dB:
+	[METER_TRUE_PEAK] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 6 },
+	[METER_MOMENTARY] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 6 },
+	[METER_SHORT_TERM] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 6 },
+	[METER_INTEGRATED] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, -120, 6 },
+	[METER_RANGE] = { LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_0, 0, 40 }
+};
+
+
+const LADSPA_Descriptor g_sMeterDescriptor = {
+	.UniqueID = CMEMETER_LADSPA_ID,
+	.Label = "cme_meter",
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE,
+	.Name = "Meter (CME)",
+	.Maker = "Chris Edwards",
+	.Copyright = "None",
+	.PortCount = CMEMETER_PORT_COUNT,
+	.PortDescriptors = g_aiMeterPortDescriptors,
+	.PortNames = g_apcMeterPortNames,
+	.PortRangeHints = g_asMeterPortRangeHints,
+	.instantiate = instantiateMeter,
+	.connect_port = connectPortToMeter,
+	.activate = activateMeter,
+	.run = runMeter,
+	.run_adding = runMeter,
+	.set_run_adding_gain = setMeterRunAddingGain,
+	.cleanup = cleanupMeter
+};
+
+
+
+/* The multichannel port tables are spelt out by the preprocessor, with CME_CHANNELS_n() (see cmeplugins.h); the per-channel macros below give the entries for one channel, in port order. */
+#define MULTIMETER_INPUT_PORT(n)	LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO,
+#define MULTIMETER_OUTPUT_PORTS(n)	LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL, LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL, \
+					LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL, LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+#define MULTIMETER_INPUT_NAME(n)	"Input " #n,
+#define MULTIMETER_OUTPUT_NAMES(n)	"Peak level " #n " (dB)", "RMS level " #n " (dB)", "Trough level " #n " (dB)", "Crest factor " #n " (dB)",
+#define MULTIMETER_INPUT_HINT(n)	{ 0, 0, 0 },
+#define MULTIMETER_OUTPUT_HINTS(n)	METER_LEVEL_HINT, METER_LEVEL_HINT, METER_LEVEL_HINT, METER_CREST_HINT,
+
+#define MULTIMETER_PORT_TABLES(C) \
+	static const LADSPA_PortDescriptor g_aiMultiMeter##C##PortDescriptors[] = { \
+		CME_CHANNELS_##C(MULTIMETER_INPUT_PORT) \
+		CME_CHANNELS_##C(MULTIMETER_OUTPUT_PORTS) \
+		LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL \
+	}; \
+	static const char * const g_apcMultiMeter##C##PortNames[] = { \
+		CME_CHANNELS_##C(MULTIMETER_INPUT_NAME) \
+		CME_CHANNELS_##C(MULTIMETER_OUTPUT_NAMES) \
+		"Window length (ms)" \
+	}; \
+	static const LADSPA_PortRangeHint g_asMultiMeter##C##PortRangeHints[] = { \
+		CME_CHANNELS_##C(MULTIMETER_INPUT_HINT) \
+		CME_CHANNELS_##C(MULTIMETER_OUTPUT_HINTS) \
+		METER_WINDOW_HINT \
+	};
+
+MULTIMETER_PORT_TABLES(2)
+MULTIMETER_PORT_TABLES(8)
+MULTIMETER_PORT_TABLES(16)
+MULTIMETER_PORT_TABLES(32)
+MULTIMETER_PORT_TABLES(64)
+
+#define MULTIMETER_DESCRIPTOR(Variant, C) { \
+	.UniqueID = CMEMULTIMETER_LADSPA_ID + Variant, \
+	.Label = "cme_meter_" #C, \
+	.Properties = LADSPA_PROPERTY_HARD_RT_CAPABLE, \
+	.Name = "Meter (CME, " #C " channels)", \
+	.Maker = "Chris Edwards", \
+	.Copyright = "None", \
+	.PortCount = C * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL) + 1, \
+	.PortDescriptors = g_aiMultiMeter##C##PortDescriptors, \
+	.PortNames = g_apcMultiMeter##C##PortNames, \
+	.PortRangeHints = g_asMultiMeter##C##PortRangeHints, \
+	.ImplementationData = (void *)(uintptr_t)C, \
+	.instantiate = instantiateMultiMeter, \
+	.connect_port = connectPortToMultiMeter, \
+	.activate = activateMultiMeter, \
+	.run = runMultiMeter, \
+	.run_adding = runMultiMeter, \
+	.set_run_adding_gain = setMeterRunAddingGain, \
+	.cleanup = cleanupMultiMeter \
+}
+
+const LADSPA_Descriptor g_asMultiMeterDescriptors[MULTIMETER_VARIANTS] = {
+	MULTIMETER_DESCRIPTOR(0, 2),
+	MULTIMETER_DESCRIPTOR(1, 8),
+	MULTIMETER_DESCRIPTOR(2, 16),
+	MULTIMETER_DESCRIPTOR(3, 32),
+	MULTIMETER_DESCRIPTOR(4, 64)
+};
+
+/* Every port table must match its descriptor's PortCount: */
+_Static_assert(sizeof(g_aiMultiMeter64PortDescriptors) / sizeof(g_aiMultiMeter64PortDescriptors[0]) == 64 * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL) + 1, "multimeter port table");
+_Static_assert(sizeof(g_apcMultiMeter64PortNames) / sizeof(g_apcMultiMeter64PortNames[0]) == 64 * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL) + 1, "multimeter port names");
+_Static_assert(sizeof(g_asMultiMeter64PortRangeHints) / sizeof(g_asMultiMeter64PortRangeHints[0]) == 64 * (1 + MULTIMETER_OUTPUTS_PER_CHANNEL) + 1, "multimeter range hints");
+
+
+
+#ifndef CME_BUNDLE
+
+void 
+_init() {
+	cmeKernelsInit();
+}
+
+
+/* Return a descriptor of the requested plugin type: the mono meter, then the multichannel ones, smallest first. */
 const LADSPA_Descriptor * 
 ladspa_descriptor(unsigned long Index) {
 	/* Return the requested descriptor or null if the index is out of range. */
-	switch (Index) {
-	case 0:
-		return g_psMeterDescriptor;
-	default:
-		return NULL;
-	}
+	if (Index == 0)
+		return &g_sMeterDescriptor;
+	if (Index - 1 < MULTIMETER_VARIANTS)
+		return &g_asMultiMeterDescriptors[Index - 1];
+	return NULL;
 }
 
-
+#endif /* CME_BUNDLE */